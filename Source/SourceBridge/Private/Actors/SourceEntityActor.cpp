@@ -6,6 +6,7 @@
 #include "Components/BillboardComponent.h"
 #include "Components/ArrowComponent.h"
 #include "Components/CapsuleComponent.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
 #include "ProceduralMeshComponent.h"
 
 // ---- Base ----
@@ -278,6 +279,23 @@ void ASourceProp::SetStaticMesh(UStaticMesh* Mesh)
 	}
 }
 
+// ---- Static Prop Group ----
+
+ASourceStaticPropGroup::ASourceStaticPropGroup()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	USceneComponent* Root = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	Root->SetMobility(EComponentMobility::Static);
+	SetRootComponent(Root);
+
+	InstancesComponent = CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(TEXT("Instances"));
+	if (InstancesComponent)
+	{
+		InstancesComponent->SetupAttachment(RootComponent);
+		InstancesComponent->SetMobility(EComponentMobility::Static);
+	}
+}
+
 // ---- Brush Entity ----
 
 ASourceBrushEntity::ASourceBrushEntity()
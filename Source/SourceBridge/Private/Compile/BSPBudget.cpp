@@ -0,0 +1,288 @@
+#include "Compile/BSPBudget.h"
+#include "Import/BSPReader.h"
+#include "Import/BSPStaticProps.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	/** A lump of fixed-size records and its element limit */
+	struct FLumpBudget
+	{
+		const TCHAR* Name;
+		EBSPLump Lump;
+		int32 ElementSize;
+		int64 Limit;
+	};
+
+	// Element sizes are the BSP v19-21 on-disk structs
+	const FLumpBudget LumpBudgets[] = {
+		{ TEXT("models"), EBSPLump::Models, 48, BSPLimits::Models },
+		{ TEXT("brushes"), EBSPLump::Brushes, 12, BSPLimits::Brushes },
+		{ TEXT("brushsides"), EBSPLump::BrushSides, 8, BSPLimits::BrushSides },
+		{ TEXT("planes"), EBSPLump::Planes, 20, BSPLimits::Planes },
+		{ TEXT("vertexes"), EBSPLump::Vertexes, 12, BSPLimits::Vertexes },
+		{ TEXT("nodes"), EBSPLump::Nodes, 32, BSPLimits::Nodes },
+		{ TEXT("texinfo"), EBSPLump::TexInfo, 72, BSPLimits::TexInfo },
+		{ TEXT("texdata"), EBSPLump::TexData, 32, BSPLimits::TexData },
+		{ TEXT("texdata_string_table"), EBSPLump::TexDataStringTable, 4, BSPLimits::TexDataStringTable },
+		{ TEXT("faces"), EBSPLump::Faces, 56, BSPLimits::Faces },
+		{ TEXT("leaffaces"), EBSPLump::LeafFaces, 2, BSPLimits::LeafFaces },
+		{ TEXT("leafbrushes"), EBSPLump::LeafBrushes, 2, BSPLimits::LeafBrushes },
+		{ TEXT("edges"), EBSPLump::Edges, 4, BSPLimits::Edges },
+		{ TEXT("surfedges"), EBSPLump::SurfEdges, 4, BSPLimits::SurfEdges },
+		{ TEXT("dispinfo"), EBSPLump::DispInfo, 176, BSPLimits::DispInfo },
+		{ TEXT("areas"), EBSPLump::Areas, 8, BSPLimits::Areas },
+		{ TEXT("areaportals"), EBSPLump::AreaPortals, 12, BSPLimits::AreaPortals },
+		{ TEXT("overlays"), EBSPLump::Overlays, 352, BSPLimits::Overlays },
+		{ TEXT("cubemaps"), EBSPLump::Cubemaps, 16, BSPLimits::Cubemaps },
+	};
+
+	// dleaf_t is 56 bytes in version 0 of the lump (with the ambient light cube), else 32
+	const int32 LEAF_SIZE = 32;
+	const int32 LEAF_V0_SIZE = 56;
+
+	// dworldlight_t grew by a 16-byte flags/shadow cast offset block in version 1
+	const int32 WORLDLIGHT_SIZE = 88;
+	const int32 WORLDLIGHT_V0_SIZE = 72;
+
+	/** Uncompressed size of a lump */
+	int64 GetLumpBytes(const FBSPReader& Reader, EBSPLump Lump)
+	{
+		const FBSPLumpInfo& Info = Reader.GetLumpInfo(Lump);
+		return Info.FourCC != 0 ? Info.FourCC : Info.Length;
+	}
+
+	FBSPBudgetEntry& AddEntry(FBSPBudgetReport& Report, const TCHAR* Name, int64 Count, int64 Bytes, int64 Limit, bool bByteLimit)
+	{
+		FBSPBudgetEntry& Entry = Report.Entries.AddDefaulted_GetRef();
+		Entry.Name = Name;
+		Entry.Count = Count;
+		Entry.Bytes = Bytes;
+		Entry.Limit = Limit;
+		Entry.bByteLimit = bByteLimit;
+		return Entry;
+	}
+
+	FString FormatBytes(int64 Bytes)
+	{
+		if (Bytes >= 1024 * 1024)
+		{
+			return FString::Printf(TEXT("%.1f MB"), Bytes / (1024.0 * 1024.0));
+		}
+		return FString::Printf(TEXT("%.1f KB"), Bytes / 1024.0);
+	}
+
+	FString FormatUsed(const FBSPBudgetEntry& Entry, int64 Value)
+	{
+		return Entry.bByteLimit || Entry.Count == 0 ? FormatBytes(Value) : FString::Printf(TEXT("%lld"), Value);
+	}
+}
+
+// ---- FBSPBudgetReport ----
+
+const FBSPBudgetEntry* FBSPBudgetReport::Find(const FString& Name) const
+{
+	return Entries.FindByPredicate([&Name](const FBSPBudgetEntry& Entry) { return Entry.Name == Name; });
+}
+
+TArray<const FBSPBudgetEntry*> FBSPBudgetReport::GetEntriesOver(float Threshold) const
+{
+	TArray<const FBSPBudgetEntry*> Over;
+	for (const FBSPBudgetEntry& Entry : Entries)
+	{
+		if (Entry.Limit > 0 && Entry.GetUsage() >= Threshold)
+		{
+			Over.Add(&Entry);
+		}
+	}
+	Over.Sort([](const FBSPBudgetEntry& A, const FBSPBudgetEntry& B) { return A.GetUsage() > B.GetUsage(); });
+	return Over;
+}
+
+TSharedRef<FJsonObject> FBSPBudgetReport::ToJson() const
+{
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("bsp"), BSPPath);
+	Root->SetStringField(TEXT("date"), FDateTime::UtcNow().ToIso8601());
+	Root->SetNumberField(TEXT("version"), Version);
+	Root->SetNumberField(TEXT("fileBytes"), (double)FileBytes);
+	if (!PreviousDate.IsEmpty())
+	{
+		Root->SetStringField(TEXT("previousDate"), PreviousDate);
+	}
+
+	TArray<TSharedPtr<FJsonValue>> Items;
+	for (const FBSPBudgetEntry& Entry : Entries)
+	{
+		TSharedRef<FJsonObject> Item = MakeShared<FJsonObject>();
+		Item->SetStringField(TEXT("name"), Entry.Name);
+		Item->SetNumberField(TEXT("count"), (double)Entry.Count);
+		Item->SetNumberField(TEXT("bytes"), (double)Entry.Bytes);
+		Item->SetNumberField(TEXT("limit"), (double)Entry.Limit);
+		Item->SetStringField(TEXT("limitUnit"), Entry.bByteLimit ? TEXT("bytes") : TEXT("count"));
+		Item->SetNumberField(TEXT("used"), (double)Entry.GetUsed());
+		Item->SetNumberField(TEXT("usage"), Entry.GetUsage());
+		if (Entry.bHasPrevious)
+		{
+			Item->SetNumberField(TEXT("delta"), (double)Entry.GetDelta());
+		}
+		Items.Add(MakeShared<FJsonValueObject>(Item));
+	}
+	Root->SetArrayField(TEXT("entries"), Items);
+	return Root;
+}
+
+// ---- FBSPBudget ----
+
+FString FBSPBudget::GetReportPath(const FString& BSPPath)
+{
+	return FPaths::GetPath(BSPPath) / FPaths::GetBaseFilename(BSPPath) + TEXT(".budget.json");
+}
+
+bool FBSPBudget::Analyze(const FString& BSPPath, FBSPBudgetReport& OutReport)
+{
+	OutReport = FBSPBudgetReport();
+	OutReport.BSPPath = BSPPath;
+
+	FBSPReader Reader;
+	if (!Reader.Open(BSPPath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SourceBridge: Budget: Cannot read %s: %s"), *BSPPath, *Reader.GetError());
+		return false;
+	}
+	OutReport.Version = Reader.GetVersion();
+	OutReport.FileBytes = Reader.GetFileSize();
+
+	for (const FLumpBudget& Budget : LumpBudgets)
+	{
+		const int64 Bytes = GetLumpBytes(Reader, Budget.Lump);
+		AddEntry(OutReport, Budget.Name, Bytes / Budget.ElementSize, Bytes, Budget.Limit, false);
+	}
+
+	// Lumps whose record size depends on the lump version
+	{
+		const int64 Bytes = GetLumpBytes(Reader, EBSPLump::Leafs);
+		const int32 Size = Reader.GetLumpInfo(EBSPLump::Leafs).Version == 0 ? LEAF_V0_SIZE : LEAF_SIZE;
+		AddEntry(OutReport, TEXT("leafs"), Bytes / Size, Bytes, BSPLimits::Leafs, false);
+	}
+	for (EBSPLump Lump : { EBSPLump::WorldLights, EBSPLump::WorldLightsHDR })
+	{
+		const int64 Bytes = GetLumpBytes(Reader, Lump);
+		const int32 Size = Reader.GetLumpInfo(Lump).Version == 0 ? WORLDLIGHT_V0_SIZE : WORLDLIGHT_SIZE;
+		AddEntry(OutReport, Lump == EBSPLump::WorldLights ? TEXT("worldlights") : TEXT("worldlights_hdr"),
+			Bytes / Size, Bytes, BSPLimits::WorldLights, false);
+	}
+
+	// Variable-size lumps, limited in bytes
+	AddEntry(OutReport, TEXT("entities"), Reader.ReadEntities().Num(), GetLumpBytes(Reader, EBSPLump::Entities),
+		BSPLimits::Entities, false);
+	AddEntry(OutReport, TEXT("entdata"), 0, GetLumpBytes(Reader, EBSPLump::Entities), BSPLimits::EntStringBytes, true);
+	AddEntry(OutReport, TEXT("texdata_string_data"), 0, GetLumpBytes(Reader, EBSPLump::TexDataStringData),
+		BSPLimits::TexDataStringBytes, true);
+	AddEntry(OutReport, TEXT("lighting"), 0, GetLumpBytes(Reader, EBSPLump::Lighting), BSPLimits::LightingBytes, true);
+	AddEntry(OutReport, TEXT("lighting_hdr"), 0, GetLumpBytes(Reader, EBSPLump::LightingHDR), BSPLimits::LightingBytes, true);
+	AddEntry(OutReport, TEXT("visibility"), 0, GetLumpBytes(Reader, EBSPLump::Visibility), BSPLimits::VisibilityBytes, true);
+
+	FBSPStaticPropLump StaticProps;
+	FBSPStaticProps::Read(Reader, StaticProps);
+	AddEntry(OutReport, TEXT("static_props"), StaticProps.Props.Num(), 0, BSPLimits::StaticProps, false);
+
+	// No engine limit, but the biggest contributor to download size and memory
+	AddEntry(OutReport, TEXT("pakfile"), Reader.GetPakEntries().Num(), GetLumpBytes(Reader, EBSPLump::PakFile), 0, true);
+	AddEntry(OutReport, TEXT("file"), 0, OutReport.FileBytes, BSPLimits::FileBytes, true);
+
+	return true;
+}
+
+bool FBSPBudget::Run(const FString& BSPPath, FBSPBudgetReport& OutReport)
+{
+	if (!Analyze(BSPPath, OutReport))
+	{
+		return false;
+	}
+
+	const FString ReportPath = GetReportPath(BSPPath);
+
+	// Deltas against the previous compile of this map
+	FString PreviousJson;
+	if (FFileHelper::LoadFileToString(PreviousJson, *ReportPath))
+	{
+		TSharedPtr<FJsonObject> Previous;
+		TSharedRef<TJsonReader<>> JsonReader = TJsonReaderFactory<>::Create(PreviousJson);
+		const TArray<TSharedPtr<FJsonValue>>* Items = nullptr;
+		if (FJsonSerializer::Deserialize(JsonReader, Previous) && Previous.IsValid()
+			&& Previous->TryGetArrayField(TEXT("entries"), Items))
+		{
+			Previous->TryGetStringField(TEXT("date"), OutReport.PreviousDate);
+			for (const TSharedPtr<FJsonValue>& Value : *Items)
+			{
+				const TSharedPtr<FJsonObject>* Item = nullptr;
+				if (!Value->TryGetObject(Item)) continue;
+
+				const FString Name = (*Item)->GetStringField(TEXT("name"));
+				FBSPBudgetEntry* Entry = OutReport.Entries.FindByPredicate(
+					[&Name](const FBSPBudgetEntry& E) { return E.Name == Name; });
+				double Used = 0.0;
+				if (Entry && (*Item)->TryGetNumberField(TEXT("used"), Used))
+				{
+					Entry->bHasPrevious = true;
+					Entry->PreviousUsed = (int64)Used;
+				}
+			}
+		}
+	}
+
+	FString Json;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	if (!FJsonSerializer::Serialize(OutReport.ToJson(), Writer) || !FFileHelper::SaveStringToFile(Json, *ReportPath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SourceBridge: Failed to write budget report %s"), *ReportPath);
+	}
+	return true;
+}
+
+void FBSPBudget::LogReport(const FBSPBudgetReport& Report)
+{
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: === BSP Budget (%s, v%d, %s) ==="),
+		*FPaths::GetCleanFilename(Report.BSPPath), Report.Version, *FormatBytes(Report.FileBytes));
+
+	for (const FBSPBudgetEntry& Entry : Report.Entries)
+	{
+		FString Line = FString::Printf(TEXT("%-22s %12s"), *Entry.Name, *FormatUsed(Entry, Entry.GetUsed()));
+		if (Entry.Limit > 0)
+		{
+			Line += FString::Printf(TEXT(" / %-12s %5.1f%%"), *FormatUsed(Entry, Entry.Limit), Entry.GetUsage() * 100.0f);
+		}
+		if (Entry.GetDelta() != 0)
+		{
+			const int64 Delta = Entry.GetDelta();
+			Line += FString::Printf(TEXT("  (%s%s)"), Delta > 0 ? TEXT("+") : TEXT("-"), *FormatUsed(Entry, FMath::Abs(Delta)));
+		}
+
+		if (Entry.Limit > 0 && Entry.GetUsage() >= WarningThreshold)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SourceBridge:   %s"), *Line);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Log, TEXT("SourceBridge:   %s"), *Line);
+		}
+	}
+}
+
+TArray<FString> FBSPBudget::GetWarnings(const FBSPBudgetReport& Report)
+{
+	TArray<FString> Warnings;
+	for (const FBSPBudgetEntry* Entry : Report.GetEntriesOver(WarningThreshold))
+	{
+		Warnings.Add(FString::Printf(TEXT("[Budget] %s at %.1f%% of the engine limit (%s / %s)"),
+			*Entry->Name, Entry->GetUsage() * 100.0f,
+			*FormatUsed(*Entry, Entry->GetUsed()), *FormatUsed(*Entry, Entry->Limit)));
+	}
+	return Warnings;
+}
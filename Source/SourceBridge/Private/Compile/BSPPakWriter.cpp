@@ -0,0 +1,476 @@
+#include "Compile/BSPPakWriter.h"
+#include "Import/BSPReader.h"
+#include "Utilities/LZMAEncoder.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+
+// ZIP records, matching what bspzip writes
+static const uint32 ZIP_LOCAL_HEADER_SIG = 0x04034b50;
+static const uint32 ZIP_CENTRAL_HEADER_SIG = 0x02014b50;
+static const uint32 ZIP_END_OF_DIR_SIG = 0x06054b50;
+static const int32 ZIP_LOCAL_HEADER_SIZE = 30;
+
+// Entry count field of the end record; Source's reader has no ZIP64
+static const int32 ZIP_MAX_ENTRIES = 0xFFFF;
+
+static const uint16 ZIP_METHOD_STORED = 0;
+static const uint16 ZIP_METHOD_LZMA = 14;
+
+// "Version needed to extract": 1.0 for stored, 6.3 for LZMA
+static const uint16 ZIP_VERSION_STORED = 10;
+static const uint16 ZIP_VERSION_LZMA = 63;
+
+// Offset of the lump directory in the BSP header
+static const int32 BSP_LUMP_DIRECTORY_OFFSET = 8;
+
+static const int64 COPY_CHUNK_SIZE = 1024 * 1024;
+
+// Smaller files aren't worth an LZMA header
+static const int64 MIN_COMPRESS_SIZE = 64;
+
+namespace
+{
+	/** One central directory record of the archive being written. */
+	struct FPakRecord
+	{
+		/** UTF-8 path */
+		TArray<uint8> Name;
+		uint16 Method = ZIP_METHOD_STORED;
+		uint32 CRC = 0;
+		uint32 CompressedSize = 0;
+		uint32 UncompressedSize = 0;
+		uint32 LocalHeaderOffset = 0;
+		uint32 DosTime = 0;
+
+		explicit FPakRecord(const FString& Path)
+		{
+			FTCHARToUTF8 Converted(*Path);
+			Name.Append(reinterpret_cast<const uint8*>(Converted.Get()), Converted.Length());
+		}
+
+		int64 DataOffset() const { return (int64)LocalHeaderOffset + ZIP_LOCAL_HEADER_SIZE + Name.Num(); }
+	};
+
+	void AppendLE16(TArray<uint8>& Out, uint32 Value)
+	{
+		Out.Add((uint8)Value);
+		Out.Add((uint8)(Value >> 8));
+	}
+
+	void AppendLE32(TArray<uint8>& Out, uint32 Value)
+	{
+		for (int32 i = 0; i < 4; ++i)
+		{
+			Out.Add((uint8)(Value >> (8 * i)));
+		}
+	}
+
+	uint32 ToDosTime(const FDateTime& Time)
+	{
+		if (Time.GetYear() < 1980)
+		{
+			return (1 << 21) | (1 << 16); // 1980-01-01
+		}
+		return ((uint32)(Time.GetYear() - 1980) << 25) | ((uint32)Time.GetMonth() << 21) | ((uint32)Time.GetDay() << 16)
+			| ((uint32)Time.GetHour() << 11) | ((uint32)Time.GetMinute() << 5) | ((uint32)Time.GetSecond() / 2);
+	}
+
+	FString NormalizePakPath(const FString& Path)
+	{
+		FString Result = Path.ToLower();
+		Result.ReplaceInline(TEXT("\\"), TEXT("/"));
+		while (Result.RemoveFromStart(TEXT("/")))
+		{
+		}
+		return Result;
+	}
+
+	bool WriteBytes(IFileHandle& Handle, const uint8* Data, int64 Size)
+	{
+		return Size == 0 || Handle.Write(Data, Size);
+	}
+
+	/** Copy Size bytes from From's current position to To's, in chunks. */
+	bool CopyChunks(IFileHandle& From, IFileHandle& To, int64 Size, TArray<uint8>& Buffer)
+	{
+		Buffer.SetNumUninitialized(COPY_CHUNK_SIZE);
+		while (Size > 0)
+		{
+			int64 Chunk = FMath::Min<int64>(Size, Buffer.Num());
+			if (!From.Read(Buffer.GetData(), Chunk) || !To.Write(Buffer.GetData(), Chunk))
+			{
+				return false;
+			}
+			Size -= Chunk;
+		}
+		return true;
+	}
+
+	/** CRC32 and SHA-1 of a whole file, read in chunks. */
+	bool HashFile(IFileHandle& Handle, int64 Size, uint32& OutCRC, FSHAHash& OutHash, TArray<uint8>& Buffer)
+	{
+		Buffer.SetNumUninitialized(COPY_CHUNK_SIZE);
+		FSHA1 SHA;
+		uint32 CRC = 0;
+		int64 Remaining = Size;
+		while (Remaining > 0)
+		{
+			int64 Chunk = FMath::Min<int64>(Remaining, Buffer.Num());
+			if (!Handle.Read(Buffer.GetData(), Chunk))
+			{
+				return false;
+			}
+			CRC = FCrc::MemCrc32(Buffer.GetData(), (int32)Chunk, CRC);
+			SHA.Update(Buffer.GetData(), (uint64)Chunk);
+			Remaining -= Chunk;
+		}
+		SHA.Final();
+		SHA.GetHash(OutHash.Hash);
+		OutCRC = CRC;
+		return true;
+	}
+
+	bool WriteLocalHeader(IFileHandle& Out, const FPakRecord& Record)
+	{
+		TArray<uint8> Header;
+		Header.Reserve(ZIP_LOCAL_HEADER_SIZE + Record.Name.Num());
+		AppendLE32(Header, ZIP_LOCAL_HEADER_SIG);
+		AppendLE16(Header, Record.Method == ZIP_METHOD_LZMA ? ZIP_VERSION_LZMA : ZIP_VERSION_STORED);
+		AppendLE16(Header, 0); // flags
+		AppendLE16(Header, Record.Method);
+		AppendLE32(Header, Record.DosTime);
+		AppendLE32(Header, Record.CRC);
+		AppendLE32(Header, Record.CompressedSize);
+		AppendLE32(Header, Record.UncompressedSize);
+		AppendLE16(Header, Record.Name.Num());
+		AppendLE16(Header, 0); // extra field
+		Header.Append(Record.Name);
+		return Out.Write(Header.GetData(), Header.Num());
+	}
+
+	/** Central directory and end record, after the last entry. */
+	bool WriteDirectory(IFileHandle& Out, const TArray<FPakRecord>& Records)
+	{
+		int64 DirStart = Out.Tell();
+		TArray<uint8> Dir;
+		for (const FPakRecord& Record : Records)
+		{
+			uint16 Version = Record.Method == ZIP_METHOD_LZMA ? ZIP_VERSION_LZMA : ZIP_VERSION_STORED;
+			AppendLE32(Dir, ZIP_CENTRAL_HEADER_SIG);
+			AppendLE16(Dir, Version); // made by
+			AppendLE16(Dir, Version); // needed
+			AppendLE16(Dir, 0);
+			AppendLE16(Dir, Record.Method);
+			AppendLE32(Dir, Record.DosTime);
+			AppendLE32(Dir, Record.CRC);
+			AppendLE32(Dir, Record.CompressedSize);
+			AppendLE32(Dir, Record.UncompressedSize);
+			AppendLE16(Dir, Record.Name.Num());
+			AppendLE16(Dir, 0); // extra
+			AppendLE16(Dir, 0); // comment
+			AppendLE16(Dir, 0); // disk
+			AppendLE16(Dir, 0); // internal attributes
+			AppendLE32(Dir, 0); // external attributes
+			AppendLE32(Dir, Record.LocalHeaderOffset);
+			Dir.Append(Record.Name);
+		}
+
+		uint32 DirSize = (uint32)Dir.Num();
+		AppendLE32(Dir, ZIP_END_OF_DIR_SIG);
+		AppendLE16(Dir, 0);
+		AppendLE16(Dir, 0);
+		AppendLE16(Dir, Records.Num());
+		AppendLE16(Dir, Records.Num());
+		AppendLE32(Dir, DirSize);
+		AppendLE32(Dir, (uint32)DirStart);
+		AppendLE16(Dir, 0);
+		return Out.Write(Dir.GetData(), Dir.Num());
+	}
+}
+
+FBSPPakResult FBSPPakWriter::Pack(
+	const FString& BSPPath,
+	const TMap<FString, FString>& Files,
+	const FBSPPakOptions& Options)
+{
+	FBSPPakResult Result;
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	FBSPReader Reader;
+	if (!Reader.Open(BSPPath))
+	{
+		Result.ErrorMessage = Reader.GetError();
+		return Result;
+	}
+
+	const FBSPLumpInfo OldPak = Reader.GetLumpInfo(EBSPLump::PakFile);
+	if (OldPak.FourCC != 0)
+	{
+		Result.ErrorMessage = TEXT("The pakfile lump is LZMA-compressed as a whole; no engine writes that");
+		return Result;
+	}
+
+	TMap<FString, const FBSPPakEntry*> OldEntries;
+	for (const FBSPPakEntry& Entry : Reader.GetPakEntries())
+	{
+		OldEntries.Add(Entry.Path, &Entry);
+	}
+
+	// Sorted so the same content always produces the same archive
+	TMap<FString, FString> NewFiles;
+	for (const auto& Pair : Files)
+	{
+		NewFiles.Add(NormalizePakPath(Pair.Key), Pair.Value);
+	}
+	NewFiles.KeySort(TLess<FString>());
+
+	// ---- Assemble the archive in a temporary file ----
+	const FString TempPath = BSPPath + TEXT(".pak.tmp");
+	TUniquePtr<IFileHandle> Out(PlatformFile.OpenWrite(*TempPath, false, true));
+	if (!Out)
+	{
+		Result.ErrorMessage = FString::Printf(TEXT("Cannot write %s"), *TempPath);
+		return Result;
+	}
+
+	TArray<FPakRecord> Records;
+	TMap<FSHAHash, int32> RecordByContent;
+	TArray<uint8> Buffer;
+	TArray<uint8> Payload;
+	bool bWriteFailed = false;
+
+	auto Fail = [&](const FString& Message)
+	{
+		Result.ErrorMessage = Message;
+		Out.Reset();
+		PlatformFile.DeleteFile(*TempPath);
+		return Result;
+	};
+
+	// Raw copy of an entry from the old pakfile
+	auto CopyOldEntry = [&](const FString& Path, const FBSPPakEntry& Entry) -> bool
+	{
+		TArrayView<const uint8> Stored = Reader.GetPakEntryData(Entry);
+		if (Stored.Num() != Entry.CompressedSize)
+		{
+			return false;
+		}
+		FPakRecord Record(Path);
+		Record.Method = Entry.Method;
+		Record.CRC = Entry.CRC;
+		Record.CompressedSize = (uint32)Entry.CompressedSize;
+		Record.UncompressedSize = (uint32)Entry.UncompressedSize;
+		Record.LocalHeaderOffset = (uint32)Out->Tell();
+		Record.DosTime = Entry.DosTime;
+		bWriteFailed |= !WriteLocalHeader(*Out, Record) || !WriteBytes(*Out, Stored.GetData(), Stored.Num());
+		Records.Add(MoveTemp(Record));
+		return true;
+	};
+
+	if (Options.bKeepExisting)
+	{
+		for (const FBSPPakEntry& Entry : Reader.GetPakEntries())
+		{
+			if (!NewFiles.Contains(Entry.Path) && CopyOldEntry(Entry.Path, Entry))
+			{
+				Result.FilesKept++;
+			}
+		}
+	}
+
+	for (const auto& Pair : NewFiles)
+	{
+		const FString& Path = Pair.Key;
+		const FString& DiskPath = Pair.Value;
+
+		TUniquePtr<IFileHandle> In(PlatformFile.OpenRead(*DiskPath));
+		int64 Size = In ? In->Size() : -1;
+		if (Size < 0 || Size > MAX_int32)
+		{
+			Result.MissingFiles.Add(DiskPath);
+			continue;
+		}
+
+		uint32 CRC = 0;
+		FSHAHash Hash;
+		if (!HashFile(*In, Size, CRC, Hash, Buffer))
+		{
+			Result.MissingFiles.Add(DiskPath);
+			continue;
+		}
+
+		// Unchanged since the last pack: keep the packed bytes as they are
+		const FBSPPakEntry* const* Old = OldEntries.Find(Path);
+		if (Old && (*Old)->CRC == CRC && (*Old)->UncompressedSize == Size
+			&& ((*Old)->Method == ZIP_METHOD_STORED || ((*Old)->Method == ZIP_METHOD_LZMA && Options.bCompress))
+			&& CopyOldEntry(Path, **Old))
+		{
+			Result.FilesUnchanged++;
+			continue;
+		}
+
+		FPakRecord Record(Path);
+		Record.CRC = CRC;
+		Record.UncompressedSize = (uint32)Size;
+		Record.LocalHeaderOffset = (uint32)Out->Tell();
+		Record.DosTime = ToDosTime(PlatformFile.GetTimeStamp(*DiskPath));
+
+		// Same content as a file already in this archive: write its compressed payload
+		// again under this name rather than recompressing the file
+		if (const int32* Existing = RecordByContent.Find(Hash))
+		{
+			const FPakRecord& Source = Records[*Existing];
+			Record.Method = Source.Method;
+			Record.CompressedSize = Source.CompressedSize;
+			bWriteFailed |= !WriteLocalHeader(*Out, Record);
+
+			int64 Target = Out->Tell();
+			int64 Copied = 0;
+			Buffer.SetNumUninitialized(COPY_CHUNK_SIZE);
+			while (Copied < Source.CompressedSize && !bWriteFailed)
+			{
+				int64 Chunk = FMath::Min<int64>(Source.CompressedSize - Copied, Buffer.Num());
+				bWriteFailed |= !Out->Seek(Source.DataOffset() + Copied) || !Out->Read(Buffer.GetData(), Chunk)
+					|| !Out->Seek(Target + Copied) || !Out->Write(Buffer.GetData(), Chunk);
+				Copied += Chunk;
+			}
+			Records.Add(MoveTemp(Record));
+			Result.FilesDeduplicated++;
+			continue;
+		}
+
+		if (Options.bCompress && Size >= MIN_COMPRESS_SIZE)
+		{
+			// LZMA needs the whole file; only this one is in memory
+			TArray<uint8> FileBytes;
+			FileBytes.SetNumUninitialized((int32)Size);
+			if (!In->Seek(0) || !In->Read(FileBytes.GetData(), Size))
+			{
+				Result.MissingFiles.Add(DiskPath);
+				continue;
+			}
+
+			FLZMAEncoder::CompressZipEntry(FileBytes.GetData(), Size, Payload);
+			bool bSmaller = Payload.Num() < Size;
+			Record.Method = bSmaller ? ZIP_METHOD_LZMA : ZIP_METHOD_STORED;
+			Record.CompressedSize = bSmaller ? (uint32)Payload.Num() : (uint32)Size;
+			bWriteFailed |= !WriteLocalHeader(*Out, Record)
+				|| !WriteBytes(*Out, bSmaller ? Payload.GetData() : FileBytes.GetData(), Record.CompressedSize);
+		}
+		else
+		{
+			Record.Method = ZIP_METHOD_STORED;
+			Record.CompressedSize = (uint32)Size;
+			bWriteFailed |= !WriteLocalHeader(*Out, Record) || !In->Seek(0) || !CopyChunks(*In, *Out, Size, Buffer);
+		}
+
+		RecordByContent.Add(Hash, Records.Num());
+		Records.Add(MoveTemp(Record));
+		Result.FilesWritten++;
+
+		if (bWriteFailed)
+		{
+			break;
+		}
+	}
+
+	if (Records.Num() > ZIP_MAX_ENTRIES)
+	{
+		return Fail(FString::Printf(TEXT("The pakfile would hold %d files; a ZIP without ZIP64 allows %d"),
+			Records.Num(), ZIP_MAX_ENTRIES));
+	}
+
+	bWriteFailed |= !WriteDirectory(*Out, Records);
+	Result.PakBytes = Out->Tell();
+	if (bWriteFailed || !Out->Flush())
+	{
+		return Fail(FString::Printf(TEXT("Failed writing the pakfile to %s"), *TempPath));
+	}
+
+	// ---- Put the archive into the BSP ----
+	const int64 FileSize = Reader.GetFileSize();
+	const bool bVersionFirst = Reader.HasVersionFirstLumps();
+
+	// In place when nothing but alignment padding follows the old pakfile
+	bool bPakIsLast = OldPak.Length > 0 && FileSize - ((int64)OldPak.Offset + OldPak.Length) < 4;
+	for (int32 i = 0; i < (int32)EBSPLump::Count && bPakIsLast; ++i)
+	{
+		const FBSPLumpInfo& Lump = Reader.GetLumpInfo((EBSPLump)i);
+		if (i != (int32)EBSPLump::PakFile && Lump.Length > 0 && (int64)Lump.Offset + Lump.Length > OldPak.Offset)
+		{
+			bPakIsLast = false;
+		}
+	}
+	const int64 PakOffset = bPakIsLast ? OldPak.Offset : Align(FileSize, 4);
+	if (PakOffset + Result.PakBytes > MAX_int32)
+	{
+		return Fail(TEXT("The packed BSP would exceed 2 GB"));
+	}
+
+	// The mapping must go before the file is rewritten
+	Reader.Close();
+
+	TUniquePtr<IFileHandle> BSP(PlatformFile.OpenWrite(*BSPPath, true, true));
+	if (!BSP)
+	{
+		return Fail(FString::Printf(TEXT("Cannot open %s for writing"), *BSPPath));
+	}
+
+	bool bOk = true;
+	if (bPakIsLast)
+	{
+		bOk = BSP->Truncate(PakOffset);
+	}
+	else
+	{
+		static const uint8 Padding[4] = { 0, 0, 0, 0 };
+		bOk = BSP->Seek(FileSize) && WriteBytes(*BSP, Padding, PakOffset - FileSize);
+	}
+
+	bOk = bOk && BSP->Seek(PakOffset) && Out->Seek(0) && CopyChunks(*Out, *BSP, Result.PakBytes, Buffer);
+
+	// Lump entry: offset, length, version, fourCC (version first in L4D2's v21)
+	TArray<uint8> LumpEntry;
+	if (bVersionFirst)
+	{
+		AppendLE32(LumpEntry, 0);
+	}
+	AppendLE32(LumpEntry, (uint32)PakOffset);
+	AppendLE32(LumpEntry, (uint32)Result.PakBytes);
+	if (!bVersionFirst)
+	{
+		AppendLE32(LumpEntry, 0);
+	}
+	AppendLE32(LumpEntry, 0);
+
+	bOk = bOk && BSP->Seek(BSP_LUMP_DIRECTORY_OFFSET + (int64)EBSPLump::PakFile * 16)
+		&& BSP->Write(LumpEntry.GetData(), LumpEntry.Num()) && BSP->Flush();
+	BSP.Reset();
+
+	if (!bOk)
+	{
+		return Fail(FString::Printf(TEXT("Failed writing the pakfile into %s; recompile the map"), *BSPPath));
+	}
+
+	Out.Reset();
+	PlatformFile.DeleteFile(*TempPath);
+
+	if (Reader.Open(BSPPath))
+	{
+		Result.MapChecksum = Reader.ComputeMapChecksum();
+	}
+
+	Result.bInPlace = bPakIsLast;
+	Result.bSuccess = true;
+
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Packed %s: %d written, %d unchanged, %d reused, %d kept, %lld bytes%s, map CRC %08x"),
+		*FPaths::GetCleanFilename(BSPPath), Result.FilesWritten, Result.FilesUnchanged, Result.FilesDeduplicated,
+		Result.FilesKept, Result.PakBytes, Result.bInPlace ? TEXT(" (in place)") : TEXT(" (appended)"), Result.MapChecksum);
+	for (const FString& Missing : Result.MissingFiles)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SourceBridge: Could not read %s for packing"), *Missing);
+	}
+
+	return Result;
+}
@@ -0,0 +1,417 @@
+#include "Compile/CompileArtifactCache.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Hash/CityHash.h"
+
+// BSP header: ident, version, 64 lumps of 16 bytes, map revision
+static const uint32 BSP_IDENT = 0x50534256; // "VBSP"
+static const int32 BSP_LUMP_COUNT = 64;
+static const int32 BSP_HEADER_SIZE = 8 + BSP_LUMP_COUNT * 16 + 4;
+static const int32 BSP_LUMP_ENTITIES = 0;
+
+// Newest artifacts kept per stage per map (each can be tens of MB)
+static const int32 MAX_ARTIFACTS_PER_STAGE = 2;
+
+namespace
+{
+	/** Incremental CityHash64 over a stage's inputs. */
+	struct FStageKeyBuilder
+	{
+		uint64 Hash;
+
+		explicit FStageKeyBuilder(ECompileStage Stage)
+			: Hash(0x5342434F4D50494Cull ^ (uint64)Stage)
+		{
+		}
+
+		void AddBytes(const uint8* Data, int64 Size)
+		{
+			Add(Size);
+			while (Size > 0)
+			{
+				uint32 Chunk = (uint32)FMath::Min<int64>(Size, MAX_int32);
+				Hash = CityHash64WithSeed(reinterpret_cast<const char*>(Data), Chunk, Hash);
+				Data += Chunk;
+				Size -= Chunk;
+			}
+		}
+
+		void Add(int64 Value)
+		{
+			Hash = CityHash64WithSeed(reinterpret_cast<const char*>(&Value), sizeof(Value), Hash);
+		}
+
+		void Add(const FString& Value)
+		{
+			FTCHARToUTF8 Utf8(*Value);
+			AddBytes(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+		}
+
+		/** Hash a file's contents (a missing file hashes differently from an empty one). */
+		void AddFile(const FString& Path)
+		{
+			TArray<uint8> Bytes;
+			if (FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent))
+			{
+				AddBytes(Bytes.GetData(), Bytes.Num());
+			}
+			else
+			{
+				Add((int64)-1);
+			}
+		}
+
+		/** Tools are identified by path, size and timestamp rather than hashing the executable. */
+		void AddToolVersion(const FString& ToolPath)
+		{
+			Add(ToolPath.ToLower());
+			Add(IFileManager::Get().FileSize(*ToolPath));
+			Add(IFileManager::Get().GetTimeStamp(*ToolPath).GetTicks());
+		}
+
+		/**
+		 * Path and contents of every file under Dir with one of the extensions. Exports
+		 * rewrite these files every run, so timestamps would change the key each time.
+		 */
+		void AddDirectoryFiles(const FString& Dir, const TArray<FString>& Extensions)
+		{
+			TArray<FString> Files;
+			for (const FString& Ext : Extensions)
+			{
+				IFileManager::Get().FindFilesRecursive(Files, *Dir, *(TEXT("*.") + Ext), true, false, false);
+			}
+			Files.Sort();
+
+			Add((int64)Files.Num());
+			for (const FString& File : Files)
+			{
+				Add(File.ToLower());
+				AddFile(File);
+			}
+		}
+	};
+
+	struct FBSPLumpView
+	{
+		int32 Offset = 0;
+		int32 Length = 0;
+		int32 Version = 0;
+		int32 FourCC = 0;
+	};
+
+	bool ParseBSPLumps(const TArray<uint8>& Data, TArray<FBSPLumpView>& OutLumps)
+	{
+		if (Data.Num() < BSP_HEADER_SIZE)
+		{
+			return false;
+		}
+
+		const int32* Header = reinterpret_cast<const int32*>(Data.GetData());
+		if ((uint32)Header[0] != BSP_IDENT || Header[1] < 19 || Header[1] > 21)
+		{
+			return false;
+		}
+
+		// L4D2's v21 stores lumps as (version, offset, length, fourCC)
+		const int32* First = Header + 2;
+		bool bVersionFirst = Header[1] == 21 && First[0] < BSP_HEADER_SIZE && First[1] >= BSP_HEADER_SIZE;
+
+		OutLumps.SetNum(BSP_LUMP_COUNT);
+		for (int32 i = 0; i < BSP_LUMP_COUNT; ++i)
+		{
+			const int32* Entry = Header + 2 + i * 4;
+			FBSPLumpView& Lump = OutLumps[i];
+			Lump.Offset = bVersionFirst ? Entry[1] : Entry[0];
+			Lump.Length = bVersionFirst ? Entry[2] : Entry[1];
+			Lump.Version = bVersionFirst ? Entry[0] : Entry[2];
+			Lump.FourCC = Entry[3];
+
+			if (Lump.Offset < 0 || Lump.Length < 0 || (int64)Lump.Offset + Lump.Length > Data.Num())
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/** Hash every lump except entities (unparseable files are hashed whole). */
+	void AddBSPWithoutEntities(FStageKeyBuilder& Key, const FString& BSPPath)
+	{
+		TArray<uint8> Data;
+		if (!FFileHelper::LoadFileToArray(Data, *BSPPath, FILEREAD_Silent))
+		{
+			Key.Add((int64)-1);
+			return;
+		}
+
+		TArray<FBSPLumpView> Lumps;
+		if (!ParseBSPLumps(Data, Lumps))
+		{
+			Key.AddBytes(Data.GetData(), Data.Num());
+			return;
+		}
+
+		for (int32 i = 0; i < Lumps.Num(); ++i)
+		{
+			if (i == BSP_LUMP_ENTITIES)
+			{
+				continue;
+			}
+			Key.Add((int64)i);
+			Key.Add((int64)Lumps[i].Version);
+			Key.Add((int64)Lumps[i].FourCC);
+			Key.AddBytes(Data.GetData() + Lumps[i].Offset, Lumps[i].Length);
+		}
+	}
+
+	/**
+	 * Hash the entities vrad reads: worldspawn, light* classes, and anything with
+	 * vrad-only keys ("_light", "_minlight", "vrad_brush_cast_shadows", ...).
+	 */
+	void AddLightingEntities(FStageKeyBuilder& Key, const TArray<uint8>& EntityLump)
+	{
+		FString Text(EntityLump.Num(), reinterpret_cast<const ANSICHAR*>(EntityLump.GetData()));
+
+		TArray<TPair<FString, FString>> Pairs;
+		FString PendingKey;
+		bool bHaveKey = false;
+		int32 EntityIndex = 0;
+
+		for (int32 Pos = 0; Pos < Text.Len(); ++Pos)
+		{
+			TCHAR Ch = Text[Pos];
+			if (Ch == TEXT('{'))
+			{
+				Pairs.Reset();
+				bHaveKey = false;
+			}
+			else if (Ch == TEXT('}'))
+			{
+				bool bAffectsLighting = EntityIndex == 0;
+				for (const TPair<FString, FString>& Pair : Pairs)
+				{
+					if ((Pair.Key.Equals(TEXT("classname"), ESearchCase::IgnoreCase) && Pair.Value.StartsWith(TEXT("light")))
+						|| Pair.Key.StartsWith(TEXT("_"))
+						|| Pair.Key.StartsWith(TEXT("vrad_")))
+					{
+						bAffectsLighting = true;
+						break;
+					}
+				}
+
+				if (bAffectsLighting)
+				{
+					Key.Add((int64)EntityIndex);
+					for (const TPair<FString, FString>& Pair : Pairs)
+					{
+						Key.Add(Pair.Key);
+						Key.Add(Pair.Value);
+					}
+				}
+				EntityIndex++;
+			}
+			else if (Ch == TEXT('"'))
+			{
+				int32 End = Pos + 1;
+				while (End < Text.Len() && Text[End] != TEXT('"'))
+				{
+					End++;
+				}
+				FString Token = Text.Mid(Pos + 1, End - Pos - 1);
+				Pos = End;
+
+				if (!bHaveKey)
+				{
+					PendingKey = MoveTemp(Token);
+					bHaveKey = true;
+				}
+				else
+				{
+					Pairs.Emplace(MoveTemp(PendingKey), MoveTemp(Token));
+					bHaveKey = false;
+				}
+			}
+		}
+	}
+
+	const TCHAR* GetStageName(ECompileStage Stage)
+	{
+		switch (Stage)
+		{
+		case ECompileStage::VBSP: return TEXT("vbsp");
+		case ECompileStage::VVIS: return TEXT("vvis");
+		case ECompileStage::VRAD: return TEXT("vrad");
+		}
+		return TEXT("unknown");
+	}
+}
+
+uint64 FCompileArtifactCache::KeyForVBSP(const FString& VMFPath, const FString& ToolPath, const FString& GameDir, const FString& Arguments)
+{
+	FStageKeyBuilder Key(ECompileStage::VBSP);
+	Key.AddFile(VMFPath);
+	Key.AddToolVersion(ToolPath);
+	Key.Add(GameDir.ToLower());
+	Key.Add(Arguments);
+
+	// Exported materials carry compile flags (%compilenodraw, translucency, water) vbsp reads
+	Key.AddDirectoryFiles(FPaths::GetPath(VMFPath) / TEXT("materials"), { TEXT("vmt") });
+	return Key.Hash;
+}
+
+uint64 FCompileArtifactCache::KeyForVVIS(const FString& BSPPath, const FString& ToolPath, const FString& Arguments)
+{
+	FStageKeyBuilder Key(ECompileStage::VVIS);
+	AddBSPWithoutEntities(Key, BSPPath);
+	Key.AddFile(FPaths::ChangeExtension(BSPPath, TEXT("prt")));
+	Key.AddToolVersion(ToolPath);
+	Key.Add(Arguments);
+	return Key.Hash;
+}
+
+uint64 FCompileArtifactCache::KeyForVRAD(const FString& BSPPath, const FString& ToolPath, const FString& GameDir, const FString& Arguments)
+{
+	FStageKeyBuilder Key(ECompileStage::VRAD);
+	AddBSPWithoutEntities(Key, BSPPath);
+
+	TArray<uint8> EntityLump;
+	if (ReadEntityLump(BSPPath, EntityLump))
+	{
+		AddLightingEntities(Key, EntityLump);
+	}
+
+	Key.AddFile(GameDir / TEXT("lights.rad"));
+	Key.AddFile(FPaths::ChangeExtension(BSPPath, TEXT("rad")));
+
+	// Texture reflectivity and material light emission feed bounce lighting
+	Key.AddDirectoryFiles(FPaths::GetPath(BSPPath) / TEXT("materials"), { TEXT("vmt"), TEXT("vtf") });
+
+	Key.AddToolVersion(ToolPath);
+	Key.Add(Arguments);
+	return Key.Hash;
+}
+
+FString FCompileArtifactCache::GetCacheDir(const FString& BSPPath)
+{
+	FString DirName = FString::Printf(TEXT("%s_%08x"),
+		*FPaths::GetBaseFilename(BSPPath), FCrc::StrCrc32(*FPaths::ConvertRelativePathToFull(BSPPath).ToLower()));
+	return FPaths::ProjectSavedDir() / TEXT("SourceBridge") / TEXT("CompileCache") / DirName;
+}
+
+FString FCompileArtifactCache::GetArtifactPath(ECompileStage Stage, uint64 Key, const FString& BSPPath, const TCHAR* Extension)
+{
+	return GetCacheDir(BSPPath) / FString::Printf(TEXT("%s_%016llx.%s"), GetStageName(Stage), Key, Extension);
+}
+
+bool FCompileArtifactCache::Restore(ECompileStage Stage, uint64 Key, const FString& BSPPath)
+{
+	if (Key == 0)
+	{
+		return false;
+	}
+
+	FString CachedBSP = GetArtifactPath(Stage, Key, BSPPath, TEXT("bsp"));
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*CachedBSP) || !PlatformFile.CopyFile(*BSPPath, *CachedBSP))
+	{
+		return false;
+	}
+
+	if (Stage == ECompileStage::VBSP)
+	{
+		FString CachedPRT = GetArtifactPath(Stage, Key, BSPPath, TEXT("prt"));
+		FString PRTPath = FPaths::ChangeExtension(BSPPath, TEXT("prt"));
+		if (PlatformFile.FileExists(*CachedPRT))
+		{
+			PlatformFile.CopyFile(*PRTPath, *CachedPRT);
+		}
+		else
+		{
+			PlatformFile.DeleteFile(*PRTPath);
+		}
+	}
+
+	// Timestamps order the artifacts for trimming
+	PlatformFile.SetTimeStamp(*CachedBSP, FDateTime::UtcNow());
+
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Restored cached %s output %016llx"), GetStageName(Stage), Key);
+	return true;
+}
+
+void FCompileArtifactCache::Store(ECompileStage Stage, uint64 Key, const FString& BSPPath)
+{
+	if (Key == 0)
+	{
+		return;
+	}
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	FString CacheDir = GetCacheDir(BSPPath);
+	PlatformFile.CreateDirectoryTree(*CacheDir);
+
+	FString CachedBSP = GetArtifactPath(Stage, Key, BSPPath, TEXT("bsp"));
+	if (!PlatformFile.CopyFile(*CachedBSP, *BSPPath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SourceBridge: Failed to cache %s output at '%s'"),
+			GetStageName(Stage), *CachedBSP);
+		return;
+	}
+
+	if (Stage == ECompileStage::VBSP)
+	{
+		FString PRTPath = FPaths::ChangeExtension(BSPPath, TEXT("prt"));
+		if (PlatformFile.FileExists(*PRTPath))
+		{
+			PlatformFile.CopyFile(*GetArtifactPath(Stage, Key, BSPPath, TEXT("prt")), *PRTPath);
+		}
+	}
+
+	// Trim to the newest few artifacts for this stage
+	TArray<FString> Existing;
+	IFileManager::Get().FindFiles(Existing, *(CacheDir / FString::Printf(TEXT("%s_*.bsp"), GetStageName(Stage))), true, false);
+	if (Existing.Num() > MAX_ARTIFACTS_PER_STAGE)
+	{
+		Existing.Sort([&CacheDir](const FString& A, const FString& B)
+		{
+			return IFileManager::Get().GetTimeStamp(*(CacheDir / A)) > IFileManager::Get().GetTimeStamp(*(CacheDir / B));
+		});
+
+		for (int32 i = MAX_ARTIFACTS_PER_STAGE; i < Existing.Num(); ++i)
+		{
+			FString Stale = CacheDir / Existing[i];
+			PlatformFile.DeleteFile(*Stale);
+			PlatformFile.DeleteFile(*FPaths::ChangeExtension(Stale, TEXT("prt")));
+		}
+	}
+}
+
+bool FCompileArtifactCache::ReadEntityLump(const FString& BSPPath, TArray<uint8>& OutLump)
+{
+	OutLump.Reset();
+
+	TArray<uint8> Data;
+	TArray<FBSPLumpView> Lumps;
+	if (!FFileHelper::LoadFileToArray(Data, *BSPPath, FILEREAD_Silent) || !ParseBSPLumps(Data, Lumps))
+	{
+		return false;
+	}
+
+	const FBSPLumpView& Entities = Lumps[BSP_LUMP_ENTITIES];
+	OutLump.Append(Data.GetData() + Entities.Offset, Entities.Length);
+	return true;
+}
+
+bool FCompileArtifactCache::EntityLumpMatches(const FString& BSPPath, const TArray<uint8>& EntityLump)
+{
+	TArray<uint8> Current;
+	return ReadEntityLump(BSPPath, Current) && Current == EntityLump;
+}
+
+void FCompileArtifactCache::Clear()
+{
+	FString Root = FPaths::ProjectSavedDir() / TEXT("SourceBridge") / TEXT("CompileCache");
+	IFileManager::Get().DeleteDirectory(*Root, false, true);
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Compile artifact cache cleared."));
+}
@@ -9,6 +9,21 @@
 #include "LandscapeProxy.h"
 #include "GameFramework/Volume.h"
 #include "EngineUtils.h"
+#include "Compile/CompilePipeline.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+// Oldest samples are dropped beyond this
+static const int32 MAX_HISTORY_SAMPLES = 200;
+
+// Samples per stage and mode before the fitted slope is trusted over the heuristic's
+static const int32 MIN_REGRESSION_SAMPLES = 3;
+static const int32 HIGH_CONFIDENCE_SAMPLES = 8;
 
 FString FCompileTimeEstimate::GetSummary() const
 {
@@ -32,19 +47,30 @@ FString FCompileTimeEstimate::GetSummary() const
 		}
 	};
 
+	FString Calibration = CalibrationSamples > 0
+		? FString::Printf(TEXT(", fitted to %d compiles on this machine"), CalibrationSamples)
+		: FString(TEXT(", uncalibrated"));
+
 	FString Result = FString::Printf(
-		TEXT("Estimated compile time: %s (%s confidence)\n")
+		TEXT("Estimated compile time: %s (90%%: %s - %s, %s confidence%s)\n")
 		TEXT("  VBSP: %s  |  VVIS: %s  |  VRAD: %s\n")
 		TEXT("  Scene: %d brushes, %d faces, %d entities, %d lights%s"),
 		*FormatTime(TotalSeconds),
+		*FormatTime(LowSeconds),
+		*FormatTime(HighSeconds),
 		*Confidence,
+		*Calibration,
 		*FormatTime(VBSPSeconds),
 		*FormatTime(VVISSeconds),
 		*FormatTime(VRADSeconds),
 		BrushCount, BrushSideCount, EntityCount, LightCount,
 		bHasDisplacements ? TEXT(", has displacements") : TEXT(""));
 
-	if (bFastCompile)
+	if (bFinalCompile)
+	{
+		Result += TEXT("\n  Mode: Final (-final)");
+	}
+	else if (bFastCompile)
 	{
 		Result += TEXT("\n  Mode: Fast (-fast)");
 	}
@@ -63,6 +89,7 @@ FCompileTimeEstimate FCompileEstimator::EstimateCompileTime(
 {
 	FCompileTimeEstimate Est;
 	Est.bFastCompile = bFastCompile;
+	Est.bFinalCompile = bFinalCompile;
 
 	if (!World) return Est;
 
@@ -106,8 +133,17 @@ FCompileTimeEstimate FCompileEstimator::EstimateCompileTime(
 	}
 
 	// Count static meshes (exported as props, affect compile)
-	int32 PropCount = 0;
-	for (TActorIterator<AStaticMeshActor> It(World); It; ++It) PropCount++;
+	for (TActorIterator<AStaticMeshActor> It(World); It; ++It) Est.PropCount++;
+
+	ApplyHeuristics(Est);
+	ApplyCalibration(Est);
+	return Est;
+}
+
+void FCompileEstimator::ApplyHeuristics(FCompileTimeEstimate& Est)
+{
+	const bool bFastCompile = Est.bFastCompile;
+	const bool bFinalCompile = Est.bFinalCompile;
 
 	// --- Estimation heuristics ---
 	// Based on typical Source engine compile behavior on modern hardware
@@ -159,7 +195,7 @@ FCompileTimeEstimate FCompileEstimator::EstimateCompileTime(
 	}
 
 	if (Est.bHasDisplacements) Est.VRADSeconds *= 2.0f;
-	if (PropCount > 10) Est.VRADSeconds *= 1.0f + (PropCount * 0.01f);
+	if (Est.PropCount > 10) Est.VRADSeconds *= 1.0f + (Est.PropCount * 0.01f);
 
 	Est.TotalSeconds = Est.VBSPSeconds + Est.VVISSeconds + Est.VRADSeconds;
 
@@ -177,5 +213,310 @@ FCompileTimeEstimate FCompileEstimator::EstimateCompileTime(
 		Est.Confidence = TEXT("low"); // Complex maps have unpredictable vvis
 	}
 
-	return Est;
+	// Uncalibrated interval: wide, and wider the less predictable the scene
+	float Spread = Est.Confidence == TEXT("high") ? 1.5f : (Est.Confidence == TEXT("medium") ? 2.5f : 4.0f);
+	Est.LowSeconds = Est.TotalSeconds / Spread;
+	Est.HighSeconds = Est.TotalSeconds * Spread;
+}
+
+// ---- Calibration from compile history ----
+
+namespace
+{
+	struct FHistorySample
+	{
+		FCompileTimeEstimate Metrics;
+		int32 ThreadCount = 0;
+
+		/** Measured seconds per stage (negative = stage didn't run, e.g. restored from cache). */
+		double StageSeconds[3] = { -1.0, -1.0, -1.0 };
+	};
+
+	const TCHAR* StageNames[3] = { TEXT("VBSP"), TEXT("VVIS"), TEXT("VRAD") };
+
+	float GetHeuristicSeconds(const FCompileTimeEstimate& Est, int32 Stage)
+	{
+		return Stage == 0 ? Est.VBSPSeconds : (Stage == 1 ? Est.VVISSeconds : Est.VRADSeconds);
+	}
+
+	/** Two-sided 90% Student t critical value. */
+	double TCritical90(int32 DegreesOfFreedom)
+	{
+		static const double Table[] = { 6.314, 2.920, 2.353, 2.132, 2.015, 1.943, 1.895, 1.860, 1.833, 1.812 };
+		if (DegreesOfFreedom <= 0)
+		{
+			return Table[0];
+		}
+		if (DegreesOfFreedom <= (int32)UE_ARRAY_COUNT(Table))
+		{
+			return Table[DegreesOfFreedom - 1];
+		}
+		return DegreesOfFreedom <= 30 ? 1.75 : 1.645;
+	}
+
+	struct FStageFit
+	{
+		int32 SampleCount = 0;
+		double Predicted = 0.0;
+		double Low = 0.0;
+		double High = 0.0;
+	};
+
+	/**
+	 * Fit log(actual) = B0 + B1 * log(heuristic) and predict at X = log(heuristic).
+	 * With too few samples (or no spread in X) the slope is fixed at 1, which only
+	 * calibrates the machine's speed.
+	 */
+	FStageFit FitStage(const TArray<TPair<double, double>>& Points, double X)
+	{
+		FStageFit Fit;
+		Fit.SampleCount = Points.Num();
+		int32 N = Points.Num();
+		if (N == 0)
+		{
+			return Fit;
+		}
+
+		double MeanX = 0.0, MeanY = 0.0;
+		for (const TPair<double, double>& Point : Points)
+		{
+			MeanX += Point.Key;
+			MeanY += Point.Value;
+		}
+		MeanX /= N;
+		MeanY /= N;
+
+		double Sxx = 0.0, Sxy = 0.0;
+		for (const TPair<double, double>& Point : Points)
+		{
+			Sxx += FMath::Square(Point.Key - MeanX);
+			Sxy += (Point.Key - MeanX) * (Point.Value - MeanY);
+		}
+
+		bool bRegression = N >= MIN_REGRESSION_SAMPLES && Sxx > 0.01;
+		double B1 = bRegression ? FMath::Clamp(Sxy / Sxx, 0.25, 3.0) : 1.0;
+		double B0 = MeanY - B1 * MeanX;
+
+		double RSS = 0.0;
+		for (const TPair<double, double>& Point : Points)
+		{
+			RSS += FMath::Square(Point.Value - (B0 + B1 * Point.Key));
+		}
+
+		int32 Params = bRegression ? 2 : 1;
+		int32 DegreesOfFreedom = N - Params;
+
+		// Below two residual degrees of freedom the spread is unknown; assume a factor of 2
+		double Sigma = DegreesOfFreedom >= 1 ? FMath::Sqrt(RSS / DegreesOfFreedom) : FMath::Loge(2.0);
+		Sigma = FMath::Max(Sigma, 0.05);
+
+		double Leverage = 1.0 / N + (bRegression ? FMath::Square(X - MeanX) / Sxx : 0.0);
+		double Margin = TCritical90(DegreesOfFreedom) * Sigma * FMath::Sqrt(1.0 + Leverage);
+
+		double Y = B0 + B1 * X;
+		Fit.Predicted = FMath::Exp(Y);
+		Fit.Low = FMath::Exp(Y - Margin);
+		Fit.High = FMath::Exp(Y + Margin);
+		return Fit;
+	}
+
+	bool LoadHistory(const FString& Path, TArray<FHistorySample>& OutSamples)
+	{
+		FString Json;
+		if (!FFileHelper::LoadFileToString(Json, *Path))
+		{
+			return false;
+		}
+
+		TSharedPtr<FJsonObject> Root;
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
+		if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid())
+		{
+			return false;
+		}
+
+		// Samples from different hardware (e.g. after an upgrade) don't describe this machine
+		int32 Cores = FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+
+		const TArray<TSharedPtr<FJsonValue>>* Samples = nullptr;
+		if (!Root->TryGetArrayField(TEXT("samples"), Samples))
+		{
+			return false;
+		}
+
+		for (const TSharedPtr<FJsonValue>& Value : *Samples)
+		{
+			const TSharedPtr<FJsonObject>* Object = nullptr;
+			if (!Value->TryGetObject(Object) || (*Object)->GetIntegerField(TEXT("cores")) != Cores)
+			{
+				continue;
+			}
+
+			FHistorySample& Sample = OutSamples.AddDefaulted_GetRef();
+			const FJsonObject& Fields = **Object;
+			Sample.Metrics.bFastCompile = Fields.GetBoolField(TEXT("fast"));
+			Sample.Metrics.bFinalCompile = Fields.GetBoolField(TEXT("final"));
+			Sample.Metrics.BrushCount = Fields.GetIntegerField(TEXT("brushes"));
+			Sample.Metrics.BrushSideCount = Fields.GetIntegerField(TEXT("sides"));
+			Sample.Metrics.EntityCount = Fields.GetIntegerField(TEXT("entities"));
+			Sample.Metrics.LightCount = Fields.GetIntegerField(TEXT("lights"));
+			Sample.Metrics.PropCount = Fields.GetIntegerField(TEXT("props"));
+			Sample.Metrics.bHasDisplacements = Fields.GetBoolField(TEXT("displacements"));
+			Sample.ThreadCount = Fields.GetIntegerField(TEXT("threads"));
+			for (int32 Stage = 0; Stage < 3; ++Stage)
+			{
+				double Seconds = -1.0;
+				Fields.TryGetNumberField(FString(StageNames[Stage]).ToLower(), Seconds);
+				Sample.StageSeconds[Stage] = Seconds;
+			}
+		}
+		return true;
+	}
+}
+
+FString FCompileEstimator::GetHistoryPath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("SourceBridge") / TEXT("CompileHistory")
+		/ FString(FPlatformProcess::ComputerName()) + TEXT(".json");
+}
+
+void FCompileEstimator::ApplyCalibration(FCompileTimeEstimate& Est)
+{
+	TArray<FHistorySample> History;
+	if (!LoadHistory(GetHistoryPath(), History) || History.Num() == 0)
+	{
+		return;
+	}
+
+	float* StageSeconds[3] = { &Est.VBSPSeconds, &Est.VVISSeconds, &Est.VRADSeconds };
+	double TotalLow = 0.0, TotalHigh = 0.0;
+	int32 MinSamples = MAX_int32;
+	bool bAllTight = true;
+
+	for (int32 Stage = 0; Stage < 3; ++Stage)
+	{
+		TArray<TPair<double, double>> Points;
+		for (FHistorySample& Sample : History)
+		{
+			// vbsp has no quality flags; vvis/vrad are only comparable within a mode
+			bool bSameMode = Stage == 0
+				|| (Sample.Metrics.bFastCompile == Est.bFastCompile && Sample.Metrics.bFinalCompile == Est.bFinalCompile);
+			if (!bSameMode || Sample.StageSeconds[Stage] < 0.0)
+			{
+				continue;
+			}
+
+			ApplyHeuristics(Sample.Metrics);
+			Points.Emplace(
+				FMath::Loge(FMath::Max(GetHeuristicSeconds(Sample.Metrics, Stage), 0.01f)),
+				FMath::Loge(FMath::Max(Sample.StageSeconds[Stage], 0.01)));
+		}
+
+		float Heuristic = *StageSeconds[Stage];
+		FStageFit Fit = FitStage(Points, FMath::Loge(FMath::Max(Heuristic, 0.01f)));
+		MinSamples = FMath::Min(MinSamples, Fit.SampleCount);
+
+		if (Fit.SampleCount == 0)
+		{
+			// Keep the heuristic with its uncalibrated spread
+			float Spread = Est.HighSeconds / FMath::Max(Est.TotalSeconds, 0.01f);
+			TotalLow += Heuristic / Spread;
+			TotalHigh += Heuristic * Spread;
+			bAllTight = false;
+			continue;
+		}
+
+		*StageSeconds[Stage] = (float)Fit.Predicted;
+		TotalLow += Fit.Low;
+		TotalHigh += Fit.High;
+		bAllTight &= Fit.SampleCount >= HIGH_CONFIDENCE_SAMPLES && Fit.High < Fit.Low * 2.0;
+	}
+
+	Est.TotalSeconds = Est.VBSPSeconds + Est.VVISSeconds + Est.VRADSeconds;
+	Est.LowSeconds = (float)TotalLow;
+	Est.HighSeconds = (float)TotalHigh;
+	Est.CalibrationSamples = MinSamples;
+
+	if (MinSamples > 0)
+	{
+		Est.Confidence = bAllTight ? TEXT("high") : TEXT("medium");
+	}
+}
+
+void FCompileEstimator::RecordCompile(
+	const FCompileTimeEstimate& Estimate,
+	const TArray<FCompileStageStats>& Stages,
+	int32 ThreadCount)
+{
+	FString Path = GetHistoryPath();
+
+	TSharedPtr<FJsonObject> Root;
+	FString Existing;
+	if (FFileHelper::LoadFileToString(Existing, *Path))
+	{
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Existing);
+		FJsonSerializer::Deserialize(Reader, Root);
+	}
+	if (!Root.IsValid())
+	{
+		Root = MakeShared<FJsonObject>();
+	}
+
+	TArray<TSharedPtr<FJsonValue>> Samples;
+	const TArray<TSharedPtr<FJsonValue>>* ExistingSamples = nullptr;
+	if (Root->TryGetArrayField(TEXT("samples"), ExistingSamples))
+	{
+		Samples = *ExistingSamples;
+	}
+
+	TSharedRef<FJsonObject> Sample = MakeShared<FJsonObject>();
+	Sample->SetStringField(TEXT("date"), FDateTime::UtcNow().ToIso8601());
+	Sample->SetNumberField(TEXT("cores"), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+	Sample->SetNumberField(TEXT("threads"), ThreadCount);
+	Sample->SetBoolField(TEXT("fast"), Estimate.bFastCompile);
+	Sample->SetBoolField(TEXT("final"), Estimate.bFinalCompile);
+	Sample->SetNumberField(TEXT("brushes"), Estimate.BrushCount);
+	Sample->SetNumberField(TEXT("sides"), Estimate.BrushSideCount);
+	Sample->SetNumberField(TEXT("entities"), Estimate.EntityCount);
+	Sample->SetNumberField(TEXT("lights"), Estimate.LightCount);
+	Sample->SetNumberField(TEXT("props"), Estimate.PropCount);
+	Sample->SetBoolField(TEXT("displacements"), Estimate.bHasDisplacements);
+
+	// -onlyents patches (also run after restoring a cached BSP) say nothing about full stage times
+	int32 Recorded = 0;
+	for (int32 Stage = 0; Stage < 3; ++Stage)
+	{
+		for (const FCompileStageStats& Stats : Stages)
+		{
+			if (Stats.ToolName.Equals(StageNames[Stage], ESearchCase::IgnoreCase) && Stats.ReturnCode == 0
+				&& !Stats.bEntitiesOnly)
+			{
+				Sample->SetNumberField(FString(StageNames[Stage]).ToLower(), Stats.WallSeconds);
+				Recorded++;
+				break;
+			}
+		}
+	}
+
+	if (Recorded == 0)
+	{
+		return;
+	}
+
+	Samples.Add(MakeShared<FJsonValueObject>(Sample));
+	if (Samples.Num() > MAX_HISTORY_SAMPLES)
+	{
+		Samples.RemoveAt(0, Samples.Num() - MAX_HISTORY_SAMPLES);
+	}
+
+	Root->SetStringField(TEXT("machine"), FPlatformProcess::ComputerName());
+	Root->SetArrayField(TEXT("samples"), Samples);
+
+	FString Json;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Root.ToSharedRef(), Writer);
+	if (!FFileHelper::SaveStringToFile(Json, *Path))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SourceBridge: Failed to write compile history %s"), *Path);
+	}
 }
@@ -0,0 +1,161 @@
+#include "Compile/CompileJob.h"
+#include "Async/Async.h"
+#include "Misc/ScopeLock.h"
+
+TSharedPtr<FCompileJob> FCompileJob::LatestJob;
+
+TSharedRef<FCompileJob> FCompileJob::StartMapCompile(const FCompileSettings& InSettings)
+{
+	check(IsInGameThread());
+
+	TSharedRef<FCompileJob> Job = MakeShareable(new FCompileJob());
+	Job->StartTime = FPlatformTime::Seconds();
+	LatestJob = Job;
+
+	// Chain the job's hooks in front of any the caller supplied
+	FCompileSettings Settings = InSettings;
+	FCompileHooks CallerHooks = InSettings.Hooks;
+
+	Settings.Hooks.OnToolStarted = [Job, CallerHooks](const FString& ToolName)
+	{
+		{
+			FScopeLock ScopeLock(&Job->Lock);
+			Job->CurrentTool = ToolName;
+			Job->CurrentPhase.Reset();
+		}
+		Job->AddLine(FString::Printf(TEXT("---- %s ----"), *ToolName));
+
+		if (CallerHooks.OnToolStarted)
+		{
+			CallerHooks.OnToolStarted(ToolName);
+		}
+	};
+
+	Settings.Hooks.OnOutputLine = [Job, CallerHooks](const FString& ToolName, const FString& Line, bool bIsStdErr)
+	{
+		Job->AddLine(Line);
+
+		if (CallerHooks.OnOutputLine)
+		{
+			CallerHooks.OnOutputLine(ToolName, Line, bIsStdErr);
+		}
+	};
+
+	Settings.Hooks.OnEvent = [Job, CallerHooks](const FCompileEvent& Event)
+	{
+		{
+			FScopeLock ScopeLock(&Job->Lock);
+			Job->Progress = Event.OverallProgress;
+			if (Event.Type == ECompileEventType::PhaseProgress)
+			{
+				Job->CurrentPhase = Event.PhaseProgress < 1.0f ? Event.Phase : FString();
+			}
+		}
+
+		if (Event.Type == ECompileEventType::Leak)
+		{
+			Job->AddLine(FString::Printf(TEXT("---- LEAK: %s (pointfile: %s) ----"),
+				Event.Text.IsEmpty() ? TEXT("unknown entity") : *Event.Text,
+				Event.Path.IsEmpty() ? TEXT("none") : *Event.Path));
+		}
+
+		if (CallerHooks.OnEvent)
+		{
+			CallerHooks.OnEvent(Event);
+		}
+	};
+
+	Settings.Hooks.ShouldCancel = [Job, CallerHooks]()
+	{
+		return Job->bCancelRequested || (CallerHooks.ShouldCancel && CallerHooks.ShouldCancel());
+	};
+
+	Async(EAsyncExecution::Thread, [Job, Settings]()
+	{
+		Job->Finish(FCompilePipeline::CompileMap(Settings));
+	});
+
+	return Job;
+}
+
+TSharedPtr<FCompileJob> FCompileJob::GetLatest()
+{
+	return LatestJob;
+}
+
+void FCompileJob::Cancel()
+{
+	if (!bDone && !bCancelRequested)
+	{
+		bCancelRequested = true;
+		AddLine(TEXT("---- Cancel requested ----"));
+	}
+}
+
+FString FCompileJob::GetCurrentTool() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return CurrentTool;
+}
+
+float FCompileJob::GetProgress() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return bDone ? 1.0f : Progress;
+}
+
+FString FCompileJob::GetCurrentPhase() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return CurrentPhase;
+}
+
+double FCompileJob::GetElapsedSeconds() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return (bDone ? EndTime : FPlatformTime::Seconds()) - StartTime;
+}
+
+void FCompileJob::GetOutputSince(int32& InOutNextLine, TArray<FString>& OutLines) const
+{
+	FScopeLock ScopeLock(&Lock);
+	for (int32 i = FMath::Max(InOutNextLine, 0); i < Lines.Num(); ++i)
+	{
+		OutLines.Add(Lines[i]);
+	}
+	InOutNextLine = Lines.Num();
+}
+
+FCompileResult FCompileJob::GetResult() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Result;
+}
+
+void FCompileJob::AddLine(const FString& Line)
+{
+	FScopeLock ScopeLock(&Lock);
+	Lines.Add(Line);
+}
+
+void FCompileJob::Finish(FCompileResult&& InResult)
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+		Result = MoveTemp(InResult);
+		CurrentTool.Reset();
+		CurrentPhase.Reset();
+		EndTime = FPlatformTime::Seconds();
+
+		Lines.Add(Result.bSuccess
+			? FString::Printf(TEXT("---- Compile finished in %.1f seconds ----"), Result.ElapsedSeconds)
+			: FString::Printf(TEXT("---- %s ----"), *Result.ErrorMessage));
+	}
+	bDone = true;
+
+	TSharedRef<FCompileJob> Self = AsShared();
+	AsyncTask(ENamedThreads::GameThread, [Self]()
+	{
+		Self->OnFinished.Broadcast(Self->GetResult());
+	});
+}
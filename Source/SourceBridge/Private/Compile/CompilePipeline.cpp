@@ -1,11 +1,207 @@
 #include "Compile/CompilePipeline.h"
+#include "Compile/BSPPakWriter.h"
+#include "Compile/CompileArtifactCache.h"
+#include "Compile/ModelCompileCache.h"
+#include "Import/VMFReader.h"
+#include "VMF/VMFExportCache.h"
 #include "HAL/PlatformProcess.h"
 #include "HAL/PlatformFilemanager.h"
 #include "HAL/FileManager.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
 
-FCompileResult FCompilePipeline::CompileMap(const FCompileSettings& Settings)
+// ---- FMapCompileState ----
+
+// Point entities that vbsp/vrad bake into BSP lumps rather than the entity lump
+static bool IsBakedPointEntity(const FString& ClassName)
+{
+	static const TSet<FString> BakedClasses = {
+		TEXT("light"), TEXT("light_spot"), TEXT("light_environment"), TEXT("light_directional"),
+		TEXT("prop_static"), TEXT("prop_detail"), TEXT("prop_detail_sprite"),
+		TEXT("info_overlay"), TEXT("info_overlay_transition"), TEXT("env_cubemap"),
+		TEXT("info_lighting"), TEXT("info_no_dynamic_shadow"),
+		TEXT("func_instance"), TEXT("func_instance_parms"), TEXT("func_viscluster")
+	};
+	return BakedClasses.Contains(ClassName);
+}
+
+static FString FindBlockProperty(const FVMFKeyValues& Block, const TCHAR* Key)
+{
+	for (const TPair<FString, FString>& Prop : Block.Properties)
+	{
+		if (Prop.Key.Equals(Key, ESearchCase::IgnoreCase))
+		{
+			return Prop.Value;
+		}
+	}
+	return FString();
+}
+
+// Hash a block as the compile tools see it: IDs are renumbered on every export and
+// "editor" blocks (colors, visgroups) never reach the BSP, so both are skipped.
+static void HashCompiledBlock(FVMFFingerprint& Fp, const FVMFKeyValues& Block)
+{
+	Fp.Add(Block.ClassName);
+	for (const TPair<FString, FString>& Prop : Block.Properties)
+	{
+		if (Prop.Key.Equals(TEXT("id"), ESearchCase::IgnoreCase)
+			|| Prop.Key.Equals(TEXT("mapversion"), ESearchCase::IgnoreCase))
+		{
+			continue;
+		}
+		Fp.Add(Prop.Key);
+		Fp.Add(Prop.Value);
+	}
+
+	for (const FVMFKeyValues& Child : Block.Children)
+	{
+		if (Child.ClassName.Equals(TEXT("editor"), ESearchCase::IgnoreCase))
+		{
+			continue;
+		}
+		HashCompiledBlock(Fp, Child);
+		Fp.Add(FString(TEXT("}")));
+	}
+}
+
+bool FMapCompileState::Compute(const FString& VMFPath, const FCompileSettings& Settings, FMapCompileState& OutState)
+{
+	TArray<FVMFKeyValues> Blocks = FVMFReader::ParseFile(VMFPath);
+	if (Blocks.Num() == 0)
+	{
+		return false;
+	}
+
+	FVMFFingerprint Geometry(TEXT("geometry"));
+	FVMFFingerprint Entities(TEXT("entities"));
+
+	for (const FVMFKeyValues& Block : Blocks)
+	{
+		const FString& Name = Block.ClassName;
+		if (Name.Equals(TEXT("versioninfo"), ESearchCase::IgnoreCase)
+			|| Name.Equals(TEXT("visgroups"), ESearchCase::IgnoreCase)
+			|| Name.Equals(TEXT("viewsettings"), ESearchCase::IgnoreCase)
+			|| Name.Equals(TEXT("cameras"), ESearchCase::IgnoreCase))
+		{
+			continue;
+		}
+
+		bool bBaked = true;
+		if (Name.Equals(TEXT("entity"), ESearchCase::IgnoreCase))
+		{
+			bool bHasSolids = Block.Children.ContainsByPredicate([](const FVMFKeyValues& Child)
+			{
+				return Child.ClassName.Equals(TEXT("solid"), ESearchCase::IgnoreCase);
+			});
+			bBaked = bHasSolids || IsBakedPointEntity(FindBlockProperty(Block, TEXT("classname")).ToLower());
+		}
+
+		// Order matters for both: brush entity models are numbered in file order
+		HashCompiledBlock(bBaked ? Geometry : Entities, Block);
+	}
+
+	OutState.GeometryHash = Geometry.Get();
+	OutState.EntityHash = Entities.Get();
+	OutState.bFastCompile = Settings.bFastCompile;
+	OutState.bFinalCompile = Settings.bFinalCompile;
+	return true;
+}
+
+bool FMapCompileState::Load(const FString& StatePath, FMapCompileState& OutState)
+{
+	if (!FPaths::FileExists(StatePath))
+	{
+		return false;
+	}
+
+	TArray<FVMFKeyValues> Blocks = FVMFReader::ParseFile(StatePath, false);
+	if (Blocks.Num() != 1 || Blocks[0].ClassName != TEXT("compilestate")
+		|| FindBlockProperty(Blocks[0], TEXT("version")) != TEXT("1"))
+	{
+		return false;
+	}
+
+	const FVMFKeyValues& State = Blocks[0];
+	OutState.GeometryHash = FCString::Strtoui64(*FindBlockProperty(State, TEXT("geometry")), nullptr, 16);
+	OutState.EntityHash = FCString::Strtoui64(*FindBlockProperty(State, TEXT("entities")), nullptr, 16);
+	OutState.bFastCompile = FindBlockProperty(State, TEXT("fast")) == TEXT("1");
+	OutState.bFinalCompile = FindBlockProperty(State, TEXT("final")) == TEXT("1");
+	return true;
+}
+
+bool FMapCompileState::Save(const FString& StatePath) const
+{
+	FVMFKeyValues State(TEXT("compilestate"));
+	State.AddProperty(TEXT("version"), 1);
+	State.AddProperty(TEXT("geometry"), FString::Printf(TEXT("%016llx"), GeometryHash));
+	State.AddProperty(TEXT("entities"), FString::Printf(TEXT("%016llx"), EntityHash));
+	State.AddProperty(TEXT("fast"), bFastCompile ? 1 : 0);
+	State.AddProperty(TEXT("final"), bFinalCompile ? 1 : 0);
+	return FFileHelper::SaveStringToFile(State.Serialize(), *StatePath);
+}
+
+FString FMapCompileState::GetStatePath(const FString& VMFPath)
+{
+	return FPaths::ChangeExtension(VMFPath, TEXT("compilestate"));
+}
+
+// ---- FCompilePipeline ----
+
+FCompileResult FCompilePipeline::CompileMap(const FCompileSettings& InSettings)
+{
+	// Route tool output through the telemetry parser ahead of the caller's hooks
+	FCompileTelemetryParser Parser;
+	Parser.OnEvent = InSettings.Hooks.OnEvent;
+
+	FCompileSettings Settings = InSettings;
+	const FCompileHooks& CallerHooks = InSettings.Hooks;
+
+	Settings.Hooks.OnToolStarted = [&Parser, &CallerHooks](const FString& ToolName)
+	{
+		Parser.BeginTool(ToolName);
+		if (CallerHooks.OnToolStarted)
+		{
+			CallerHooks.OnToolStarted(ToolName);
+		}
+	};
+	Settings.Hooks.OnOutputLine = [&Parser, &CallerHooks](const FString& ToolName, const FString& Line, bool bIsStdErr)
+	{
+		Parser.ParseLine(Line);
+		if (CallerHooks.OnOutputLine)
+		{
+			CallerHooks.OnOutputLine(ToolName, Line, bIsStdErr);
+		}
+	};
+	Settings.Hooks.OnPartialLine = [&Parser, &CallerHooks](const FString& ToolName, const FString& PartialLine)
+	{
+		Parser.ParsePartial(PartialLine);
+		if (CallerHooks.OnPartialLine)
+		{
+			CallerHooks.OnPartialLine(ToolName, PartialLine);
+		}
+	};
+
+	FCompileResult Result = CompileMapStages(Settings);
+	Parser.Finish();
+	Result.Telemetry = Parser.GetTelemetry();
+
+	if (!Result.bCancelled && Result.Stages.Num() > 0 && FCompileReport::Write(Settings.VMFPath, Result))
+	{
+		Result.ReportPath = FCompileReport::GetReportPath(Settings.VMFPath);
+	}
+
+	if (Result.Telemetry.bLeaked)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SourceBridge: Map leaked%s%s. Pointfile: %s"),
+			Result.Telemetry.LeakEntity.IsEmpty() ? TEXT("") : TEXT(" at "),
+			*Result.Telemetry.LeakEntity,
+			Result.Telemetry.PointfilePath.IsEmpty() ? TEXT("(none)") : *Result.Telemetry.PointfilePath);
+	}
+
+	return Result;
+}
+
+FCompileResult FCompilePipeline::CompileMapStages(const FCompileSettings& Settings)
 {
 	FCompileResult FinalResult;
 	double StartTime = FPlatformTime::Seconds();
@@ -32,70 +228,192 @@ FCompileResult FCompilePipeline::CompileMap(const FCompileSettings& Settings)
 	FString MapDir = FPaths::GetPath(Settings.VMFPath);
 	FString BSPPath = MapDir / MapName + TEXT(".bsp");
 
-	// ---- VBSP (geometry) ----
+	// ---- Decide between a full compile and an entity-only patch ----
+	FString StatePath = FMapCompileState::GetStatePath(Settings.VMFPath);
+	FMapCompileState NewState;
+	bool bHasNewState = FMapCompileState::Compute(Settings.VMFPath, Settings, NewState);
+
+	FMapCompileState LastState;
+	FinalResult.bEntitiesOnly = Settings.bAllowEntityOnlyCompile
+		&& bHasNewState
+		&& FPaths::FileExists(BSPPath)
+		&& FMapCompileState::Load(StatePath, LastState)
+		&& LastState.GeometryHash == NewState.GeometryHash
+		&& LastState.bFastCompile == NewState.bFastCompile
+		&& LastState.bFinalCompile == NewState.bFinalCompile;
+
+	// The BSP no longer matches any recorded state until this compile succeeds
+	IFileManager::Get().Delete(*StatePath, false, false, true);
+
+	// Stage outputs are cached by input hash; the entity-only path always runs vbsp
+	const bool bUseCache = Settings.bUseArtifactCache && !FinalResult.bEntitiesOnly;
+	FString VBSPPath = GetToolPath(Settings.ToolsDir, TEXT("vbsp"));
+
+	// Thread count doesn't change vvis/vrad output, so it stays out of the cache keys
+	FString ThreadsFlag = Settings.ThreadCount > 0
+		? FString::Printf(TEXT("-threads %d "), Settings.ThreadCount) : FString();
+
+	// Entity lump vbsp produced for the current VMF, used to detect stale restored BSPs
+	TArray<uint8> CompiledEntities;
+
+	// A BSP restored from the cache may carry an older entity lump; patch it in place
+	auto PatchStaleEntities = [&]() -> bool
 	{
-		FString VBSPPath = Settings.ToolsDir / TEXT("vbsp.exe");
-		FString Args = FString::Printf(TEXT("-game \"%s\" \"%s\""),
-			*Settings.GameDir, *Settings.VMFPath);
+		if (CompiledEntities.Num() == 0 || FCompileArtifactCache::EntityLumpMatches(BSPPath, CompiledEntities))
+		{
+			return true;
+		}
 
-		UE_LOG(LogTemp, Log, TEXT("SourceBridge: Running VBSP..."));
-		FCompileResult VBSPResult = RunTool(VBSPPath, Args, TEXT("VBSP"));
-		FinalResult.Output += VBSPResult.Output + TEXT("\n");
+		UE_LOG(LogTemp, Log, TEXT("SourceBridge: Cached BSP has older entities, running VBSP -onlyents..."));
+		FString Args = FString::Printf(TEXT("-onlyents -game \"%s\" \"%s\""), *Settings.GameDir, *Settings.VMFPath);
+		FCompileResult PatchResult = RunTool(VBSPPath, Args, TEXT("VBSP"), Settings.Hooks);
+		for (FCompileStageStats& Stage : PatchResult.Stages)
+		{
+			Stage.bEntitiesOnly = true;
+		}
+		FinalResult.Output += PatchResult.Output + TEXT("\n");
+		FinalResult.Stages.Append(PatchResult.Stages);
 
-		if (!VBSPResult.bSuccess)
+		if (!PatchResult.bSuccess)
 		{
-			FinalResult.ErrorMessage = TEXT("VBSP failed: ") + VBSPResult.ErrorMessage;
-			FinalResult.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
-			return FinalResult;
+			FinalResult.bCancelled = PatchResult.bCancelled;
+			FinalResult.ErrorMessage = TEXT("VBSP failed: ") + PatchResult.ErrorMessage;
+			return false;
 		}
-	}
+		return true;
+	};
 
-	// ---- VVIS (visibility) ----
+	// ---- VBSP (geometry) ----
 	{
-		FString VVISPath = Settings.ToolsDir / TEXT("vvis.exe");
-		FString FastFlag = Settings.bFastCompile ? TEXT("-fast ") : TEXT("");
+		FString OnlyEntsFlag = FinalResult.bEntitiesOnly ? TEXT("-onlyents ") : TEXT("");
 		FString Args = FString::Printf(TEXT("%s-game \"%s\" \"%s\""),
-			*FastFlag, *Settings.GameDir, *BSPPath);
+			*OnlyEntsFlag, *Settings.GameDir, *Settings.VMFPath);
+
+		uint64 Key = bUseCache ? FCompileArtifactCache::KeyForVBSP(Settings.VMFPath, VBSPPath, Settings.GameDir, Args) : 0;
+		if (FCompileArtifactCache::Restore(ECompileStage::VBSP, Key, BSPPath))
+		{
+			UE_LOG(LogTemp, Log, TEXT("SourceBridge: VBSP inputs unchanged, restored cached output."));
+			FinalResult.Output += TEXT("VBSP: restored from cache\n");
+		}
+		else
+		{
+			UE_LOG(LogTemp, Log, TEXT("SourceBridge: Running VBSP%s..."),
+				FinalResult.bEntitiesOnly ? TEXT(" (entities only, geometry unchanged since last compile)") : TEXT(""));
+			FCompileResult VBSPResult = RunTool(VBSPPath, Args, TEXT("VBSP"), Settings.Hooks);
+			for (FCompileStageStats& Stage : VBSPResult.Stages)
+			{
+				Stage.bEntitiesOnly = FinalResult.bEntitiesOnly;
+			}
+			FinalResult.Output += VBSPResult.Output + TEXT("\n");
+			FinalResult.Stages.Append(VBSPResult.Stages);
 
-		UE_LOG(LogTemp, Log, TEXT("SourceBridge: Running VVIS%s..."),
-			Settings.bFastCompile ? TEXT(" (fast)") : TEXT(""));
-		FCompileResult VVISResult = RunTool(VVISPath, Args, TEXT("VVIS"));
-		FinalResult.Output += VVISResult.Output + TEXT("\n");
+			if (!VBSPResult.bSuccess)
+			{
+				FinalResult.bCancelled = VBSPResult.bCancelled;
+				FinalResult.ErrorMessage = TEXT("VBSP failed: ") + VBSPResult.ErrorMessage;
+				FinalResult.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+				return FinalResult;
+			}
 
-		if (!VVISResult.bSuccess)
+			FCompileArtifactCache::Store(ECompileStage::VBSP, Key, BSPPath);
+		}
+
+		if (bUseCache)
 		{
-			FinalResult.ErrorMessage = TEXT("VVIS failed: ") + VVISResult.ErrorMessage;
-			FinalResult.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
-			return FinalResult;
+			FCompileArtifactCache::ReadEntityLump(BSPPath, CompiledEntities);
 		}
 	}
 
-	// ---- VRAD (lighting) ----
+	// vbsp -onlyents keeps the existing vis and lighting, so vvis/vrad are skipped
+	if (!FinalResult.bEntitiesOnly)
 	{
-		FString VRADPath = Settings.ToolsDir / TEXT("vrad.exe");
-		FString QualityFlag;
-		if (Settings.bFinalCompile)
-		{
-			QualityFlag = TEXT("-final ");
-		}
-		else if (Settings.bFastCompile)
+		// ---- VVIS (visibility) ----
 		{
-			QualityFlag = TEXT("-fast ");
+			FString VVISPath = GetToolPath(Settings.ToolsDir, TEXT("vvis"));
+			FString FastFlag = Settings.bFastCompile ? TEXT("-fast ") : TEXT("");
+			FString Args = FString::Printf(TEXT("%s-game \"%s\" \"%s\""),
+				*FastFlag, *Settings.GameDir, *BSPPath);
+
+			// Keyed on the BSP without its entity lump: entity edits never rerun vvis
+			uint64 Key = bUseCache ? FCompileArtifactCache::KeyForVVIS(BSPPath, VVISPath, Args) : 0;
+			if (FCompileArtifactCache::Restore(ECompileStage::VVIS, Key, BSPPath))
+			{
+				UE_LOG(LogTemp, Log, TEXT("SourceBridge: VVIS inputs unchanged, restored cached output."));
+				FinalResult.Output += TEXT("VVIS: restored from cache\n");
+
+				if (!PatchStaleEntities())
+				{
+					FinalResult.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+					return FinalResult;
+				}
+			}
+			else
+			{
+				UE_LOG(LogTemp, Log, TEXT("SourceBridge: Running VVIS%s..."),
+					Settings.bFastCompile ? TEXT(" (fast)") : TEXT(""));
+				FCompileResult VVISResult = RunTool(VVISPath, ThreadsFlag + Args, TEXT("VVIS"), Settings.Hooks);
+				FinalResult.Output += VVISResult.Output + TEXT("\n");
+				FinalResult.Stages.Append(VVISResult.Stages);
+
+				if (!VVISResult.bSuccess)
+				{
+					FinalResult.bCancelled = VVISResult.bCancelled;
+					FinalResult.ErrorMessage = TEXT("VVIS failed: ") + VVISResult.ErrorMessage;
+					FinalResult.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+					return FinalResult;
+				}
+
+				FCompileArtifactCache::Store(ECompileStage::VVIS, Key, BSPPath);
+			}
 		}
-		FString Args = FString::Printf(TEXT("%s-game \"%s\" \"%s\""),
-			*QualityFlag, *Settings.GameDir, *BSPPath);
 
-		FString QualityLabel = Settings.bFinalCompile ? TEXT(" (final)") :
-			(Settings.bFastCompile ? TEXT(" (fast)") : TEXT(""));
-		UE_LOG(LogTemp, Log, TEXT("SourceBridge: Running VRAD%s..."), *QualityLabel);
-		FCompileResult VRADResult = RunTool(VRADPath, Args, TEXT("VRAD"));
-		FinalResult.Output += VRADResult.Output + TEXT("\n");
-
-		if (!VRADResult.bSuccess)
+		// ---- VRAD (lighting) ----
 		{
-			FinalResult.ErrorMessage = TEXT("VRAD failed: ") + VRADResult.ErrorMessage;
-			FinalResult.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
-			return FinalResult;
+			FString VRADPath = GetToolPath(Settings.ToolsDir, TEXT("vrad"));
+			FString QualityFlag;
+			if (Settings.bFinalCompile)
+			{
+				QualityFlag = TEXT("-final ");
+			}
+			else if (Settings.bFastCompile)
+			{
+				QualityFlag = TEXT("-fast ");
+			}
+			FString Args = FString::Printf(TEXT("%s-game \"%s\" \"%s\""),
+				*QualityFlag, *Settings.GameDir, *BSPPath);
+
+			// Keyed on geometry/vis plus light entities and .rad files only
+			uint64 Key = bUseCache ? FCompileArtifactCache::KeyForVRAD(BSPPath, VRADPath, Settings.GameDir, Args) : 0;
+			if (FCompileArtifactCache::Restore(ECompileStage::VRAD, Key, BSPPath))
+			{
+				UE_LOG(LogTemp, Log, TEXT("SourceBridge: VRAD inputs unchanged, restored cached output."));
+				FinalResult.Output += TEXT("VRAD: restored from cache\n");
+
+				if (!PatchStaleEntities())
+				{
+					FinalResult.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+					return FinalResult;
+				}
+			}
+			else
+			{
+				FString QualityLabel = Settings.bFinalCompile ? TEXT(" (final)") :
+					(Settings.bFastCompile ? TEXT(" (fast)") : TEXT(""));
+				UE_LOG(LogTemp, Log, TEXT("SourceBridge: Running VRAD%s..."), *QualityLabel);
+				FCompileResult VRADResult = RunTool(VRADPath, ThreadsFlag + Args, TEXT("VRAD"), Settings.Hooks);
+				FinalResult.Output += VRADResult.Output + TEXT("\n");
+				FinalResult.Stages.Append(VRADResult.Stages);
+
+				if (!VRADResult.bSuccess)
+				{
+					FinalResult.bCancelled = VRADResult.bCancelled;
+					FinalResult.ErrorMessage = TEXT("VRAD failed: ") + VRADResult.ErrorMessage;
+					FinalResult.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+					return FinalResult;
+				}
+
+				FCompileArtifactCache::Store(ECompileStage::VRAD, Key, BSPPath);
+			}
 		}
 	}
 
@@ -119,11 +437,22 @@ FCompileResult FCompilePipeline::CompileMap(const FCompileSettings& Settings)
 		}
 	}
 
+	if (bHasNewState && !NewState.Save(StatePath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SourceBridge: Failed to write compile state to %s"), *StatePath);
+	}
+
 	FinalResult.bSuccess = true;
 	FinalResult.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
 
-	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Compile completed in %.1f seconds."),
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: %s completed in %.1f seconds."),
+		FinalResult.bEntitiesOnly ? TEXT("Entity-only compile") : TEXT("Compile"),
 		FinalResult.ElapsedSeconds);
+	for (const FCompileStageStats& Stage : FinalResult.Stages)
+	{
+		UE_LOG(LogTemp, Log, TEXT("SourceBridge:   %s: %.1f s, peak memory %.0f MB"),
+			*Stage.ToolName, Stage.WallSeconds, Stage.PeakMemoryBytes / (1024.0 * 1024.0));
+	}
 
 	return FinalResult;
 }
@@ -151,16 +480,34 @@ FCompileResult FCompilePipeline::CompileModel(const FModelCompileSettings& Setti
 		return Result;
 	}
 
-	FString StudioMDLPath = Settings.ToolsDir / TEXT("studiomdl.exe");
+	FString StudioMDLPath = GetToolPath(Settings.ToolsDir, TEXT("studiomdl"));
 	FString Args = FString::Printf(TEXT("-nop4 -game \"%s\" \"%s\""),
 		*Settings.GameDir, *Settings.QCPath);
 
-	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Running studiomdl..."));
-	FCompileResult MDLResult = RunTool(StudioMDLPath, Args, TEXT("studiomdl"));
+	uint64 CacheKey = 0;
+	FString ModelName;
+	if (Settings.bUseCache)
+	{
+		CacheKey = FModelCompileCache::ComputeKey(Settings.QCPath, StudioMDLPath, Settings.GameDir);
+		ModelName = FModelCompileCache::ReadModelName(Settings.QCPath);
+		if (FModelCompileCache::Restore(CacheKey, Settings.GameDir, ModelName))
+		{
+			Result.bSuccess = true;
+			Result.bFromCache = true;
+			Result.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+			return Result;
+		}
+	}
+	FDateTime ToolStartTime = FDateTime::UtcNow();
+
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Running studiomdl on %s..."), *FPaths::GetCleanFilename(Settings.QCPath));
+	FCompileResult MDLResult = RunTool(StudioMDLPath, Args, TEXT("studiomdl"), Settings.Hooks);
 	Result.Output = MDLResult.Output;
+	Result.Stages = MDLResult.Stages;
 
 	if (!MDLResult.bSuccess)
 	{
+		Result.bCancelled = MDLResult.bCancelled;
 		Result.ErrorMessage = TEXT("studiomdl failed: ") + MDLResult.ErrorMessage;
 		Result.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
 		return Result;
@@ -168,20 +515,24 @@ FCompileResult FCompilePipeline::CompileModel(const FModelCompileSettings& Setti
 
 	// studiomdl outputs files to the game's models/ folder automatically
 	// based on $modelname in the QC file
+	if (Settings.bUseCache)
+	{
+		FModelCompileCache::Store(CacheKey, Settings.GameDir, ModelName, ToolStartTime);
+	}
 
 	Result.bSuccess = true;
 	Result.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
 
-	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Model compile completed in %.1f seconds."),
-		Result.ElapsedSeconds);
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Model %s compiled in %.1f seconds."),
+		*FPaths::GetBaseFilename(Settings.QCPath), Result.ElapsedSeconds);
 
 	return Result;
 }
 
 FCompileResult FCompilePipeline::PackCustomContent(
 	const FString& BSPPath,
-	const FString& ToolsDir,
-	const TMap<FString, FString>& FileList)
+	const TMap<FString, FString>& FileList,
+	bool bCompress)
 {
 	FCompileResult Result;
 
@@ -192,63 +543,88 @@ FCompileResult FCompilePipeline::PackCustomContent(
 		return Result;
 	}
 
-	FString BSPZipPath = ToolsDir / TEXT("bspzip.exe");
-	if (!FPaths::FileExists(BSPZipPath))
-	{
-		Result.ErrorMessage = FString::Printf(TEXT("bspzip not found at: %s"), *BSPZipPath);
-		return Result;
-	}
-
 	if (!FPaths::FileExists(BSPPath))
 	{
 		Result.ErrorMessage = FString::Printf(TEXT("BSP file not found: %s"), *BSPPath);
 		return Result;
 	}
 
-	// bspzip -addlist expects a text file with alternating lines:
-	// internal/path/file.ext
-	// C:\absolute\disk\path\file.ext
-	// internal/path/file2.ext
-	// C:\absolute\disk\path\file2.ext
-	FString ListContent;
-	for (const auto& Pair : FileList)
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Packing %d files into BSP"), FileList.Num());
+
+	double StartTime = FPlatformTime::Seconds();
+
+	FBSPPakOptions Options;
+	Options.bCompress = bCompress;
+	FBSPPakResult PakResult = FBSPPakWriter::Pack(BSPPath, FileList, Options);
+
+	Result.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+	Result.bSuccess = PakResult.bSuccess;
+	Result.ErrorMessage = PakResult.ErrorMessage;
+	if (!PakResult.bSuccess)
 	{
-		ListContent += Pair.Key + TEXT("\n");
-		ListContent += Pair.Value + TEXT("\n");
+		return Result;
 	}
 
-	// Write the file list to a temp file next to the BSP
-	FString ListFilePath = FPaths::ChangeExtension(BSPPath, TEXT("")) + TEXT("_packlist.txt");
-	if (!FFileHelper::SaveStringToFile(ListContent, *ListFilePath))
+	Result.Output = FString::Printf(TEXT("Packed %d files (%d unchanged, %d reused from duplicates, %d kept from the compile), %lld bytes, map CRC %08x"),
+		PakResult.FilesWritten, PakResult.FilesUnchanged, PakResult.FilesDeduplicated, PakResult.FilesKept,
+		PakResult.PakBytes, PakResult.MapChecksum);
+	for (const FString& Missing : PakResult.MissingFiles)
 	{
-		Result.ErrorMessage = FString::Printf(TEXT("Failed to write pack list to: %s"), *ListFilePath);
-		return Result;
+		Result.Output += TEXT("\nMissing: ") + Missing;
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Packing %d files into BSP via bspzip"), FileList.Num());
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Packed %d custom files into BSP in %.2f seconds"),
+		FileList.Num() - PakResult.MissingFiles.Num(), Result.ElapsedSeconds);
 
-	FString Args = FString::Printf(TEXT("-addlist \"%s\" \"%s\" \"%s\""),
-		*BSPPath, *ListFilePath, *BSPPath);
+	return Result;
+}
 
-	Result = RunTool(BSPZipPath, Args, TEXT("bspzip"));
+namespace
+{
+	/** Splits streamed pipe output into lines, holding back a trailing partial line. */
+	struct FCompileLineSplitter
+	{
+		FString Pending;
 
-	// Clean up temp file
-	IFileManager::Get().Delete(*ListFilePath);
+		template<typename FuncType>
+		void Feed(const FString& Chunk, FuncType&& OnLine)
+		{
+			Pending += Chunk;
 
-	if (Result.bSuccess)
-	{
-		UE_LOG(LogTemp, Log, TEXT("SourceBridge: Packed %d custom files into BSP"), FileList.Num());
-	}
+			int32 LineStart = 0;
+			for (int32 i = 0; i < Pending.Len(); ++i)
+			{
+				if (Pending[i] == TEXT('\n'))
+				{
+					int32 LineEnd = (i > LineStart && Pending[i - 1] == TEXT('\r')) ? i - 1 : i;
+					OnLine(Pending.Mid(LineStart, LineEnd - LineStart));
+					LineStart = i + 1;
+				}
+			}
+			Pending.RightChopInline(LineStart);
+		}
 
-	return Result;
+		template<typename FuncType>
+		void Flush(FuncType&& OnLine)
+		{
+			if (!Pending.IsEmpty())
+			{
+				OnLine(Pending);
+				Pending.Reset();
+			}
+		}
+	};
 }
 
 FCompileResult FCompilePipeline::RunTool(
 	const FString& ToolPath,
 	const FString& Arguments,
-	const FString& ToolName)
+	const FString& ToolName,
+	const FCompileHooks& Hooks)
 {
 	FCompileResult Result;
+	FCompileStageStats& Stage = Result.Stages.AddDefaulted_GetRef();
+	Stage.ToolName = ToolName;
 
 	if (!FPaths::FileExists(ToolPath))
 	{
@@ -256,23 +632,135 @@ FCompileResult FCompilePipeline::RunTool(
 		return Result;
 	}
 
-	int32 ReturnCode = -1;
-	FString StdOut;
+	if (Hooks.ShouldCancel && Hooks.ShouldCancel())
+	{
+		Result.bCancelled = true;
+		Result.ErrorMessage = FString::Printf(TEXT("%s cancelled."), *ToolName);
+		return Result;
+	}
+
+	void* StdOutRead = nullptr;
+	void* StdOutWrite = nullptr;
+	void* StdErrRead = nullptr;
+	void* StdErrWrite = nullptr;
+	if (!FPlatformProcess::CreatePipe(StdOutRead, StdOutWrite) ||
+		!FPlatformProcess::CreatePipe(StdErrRead, StdErrWrite))
+	{
+		FPlatformProcess::ClosePipe(StdOutRead, StdOutWrite);
+		FPlatformProcess::ClosePipe(StdErrRead, StdErrWrite);
+		Result.ErrorMessage = FString::Printf(TEXT("Failed to create output pipes for %s"), *ToolName);
+		return Result;
+	}
+
+	double StartTime = FPlatformTime::Seconds();
+	uint32 ProcessId = 0;
+	FProcHandle Process = FPlatformProcess::CreateProc(
+		*ToolPath, *Arguments,
+		false, true, true,
+		&ProcessId, 0, nullptr,
+		StdOutWrite, nullptr, StdErrWrite);
+
+	if (!Process.IsValid())
+	{
+		FPlatformProcess::ClosePipe(StdOutRead, StdOutWrite);
+		FPlatformProcess::ClosePipe(StdErrRead, StdErrWrite);
+		Result.ErrorMessage = FString::Printf(TEXT("Failed to launch %s"), *ToolName);
+		return Result;
+	}
+
+	if (Hooks.OnToolStarted)
+	{
+		Hooks.OnToolStarted(ToolName);
+	}
+
 	FString StdErr;
+	auto HandleStdOut = [&](const FString& Line)
+	{
+		Result.Output += Line + TEXT("\n");
+		UE_LOG(LogTemp, Log, TEXT("SourceBridge: [%s] %s"), *ToolName, *Line);
+		if (Hooks.OnOutputLine)
+		{
+			Hooks.OnOutputLine(ToolName, Line, false);
+		}
+	};
+	auto HandleStdErr = [&](const FString& Line)
+	{
+		StdErr += Line + TEXT("\n");
+		UE_LOG(LogTemp, Log, TEXT("SourceBridge: [%s] %s"), *ToolName, *Line);
+		if (Hooks.OnOutputLine)
+		{
+			Hooks.OnOutputLine(ToolName, Line, true);
+		}
+	};
+
+	// Poll instead of ExecProcess so output streams while the tool runs and a hung
+	// tool can be killed. Pipes are drained every pass so the child never blocks on a
+	// full pipe buffer.
+	FCompileLineSplitter StdOutLines;
+	FCompileLineSplitter StdErrLines;
+	bool bRunning = true;
+	while (bRunning)
+	{
+		bRunning = FPlatformProcess::IsProcRunning(Process);
+
+		FString OutChunk = FPlatformProcess::ReadPipe(StdOutRead);
+		FString ErrChunk = FPlatformProcess::ReadPipe(StdErrRead);
+		StdOutLines.Feed(OutChunk, HandleStdOut);
+		StdErrLines.Feed(ErrChunk, HandleStdErr);
+
+		if (!OutChunk.IsEmpty() && !StdOutLines.Pending.IsEmpty() && Hooks.OnPartialLine)
+		{
+			Hooks.OnPartialLine(ToolName, StdOutLines.Pending);
+		}
+
+		if (!bRunning)
+		{
+			break;
+		}
+
+		SIZE_T MemoryUsage = 0;
+		if (FPlatformProcess::GetApplicationMemoryUsage(ProcessId, &MemoryUsage))
+		{
+			Stage.PeakMemoryBytes = FMath::Max<uint64>(Stage.PeakMemoryBytes, MemoryUsage);
+		}
+
+		if (Hooks.ShouldCancel && Hooks.ShouldCancel())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SourceBridge: Cancelling %s..."), *ToolName);
+			FPlatformProcess::TerminateProc(Process, true);
+			FPlatformProcess::WaitForProc(Process);
+			Result.bCancelled = true;
+			break;
+		}
+
+		if (OutChunk.IsEmpty() && ErrChunk.IsEmpty())
+		{
+			FPlatformProcess::Sleep(0.05f);
+		}
+	}
 
-	// Run the tool and capture output
-	bool bLaunched = FPlatformProcess::ExecProcess(
-		*ToolPath,
-		*Arguments,
-		&ReturnCode,
-		&StdOut,
-		&StdErr);
+	StdOutLines.Feed(FPlatformProcess::ReadPipe(StdOutRead), HandleStdOut);
+	StdErrLines.Feed(FPlatformProcess::ReadPipe(StdErrRead), HandleStdErr);
+	StdOutLines.Flush(HandleStdOut);
+	StdErrLines.Flush(HandleStdErr);
 
-	Result.Output = StdOut;
+	int32 ReturnCode = -1;
+	if (!Result.bCancelled)
+	{
+		FPlatformProcess::GetProcReturnCode(Process, &ReturnCode);
+	}
 
-	if (!bLaunched)
+	FPlatformProcess::CloseProc(Process);
+	FPlatformProcess::ClosePipe(StdOutRead, StdOutWrite);
+	FPlatformProcess::ClosePipe(StdErrRead, StdErrWrite);
+
+	Stage.WallSeconds = FPlatformTime::Seconds() - StartTime;
+	Stage.ReturnCode = ReturnCode;
+	Result.ElapsedSeconds = Stage.WallSeconds;
+
+	if (Result.bCancelled)
 	{
-		Result.ErrorMessage = FString::Printf(TEXT("Failed to launch %s"), *ToolName);
+		Result.ErrorMessage = FString::Printf(TEXT("%s cancelled."), *ToolName);
 		return Result;
 	}
 
@@ -288,6 +776,24 @@ FCompileResult FCompilePipeline::RunTool(
 	return Result;
 }
 
+FString FCompilePipeline::GetToolPath(const FString& ToolsDir, const FString& ToolName)
+{
+#if PLATFORM_WINDOWS
+	return (ToolsDir / ToolName) + TEXT(".exe");
+#else
+	// Native builds and stand-in scripts; .exe last for binfmt/Wine setups
+	for (const TCHAR* Suffix : { TEXT(""), TEXT("_linux"), TEXT(".sh"), TEXT(".exe") })
+	{
+		FString Path = (ToolsDir / ToolName) + Suffix;
+		if (FPaths::FileExists(Path))
+		{
+			return Path;
+		}
+	}
+	return ToolsDir / ToolName;
+#endif
+}
+
 FString FCompilePipeline::FindToolsDirectory()
 {
 	TArray<FString> LibPaths = GetSteamLibraryPaths();
@@ -308,7 +814,7 @@ FString FCompilePipeline::FindToolsDirectory()
 		for (const FString& SubPath : ToolSubPaths)
 		{
 			FString FullPath = LibPath / SubPath;
-			FString VBSPPath = FullPath / TEXT("vbsp.exe");
+			FString VBSPPath = GetToolPath(FullPath, TEXT("vbsp"));
 
 			if (FPaths::FileExists(VBSPPath))
 			{
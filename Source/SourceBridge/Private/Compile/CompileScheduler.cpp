@@ -0,0 +1,230 @@
+#include "Compile/CompileScheduler.h"
+#include "Async/Async.h"
+#include "Algo/StableSort.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "HAL/PlatformMisc.h"
+
+// Below this many threads per compile, running another map at once stops paying off
+static const int32 THREADS_PER_CONCURRENT_COMPILE = 4;
+
+/** Run Worker on Concurrency threads, the calling thread being one of them, and wait for all. */
+static void RunWorkers(int32 Concurrency, const TFunction<void()>& Worker)
+{
+	TArray<TFuture<void>> Workers;
+	for (int32 i = 1; i < Concurrency; ++i)
+	{
+		Workers.Add(Async(EAsyncExecution::Thread, [&Worker]() { Worker(); }));
+	}
+	Worker();
+
+	for (TFuture<void>& Future : Workers)
+	{
+		Future.Wait();
+	}
+}
+
+int32 FCompileScheduler::GetThreadBudget(int32 RequestedBudget)
+{
+	int32 Cores = FMath::Max(FPlatformMisc::NumberOfCoresIncludingHyperthreads(), 1);
+	if (RequestedBudget <= 0)
+	{
+		return FMath::Max(Cores - 1, 1);
+	}
+	return FMath::Min(RequestedBudget, Cores);
+}
+
+int32 FCompileScheduler::GetConcurrency(int32 ThreadBudget, int32 RequestedConcurrency, int32 QueueLength)
+{
+	int32 Concurrency = RequestedConcurrency > 0
+		? RequestedConcurrency
+		: ThreadBudget / THREADS_PER_CONCURRENT_COMPILE;
+
+	return FMath::Clamp(Concurrency, 1, FMath::Max(FMath::Min(QueueLength, ThreadBudget), 1));
+}
+
+TSharedRef<FCompileBatch> FCompileScheduler::StartBatch(
+	const TArray<FCompileQueueItem>& Queue,
+	int32 ThreadBudget,
+	int32 MaxConcurrent)
+{
+	check(IsInGameThread());
+
+	TSharedRef<FCompileBatch> Batch = MakeShareable(new FCompileBatch());
+	FCompileBatch::LatestBatch = Batch;
+	Batch->StartTime = FPlatformTime::Seconds();
+	Batch->Queue = Queue;
+	Batch->Result.Results.SetNum(Queue.Num());
+	Batch->Budget = GetThreadBudget(ThreadBudget);
+	Batch->Concurrency = GetConcurrency(Batch->Budget, MaxConcurrent, Queue.Num());
+
+	for (int32 i = 0; i < Queue.Num(); ++i)
+	{
+		Batch->Order.Add(i);
+	}
+	Algo::StableSort(Batch->Order, [&Queue](int32 A, int32 B)
+	{
+		return Queue[A].Priority > Queue[B].Priority;
+	});
+
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Batch compiling %d maps, %d at a time with %d threads."),
+		Queue.Num(), Batch->Concurrency, Batch->Budget);
+
+	Batch->StartNext();
+	return Batch;
+}
+
+TSharedPtr<FCompileBatch> FCompileBatch::LatestBatch;
+
+TSharedPtr<FCompileBatch> FCompileBatch::GetLatest()
+{
+	return LatestBatch;
+}
+
+void FCompileBatch::Cancel()
+{
+	check(IsInGameThread());
+
+	if (bDone || bCancelRequested)
+	{
+		return;
+	}
+	bCancelRequested = true;
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Batch: cancelling %d running and %d queued compiles."),
+		RunningJobs.Num(), Order.Num() - NextOrder);
+
+	for (const TPair<int32, TSharedRef<FCompileJob>>& Running : RunningJobs)
+	{
+		Running.Value->Cancel();
+	}
+}
+
+void FCompileBatch::StartNext()
+{
+	while (!bCancelRequested && NextOrder < Order.Num() && RunningJobs.Num() < Concurrency)
+	{
+		const int32 Index = Order[NextOrder++];
+
+		// Even share of the free threads across the slots about to be filled
+		const int32 Pending = Order.Num() - NextOrder + 1;
+		const int32 SlotsToFill = FMath::Max(FMath::Min(Concurrency - RunningJobs.Num(), Pending), 1);
+		const int32 Threads = FMath::Max((Budget - ThreadsInUse) / SlotsToFill, 1);
+		ThreadsInUse += Threads;
+
+		FCompileSettings Settings = Queue[Index].Settings;
+		Settings.ThreadCount = Threads;
+
+		UE_LOG(LogTemp, Log, TEXT("SourceBridge: Batch: compiling %s (priority %d, %d threads)"),
+			*FPaths::GetBaseFilename(Settings.VMFPath), Queue[Index].Priority, Threads);
+
+		// The job holds the batch until it finishes; the batch drops the job then
+		TSharedRef<FCompileJob> Job = FCompileJob::StartMapCompile(Settings);
+		RunningJobs.Add(Index, Job);
+		Job->OnFinished.AddLambda([Self = AsShared(), Index, Threads](const FCompileResult& MapResult)
+		{
+			Self->OnJobFinished(Index, Threads, MapResult);
+		});
+	}
+
+	if (RunningJobs.Num() == 0)
+	{
+		Finish();
+	}
+}
+
+void FCompileBatch::OnJobFinished(int32 QueueIndex, int32 Threads, const FCompileResult& MapResult)
+{
+	RunningJobs.Remove(QueueIndex);
+	ThreadsInUse -= Threads;
+
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Batch: %s %s in %.1f seconds"),
+		*FPaths::GetBaseFilename(Queue[QueueIndex].Settings.VMFPath),
+		MapResult.bSuccess ? TEXT("compiled") : TEXT("failed"), MapResult.ElapsedSeconds);
+
+	Result.Results[QueueIndex] = MapResult;
+	OnMapFinished.Broadcast(QueueIndex, MapResult);
+
+	StartNext();
+}
+
+void FCompileBatch::Finish()
+{
+	// Maps a cancel kept from starting
+	for (int32 i = NextOrder; i < Order.Num(); ++i)
+	{
+		FCompileResult& Skipped = Result.Results[Order[i]];
+		Skipped.bCancelled = true;
+		Skipped.ErrorMessage = TEXT("Compile cancelled.");
+	}
+
+	for (const FCompileResult& MapResult : Result.Results)
+	{
+		if (MapResult.bSuccess)
+		{
+			Result.SucceededCount++;
+		}
+		else
+		{
+			Result.FailedCount++;
+		}
+	}
+	Result.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+	bDone = true;
+
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Batch compile finished in %.1f seconds: %d succeeded, %d failed."),
+		Result.ElapsedSeconds, Result.SucceededCount, Result.FailedCount);
+
+	OnFinished.Broadcast(Result);
+}
+
+TArray<FCompileResult> FCompileScheduler::RunModelBatch(
+	const TArray<FModelCompileSettings>& Models,
+	int32 MaxConcurrent,
+	TFunction<void(int32, const FCompileResult&)> OnModelFinished)
+{
+	TArray<FCompileResult> Results;
+	Results.SetNum(Models.Num());
+	if (Models.Num() == 0)
+	{
+		return Results;
+	}
+
+	int32 Concurrency = MaxConcurrent > 0 ? MaxConcurrent : GetThreadBudget(0);
+	Concurrency = FMath::Clamp(Concurrency, 1, Models.Num());
+
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Compiling %d models, %d at a time."),
+		Models.Num(), Concurrency);
+
+	FCriticalSection Lock;
+	int32 NextIndex = 0;
+
+	auto Worker = [&]()
+	{
+		for (;;)
+		{
+			int32 Index;
+			{
+				FScopeLock ScopeLock(&Lock);
+				if (NextIndex >= Models.Num())
+				{
+					return;
+				}
+				Index = NextIndex++;
+			}
+
+			FCompileResult Result = FCompilePipeline::CompileModel(Models[Index]);
+
+			if (OnModelFinished)
+			{
+				OnModelFinished(Index, Result);
+			}
+
+			FScopeLock ScopeLock(&Lock);
+			Results[Index] = MoveTemp(Result);
+		}
+	};
+
+	RunWorkers(Concurrency, Worker);
+
+	return Results;
+}
@@ -0,0 +1,398 @@
+#include "Compile/CompileTelemetry.h"
+#include "Compile/CompilePipeline.h"
+#include "Internationalization/Regex.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+// ---- Progress weighting ----
+
+namespace
+{
+	struct FProgressRange
+	{
+		const TCHAR* ToolName;
+		const TCHAR* Phase;
+		float Start;
+		float End;
+	};
+
+	// Share of a full compile spent in each tool
+	const FProgressRange ToolRanges[] = {
+		{ TEXT("VBSP"), nullptr, 0.0f, 0.15f },
+		{ TEXT("VVIS"), nullptr, 0.15f, 0.5f },
+		{ TEXT("VRAD"), nullptr, 0.5f, 1.0f },
+	};
+
+	// Share of each tool spent in its counted phases; unlisted phases don't move the bar
+	const FProgressRange PhaseRanges[] = {
+		{ TEXT("VBSP"), TEXT("ProcessBlock_Thread"), 0.05f, 0.6f },
+		{ TEXT("VVIS"), TEXT("BasePortalVis"), 0.0f, 0.15f },
+		{ TEXT("VVIS"), TEXT("PortalFlow"), 0.15f, 1.0f },
+		{ TEXT("VRAD"), TEXT("BuildFacelights"), 0.0f, 0.45f },
+		{ TEXT("VRAD"), TEXT("BuildVisLeafs"), 0.45f, 0.55f },
+		{ TEXT("VRAD"), TEXT("FinalLightFace"), 0.75f, 0.95f },
+		{ TEXT("VRAD"), TEXT("ThreadComputeLeafAmbient"), 0.95f, 1.0f },
+	};
+
+	// Bounces run between BuildVisLeafs and FinalLightFace; vrad usually converges by ~20
+	const float BOUNCE_RANGE_START = 0.55f;
+	const float BOUNCE_RANGE_END = 0.75f;
+	const int32 TYPICAL_BOUNCES = 20;
+
+	const FProgressRange* FindRange(const FProgressRange* Ranges, int32 Count, const FString& ToolName, const TCHAR* Phase)
+	{
+		for (int32 i = 0; i < Count; ++i)
+		{
+			if (ToolName.Equals(Ranges[i].ToolName, ESearchCase::IgnoreCase)
+				&& (Phase == nullptr || FCString::Stricmp(Phase, Ranges[i].Phase) == 0))
+			{
+				return &Ranges[i];
+			}
+		}
+		return nullptr;
+	}
+
+	float ToOverall(const FString& ToolName, float ToolProgress)
+	{
+		const FProgressRange* Tool = FindRange(ToolRanges, UE_ARRAY_COUNT(ToolRanges), ToolName, nullptr);
+		if (!Tool)
+		{
+			return 0.0f;
+		}
+		return FMath::Lerp(Tool->Start, Tool->End, FMath::Clamp(ToolProgress, 0.0f, 1.0f));
+	}
+}
+
+// ---- FCompileTelemetryParser ----
+
+void FCompileTelemetryParser::BeginTool(const FString& ToolName)
+{
+	EndPhase();
+	CurrentTool = ToolName;
+	OverallProgress = FMath::Max(OverallProgress, ToOverall(ToolName, 0.0f));
+}
+
+void FCompileTelemetryParser::ParsePartial(const FString& Text)
+{
+	UpdatePhaseProgress(Text, false);
+}
+
+void FCompileTelemetryParser::ParseLine(const FString& Line)
+{
+	UpdatePhaseProgress(Line, true);
+
+	// ---- vbsp: leaks ----
+	if (Line.Contains(TEXT("leaked")))
+	{
+		Telemetry.bLeaked = true;
+
+		static const FRegexPattern LeakEntityPattern(TEXT("Entity\\s+(\\S+)\\s*\\(([^)]*)\\)\\s+leaked"));
+		FRegexMatcher Matcher(LeakEntityPattern, Line);
+		if (Matcher.FindNext())
+		{
+			Telemetry.LeakEntity = FString::Printf(TEXT("%s (%s)"),
+				*Matcher.GetCaptureGroup(1), *Matcher.GetCaptureGroup(2).TrimStartAndEnd());
+		}
+		return;
+	}
+
+	if (Telemetry.bLeaked && Line.TrimEnd().EndsWith(TEXT(".lin")))
+	{
+		static const FRegexPattern PointfilePattern(TEXT("(?:Writing|pointfile)\\s+(.+\\.lin)"));
+		FRegexMatcher Matcher(PointfilePattern, Line);
+		if (Matcher.FindNext())
+		{
+			Telemetry.PointfilePath = Matcher.GetCaptureGroup(1).TrimStartAndEnd();
+			bLeakReported = true;
+
+			FCompileEvent Event;
+			Event.Type = ECompileEventType::Leak;
+			Event.ToolName = CurrentTool;
+			Event.OverallProgress = OverallProgress;
+			Event.Text = Telemetry.LeakEntity;
+			Event.Path = Telemetry.PointfilePath;
+			if (OnEvent)
+			{
+				OnEvent(Event);
+			}
+		}
+		return;
+	}
+
+	// ---- vvis: portals and clusters ----
+	static const FRegexPattern CountPattern(TEXT("^\\s*(\\d+)\\s+(portalclusters|numportals|direct lights)"));
+	{
+		FRegexMatcher Matcher(CountPattern, Line);
+		if (Matcher.FindNext())
+		{
+			int32 Count = FCString::Atoi(*Matcher.GetCaptureGroup(1));
+			FString What = Matcher.GetCaptureGroup(2);
+			if (What == TEXT("portalclusters"))
+			{
+				Telemetry.PortalClusters = Count;
+				Emit(ECompileEventType::VisStats, Line, Count);
+			}
+			else if (What == TEXT("numportals"))
+			{
+				Telemetry.Portals = Count;
+				Emit(ECompileEventType::VisStats, Line, Count);
+			}
+			else
+			{
+				Telemetry.DirectLights = Count;
+				Emit(ECompileEventType::RadStats, Line, Count);
+			}
+			return;
+		}
+	}
+
+	static const FRegexPattern AveragePattern(TEXT("Average clusters visible:\\s*(\\d+)"));
+	{
+		FRegexMatcher Matcher(AveragePattern, Line);
+		if (Matcher.FindNext())
+		{
+			Telemetry.AverageClustersVisible = FCString::Atoi(*Matcher.GetCaptureGroup(1));
+			Emit(ECompileEventType::VisStats, Line, Telemetry.AverageClustersVisible);
+			return;
+		}
+	}
+
+	// ---- vrad: bounces and lightmap size ----
+	static const FRegexPattern BouncePattern(TEXT("Bounce #(\\d+) added RGB\\((\\d+),\\s*(\\d+),\\s*(\\d+)\\)"));
+	{
+		FRegexMatcher Matcher(BouncePattern, Line);
+		if (Matcher.FindNext())
+		{
+			Telemetry.Bounces = FCString::Atoi(*Matcher.GetCaptureGroup(1));
+			Telemetry.LastBounceEnergy = FCString::Atoi64(*Matcher.GetCaptureGroup(2))
+				+ FCString::Atoi64(*Matcher.GetCaptureGroup(3))
+				+ FCString::Atoi64(*Matcher.GetCaptureGroup(4));
+
+			float BounceProgress = FMath::Lerp(BOUNCE_RANGE_START, BOUNCE_RANGE_END,
+				FMath::Min((float)Telemetry.Bounces / TYPICAL_BOUNCES, 1.0f));
+			OverallProgress = FMath::Max(OverallProgress, ToOverall(CurrentTool, BounceProgress));
+
+			Emit(ECompileEventType::RadBounce, Line, Telemetry.Bounces);
+			return;
+		}
+	}
+
+	// Lump usage table printed at the end of vrad: "lightdata   [variable]   123456/0 ..."
+	static const FRegexPattern LightdataPattern(TEXT("^\\s*(lightdata\\w*)\\s+\\[variable\\]\\s+(\\d+)"));
+	{
+		FRegexMatcher Matcher(LightdataPattern, Line);
+		if (Matcher.FindNext() && CurrentTool.Equals(TEXT("VRAD"), ESearchCase::IgnoreCase))
+		{
+			Telemetry.LightmapBytes += FCString::Atoi64(*Matcher.GetCaptureGroup(2));
+			Emit(ECompileEventType::RadStats, Line, Telemetry.LightmapBytes);
+		}
+	}
+}
+
+void FCompileTelemetryParser::UpdatePhaseProgress(const FString& Text, bool bLineComplete)
+{
+	// Counters look like "Label:   0...1...2...3" and end with "10 (seconds)"
+	int32 CounterStart = INDEX_NONE;
+	for (int32 Search = Text.Find(TEXT("0...")); Search != INDEX_NONE;
+		Search = Text.Find(TEXT("0..."), ESearchCase::CaseSensitive, ESearchDir::FromStart, Search + 1))
+	{
+		if (Search == 0 || Text[Search - 1] == TEXT(' ') || Text[Search - 1] == TEXT(':') || Text[Search - 1] == TEXT('\t'))
+		{
+			CounterStart = Search;
+			break;
+		}
+	}
+
+	if (CounterStart == INDEX_NONE)
+	{
+		return;
+	}
+
+	FString Phase = Text.Left(CounterStart).TrimStartAndEnd();
+	Phase.RemoveFromEnd(TEXT(":"));
+	Phase.TrimEndInline();
+
+	TArray<FString> Steps;
+	Text.Mid(CounterStart).ParseIntoArray(Steps, TEXT("..."), true);
+
+	// The last token is only trustworthy once the line is complete ("1" may become "10")
+	int32 Step = 0;
+	int32 Usable = bLineComplete ? Steps.Num() : Steps.Num() - 1;
+	for (int32 i = 0; i < Usable; ++i)
+	{
+		Step = FMath::Max(Step, FCString::Atoi(*Steps[i]));
+	}
+
+	if (Phase != CurrentPhase)
+	{
+		EndPhase();
+		CurrentPhase = Phase;
+		CurrentPhaseProgress = -1.0f;
+		PhaseStartTime = FPlatformTime::Seconds();
+	}
+
+	float PhaseProgress = FMath::Clamp(Step / 10.0f, 0.0f, 1.0f);
+	if (PhaseProgress == CurrentPhaseProgress)
+	{
+		return;
+	}
+	CurrentPhaseProgress = PhaseProgress;
+
+	if (const FProgressRange* Range = FindRange(PhaseRanges, UE_ARRAY_COUNT(PhaseRanges), CurrentTool, *Phase))
+	{
+		float ToolProgress = FMath::Lerp(Range->Start, Range->End, PhaseProgress);
+		OverallProgress = FMath::Max(OverallProgress, ToOverall(CurrentTool, ToolProgress));
+	}
+
+	FCompileEvent Event;
+	Event.Type = ECompileEventType::PhaseProgress;
+	Event.ToolName = CurrentTool;
+	Event.Phase = Phase;
+	Event.PhaseProgress = PhaseProgress;
+	Event.OverallProgress = OverallProgress;
+	if (OnEvent)
+	{
+		OnEvent(Event);
+	}
+
+	if (bLineComplete)
+	{
+		EndPhase();
+	}
+}
+
+void FCompileTelemetryParser::EndPhase()
+{
+	if (CurrentPhase.IsEmpty())
+	{
+		return;
+	}
+
+	FCompilePhaseTiming& Timing = Telemetry.Phases.AddDefaulted_GetRef();
+	Timing.ToolName = CurrentTool;
+	Timing.Phase = CurrentPhase;
+	Timing.Seconds = FPlatformTime::Seconds() - PhaseStartTime;
+
+	CurrentPhase.Reset();
+	CurrentPhaseProgress = 0.0f;
+}
+
+void FCompileTelemetryParser::Finish()
+{
+	EndPhase();
+
+	if (Telemetry.bLeaked && !bLeakReported)
+	{
+		bLeakReported = true;
+		FCompileEvent Event;
+		Event.Type = ECompileEventType::Leak;
+		Event.ToolName = CurrentTool;
+		Event.OverallProgress = OverallProgress;
+		Event.Text = Telemetry.LeakEntity;
+		if (OnEvent)
+		{
+			OnEvent(Event);
+		}
+	}
+}
+
+void FCompileTelemetryParser::Emit(ECompileEventType Type, const FString& Text, int64 Value)
+{
+	if (!OnEvent)
+	{
+		return;
+	}
+
+	FCompileEvent Event;
+	Event.Type = Type;
+	Event.ToolName = CurrentTool;
+	Event.OverallProgress = OverallProgress;
+	Event.Text = Text.TrimStartAndEnd();
+	Event.Value = Value;
+	OnEvent(Event);
+}
+
+// ---- FCompileReport ----
+
+FString FCompileReport::GetReportPath(const FString& VMFPath)
+{
+	return FPaths::GetPath(VMFPath) / FPaths::GetBaseFilename(VMFPath) + TEXT(".compile.json");
+}
+
+bool FCompileReport::Write(const FString& VMFPath, const FCompileResult& Result)
+{
+	const FCompileTelemetry& Telemetry = Result.Telemetry;
+
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("map"), FPaths::GetBaseFilename(VMFPath));
+	Root->SetStringField(TEXT("date"), FDateTime::UtcNow().ToIso8601());
+	Root->SetNumberField(TEXT("cores"), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+	Root->SetBoolField(TEXT("success"), Result.bSuccess);
+	Root->SetBoolField(TEXT("entitiesOnly"), Result.bEntitiesOnly);
+	Root->SetNumberField(TEXT("elapsedSeconds"), Result.ElapsedSeconds);
+	if (!Result.ErrorMessage.IsEmpty())
+	{
+		Root->SetStringField(TEXT("error"), Result.ErrorMessage);
+	}
+
+	TArray<TSharedPtr<FJsonValue>> Stages;
+	for (const FCompileStageStats& Stage : Result.Stages)
+	{
+		TSharedRef<FJsonObject> StageObject = MakeShared<FJsonObject>();
+		StageObject->SetStringField(TEXT("tool"), Stage.ToolName);
+		StageObject->SetNumberField(TEXT("seconds"), Stage.WallSeconds);
+		StageObject->SetNumberField(TEXT("peakMemoryBytes"), (double)Stage.PeakMemoryBytes);
+		StageObject->SetNumberField(TEXT("returnCode"), Stage.ReturnCode);
+		Stages.Add(MakeShared<FJsonValueObject>(StageObject));
+	}
+	Root->SetArrayField(TEXT("stages"), Stages);
+
+	TArray<TSharedPtr<FJsonValue>> Phases;
+	for (const FCompilePhaseTiming& Phase : Telemetry.Phases)
+	{
+		TSharedRef<FJsonObject> PhaseObject = MakeShared<FJsonObject>();
+		PhaseObject->SetStringField(TEXT("tool"), Phase.ToolName);
+		PhaseObject->SetStringField(TEXT("phase"), Phase.Phase);
+		PhaseObject->SetNumberField(TEXT("seconds"), Phase.Seconds);
+		Phases.Add(MakeShared<FJsonValueObject>(PhaseObject));
+	}
+	Root->SetArrayField(TEXT("phases"), Phases);
+
+	TSharedRef<FJsonObject> Leak = MakeShared<FJsonObject>();
+	Leak->SetBoolField(TEXT("leaked"), Telemetry.bLeaked);
+	Leak->SetStringField(TEXT("entity"), Telemetry.LeakEntity);
+	Leak->SetStringField(TEXT("pointfile"), Telemetry.PointfilePath);
+	Root->SetObjectField(TEXT("leak"), Leak);
+
+	TSharedRef<FJsonObject> Vis = MakeShared<FJsonObject>();
+	Vis->SetNumberField(TEXT("portalClusters"), Telemetry.PortalClusters);
+	Vis->SetNumberField(TEXT("portals"), Telemetry.Portals);
+	Vis->SetNumberField(TEXT("averageClustersVisible"), Telemetry.AverageClustersVisible);
+	Root->SetObjectField(TEXT("vis"), Vis);
+
+	TSharedRef<FJsonObject> Rad = MakeShared<FJsonObject>();
+	Rad->SetNumberField(TEXT("directLights"), Telemetry.DirectLights);
+	Rad->SetNumberField(TEXT("bounces"), Telemetry.Bounces);
+	Rad->SetNumberField(TEXT("lastBounceEnergy"), (double)Telemetry.LastBounceEnergy);
+	Rad->SetNumberField(TEXT("lightmapBytes"), (double)Telemetry.LightmapBytes);
+	Rad->SetNumberField(TEXT("lightmapTexels"), (double)Telemetry.GetLightmapTexels());
+	Root->SetObjectField(TEXT("rad"), Rad);
+
+	FString Json;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	if (!FJsonSerializer::Serialize(Root, Writer))
+	{
+		return false;
+	}
+
+	FString ReportPath = GetReportPath(VMFPath);
+	if (!FFileHelper::SaveStringToFile(Json, *ReportPath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SourceBridge: Failed to write compile report %s"), *ReportPath);
+		return false;
+	}
+	return true;
+}
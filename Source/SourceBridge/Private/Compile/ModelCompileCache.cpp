@@ -0,0 +1,316 @@
+#include "Compile/ModelCompileCache.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Hash/CityHash.h"
+
+// Written last when an entry is stored; its timestamp is the entry's last use
+static const TCHAR* MODEL_CACHE_STAMP = TEXT("lastused");
+
+// Everything studiomdl writes for one model, by the part after "<name>."
+static const TCHAR* MODEL_OUTPUT_SUFFIXES[] = {
+	TEXT("mdl"), TEXT("vvd"), TEXT("phy"), TEXT("ani"),
+	TEXT("vtx"), TEXT("dx80.vtx"), TEXT("dx90.vtx"), TEXT("sw.vtx"), TEXT("xbox.vtx"),
+};
+
+static FThreadSafeCounter GModelCacheHits;
+static FThreadSafeCounter GModelCacheMisses;
+static FCriticalSection GModelCacheTrimLock;
+
+namespace
+{
+	uint64 HashBytes(uint64 Hash, const void* Data, int64 Size)
+	{
+		Hash = CityHash64WithSeed(reinterpret_cast<const char*>(&Size), sizeof(Size), Hash);
+		return Size > 0 ? CityHash64WithSeed(reinterpret_cast<const char*>(Data), (uint32)Size, Hash) : Hash;
+	}
+
+	uint64 HashString(uint64 Hash, const FString& Value)
+	{
+		FTCHARToUTF8 Utf8(*Value);
+		return HashBytes(Hash, Utf8.Get(), Utf8.Length());
+	}
+
+	/** Quoted file names in a QC that studiomdl reads (SMDs, flex VTAs, included QCIs). */
+	TArray<FString> FindReferencedFiles(const FString& QCContent)
+	{
+		TArray<FString> Files;
+		int32 Pos = 0;
+		while (Pos < QCContent.Len())
+		{
+			int32 Open = QCContent.Find(TEXT("\""), ESearchCase::CaseSensitive, ESearchDir::FromStart, Pos);
+			if (Open == INDEX_NONE) break;
+			int32 Close = QCContent.Find(TEXT("\""), ESearchCase::CaseSensitive, ESearchDir::FromStart, Open + 1);
+			if (Close == INDEX_NONE) break;
+
+			FString Token = QCContent.Mid(Open + 1, Close - Open - 1);
+			FString Ext = FPaths::GetExtension(Token).ToLower();
+			if (Ext == TEXT("smd") || Ext == TEXT("dmx") || Ext == TEXT("vta") || Ext == TEXT("qci"))
+			{
+				Files.Add(Token);
+			}
+			Pos = Close + 1;
+		}
+		return Files;
+	}
+
+	int64 GetDirectorySize(const FString& Dir)
+	{
+		int64 Bytes = 0;
+		IFileManager::Get().IterateDirectoryStat(*Dir, [&Bytes](const TCHAR*, const FFileStatData& Stat)
+		{
+			if (!Stat.bIsDirectory)
+			{
+				Bytes += Stat.FileSize;
+			}
+			return true;
+		});
+		return Bytes;
+	}
+}
+
+FString FModelCompileCache::GetCacheRoot()
+{
+	return FPaths::ProjectSavedDir() / TEXT("SourceBridge") / TEXT("ModelCache");
+}
+
+uint64 FModelCompileCache::ComputeKey(const FString& QCPath, const FString& StudioMDLPath, const FString& GameDir)
+{
+	FString QCContent;
+	if (!FFileHelper::LoadFileToString(QCContent, *QCPath))
+	{
+		return 0;
+	}
+
+	uint64 Hash = 0x53424D444C434143ull;
+	Hash = HashString(Hash, QCContent);
+
+	// Referenced files resolve relative to the QC, like studiomdl does
+	FString QCDir = FPaths::GetPath(QCPath);
+	for (const FString& File : FindReferencedFiles(QCContent))
+	{
+		FString FullPath = FPaths::IsRelative(File) ? QCDir / File : File;
+		TArray<uint8> Bytes;
+		if (FFileHelper::LoadFileToArray(Bytes, *FullPath, FILEREAD_Silent))
+		{
+			Hash = HashBytes(Hash, Bytes.GetData(), Bytes.Num());
+		}
+		else
+		{
+			Hash = HashBytes(Hash, nullptr, -1);
+		}
+	}
+
+	// The tool is identified by path, size and timestamp rather than hashing the executable
+	Hash = HashString(Hash, StudioMDLPath.ToLower());
+	int64 ToolSize = IFileManager::Get().FileSize(*StudioMDLPath);
+	int64 ToolTime = IFileManager::Get().GetTimeStamp(*StudioMDLPath).GetTicks();
+	Hash = HashBytes(Hash, &ToolSize, sizeof(ToolSize));
+	Hash = HashBytes(Hash, &ToolTime, sizeof(ToolTime));
+	Hash = HashString(Hash, FPaths::ConvertRelativePathToFull(GameDir).ToLower());
+
+	return Hash != 0 ? Hash : 1;
+}
+
+FString FModelCompileCache::ReadModelName(const FString& QCPath)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *QCPath))
+	{
+		return FString();
+	}
+
+	for (const FString& RawLine : Lines)
+	{
+		FString Line = RawLine.TrimStartAndEnd();
+		if (!Line.StartsWith(TEXT("$modelname"), ESearchCase::IgnoreCase))
+		{
+			continue;
+		}
+
+		FString Name = Line.Mid(10).TrimStartAndEnd().TrimQuotes();
+		Name.ReplaceInline(TEXT("\\"), TEXT("/"));
+		if (Name.EndsWith(TEXT(".mdl"), ESearchCase::IgnoreCase))
+		{
+			Name.LeftChopInline(4);
+		}
+		return Name;
+	}
+	return FString();
+}
+
+TArray<FString> FModelCompileCache::FindOutputs(const FString& GameDir, const FString& ModelName, const FDateTime& MinTime)
+{
+	FString Dir = GameDir / TEXT("models") / FPaths::GetPath(ModelName);
+	FString Base = FPaths::GetCleanFilename(ModelName);
+
+	TArray<FString> Found;
+	IFileManager::Get().FindFiles(Found, *(Dir / Base + TEXT(".*")), true, false);
+
+	TArray<FString> Outputs;
+	for (const FString& File : Found)
+	{
+		FString Suffix = File.Mid(Base.Len() + 1);
+		bool bIsOutput = false;
+		for (const TCHAR* Known : MODEL_OUTPUT_SUFFIXES)
+		{
+			bIsOutput |= Suffix.Equals(Known, ESearchCase::IgnoreCase);
+		}
+
+		FString FullPath = Dir / File;
+		if (bIsOutput && IFileManager::Get().GetTimeStamp(*FullPath) >= MinTime)
+		{
+			Outputs.Add(FullPath);
+		}
+	}
+	return Outputs;
+}
+
+bool FModelCompileCache::Restore(uint64 Key, const FString& GameDir, const FString& ModelName)
+{
+	FString EntryDir = GetCacheRoot() / FString::Printf(TEXT("%016llx"), Key);
+	FString StampPath = EntryDir / MODEL_CACHE_STAMP;
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (Key == 0 || ModelName.IsEmpty() || !PlatformFile.FileExists(*StampPath))
+	{
+		GModelCacheMisses.Increment();
+		return false;
+	}
+
+	TArray<FString> Cached;
+	IFileManager::Get().FindFiles(Cached, *(EntryDir / TEXT("*.*")), true, false);
+	Cached.Remove(MODEL_CACHE_STAMP);
+
+	// Outputs from other compiles of this model (e.g. a .phy the cached set lacks) must not survive
+	FString TargetDir = GameDir / TEXT("models") / FPaths::GetPath(ModelName);
+	PlatformFile.CreateDirectoryTree(*TargetDir);
+	for (const FString& Stale : FindOutputs(GameDir, ModelName, FDateTime::MinValue()))
+	{
+		PlatformFile.DeleteFile(*Stale);
+	}
+
+	for (const FString& File : Cached)
+	{
+		if (!PlatformFile.CopyFile(*(TargetDir / File), *(EntryDir / File)))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SourceBridge: Failed to restore cached %s for %s"), *File, *ModelName);
+			GModelCacheMisses.Increment();
+			return false;
+		}
+	}
+
+	PlatformFile.SetTimeStamp(*StampPath, FDateTime::UtcNow());
+	GModelCacheHits.Increment();
+
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Restored compiled model %s from cache (%016llx)"), *ModelName, Key);
+	return true;
+}
+
+void FModelCompileCache::Store(uint64 Key, const FString& GameDir, const FString& ModelName, const FDateTime& CompileStartTime)
+{
+	if (Key == 0 || ModelName.IsEmpty())
+	{
+		return;
+	}
+
+	// Filesystem timestamps can be coarser than the clock
+	TArray<FString> Outputs = FindOutputs(GameDir, ModelName, CompileStartTime - FTimespan::FromSeconds(2.0));
+	if (!Outputs.ContainsByPredicate([](const FString& File) { return File.EndsWith(TEXT(".mdl"), ESearchCase::IgnoreCase); }))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SourceBridge: No compiled .mdl found for %s; not cached"), *ModelName);
+		return;
+	}
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	FString EntryDir = GetCacheRoot() / FString::Printf(TEXT("%016llx"), Key);
+	PlatformFile.CreateDirectoryTree(*EntryDir);
+
+	for (const FString& Output : Outputs)
+	{
+		if (!PlatformFile.CopyFile(*(EntryDir / FPaths::GetCleanFilename(Output)), *Output))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SourceBridge: Failed to cache %s"), *Output);
+			IFileManager::Get().DeleteDirectory(*EntryDir, false, true);
+			return;
+		}
+	}
+
+	// The stamp marks the entry complete
+	FFileHelper::SaveStringToFile(ModelName, *(EntryDir / MODEL_CACHE_STAMP));
+}
+
+void FModelCompileCache::Trim(int64 BudgetBytes)
+{
+	FScopeLock ScopeLock(&GModelCacheTrimLock);
+
+	struct FEntry
+	{
+		FString Dir;
+		int64 Bytes = 0;
+		FDateTime LastUsed;
+	};
+
+	TArray<FString> Dirs;
+	IFileManager::Get().FindFiles(Dirs, *(GetCacheRoot() / TEXT("*")), false, true);
+
+	TArray<FEntry> Entries;
+	int64 TotalBytes = 0;
+	for (const FString& Name : Dirs)
+	{
+		FEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.Dir = GetCacheRoot() / Name;
+		Entry.Bytes = GetDirectorySize(Entry.Dir);
+		// Unfinished entries (no stamp) sort first and go first
+		Entry.LastUsed = IFileManager::Get().GetTimeStamp(*(Entry.Dir / MODEL_CACHE_STAMP));
+		TotalBytes += Entry.Bytes;
+	}
+
+	if (TotalBytes <= BudgetBytes)
+	{
+		return;
+	}
+
+	Entries.Sort([](const FEntry& A, const FEntry& B) { return A.LastUsed < B.LastUsed; });
+
+	int32 Removed = 0;
+	for (const FEntry& Entry : Entries)
+	{
+		if (TotalBytes <= BudgetBytes)
+		{
+			break;
+		}
+		IFileManager::Get().DeleteDirectory(*Entry.Dir, false, true);
+		TotalBytes -= Entry.Bytes;
+		Removed++;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Trimmed %d model cache entries, %.1f MB left"),
+		Removed, TotalBytes / (1024.0 * 1024.0));
+}
+
+FModelCacheStats FModelCompileCache::GetStats()
+{
+	FModelCacheStats Stats;
+	Stats.Hits = GModelCacheHits.GetValue();
+	Stats.Misses = GModelCacheMisses.GetValue();
+
+	TArray<FString> Dirs;
+	IFileManager::Get().FindFiles(Dirs, *(GetCacheRoot() / TEXT("*")), false, true);
+	for (const FString& Name : Dirs)
+	{
+		Stats.EntryCount++;
+		Stats.TotalBytes += GetDirectorySize(GetCacheRoot() / Name);
+	}
+	return Stats;
+}
+
+void FModelCompileCache::Clear()
+{
+	FScopeLock ScopeLock(&GModelCacheTrimLock);
+	IFileManager::Get().DeleteDirectory(*GetCacheRoot(), false, true);
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Model compile cache cleared."));
+}
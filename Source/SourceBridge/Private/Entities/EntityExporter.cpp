@@ -13,7 +13,9 @@
 #include "Engine/PointLight.h"
 #include "Engine/SpotLight.h"
 #include "Engine/DirectionalLight.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
 #include "Import/VMFImporter.h"
+#include "Import/BSPStaticProps.h"
 
 // ---- FSourceEntity ----
 
@@ -84,6 +86,11 @@ FEntityExportResult FEntityExporter::ExportEntities(UWorld* World)
 			continue;
 		}
 
+		if (TryExportStaticPropGroup(Actor, Result))
+		{
+			continue;
+		}
+
 		// Export custom ASourceEntityActor instances
 		ASourceEntityActor* SourceActor = Cast<ASourceEntityActor>(Actor);
 		if (SourceActor && !SourceActor->SourceClassname.IsEmpty())
@@ -633,6 +640,89 @@ bool FEntityExporter::TryExportWaterVolume(AActor* Actor, FEntityExportResult& R
 	return true;
 }
 
+bool FEntityExporter::TryExportStaticPropGroup(AActor* Actor, FEntityExportResult& Result)
+{
+	ASourceStaticPropGroup* Group = Cast<ASourceStaticPropGroup>(Actor);
+	if (!Group)
+	{
+		return false;
+	}
+
+	UHierarchicalInstancedStaticMeshComponent* Instances = Group->InstancesComponent;
+	if (!Instances || Group->ModelPath.IsEmpty())
+	{
+		return true;
+	}
+
+	for (int32 i = 0; i < Instances->GetInstanceCount(); ++i)
+	{
+		FTransform Transform;
+		if (!Instances->GetInstanceTransform(i, Transform, true))
+		{
+			continue;
+		}
+
+		FSourceEntity Entity;
+		Entity.ClassName = TEXT("prop_static");
+		Entity.Origin = Transform.GetLocation();
+		Entity.Angles = Transform.Rotator();
+
+		Entity.AddKeyValue(TEXT("model"), Group->ModelPath);
+		Entity.AddKeyValue(TEXT("skin"), Group->Skin);
+		Entity.AddKeyValue(TEXT("solid"), Group->Solid);
+
+		const float ModelScale = Group->InstanceScales.IsValidIndex(i) ? Group->InstanceScales[i] : 1.0f;
+		if (!FMath::IsNearlyEqual(ModelScale, 1.0f, 0.001f))
+		{
+			Entity.AddKeyValue(TEXT("modelscale"), FString::Printf(TEXT("%g"), ModelScale));
+		}
+
+		if (Group->FadeMinDist > 0.0f)
+		{
+			Entity.AddKeyValue(TEXT("fademindist"), FString::Printf(TEXT("%g"), Group->FadeMinDist));
+		}
+		if (Group->FadeMaxDist > 0.0f)
+		{
+			Entity.AddKeyValue(TEXT("fademaxdist"), FString::Printf(TEXT("%g"), Group->FadeMaxDist));
+		}
+
+		const int32 Flags = Group->InstanceFlags.IsValidIndex(i) ? Group->InstanceFlags[i] : 0;
+		if (Group->bDisableShadows)
+		{
+			Entity.AddKeyValue(TEXT("disableshadows"), 1);
+		}
+		if (Flags & EBSPStaticPropFlags::NoPerVertexLighting)
+		{
+			Entity.AddKeyValue(TEXT("disablevertexlighting"), 1);
+		}
+		if (Flags & EBSPStaticPropFlags::NoSelfShadowing)
+		{
+			Entity.AddKeyValue(TEXT("disableselfshadowing"), 1);
+		}
+		if (Flags & EBSPStaticPropFlags::IgnoreNormals)
+		{
+			Entity.AddKeyValue(TEXT("ignorenormals"), 1);
+		}
+
+		if (Group->InstanceColors.IsValidIndex(i))
+		{
+			const FColor& Color = Group->InstanceColors[i];
+			if (Color.R != 255 || Color.G != 255 || Color.B != 255)
+			{
+				Entity.AddKeyValue(TEXT("rendercolor"), FString::Printf(TEXT("%d %d %d"), Color.R, Color.G, Color.B));
+			}
+			if (Color.A != 255)
+			{
+				Entity.AddKeyValue(TEXT("renderamt"), Color.A);
+			}
+		}
+
+		Result.Entities.Add(MoveTemp(Entity));
+	}
+
+	return true;
+}
+
 bool FEntityExporter::TryExportBrushEntity(AActor* Actor, FEntityExportResult& Result)
 {
 	ASourceBrushEntity* BrushEntity = Cast<ASourceBrushEntity>(Actor);
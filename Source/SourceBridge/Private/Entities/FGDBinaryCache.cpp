@@ -0,0 +1,153 @@
+#include "Entities/FGDBinaryCache.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+static const uint32 FGD_CACHE_MAGIC = 0x43444746; // "FGDC"
+static const uint32 FGD_CACHE_VERSION = 1;
+
+static FArchive& operator<<(FArchive& Ar, FFGDChoice& Choice)
+{
+	return Ar << Choice.Value << Choice.DisplayName;
+}
+
+static FArchive& operator<<(FArchive& Ar, FFGDFlag& Flag)
+{
+	return Ar << Flag.Bit << Flag.DisplayName << Flag.bDefaultOn;
+}
+
+static FArchive& operator<<(FArchive& Ar, FFGDProperty& Prop)
+{
+	uint8 Type = (uint8)Prop.Type;
+	Ar << Prop.Name << Prop.DisplayName << Type << Prop.DefaultValue << Prop.Description;
+	Ar << Prop.Choices << Prop.Flags << Prop.bReadOnly;
+	Prop.Type = Type <= (uint8)EFGDPropertyType::Unknown ? (EFGDPropertyType)Type : EFGDPropertyType::Unknown;
+	return Ar;
+}
+
+static FArchive& operator<<(FArchive& Ar, FFGDIODef& IO)
+{
+	return Ar << IO.Name << IO.ParamType << IO.Description;
+}
+
+static FArchive& operator<<(FArchive& Ar, FFGDEntityClass& Class)
+{
+	Ar << Class.ClassName << Class.ClassType << Class.Description << Class.BaseClasses;
+	Ar << Class.EditorModel << Class.IconSprite << Class.Color << Class.SizeMins << Class.SizeMaxs;
+	Ar << Class.Properties << Class.Inputs << Class.Outputs;
+	Ar << Class.bIsSolid << Class.bIsBase;
+	return Ar;
+}
+
+static FArchive& operator<<(FArchive& Ar, FFGDSourceFile& File)
+{
+	return Ar << File.Path << File.Size << File.Crc;
+}
+
+FString FFGDBinaryCache::GetCachePath(const FString& AbsFGDPath)
+{
+	// Same-named FGDs from different games must not share a cache
+	FString FileName = FString::Printf(TEXT("%s_%08x.fgdc"),
+		*FPaths::GetBaseFilename(AbsFGDPath), FCrc::StrCrc32(*AbsFGDPath.ToLower()));
+	return FPaths::ProjectSavedDir() / TEXT("SourceBridge") / TEXT("FGDCache") / FileName;
+}
+
+FFGDSourceFile FFGDBinaryCache::HashFile(const FString& AbsPath)
+{
+	FFGDSourceFile Result;
+	Result.Path = AbsPath;
+
+	TArray<uint8> Bytes;
+	if (FFileHelper::LoadFileToArray(Bytes, *AbsPath, FILEREAD_Silent))
+	{
+		Result.Size = Bytes.Num();
+		Result.Crc = FCrc::MemCrc32(Bytes.GetData(), Bytes.Num());
+	}
+	return Result;
+}
+
+bool FFGDBinaryCache::Write(const FString& AbsFGDPath, const FFGDDatabase& Database,
+	const TArray<FFGDSourceFile>& SourceFiles)
+{
+	TArray<uint8> Out;
+	FMemoryWriter Writer(Out);
+
+	uint32 Magic = FGD_CACHE_MAGIC;
+	uint32 Version = FGD_CACHE_VERSION;
+	Writer << Magic << Version;
+	Writer << const_cast<TArray<FFGDSourceFile>&>(SourceFiles);
+	Writer << const_cast<TMap<FString, FFGDEntityClass>&>(Database.Classes);
+	Writer << const_cast<TArray<FString>&>(Database.Warnings);
+
+	FString CachePath = GetCachePath(AbsFGDPath);
+	if (!FFileHelper::SaveArrayToFile(Out, *CachePath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SourceBridge: Failed to write FGD cache '%s'"), *CachePath);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Wrote FGD cache '%s' (%d classes, %d source files, %d bytes)"),
+		*CachePath, Database.Classes.Num(), SourceFiles.Num(), Out.Num());
+	return true;
+}
+
+bool FFGDBinaryCache::TryRead(const FString& AbsFGDPath, FFGDDatabase& OutDatabase)
+{
+	FString CachePath = GetCachePath(AbsFGDPath);
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *CachePath, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	Reader << Magic << Version;
+	if (Reader.IsError() || Magic != FGD_CACHE_MAGIC || Version != FGD_CACHE_VERSION)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SourceBridge: Ignoring invalid FGD cache '%s'"), *CachePath);
+		return false;
+	}
+
+	TArray<FFGDSourceFile> SourceFiles;
+	Reader << SourceFiles;
+	if (Reader.IsError() || SourceFiles.Num() == 0 || !SourceFiles[0].Path.Equals(AbsFGDPath, ESearchCase::IgnoreCase))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SourceBridge: Ignoring invalid FGD cache '%s'"), *CachePath);
+		return false;
+	}
+
+	// Cheap size check first; only hash files whose size still matches
+	for (const FFGDSourceFile& Recorded : SourceFiles)
+	{
+		int64 CurrentSize = IFileManager::Get().FileSize(*Recorded.Path);
+		if (CurrentSize < 0)
+		{
+			CurrentSize = -1;
+		}
+
+		if (CurrentSize != Recorded.Size
+			|| (Recorded.Size >= 0 && HashFile(Recorded.Path).Crc != Recorded.Crc))
+		{
+			UE_LOG(LogTemp, Log, TEXT("SourceBridge: '%s' changed, reparsing FGD"), *Recorded.Path);
+			return false;
+		}
+	}
+
+	FFGDDatabase Loaded;
+	Reader << Loaded.Classes;
+	Reader << Loaded.Warnings;
+	if (Reader.IsError() || !Reader.AtEnd())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SourceBridge: Ignoring corrupt FGD cache '%s'"), *CachePath);
+		return false;
+	}
+
+	OutDatabase = MoveTemp(Loaded);
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Loaded FGD cache '%s' (%d classes)"), *CachePath, OutDatabase.Classes.Num());
+	return true;
+}
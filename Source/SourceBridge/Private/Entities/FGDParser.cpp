@@ -1,43 +1,66 @@
 #include "Entities/FGDParser.h"
+#include "Entities/FGDBinaryCache.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
+#include "Algo/Reverse.h"
 
 // ---- FFGDEntityClass ----
 
-const FFGDProperty* FFGDEntityClass::FindProperty(const FString& Name) const
+template<typename T>
+static const T* FindByName(const TArray<T>& Items, const TMap<FString, int32>& Lookup, bool bHasLookup, const FString& Name)
 {
-	for (const FFGDProperty& Prop : Properties)
+	if (bHasLookup)
 	{
-		if (Prop.Name.Equals(Name, ESearchCase::IgnoreCase))
+		const int32* Index = Lookup.Find(Name);
+		return Index ? &Items[*Index] : nullptr;
+	}
+
+	for (const T& Item : Items)
+	{
+		if (Item.Name.Equals(Name, ESearchCase::IgnoreCase))
 		{
-			return &Prop;
+			return &Item;
 		}
 	}
 	return nullptr;
 }
 
-const FFGDIODef* FFGDEntityClass::FindInput(const FString& Name) const
+template<typename T>
+static void BuildNameLookup(const TArray<T>& Items, TMap<FString, int32>& OutLookup)
 {
-	for (const FFGDIODef& IO : Inputs)
+	OutLookup.Reset();
+	OutLookup.Reserve(Items.Num());
+	for (int32 i = 0; i < Items.Num(); ++i)
 	{
-		if (IO.Name.Equals(Name, ESearchCase::IgnoreCase))
+		// FString keys hash and compare case-insensitively
+		if (!OutLookup.Contains(Items[i].Name))
 		{
-			return &IO;
+			OutLookup.Add(Items[i].Name, i);
 		}
 	}
-	return nullptr;
+}
+
+const FFGDProperty* FFGDEntityClass::FindProperty(const FString& Name) const
+{
+	return FindByName(Properties, PropertyLookup, bHasLookup, Name);
+}
+
+const FFGDIODef* FFGDEntityClass::FindInput(const FString& Name) const
+{
+	return FindByName(Inputs, InputLookup, bHasLookup, Name);
 }
 
 const FFGDIODef* FFGDEntityClass::FindOutput(const FString& Name) const
 {
-	for (const FFGDIODef& IO : Outputs)
-	{
-		if (IO.Name.Equals(Name, ESearchCase::IgnoreCase))
-		{
-			return &IO;
-		}
-	}
-	return nullptr;
+	return FindByName(Outputs, OutputLookup, bHasLookup, Name);
+}
+
+void FFGDEntityClass::BuildLookup()
+{
+	BuildNameLookup(Properties, PropertyLookup);
+	BuildNameLookup(Inputs, InputLookup);
+	BuildNameLookup(Outputs, OutputLookup);
+	bHasLookup = true;
 }
 
 // ---- FFGDDatabase ----
@@ -91,60 +114,124 @@ TArray<FString> FFGDDatabase::GetSolidClassNames() const
 
 FFGDEntityClass FFGDDatabase::GetResolved(const FString& ClassName) const
 {
-	TSet<FString> Visited;
-	return GetResolvedInternal(ClassName, Visited);
+	TSharedPtr<const FFGDEntityClass> Resolved = FindResolved(ClassName);
+	return Resolved.IsValid() ? *Resolved : FFGDEntityClass();
 }
 
-FFGDEntityClass FFGDDatabase::GetResolvedInternal(const FString& ClassName, TSet<FString>& Visited) const
+TSharedPtr<const FFGDEntityClass> FFGDDatabase::FindResolved(const FString& ClassName) const
 {
+	if (const TSharedPtr<const FFGDEntityClass>* Resolved = ResolvedClasses.Find(ClassName))
+	{
+		return *Resolved;
+	}
+
+	// Table not built (database assembled by hand): resolve into a throwaway copy.
+	// Slow, but FFGDParser always builds the table.
+	if (ResolvedClasses.Num() == 0 && FindClass(ClassName))
+	{
+		FFGDDatabase Scratch;
+		Scratch.Classes = Classes;
+		TSet<FString> InProgress;
+		return Scratch.ResolveMemoized(ClassName, InProgress);
+	}
+
+	return nullptr;
+}
+
+void FFGDDatabase::BuildResolvedTable()
+{
+	ResolvedClasses.Reset();
+	ResolvedClasses.Reserve(Classes.Num());
+
+	TSet<FString> InProgress;
+	for (const auto& Pair : Classes)
+	{
+		ResolveMemoized(Pair.Key, InProgress);
+	}
+}
+
+TSharedPtr<const FFGDEntityClass> FFGDDatabase::ResolveMemoized(const FString& ClassName, TSet<FString>& InProgress)
+{
+	if (const TSharedPtr<const FFGDEntityClass>* Existing = ResolvedClasses.Find(ClassName))
+	{
+		return *Existing;
+	}
+
 	const FFGDEntityClass* Class = FindClass(ClassName);
 	if (!Class)
 	{
-		return FFGDEntityClass();
+		return nullptr;
 	}
 
-	// Cycle detection: if we've already visited this class, stop recursion
-	if (Visited.Contains(ClassName))
+	// Cycle detection: a class that is still being resolved contributes only its own members
+	if (InProgress.Contains(ClassName))
 	{
-		return *Class;
+		TSharedPtr<FFGDEntityClass> Unresolved = MakeShared<FFGDEntityClass>(*Class);
+		Unresolved->BuildLookup();
+		return Unresolved;
 	}
-	Visited.Add(ClassName);
+	InProgress.Add(ClassName);
 
-	FFGDEntityClass Resolved = *Class;
+	TSharedPtr<FFGDEntityClass> Resolved = MakeShared<FFGDEntityClass>(*Class);
+
+	// Merge base classes (depth-first, earliest base = lowest priority).
+	// Each missing base property goes to the front, so they are collected and prepended
+	// in reverse once instead of inserting at index 0 per property.
+	TArray<FFGDProperty> Prepended;
+	TSet<FString> PropertyNames, InputNames, OutputNames;
+	for (const FFGDProperty& Prop : Resolved->Properties) PropertyNames.Add(Prop.Name);
+	for (const FFGDIODef& IO : Resolved->Inputs) InputNames.Add(IO.Name);
+	for (const FFGDIODef& IO : Resolved->Outputs) OutputNames.Add(IO.Name);
 
-	// Merge base classes (depth-first, earliest base = lowest priority)
 	for (int32 i = Class->BaseClasses.Num() - 1; i >= 0; --i)
 	{
-		FFGDEntityClass BaseResolved = GetResolvedInternal(Class->BaseClasses[i], Visited);
+		TSharedPtr<const FFGDEntityClass> BaseResolved = ResolveMemoized(Class->BaseClasses[i], InProgress);
+		if (!BaseResolved.IsValid())
+		{
+			continue;
+		}
 
 		// Add base properties that don't already exist in Resolved
-		for (const FFGDProperty& BaseProp : BaseResolved.Properties)
+		for (const FFGDProperty& BaseProp : BaseResolved->Properties)
 		{
-			if (!Resolved.FindProperty(BaseProp.Name))
+			if (!PropertyNames.Contains(BaseProp.Name))
 			{
-				Resolved.Properties.Insert(BaseProp, 0);
+				PropertyNames.Add(BaseProp.Name);
+				Prepended.Add(BaseProp);
 			}
 		}
 
 		// Add base inputs that don't already exist
-		for (const FFGDIODef& BaseIO : BaseResolved.Inputs)
+		for (const FFGDIODef& BaseIO : BaseResolved->Inputs)
 		{
-			if (!Resolved.FindInput(BaseIO.Name))
+			if (!InputNames.Contains(BaseIO.Name))
 			{
-				Resolved.Inputs.Add(BaseIO);
+				InputNames.Add(BaseIO.Name);
+				Resolved->Inputs.Add(BaseIO);
 			}
 		}
 
 		// Add base outputs that don't already exist
-		for (const FFGDIODef& BaseIO : BaseResolved.Outputs)
+		for (const FFGDIODef& BaseIO : BaseResolved->Outputs)
 		{
-			if (!Resolved.FindOutput(BaseIO.Name))
+			if (!OutputNames.Contains(BaseIO.Name))
 			{
-				Resolved.Outputs.Add(BaseIO);
+				OutputNames.Add(BaseIO.Name);
+				Resolved->Outputs.Add(BaseIO);
 			}
 		}
 	}
 
+	if (Prepended.Num() > 0)
+	{
+		Algo::Reverse(Prepended);
+		Prepended.Append(MoveTemp(Resolved->Properties));
+		Resolved->Properties = MoveTemp(Prepended);
+	}
+	Resolved->BuildLookup();
+
+	InProgress.Remove(ClassName);
+	ResolvedClasses.Add(ClassName, Resolved);
 	return Resolved;
 }
 
@@ -154,15 +241,13 @@ TArray<FString> FFGDDatabase::ValidateEntity(
 {
 	TArray<FString> ValidationWarnings;
 
-	const FFGDEntityClass* Class = FindClass(ClassName);
-	if (!Class)
+	TSharedPtr<const FFGDEntityClass> Resolved = FindResolved(ClassName);
+	if (!Resolved.IsValid())
 	{
 		ValidationWarnings.Add(FString::Printf(TEXT("Unknown entity class '%s'. Not found in FGD."), *ClassName));
 		return ValidationWarnings;
 	}
 
-	FFGDEntityClass Resolved = GetResolved(ClassName);
-
 	for (const auto& KV : KeyValues)
 	{
 		// Skip standard keys that all entities have
@@ -174,7 +259,7 @@ TArray<FString> FFGDDatabase::ValidateEntity(
 			continue;
 		}
 
-		const FFGDProperty* Prop = Resolved.FindProperty(KV.Key);
+		const FFGDProperty* Prop = Resolved->FindProperty(KV.Key);
 		if (!Prop)
 		{
 			ValidationWarnings.Add(FString::Printf(
@@ -214,8 +299,8 @@ FString FFGDDatabase::ValidateIOConnection(
 	// Validate output exists on source entity
 	if (!SourceClass.IsEmpty())
 	{
-		FFGDEntityClass SourceResolved = GetResolved(SourceClass);
-		if (!SourceResolved.FindOutput(OutputName))
+		TSharedPtr<const FFGDEntityClass> SourceResolved = FindResolved(SourceClass);
+		if (!SourceResolved.IsValid() || !SourceResolved->FindOutput(OutputName))
 		{
 			return FString::Printf(
 				TEXT("Entity '%s' has no output '%s'."),
@@ -226,8 +311,8 @@ FString FFGDDatabase::ValidateIOConnection(
 	// Validate input exists on target entity
 	if (!TargetClass.IsEmpty())
 	{
-		FFGDEntityClass TargetResolved = GetResolved(TargetClass);
-		if (!TargetResolved.FindInput(InputName))
+		TSharedPtr<const FFGDEntityClass> TargetResolved = FindResolved(TargetClass);
+		if (!TargetResolved.IsValid() || !TargetResolved->FindInput(InputName))
 		{
 			return FString::Printf(
 				TEXT("Entity '%s' has no input '%s'."),
@@ -263,18 +348,30 @@ FFGDDatabase FFGDParser::ParseFile(const FString& FilePath)
 	FFGDDatabase Database;
 
 	FString AbsPath = FPaths::ConvertRelativePathToFull(FilePath);
-	FString Content;
 
-	if (!FFileHelper::LoadFileToString(Content, *AbsPath))
+	if (FFGDBinaryCache::TryRead(AbsPath, Database))
 	{
-		Database.Warnings.Add(FString::Printf(TEXT("Failed to read FGD file: %s"), *AbsPath));
+		Database.BuildResolvedTable();
+		UE_LOG(LogTemp, Log, TEXT("SourceBridge: Loaded FGD '%s' from cache: %d entity classes (%d warnings)."),
+			*FPaths::GetCleanFilename(FilePath), Database.Classes.Num(), Database.Warnings.Num());
 		return Database;
 	}
 
 	FParseContext Context{ Database, FPaths::GetPath(AbsPath), {} };
+
+	FString Content;
+	if (!LoadSourceFile(AbsPath, Content, Context.SourceFiles))
+	{
+		Database.Warnings.Add(FString::Printf(TEXT("Failed to read FGD file: %s"), *AbsPath));
+		return Database;
+	}
+
 	Context.IncludedFiles.Add(AbsPath.ToLower());
 
 	ParseContent(Content, Context);
+	Database.BuildResolvedTable();
+
+	FFGDBinaryCache::Write(AbsPath, Database, Context.SourceFiles);
 
 	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Parsed FGD '%s': %d entity classes (%d warnings)."),
 		*FPaths::GetCleanFilename(FilePath), Database.Classes.Num(), Database.Warnings.Num());
@@ -287,9 +384,27 @@ FFGDDatabase FFGDParser::ParseString(const FString& Content, const FString& Base
 	FFGDDatabase Database;
 	FParseContext Context{ Database, BaseDirectory, {} };
 	ParseContent(Content, Context);
+	Database.BuildResolvedTable();
 	return Database;
 }
 
+bool FFGDParser::LoadSourceFile(const FString& AbsPath, FString& OutContent, TArray<FFGDSourceFile>& SourceFiles)
+{
+	FFGDSourceFile& Source = SourceFiles.AddDefaulted_GetRef();
+	Source.Path = AbsPath;
+
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *AbsPath, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	Source.Size = Bytes.Num();
+	Source.Crc = FCrc::MemCrc32(Bytes.GetData(), Bytes.Num());
+	FFileHelper::BufferToString(OutContent, Bytes.GetData(), Bytes.Num());
+	return true;
+}
+
 void FFGDParser::ParseContent(const FString& Content, FParseContext& Context)
 {
 	int32 Pos = 0;
@@ -333,7 +448,7 @@ void FFGDParser::ParseContent(const FString& Content, FParseContext& Context)
 					Context.IncludedFiles.Add(Key);
 
 					FString IncludeContent;
-					if (FFileHelper::LoadFileToString(IncludeContent, *FullPath))
+					if (LoadSourceFile(FullPath, IncludeContent, Context.SourceFiles))
 					{
 						FString OldBase = Context.BaseDirectory;
 						Context.BaseDirectory = FPaths::GetPath(FullPath);
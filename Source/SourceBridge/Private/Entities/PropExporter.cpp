@@ -505,8 +505,23 @@ FMeshToBrushResult FPropExporter::ConvertMeshToBrush(
 			Swap(P2, P3);
 		}
 
-		FString PlaneStr = FString::Printf(TEXT("(%g %g %g) (%g %g %g) (%g %g %g)"),
-			P1.X, P1.Y, P1.Z, P2.X, P2.Y, P2.Z, P3.X, P3.Y, P3.Z);
+		FString PlaneStr;
+		if (FVMFPlaneTable::IsEnabled())
+		{
+			TArray<FVector> SourceVerts;
+			SourceVerts.Reserve(Face.Vertices.Num());
+			for (const FVector& Vertex : Face.Vertices)
+			{
+				SourceVerts.Add(FSourceCoord::UEToSource(Vertex));
+			}
+			const FVector RawPoints[3] = { P1, P2, P3 };
+			PlaneStr = FVMFPlaneTable::GetPlaneString(SourceVerts, RawPoints, Result.Planes);
+		}
+		else
+		{
+			PlaneStr = FString::Printf(TEXT("(%g %g %g) (%g %g %g) (%g %g %g)"),
+				P1.X, P1.Y, P1.Z, P2.X, P2.Y, P2.Z, P3.X, P3.Y, P3.Z);
+		}
 
 		// Get UV axes based on the Source-space normal
 		FString UAxis, VAxis;
@@ -548,50 +563,3 @@ FMeshToBrushResult FPropExporter::ConvertMeshToBrush(
 
 	return Result;
 }
-
-TArray<FMeshToBrushResult> FPropExporter::CollectMeshBrushes(
-	UWorld* World,
-	int32& SolidIdCounter,
-	int32& SideIdCounter)
-{
-	TArray<FMeshToBrushResult> Results;
-
-	if (!World) return Results;
-
-	for (TActorIterator<AStaticMeshActor> It(World); It; ++It)
-	{
-		AStaticMeshActor* Actor = *It;
-		if (!Actor) continue;
-
-		// Check for noexport tag
-		bool bNoExport = false;
-		for (const FName& Tag : Actor->Tags)
-		{
-			if (Tag.ToString().Equals(TEXT("noexport"), ESearchCase::IgnoreCase))
-			{
-				bNoExport = true;
-				break;
-			}
-		}
-		if (bNoExport) continue;
-
-		TOptional<FString> BrushClass = ShouldConvertToBrush(Actor);
-		if (!BrushClass.IsSet()) continue;
-
-		FMeshToBrushResult Result = ConvertMeshToBrush(Actor, SolidIdCounter, SideIdCounter, BrushClass.GetValue());
-
-		if (!Result.bSuccess)
-		{
-			for (const FString& Warning : Result.Warnings)
-			{
-				UE_LOG(LogTemp, Warning, TEXT("SourceBridge: %s"), *Warning);
-			}
-		}
-		else
-		{
-			Results.Add(MoveTemp(Result));
-		}
-	}
-
-	return Results;
-}
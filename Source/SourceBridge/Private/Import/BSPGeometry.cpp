@@ -0,0 +1,829 @@
+#include "Import/BSPGeometry.h"
+#include "Import/BSPReader.h"
+
+// texinfo_t flags of faces the engine never draws
+static const int32 SURF_NODRAW = 0x0080;
+static const int32 SURF_HINT = 0x0100;
+static const int32 SURF_SKIP = 0x0200;
+
+// texinfo_t flags of the lightmap layout
+static const int32 SURF_NOLIGHT = 0x0400;
+static const int32 SURF_BUMPLIGHT = 0x0800;
+
+// Light styles per face; 255 ends the list
+static const int32 MAX_LIGHT_STYLES = 4;
+static const uint8 LIGHT_STYLE_NONE = 255;
+
+// Atlas layout: texels replicated around each block against bilinear bleeding, and the
+// fullbright block unlit faces sample
+static const int32 LIGHTMAP_PADDING = 1;
+static const int32 LIGHTMAP_FULLBRIGHT_SIZE = 4;
+static const int32 LIGHTMAP_MAX_ATLAS_WIDTH = 4096;
+
+// dprimitive_t types
+static const uint8 PRIM_TRILIST = 0;
+static const uint8 PRIM_TRISTRIP = 1;
+
+// dface_t::numPrims: the high bit marks faces with dynamic shadows disabled
+static const uint16 FACE_NUM_PRIMS_MASK = 0x7FFF;
+
+// Highest displacement power vbsp accepts (17x17 vertices)
+static const int32 MAX_DISP_POWER = 4;
+
+namespace
+{
+	// On-disk layouts of the lumps read here (BSP v19-21)
+
+	struct FBSPFace
+	{
+		uint16 PlaneNum;
+		uint8 Side;
+		uint8 OnNode;
+		int32 FirstEdge;
+		int16 NumEdges;
+		int16 TexInfo;
+		int16 DispInfo;
+		int16 SurfaceFogVolumeID;
+		uint8 Styles[4];
+		int32 LightOffset;
+		float Area;
+		int32 LightmapMins[2];
+		int32 LightmapSize[2];
+		int32 OrigFace;
+		uint16 NumPrims;
+		uint16 FirstPrimID;
+		uint32 SmoothingGroups;
+	};
+	static_assert(sizeof(FBSPFace) == 56, "dface_t is 56 bytes");
+
+	struct FBSPPlane
+	{
+		FVector3f Normal;
+		float Dist;
+		int32 Type;
+	};
+	static_assert(sizeof(FBSPPlane) == 20, "dplane_t is 20 bytes");
+
+	struct FBSPEdge
+	{
+		uint16 V[2];
+	};
+
+	struct FBSPTexInfo
+	{
+		float TextureVecs[2][4];
+		float LightmapVecs[2][4];
+		int32 Flags;
+		int32 TexData;
+	};
+	static_assert(sizeof(FBSPTexInfo) == 72, "texinfo_t is 72 bytes");
+
+	struct FBSPModel
+	{
+		FVector3f Mins;
+		FVector3f Maxs;
+		FVector3f Origin;
+		int32 HeadNode;
+		int32 FirstFace;
+		int32 NumFaces;
+	};
+	static_assert(sizeof(FBSPModel) == 48, "dmodel_t is 48 bytes");
+
+	struct FBSPPrimitive
+	{
+		uint8 Type;
+		uint16 FirstIndex;
+		uint16 IndexCount;
+		uint16 FirstVert;
+		uint16 VertCount;
+	};
+	static_assert(sizeof(FBSPPrimitive) == 10, "dprimitive_t is 10 bytes");
+
+	struct FBSPDispInfo
+	{
+		FVector3f StartPosition;
+		int32 DispVertStart;
+		int32 DispTriStart;
+		int32 Power;
+		int32 MinTess;
+		float SmoothingAngle;
+		int32 Contents;
+		uint16 MapFace;
+		uint16 Padding;
+		int32 LightmapAlphaStart;
+		int32 LightmapSamplePositionStart;
+		uint8 Neighbors[128];
+	};
+	static_assert(sizeof(FBSPDispInfo) == 176, "ddispinfo_t is 176 bytes");
+
+	struct FBSPDispVert
+	{
+		FVector3f Vec;
+		float Dist;
+		float Alpha;
+	};
+	static_assert(sizeof(FBSPDispVert) == 20, "dDispVert is 20 bytes");
+
+	/** All lumps a model's faces refer to. */
+	struct FBSPLumps
+	{
+		TArray<FBSPFace> Faces;
+		TArray<FBSPPlane> Planes;
+		TArray<FVector3f> Vertexes;
+		TArray<FBSPEdge> Edges;
+		TArray<int32> SurfEdges;
+		TArray<FBSPTexInfo> TexInfos;
+		TArray<FBSPTexData> TexData;
+		TArray<FBSPPrimitive> Primitives;
+		TArray<FVector3f> PrimVerts;
+		TArray<uint16> PrimIndices;
+		TArray<FBSPDispInfo> DispInfos;
+		TArray<FBSPDispVert> DispVerts;
+		TArray<FString> Materials;
+	};
+
+	/** A face's triangles before they are sorted into chunks. */
+	struct FFaceMesh
+	{
+		int32 TexData = INDEX_NONE;
+		TArray<FVector3f> Positions;
+		TArray<FVector3f> Normals;
+
+		/** Where UVs are taken from (the flat base surface for displacements) */
+		TArray<FVector3f> UVPositions;
+		TArray<int32> Indices;
+	};
+
+	/** Polygon corners of a face, in surfedge order. */
+	bool GetFaceVertices(const FBSPLumps& L, const FBSPFace& Face, TArray<FVector3f>& Out)
+	{
+		Out.Reset(Face.NumEdges);
+		for (int32 i = 0; i < Face.NumEdges; ++i)
+		{
+			int32 SurfEdgeIndex = Face.FirstEdge + i;
+			if (!L.SurfEdges.IsValidIndex(SurfEdgeIndex))
+			{
+				return false;
+			}
+			int32 SurfEdge = L.SurfEdges[SurfEdgeIndex];
+			int32 EdgeIndex = FMath::Abs(SurfEdge);
+			if (!L.Edges.IsValidIndex(EdgeIndex))
+			{
+				return false;
+			}
+			int32 Vertex = L.Edges[EdgeIndex].V[SurfEdge >= 0 ? 0 : 1];
+			if (!L.Vertexes.IsValidIndex(Vertex))
+			{
+				return false;
+			}
+			Out.Add(L.Vertexes[Vertex]);
+		}
+		return Out.Num() >= 3;
+	}
+
+	/** Add triangle A-B-C, ordered counter-clockwise around Normal. */
+	void AddTriangle(TArray<int32>& Indices, const TArray<FVector3f>& Positions, int32 A, int32 B, int32 C, const FVector3f& Normal)
+	{
+		FVector3f Winding = FVector3f::CrossProduct(Positions[B] - Positions[A], Positions[C] - Positions[A]);
+		Indices.Add(A);
+		if (FVector3f::DotProduct(Winding, Normal) >= 0.0f)
+		{
+			Indices.Add(B);
+			Indices.Add(C);
+		}
+		else
+		{
+			Indices.Add(C);
+			Indices.Add(B);
+		}
+	}
+
+	bool BuildPolygonFace(const FBSPLumps& L, const FBSPFace& Face, const FVector3f& Normal, FFaceMesh& Out)
+	{
+		TArray<FVector3f> Corners;
+		if (!GetFaceVertices(L, Face, Corners))
+		{
+			return false;
+		}
+
+		Out.Positions = Corners;
+		Out.UVPositions = Corners;
+		Out.Normals.Init(Normal, Corners.Num());
+
+		const int32 NumPrims = Face.NumPrims & FACE_NUM_PRIMS_MASK;
+		if (NumPrims == 0)
+		{
+			for (int32 i = 1; i + 1 < Corners.Num(); ++i)
+			{
+				AddTriangle(Out.Indices, Out.Positions, 0, i, i + 1, Normal);
+			}
+			return true;
+		}
+
+		// vbsp's T-junction fixes: index lists into the face's vertices, or their own vertices
+		for (int32 PrimIndex = Face.FirstPrimID; PrimIndex < Face.FirstPrimID + NumPrims; ++PrimIndex)
+		{
+			if (!L.Primitives.IsValidIndex(PrimIndex))
+			{
+				return false;
+			}
+			const FBSPPrimitive& Prim = L.Primitives[PrimIndex];
+
+			int32 Base = 0;
+			if (Prim.VertCount > 0)
+			{
+				Base = Out.Positions.Num();
+				for (int32 i = 0; i < Prim.VertCount; ++i)
+				{
+					if (!L.PrimVerts.IsValidIndex(Prim.FirstVert + i))
+					{
+						return false;
+					}
+					Out.Positions.Add(L.PrimVerts[Prim.FirstVert + i]);
+					Out.UVPositions.Add(L.PrimVerts[Prim.FirstVert + i]);
+					Out.Normals.Add(Normal);
+				}
+			}
+
+			auto Index = [&](int32 i) { return Base + L.PrimIndices[Prim.FirstIndex + i]; };
+			if (Prim.FirstIndex + Prim.IndexCount > L.PrimIndices.Num())
+			{
+				return false;
+			}
+			for (int32 i = 0; i < Prim.IndexCount; ++i)
+			{
+				if (!Out.Positions.IsValidIndex(Index(i)))
+				{
+					return false;
+				}
+			}
+
+			if (Prim.Type == PRIM_TRILIST)
+			{
+				for (int32 i = 0; i + 2 < Prim.IndexCount; i += 3)
+				{
+					AddTriangle(Out.Indices, Out.Positions, Index(i), Index(i + 1), Index(i + 2), Normal);
+				}
+			}
+			else if (Prim.Type == PRIM_TRISTRIP)
+			{
+				for (int32 i = 0; i + 2 < Prim.IndexCount; ++i)
+				{
+					AddTriangle(Out.Indices, Out.Positions, Index(i), Index(i + 1), Index(i + 2), Normal);
+				}
+			}
+		}
+		return true;
+	}
+
+	/** A displacement's (2^power+1)^2 grid over its four-sided base face. */
+	bool BuildDisplacementFace(const FBSPLumps& L, const FBSPFace& Face, const FVector3f& Normal, FFaceMesh& Out)
+	{
+		if (!L.DispInfos.IsValidIndex(Face.DispInfo))
+		{
+			return false;
+		}
+		const FBSPDispInfo& Disp = L.DispInfos[Face.DispInfo];
+
+		TArray<FVector3f> Base;
+		if (!GetFaceVertices(L, Face, Base) || Base.Num() != 4 || Disp.Power < 2 || Disp.Power > MAX_DISP_POWER)
+		{
+			return false;
+		}
+
+		// The grid starts at the corner nearest the stored start position
+		int32 Start = 0;
+		float BestDistance = MAX_flt;
+		for (int32 i = 0; i < 4; ++i)
+		{
+			float Distance = FVector3f::DistSquared(Base[i], Disp.StartPosition);
+			if (Distance < BestDistance)
+			{
+				BestDistance = Distance;
+				Start = i;
+			}
+		}
+		FVector3f Corners[4];
+		for (int32 i = 0; i < 4; ++i)
+		{
+			Corners[i] = Base[(Start + i) % 4];
+		}
+
+		const int32 Size = (1 << Disp.Power) + 1;
+		if (Disp.DispVertStart < 0 || Disp.DispVertStart + Size * Size > L.DispVerts.Num())
+		{
+			return false;
+		}
+
+		// Rows run from corner 0 to 1 (and 3 to 2), columns across them
+		const float Step = 1.0f / (Size - 1);
+		for (int32 Row = 0; Row < Size; ++Row)
+		{
+			FVector3f RowStart = FMath::Lerp(Corners[0], Corners[1], Row * Step);
+			FVector3f RowEnd = FMath::Lerp(Corners[3], Corners[2], Row * Step);
+			for (int32 Column = 0; Column < Size; ++Column)
+			{
+				FVector3f Flat = FMath::Lerp(RowStart, RowEnd, Column * Step);
+				const FBSPDispVert& Vert = L.DispVerts[Disp.DispVertStart + Row * Size + Column];
+				Out.Positions.Add(Flat + Vert.Vec * Vert.Dist);
+				Out.UVPositions.Add(Flat);
+			}
+		}
+
+		// Triangles are oriented on the flat grid so folded terrain keeps its winding
+		FVector3f GridWinding = FVector3f::CrossProduct(Out.UVPositions[Size] - Out.UVPositions[0], Out.UVPositions[1] - Out.UVPositions[0]);
+		bool bFlip = FVector3f::DotProduct(GridWinding, Normal) < 0.0f;
+		auto Emit = [&](int32 A, int32 B, int32 C)
+		{
+			Out.Indices.Add(A);
+			Out.Indices.Add(bFlip ? C : B);
+			Out.Indices.Add(bFlip ? B : C);
+		};
+
+		for (int32 Row = 0; Row + 1 < Size; ++Row)
+		{
+			for (int32 Column = 0; Column + 1 < Size; ++Column)
+			{
+				int32 A = Row * Size + Column;
+				int32 B = A + Size;
+				int32 C = A + 1;
+				int32 D = B + 1;
+
+				// Alternate the diagonal like the engine's tessellation
+				if ((A & 1) == 0)
+				{
+					Emit(A, B, D);
+					Emit(A, D, C);
+				}
+				else
+				{
+					Emit(A, B, C);
+					Emit(C, B, D);
+				}
+			}
+		}
+
+		// Smooth normals from the displaced triangles
+		Out.Normals.Init(FVector3f::ZeroVector, Out.Positions.Num());
+		for (int32 i = 0; i + 2 < Out.Indices.Num(); i += 3)
+		{
+			const int32 A = Out.Indices[i], B = Out.Indices[i + 1], C = Out.Indices[i + 2];
+			FVector3f TriangleNormal = FVector3f::CrossProduct(Out.Positions[B] - Out.Positions[A], Out.Positions[C] - Out.Positions[A]);
+			Out.Normals[A] += TriangleNormal;
+			Out.Normals[B] += TriangleNormal;
+			Out.Normals[C] += TriangleNormal;
+		}
+		for (FVector3f& VertexNormal : Out.Normals)
+		{
+			VertexNormal = VertexNormal.GetSafeNormal(KINDA_SMALL_NUMBER, Normal);
+		}
+		return true;
+	}
+
+	int32 FloorToCell(float Value, float ChunkSize)
+	{
+		return ChunkSize > 0.0f ? FMath::FloorToInt(Value / ChunkSize) : 0;
+	}
+
+	/** The lighting lump and the face records whose light offsets point into it. */
+	struct FBSPLighting
+	{
+		TArray<uint8> Samples;
+		TArray<FBSPFace> Faces;
+		bool bHDR = false;
+	};
+
+	/** A face's luxels, waiting to be packed into its chunk's atlas. */
+	struct FLightmapBlock
+	{
+		int32 Section = 0;
+		int32 FirstVertex = 0;
+		int32 NumVertices = 0;
+
+		/** Samples per axis; 0 when the face has no lightmap */
+		int32 Width = 0;
+		int32 Height = 0;
+
+		/** Byte offset of the first style's samples */
+		int32 LightOffset = 0;
+		int32 NumStyles = 0;
+		bool bBumped = false;
+
+		FIntPoint AtlasPos = FIntPoint::ZeroValue;
+	};
+
+	/** HDR lighting when the map has it for every face, else LDR. */
+	bool ReadLighting(const FBSPReader& Reader, const TArray<FBSPFace>& Faces, FBSPLighting& Out)
+	{
+		TArray<FBSPFace> HDRFaces;
+		Reader.ReadLumpArray(EBSPLump::FacesHDR, HDRFaces);
+		if (HDRFaces.Num() == Faces.Num() && Reader.ReadLump(EBSPLump::LightingHDR, Out.Samples) && Out.Samples.Num() > 0)
+		{
+			Out.Faces = MoveTemp(HDRFaces);
+			Out.bHDR = true;
+			return true;
+		}
+
+		Out.Faces = Faces;
+		Out.bHDR = false;
+		return Reader.ReadLump(EBSPLump::Lighting, Out.Samples) && Out.Samples.Num() > 0;
+	}
+
+	/** Fill in a face's sample layout. False (and an empty block) if it has no usable lightmap. */
+	bool GetLightmapBlock(const FBSPLighting& Lighting, const FBSPFace& Face, const FBSPTexInfo& TexInfo, FLightmapBlock& Out)
+	{
+		Out.Width = 0;
+		Out.Height = 0;
+		if ((TexInfo.Flags & SURF_NOLIGHT) || Face.LightOffset < 0 || Face.Styles[0] == LIGHT_STYLE_NONE)
+		{
+			return false;
+		}
+
+		const int32 Width = Face.LightmapSize[0] + 1;
+		const int32 Height = Face.LightmapSize[1] + 1;
+		if (Width <= 0 || Height <= 0 || Width > LIGHTMAP_MAX_ATLAS_WIDTH / 2 || Height > LIGHTMAP_MAX_ATLAS_WIDTH / 2)
+		{
+			return false;
+		}
+
+		int32 NumStyles = 0;
+		while (NumStyles < MAX_LIGHT_STYLES && Face.Styles[NumStyles] != LIGHT_STYLE_NONE)
+		{
+			NumStyles++;
+		}
+
+		// Bumpmapped faces store the flat samples followed by one set per bump basis vector
+		const bool bBumped = (TexInfo.Flags & SURF_BUMPLIGHT) != 0;
+		const int64 Stride = (int64)Width * Height * (bBumped ? 4 : 1);
+		if ((int64)Face.LightOffset + NumStyles * Stride * 4 > Lighting.Samples.Num())
+		{
+			return false;
+		}
+
+		Out.Width = Width;
+		Out.Height = Height;
+		Out.LightOffset = Face.LightOffset;
+		Out.NumStyles = NumStyles;
+		Out.bBumped = bBumped;
+		return true;
+	}
+
+	/** ColorRGBExp32: 8-bit mantissas sharing a signed exponent. */
+	FLinearColor DecodeLuxel(const uint8* P)
+	{
+		const float Scale = FMath::Pow(2.0f, (float)(int8)P[3]) / 255.0f;
+		return FLinearColor(P[0] * Scale, P[1] * Scale, P[2] * Scale, 0.0f);
+	}
+
+	/** Shelf-pack the lit blocks (tallest first) behind the fullbright block. Returns the atlas size. */
+	FIntPoint PackLightmapBlocks(TArray<FLightmapBlock>& Blocks)
+	{
+		TArray<int32> Order;
+		int64 Area = LIGHTMAP_FULLBRIGHT_SIZE * LIGHTMAP_FULLBRIGHT_SIZE;
+		int32 Widest = LIGHTMAP_FULLBRIGHT_SIZE;
+		for (int32 i = 0; i < Blocks.Num(); ++i)
+		{
+			if (Blocks[i].Width > 0)
+			{
+				Order.Add(i);
+				Area += (int64)(Blocks[i].Width + 2 * LIGHTMAP_PADDING) * (Blocks[i].Height + 2 * LIGHTMAP_PADDING);
+				Widest = FMath::Max(Widest, Blocks[i].Width + 2 * LIGHTMAP_PADDING);
+			}
+		}
+		Order.Sort([&Blocks](int32 A, int32 B) { return Blocks[A].Height > Blocks[B].Height; });
+
+		int32 AtlasWidth = (int32)FMath::RoundUpToPowerOfTwo((uint32)FMath::Max(Widest, FMath::CeilToInt(FMath::Sqrt((double)Area))));
+		int32 AtlasHeight = 0;
+		while (true)
+		{
+			int32 X = LIGHTMAP_FULLBRIGHT_SIZE;
+			int32 Y = 0;
+			int32 ShelfHeight = LIGHTMAP_FULLBRIGHT_SIZE;
+			for (int32 Index : Order)
+			{
+				FLightmapBlock& Block = Blocks[Index];
+				const int32 W = Block.Width + 2 * LIGHTMAP_PADDING;
+				const int32 H = Block.Height + 2 * LIGHTMAP_PADDING;
+				if (X + W > AtlasWidth)
+				{
+					Y += ShelfHeight;
+					X = 0;
+					ShelfHeight = 0;
+				}
+				Block.AtlasPos = FIntPoint(X, Y);
+				X += W;
+				ShelfHeight = FMath::Max(ShelfHeight, H);
+			}
+			AtlasHeight = Y + ShelfHeight;
+
+			// Keep the atlas roughly square
+			if (AtlasHeight > AtlasWidth * 2 && AtlasWidth < LIGHTMAP_MAX_ATLAS_WIDTH)
+			{
+				AtlasWidth *= 2;
+				continue;
+			}
+			break;
+		}
+		return FIntPoint(AtlasWidth, Align(AtlasHeight, 4));
+	}
+
+	/**
+	 * Pack a chunk's blocks, decode their samples (styles summed) into the atlas and turn the
+	 * sections' luxel coordinates into atlas UVs.
+	 */
+	void BuildLightmapAtlas(const FBSPLighting& Lighting, TArray<FLightmapBlock>& Blocks, FBSPMeshChunk& Chunk)
+	{
+		const FIntPoint Size = PackLightmapBlocks(Blocks);
+		FBSPLightmapAtlas& Atlas = Chunk.Lightmap;
+		Atlas.Width = Size.X;
+		Atlas.Height = Size.Y;
+		Atlas.bHDR = Lighting.bHDR;
+		Atlas.Pixels.Init(FFloat16Color(FLinearColor::Black), Size.X * Size.Y);
+
+		for (int32 Y = 0; Y < LIGHTMAP_FULLBRIGHT_SIZE; ++Y)
+		{
+			for (int32 X = 0; X < LIGHTMAP_FULLBRIGHT_SIZE; ++X)
+			{
+				Atlas.Pixels[Y * Size.X + X] = FFloat16Color(FLinearColor::White);
+			}
+		}
+		const FVector2f FullbrightUV(0.5f * LIGHTMAP_FULLBRIGHT_SIZE / Size.X, 0.5f * LIGHTMAP_FULLBRIGHT_SIZE / Size.Y);
+
+		for (const FLightmapBlock& Block : Blocks)
+		{
+			TArray<FVector2f>& UVs = Chunk.Sections[Block.Section].LightmapUVs;
+			if (Block.Width == 0)
+			{
+				for (int32 i = 0; i < Block.NumVertices; ++i)
+				{
+					UVs[Block.FirstVertex + i] = FullbrightUV;
+				}
+				continue;
+			}
+
+			const int64 Stride = (int64)Block.Width * Block.Height * (Block.bBumped ? 4 : 1);
+			const uint8* Samples = Lighting.Samples.GetData() + Block.LightOffset;
+			for (int32 Y = -LIGHTMAP_PADDING; Y < Block.Height + LIGHTMAP_PADDING; ++Y)
+			{
+				const int32 SampleY = FMath::Clamp(Y, 0, Block.Height - 1);
+				for (int32 X = -LIGHTMAP_PADDING; X < Block.Width + LIGHTMAP_PADDING; ++X)
+				{
+					const int32 SampleX = FMath::Clamp(X, 0, Block.Width - 1);
+					FLinearColor Light(0.0f, 0.0f, 0.0f, 0.0f);
+					for (int32 Style = 0; Style < Block.NumStyles; ++Style)
+					{
+						Light += DecodeLuxel(Samples + (Style * Stride + SampleY * Block.Width + SampleX) * 4);
+					}
+					Light.A = 1.0f;
+
+					const int32 AtlasX = Block.AtlasPos.X + LIGHTMAP_PADDING + X;
+					const int32 AtlasY = Block.AtlasPos.Y + LIGHTMAP_PADDING + Y;
+					Atlas.Pixels[AtlasY * Size.X + AtlasX] = FFloat16Color(Light);
+				}
+			}
+
+			// Luxel N is centered on texel N of the block
+			for (int32 i = 0; i < Block.NumVertices; ++i)
+			{
+				FVector2f& UV = UVs[Block.FirstVertex + i];
+				UV.X = (Block.AtlasPos.X + LIGHTMAP_PADDING + UV.X + 0.5f) / Size.X;
+				UV.Y = (Block.AtlasPos.Y + LIGHTMAP_PADDING + UV.Y + 0.5f) / Size.Y;
+			}
+		}
+	}
+}
+
+FString FBSPGeometry::UnpatchMaterialName(const FString& Material)
+{
+	FString Name = Material;
+	Name.ReplaceInline(TEXT("\\"), TEXT("/"));
+
+	// Patched materials live under maps/<mapname>/
+	if (!Name.StartsWith(TEXT("maps/"), ESearchCase::IgnoreCase))
+	{
+		return Name;
+	}
+	int32 MapEnd = Name.Find(TEXT("/"), ESearchCase::CaseSensitive, ESearchDir::FromStart, 5);
+	if (MapEnd == INDEX_NONE)
+	{
+		return Name;
+	}
+	FString Original = Name.Mid(MapEnd + 1);
+
+	if (Original.RemoveFromEnd(TEXT("_wvt_patch"), ESearchCase::IgnoreCase))
+	{
+		return Original;
+	}
+
+	// Cubemap patches append the cubemap's origin: _x_y_z
+	int32 Pos = Original.Len();
+	for (int32 Part = 0; Part < 3; ++Part)
+	{
+		int32 DigitsEnd = Pos;
+		while (Pos > 0 && FChar::IsDigit(Original[Pos - 1]))
+		{
+			Pos--;
+		}
+		if (Pos == DigitsEnd)
+		{
+			return Name;
+		}
+		if (Pos > 0 && Original[Pos - 1] == TEXT('-'))
+		{
+			Pos--;
+		}
+		if (Pos == 0 || Original[Pos - 1] != TEXT('_'))
+		{
+			return Name;
+		}
+		Pos--;
+	}
+	return Original.Left(Pos);
+}
+
+TArray<FBSPModelMesh> FBSPGeometry::Build(const FBSPReader& Reader, float ChunkSize, bool bLightmaps)
+{
+	TArray<FBSPModelMesh> Models;
+	if (!Reader.IsOpen())
+	{
+		return Models;
+	}
+
+	FBSPLumps L;
+	TArray<FBSPModel> ModelLump;
+	Reader.ReadLumpArray(EBSPLump::Models, ModelLump);
+	Reader.ReadLumpArray(EBSPLump::Faces, L.Faces);
+	if (L.Faces.Num() == 0)
+	{
+		// HDR-only compiles
+		Reader.ReadLumpArray(EBSPLump::FacesHDR, L.Faces);
+	}
+	Reader.ReadLumpArray(EBSPLump::Planes, L.Planes);
+	Reader.ReadLumpArray(EBSPLump::Vertexes, L.Vertexes);
+	Reader.ReadLumpArray(EBSPLump::Edges, L.Edges);
+	Reader.ReadLumpArray(EBSPLump::SurfEdges, L.SurfEdges);
+	Reader.ReadLumpArray(EBSPLump::TexInfo, L.TexInfos);
+	Reader.ReadLumpArray(EBSPLump::Primitives, L.Primitives);
+	Reader.ReadLumpArray(EBSPLump::PrimVerts, L.PrimVerts);
+	Reader.ReadLumpArray(EBSPLump::PrimIndices, L.PrimIndices);
+	Reader.ReadLumpArray(EBSPLump::DispInfo, L.DispInfos);
+	Reader.ReadLumpArray(EBSPLump::DispVerts, L.DispVerts);
+	L.TexData = Reader.ReadTexData();
+
+	L.Materials.Reserve(L.TexData.Num());
+	for (const FBSPTexData& TexData : L.TexData)
+	{
+		L.Materials.Add(UnpatchMaterialName(TexData.MaterialName));
+	}
+
+	FBSPLighting Lighting;
+	if (bLightmaps && !ReadLighting(Reader, L.Faces, Lighting))
+	{
+		UE_LOG(LogTemp, Log, TEXT("BSPGeometry: Map has no lighting, building without lightmaps"));
+		bLightmaps = false;
+	}
+
+	int32 SkippedFaces = 0;
+	FFaceMesh FaceMesh;
+
+	for (int32 ModelIndex = 0; ModelIndex < ModelLump.Num(); ++ModelIndex)
+	{
+		const FBSPModel& Model = ModelLump[ModelIndex];
+		FBSPModelMesh& Mesh = Models.AddDefaulted_GetRef();
+		Mesh.ModelIndex = ModelIndex;
+		Mesh.Bounds = FBox3f(Model.Mins, Model.Maxs);
+
+		TMap<FIntVector, int32> ChunkByCell;
+		TArray<TMap<int32, int32>> SectionByTexData;
+		TArray<TArray<FLightmapBlock>> LightmapBlocks;
+
+		for (int32 FaceIndex = Model.FirstFace; FaceIndex < Model.FirstFace + Model.NumFaces; ++FaceIndex)
+		{
+			if (!L.Faces.IsValidIndex(FaceIndex))
+			{
+				break;
+			}
+			const FBSPFace& Face = L.Faces[FaceIndex];
+
+			if (!L.TexInfos.IsValidIndex(Face.TexInfo) || !L.Planes.IsValidIndex(Face.PlaneNum))
+			{
+				continue;
+			}
+			const FBSPTexInfo& TexInfo = L.TexInfos[Face.TexInfo];
+			if (TexInfo.Flags & (SURF_NODRAW | SURF_HINT | SURF_SKIP))
+			{
+				continue;
+			}
+
+			FVector3f Normal = L.Planes[Face.PlaneNum].Normal * (Face.Side ? -1.0f : 1.0f);
+
+			FaceMesh = FFaceMesh();
+			FaceMesh.TexData = TexInfo.TexData;
+			bool bDisplacement = Face.DispInfo >= 0;
+			bool bBuilt = bDisplacement
+				? BuildDisplacementFace(L, Face, Normal, FaceMesh)
+				: BuildPolygonFace(L, Face, Normal, FaceMesh);
+			if (!bBuilt || FaceMesh.Indices.Num() == 0)
+			{
+				SkippedFaces++;
+				continue;
+			}
+
+			// Chunk by the face's center
+			FBox3f FaceBounds(FaceMesh.Positions);
+			FVector3f Center = FaceBounds.GetCenter();
+			FIntVector Cell(FloorToCell(Center.X, ChunkSize), FloorToCell(Center.Y, ChunkSize), FloorToCell(Center.Z, ChunkSize));
+
+			int32* ChunkIndex = ChunkByCell.Find(Cell);
+			if (!ChunkIndex)
+			{
+				ChunkIndex = &ChunkByCell.Add(Cell, Mesh.Chunks.Num());
+				Mesh.Chunks.AddDefaulted_GetRef().Cell = Cell;
+				SectionByTexData.AddDefaulted();
+				LightmapBlocks.AddDefaulted();
+			}
+			FBSPMeshChunk& Chunk = Mesh.Chunks[*ChunkIndex];
+			Chunk.Bounds += FaceBounds;
+
+			int32* SectionIndex = SectionByTexData[*ChunkIndex].Find(FaceMesh.TexData);
+			if (!SectionIndex)
+			{
+				SectionIndex = &SectionByTexData[*ChunkIndex].Add(FaceMesh.TexData, Chunk.Sections.Num());
+				FBSPMeshSection& NewSection = Chunk.Sections.AddDefaulted_GetRef();
+				if (L.TexData.IsValidIndex(FaceMesh.TexData))
+				{
+					NewSection.Material = L.Materials[FaceMesh.TexData];
+					NewSection.TextureWidth = FMath::Max(1, L.TexData[FaceMesh.TexData].Width);
+					NewSection.TextureHeight = FMath::Max(1, L.TexData[FaceMesh.TexData].Height);
+				}
+				NewSection.bToolsMaterial = NewSection.Material.StartsWith(TEXT("tools/"), ESearchCase::IgnoreCase);
+			}
+			FBSPMeshSection& Section = Chunk.Sections[*SectionIndex];
+
+			const FVector3f UAxis(TexInfo.TextureVecs[0][0], TexInfo.TextureVecs[0][1], TexInfo.TextureVecs[0][2]);
+			const FVector3f VAxis(TexInfo.TextureVecs[1][0], TexInfo.TextureVecs[1][1], TexInfo.TextureVecs[1][2]);
+			const FVector3f Tangent = UAxis.GetSafeNormal();
+
+			int32 BaseVertex = Section.Positions.Num();
+			for (int32 i = 0; i < FaceMesh.Positions.Num(); ++i)
+			{
+				const FVector3f& UVPosition = FaceMesh.UVPositions[i];
+				Section.Positions.Add(FaceMesh.Positions[i]);
+				Section.Normals.Add(FaceMesh.Normals[i]);
+				Section.TangentsU.Add(Tangent);
+				Section.TexelUVs.Add(FVector2f(
+					FVector3f::DotProduct(UVPosition, UAxis) + TexInfo.TextureVecs[0][3],
+					FVector3f::DotProduct(UVPosition, VAxis) + TexInfo.TextureVecs[1][3]));
+			}
+			for (int32 Index : FaceMesh.Indices)
+			{
+				Section.Indices.Add(BaseVertex + Index);
+			}
+
+			if (bLightmaps)
+			{
+				// Luxel coordinates for now; BuildLightmapAtlas maps them into the atlas
+				const FBSPFace& LightFace = Lighting.Faces.IsValidIndex(FaceIndex) ? Lighting.Faces[FaceIndex] : Face;
+				FLightmapBlock& Block = LightmapBlocks[*ChunkIndex].AddDefaulted_GetRef();
+				Block.Section = *SectionIndex;
+				Block.FirstVertex = BaseVertex;
+				Block.NumVertices = FaceMesh.Positions.Num();
+				Mesh.LightmappedFaceCount += GetLightmapBlock(Lighting, LightFace, TexInfo, Block) ? 1 : 0;
+
+				const FVector3f SAxis(TexInfo.LightmapVecs[0][0], TexInfo.LightmapVecs[0][1], TexInfo.LightmapVecs[0][2]);
+				const FVector3f TAxis(TexInfo.LightmapVecs[1][0], TexInfo.LightmapVecs[1][1], TexInfo.LightmapVecs[1][2]);
+				for (const FVector3f& UVPosition : FaceMesh.UVPositions)
+				{
+					Section.LightmapUVs.Add(FVector2f(
+						FVector3f::DotProduct(UVPosition, SAxis) + TexInfo.LightmapVecs[0][3] - LightFace.LightmapMins[0],
+						FVector3f::DotProduct(UVPosition, TAxis) + TexInfo.LightmapVecs[1][3] - LightFace.LightmapMins[1]));
+				}
+			}
+
+			Mesh.FaceCount++;
+			Mesh.DisplacementCount += bDisplacement ? 1 : 0;
+			Mesh.TriangleCount += FaceMesh.Indices.Num() / 3;
+		}
+
+		for (int32 ChunkIndex = 0; bLightmaps && ChunkIndex < Mesh.Chunks.Num(); ++ChunkIndex)
+		{
+			BuildLightmapAtlas(Lighting, LightmapBlocks[ChunkIndex], Mesh.Chunks[ChunkIndex]);
+		}
+	}
+
+	if (SkippedFaces > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BSPGeometry: Skipped %d malformed faces"), SkippedFaces);
+	}
+	if (Models.Num() > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("BSPGeometry: World has %d faces (%d displacements, %d triangles) in %d chunks; %d brush entity models"),
+			Models[0].FaceCount, Models[0].DisplacementCount, Models[0].TriangleCount, Models[0].Chunks.Num(), Models.Num() - 1);
+		if (bLightmaps)
+		{
+			UE_LOG(LogTemp, Log, TEXT("BSPGeometry: %d world faces lightmapped (%s lighting)"),
+				Models[0].LightmappedFaceCount, Lighting.bHDR ? TEXT("HDR") : TEXT("LDR"));
+		}
+	}
+	return Models;
+}
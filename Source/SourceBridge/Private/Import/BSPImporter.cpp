@@ -1,5 +1,10 @@
 #include "Import/BSPImporter.h"
+#include "Import/BSPReader.h"
+#include "Import/BSPGeometry.h"
+#include "Import/BSPStaticProps.h"
+#include "Import/BSPVisibility.h"
 #include "Import/VMFImporter.h"
+#include "Import/VMFReader.h"
 #include "Import/MaterialImporter.h"
 #include "Import/ModelImporter.h"
 #include "Import/SoundImporter.h"
@@ -38,49 +43,78 @@ FVMFImportResult FBSPImporter::ImportFile(const FString& BSPPath, UWorld* World,
 
 	UE_LOG(LogTemp, Log, TEXT("BSPImporter: Import directory: %s"), *OutputDir);
 
-	// Step 1: Decompile BSP → VMF + extract embedded assets
-	SlowTask.EnterProgressFrame(1.0f, FText::FromString(TEXT("Decompiling BSP...")));
+	// Step 1: Read the BSP natively: embedded assets from the pakfile, entities from the entity lump
+	SlowTask.EnterProgressFrame(1.0f, FText::FromString(TEXT("Reading BSP...")));
 
-	FString DecompileError;
-	FString VMFPath = DecompileBSP(BSPPath, OutputDir, DecompileError);
-
-	if (VMFPath.IsEmpty())
+	FBSPReader Reader;
+	if (!Reader.Open(BSPPath))
 	{
-		Result.Warnings.Add(FString::Printf(TEXT("BSPSource decompile failed: %s"), *DecompileError));
+		Result.Warnings.Add(FString::Printf(TEXT("Cannot read BSP: %s"), *Reader.GetError()));
 		return Result;
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("BSPImporter: Decompiled '%s' → '%s'"), *BSPPath, *VMFPath);
-
-	// Step 2: Set up search paths
-	SlowTask.EnterProgressFrame(1.0f, FText::FromString(TEXT("Setting up search paths...")));
+	int32 ExtractedCount = Reader.ExtractPakFile(OutputDir);
+	UE_LOG(LogTemp, Log, TEXT("BSPImporter: Extracted %d embedded files to %s"), ExtractedCount, *OutputDir);
 
-	// BSPSource --unpack_embedded extracts files into a nested subdirectory:
-	//   <OutputDir>/<mapname>/materials/  (not <OutputDir>/materials/)
-	// Detect this and use the nested directory as the asset search path
-	FString AssetSearchDir = OutputDir;
-	FString NestedDir = OutputDir / MapName;
-	if (FPaths::DirectoryExists(NestedDir / TEXT("materials")))
+	// Brush geometry comes from a BSPSource decompile when it is installed and editable
+	// brushes are wanted. Otherwise (or if it fails) the compiled faces are imported as
+	// meshes, with entities from the entity lump.
+	TArray<FString> ImportWarnings;
+	TArray<FVMFKeyValues> VMFBlocks;
+	if (Settings.bImportBrushes && !Settings.bUseCompiledBSPGeometry && !FindBSPSourceJavaPath().IsEmpty())
 	{
-		AssetSearchDir = NestedDir;
-		UE_LOG(LogTemp, Log, TEXT("BSPImporter: Using nested asset directory: %s"), *AssetSearchDir);
+		FString DecompileError;
+		FString VMFPath = DecompileBSP(BSPPath, OutputDir, DecompileError);
+		if (!VMFPath.IsEmpty())
+		{
+			UE_LOG(LogTemp, Log, TEXT("BSPImporter: Decompiled '%s' → '%s'"), *BSPPath, *VMFPath);
+
+			// Load the decompiled tree through the binary parse cache. The first import writes
+			// <mapname>.vmfc next to the VMF; re-imports of an unchanged decompile skip text parsing.
+			VMFBlocks = FVMFReader::ParseFileAndUpdateCache(VMFPath);
+		}
+
+		if (VMFBlocks.Num() == 0)
+		{
+			ImportWarnings.Add(FString::Printf(TEXT("BSPSource decompile failed (%s); imported compiled geometry instead."),
+				DecompileError.IsEmpty() ? TEXT("unreadable VMF") : *DecompileError));
+		}
 	}
-	else if (!FPaths::DirectoryExists(OutputDir / TEXT("materials")))
+
+	TArray<FBSPModelMesh> CompiledModels;
+	if (VMFBlocks.Num() == 0)
 	{
-		// Search for any materials/ directory under OutputDir
-		TArray<FString> SubDirs;
-		IFileManager::Get().FindFiles(SubDirs, *(OutputDir / TEXT("*")), false, true);
-		for (const FString& SubDir : SubDirs)
+		VMFBlocks = Reader.ReadEntities();
+		UE_LOG(LogTemp, Log, TEXT("BSPImporter: Read %d entities from the entity lump"), VMFBlocks.Num());
+
+		if (Settings.bImportBrushes)
 		{
-			if (FPaths::DirectoryExists(OutputDir / SubDir / TEXT("materials")))
-			{
-				AssetSearchDir = OutputDir / SubDir;
-				UE_LOG(LogTemp, Log, TEXT("BSPImporter: Found assets in subdirectory: %s"), *AssetSearchDir);
-				break;
-			}
+			CompiledModels = FBSPGeometry::Build(Reader, 2048.0f, Settings.bImportLightmaps);
 		}
 	}
 
+	if (VMFBlocks.Num() == 0)
+	{
+		Result.Warnings.Add(FString::Printf(TEXT("No entities found in %s"), *BSPPath));
+		return Result;
+	}
+
+	// Static props come straight from the sprp game lump (the entity lump has none, and
+	// the decompile's prop_static entities are skipped in favour of these)
+	FBSPStaticPropLump StaticProps;
+	const bool bHasStaticProps = Settings.bImportEntities && FBSPStaticProps::Read(Reader, StaticProps);
+
+	// Clusters and PVS, for tagging what gets imported and culling it like the game does
+	FBSPVisibility Visibility;
+	const bool bHasVisibility = Settings.bImportVisibility && Visibility.Load(Reader);
+	Reader.Close();
+
+	// Step 2: Set up search paths
+	SlowTask.EnterProgressFrame(1.0f, FText::FromString(TEXT("Setting up search paths...")));
+
+	// Pakfile entries keep their game-relative paths (materials/, models/, sound/...)
+	FString AssetSearchDir = OutputDir;
+
 	FMaterialImporter::SetAssetSearchPath(AssetSearchDir);
 
 	// Set up additional search paths from the game installation directory
@@ -96,12 +130,17 @@ FVMFImportResult FBSPImporter::ImportFile(const FString& BSPPath, UWorld* World,
 	// (Set it in the console or code before import if you need to inspect textures)
 	FVTFReader::DebugDumpPath = OutputDir / TEXT("Debug_Textures");
 
-	// Step 3: Import the decompiled VMF (geometry, entities, materials, models)
+	// Step 3: Import the blocks (geometry, entities, materials, models)
 	SlowTask.EnterProgressFrame(1.0f, FText::FromString(TEXT("Importing VMF...")));
 
 	FVMFImportSettings ImportSettings = Settings;
 	ImportSettings.AssetSearchPath = AssetSearchDir;
-	Result = FVMFImporter::ImportFile(VMFPath, World, ImportSettings);
+	ImportSettings.CompiledModels = CompiledModels.Num() > 0 ? &CompiledModels : nullptr;
+	ImportSettings.LightmapAssetPath = FString::Printf(TEXT("/Game/SourceBridge/Lightmaps/%s"), *MapName);
+	ImportSettings.StaticProps = bHasStaticProps ? &StaticProps : nullptr;
+	ImportSettings.Visibility = bHasVisibility ? &Visibility : nullptr;
+	Result = FVMFImporter::ImportBlocks(VMFBlocks, World, ImportSettings);
+	Result.Warnings.Append(ImportWarnings);
 
 	// Step 4: Post-VMF asset imports and manifest saves
 
@@ -217,11 +256,11 @@ FString FBSPImporter::DecompileBSP(const FString& BSPPath, const FString& Output
 	FString MapName = FPaths::GetBaseFilename(BSPPath);
 	FString VMFPath = OutputDir / MapName + TEXT(".vmf");
 
-	// Build command with --unpack_embedded to extract materials/textures from BSP pakfile
-	// -o points to the output VMF file path (BSPSource extracts embedded files relative to it)
+	// -o points to the output VMF file path. Embedded files are extracted natively by
+	// FBSPReader, so BSPSource only decompiles geometry.
 	// All paths must be absolute since BSPSource runs as an external process
 	FString Args = FString::Printf(
-		TEXT("-m info.ata4.bspsrc.app/info.ata4.bspsrc.app.src.BspSourceLauncher --unpack_embedded -o \"%s\" \"%s\""),
+		TEXT("-m info.ata4.bspsrc.app/info.ata4.bspsrc.app.src.BspSourceLauncher -o \"%s\" \"%s\""),
 		*VMFPath, *AbsBSPPath);
 
 	UE_LOG(LogTemp, Log, TEXT("BSPImporter: Running '%s' %s"), *JavaPath, *Args);
@@ -254,8 +293,7 @@ FString FBSPImporter::DecompileBSP(const FString& BSPPath, const FString& Output
 	if (StdOut.Contains(TEXT("ERROR")) && StdOut.Contains(TEXT("Failed")))
 	{
 		OutError = FString::Printf(TEXT("BSPSource reported error: %s"), *StdOut.Left(500));
-		// Don't return yet - the embedded files may have been extracted even if decompile failed
-		// We'll check for the VMF below
+		// Don't return yet - a VMF may still have been written; we'll check for it below
 	}
 
 	// BSPSource with -o <dir> puts the VMF as <dir>/<mapname>.vmf
@@ -286,16 +324,5 @@ FString FBSPImporter::DecompileBSP(const FString& BSPPath, const FString& Output
 		}
 	}
 
-	// Log what was extracted
-	TArray<FString> ExtractedVMTs;
-	IFileManager::Get().FindFilesRecursive(ExtractedVMTs, *OutputDir, TEXT("*.vmt"), true, false);
-	TArray<FString> ExtractedVTFs;
-	IFileManager::Get().FindFilesRecursive(ExtractedVTFs, *OutputDir, TEXT("*.vtf"), true, false);
-	TArray<FString> ExtractedMDLs;
-	IFileManager::Get().FindFilesRecursive(ExtractedMDLs, *OutputDir, TEXT("*.mdl"), true, false);
-
-	UE_LOG(LogTemp, Log, TEXT("BSPImporter: Extracted %d VMT, %d VTF, %d MDL files to %s"),
-		ExtractedVMTs.Num(), ExtractedVTFs.Num(), ExtractedMDLs.Num(), *OutputDir);
-
 	return VMFPath;
 }
@@ -0,0 +1,679 @@
+#include "Import/BSPReader.h"
+#include "Utilities/LZMADecoder.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+// BSP header: ident, version, 64 lumps of 16 bytes, map revision
+static const uint32 BSP_IDENT = 0x50534256; // "VBSP"
+static const int32 BSP_HEADER_SIZE = 8 + (int32)EBSPLump::Count * 16 + 4;
+static const int32 BSP_MIN_VERSION = 19;
+static const int32 BSP_MAX_VERSION = 21;
+
+// ZIP records used by bspzip and vbsp
+static const uint32 ZIP_LOCAL_HEADER_SIG = 0x04034b50;
+static const uint32 ZIP_CENTRAL_HEADER_SIG = 0x02014b50;
+static const uint32 ZIP_END_OF_DIR_SIG = 0x06054b50;
+static const int32 ZIP_LOCAL_HEADER_SIZE = 30;
+static const int32 ZIP_CENTRAL_HEADER_SIZE = 46;
+static const int32 ZIP_END_OF_DIR_SIZE = 22;
+
+static const uint16 ZIP_METHOD_STORED = 0;
+static const uint16 ZIP_METHOD_DEFLATE = 8;
+static const uint16 ZIP_METHOD_LZMA = 14;
+
+// Separator Hammer and vbsp use between output fields in newer games
+static const TCHAR ENTITY_OUTPUT_SEPARATOR = 0x1B;
+
+namespace
+{
+	uint16 ReadLE16(const uint8* P) { return (uint16)(P[0] | (P[1] << 8)); }
+	uint32 ReadLE32(const uint8* P) { return (uint32)P[0] | ((uint32)P[1] << 8) | ((uint32)P[2] << 16) | ((uint32)P[3] << 24); }
+
+	FString NormalizePakPath(const FString& Path)
+	{
+		FString Result = Path.ToLower();
+		Result.ReplaceInline(TEXT("\\"), TEXT("/"));
+		return Result;
+	}
+
+	bool IsEntityOutput(const FString& Value)
+	{
+		int32 Separator;
+		if (Value.FindChar(ENTITY_OUTPUT_SEPARATOR, Separator))
+		{
+			return true;
+		}
+
+		// Older games: "target,input,parameter,delay,refire" under any output name (game_ui's
+		// PressedForward, PlayerOn, ...), so the value's shape is what marks an output
+		TArray<FString> Fields;
+		Value.ParseIntoArray(Fields, TEXT(","), false);
+		return Fields.Num() == 5
+			&& !Fields[0].IsEmpty() && !Fields[1].IsEmpty() && !Fields[1].Contains(TEXT(" "))
+			&& Fields[3].IsNumeric() && Fields[4].IsNumeric() && !Fields[4].Contains(TEXT("."));
+	}
+
+	/** Read a quoted token. Entity lumps have no escape sequences. */
+	bool ReadQuoted(const FString& Text, int32& Pos, FString& Out)
+	{
+		if (Pos >= Text.Len() || Text[Pos] != TEXT('"'))
+		{
+			return false;
+		}
+		int32 End = Text.Find(TEXT("\""), ESearchCase::CaseSensitive, ESearchDir::FromStart, Pos + 1);
+		if (End == INDEX_NONE)
+		{
+			return false;
+		}
+		Out = Text.Mid(Pos + 1, End - Pos - 1);
+		Pos = End + 1;
+		return true;
+	}
+
+	void SkipWhitespace(const FString& Text, int32& Pos)
+	{
+		while (Pos < Text.Len() && FChar::IsWhitespace(Text[Pos]))
+		{
+			Pos++;
+		}
+	}
+}
+
+FBSPReader::FBSPReader()
+{
+}
+
+FBSPReader::~FBSPReader()
+{
+	Close();
+}
+
+void FBSPReader::Close()
+{
+	MappedRegion.Reset();
+	MappedHandle.Reset();
+	FileData.Empty();
+	Data = nullptr;
+	DataSize = 0;
+	Version = 0;
+	MapRevision = 0;
+	bVersionFirstLumps = false;
+	bGameLumpsParsed = false;
+	GameLumps.Empty();
+	bPakParsed = false;
+	PakEntries.Empty();
+	PakIndex.Empty();
+}
+
+bool FBSPReader::Open(const FString& BSPPath)
+{
+	Close();
+	Error.Reset();
+
+	IMappedFileHandle* Handle = FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*BSPPath);
+	if (Handle)
+	{
+		MappedHandle.Reset(Handle);
+		MappedRegion.Reset(MappedHandle->MapRegion(0, MappedHandle->GetFileSize()));
+	}
+
+	if (MappedRegion)
+	{
+		Data = MappedRegion->GetMappedPtr();
+		DataSize = MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		MappedHandle.Reset();
+		if (!FFileHelper::LoadFileToArray(FileData, *BSPPath))
+		{
+			Error = FString::Printf(TEXT("Cannot read %s"), *BSPPath);
+			return false;
+		}
+		Data = FileData.GetData();
+		DataSize = FileData.Num();
+	}
+
+	if (DataSize < BSP_HEADER_SIZE || ReadLE32(Data) != BSP_IDENT)
+	{
+		Error = FString::Printf(TEXT("%s is not a VBSP file"), *FPaths::GetCleanFilename(BSPPath));
+		Close();
+		return false;
+	}
+
+	Version = (int32)ReadLE32(Data + 4);
+	if (Version < BSP_MIN_VERSION || Version > BSP_MAX_VERSION)
+	{
+		Error = FString::Printf(TEXT("Unsupported BSP version %d (expected %d-%d)"), Version, BSP_MIN_VERSION, BSP_MAX_VERSION);
+		Close();
+		return false;
+	}
+
+	// L4D2's v21 stores lumps as (version, offset, length, fourCC). A version is small and
+	// always precedes the header, while a real offset never does.
+	const uint8* Directory = Data + 8;
+	bVersionFirstLumps = Version == 21
+		&& (int32)ReadLE32(Directory) < BSP_HEADER_SIZE
+		&& (int32)ReadLE32(Directory + 4) >= BSP_HEADER_SIZE;
+
+	for (int32 i = 0; i < (int32)EBSPLump::Count; ++i)
+	{
+		const uint8* Entry = Directory + i * 16;
+		FBSPLumpInfo& Lump = Lumps[i];
+		Lump.Offset = (int32)ReadLE32(Entry + (bVersionFirstLumps ? 4 : 0));
+		Lump.Length = (int32)ReadLE32(Entry + (bVersionFirstLumps ? 8 : 4));
+		Lump.Version = (int32)ReadLE32(Entry + (bVersionFirstLumps ? 0 : 8));
+		Lump.FourCC = (int32)ReadLE32(Entry + 12);
+
+		if (Lump.Length == 0)
+		{
+			continue;
+		}
+		if (Lump.Offset < 0 || Lump.Length < 0 || (int64)Lump.Offset + Lump.Length > DataSize)
+		{
+			Error = FString::Printf(TEXT("Lump %d (offset %d, length %d) lies outside the %lld-byte file"),
+				i, Lump.Offset, Lump.Length, DataSize);
+			Close();
+			return false;
+		}
+	}
+
+	MapRevision = (int32)ReadLE32(Data + 8 + (int32)EBSPLump::Count * 16);
+
+	UE_LOG(LogTemp, Log, TEXT("BSPReader: Opened %s (v%d, revision %d, %s)"),
+		*FPaths::GetCleanFilename(BSPPath), Version, MapRevision,
+		MappedRegion ? TEXT("mapped") : TEXT("loaded"));
+	return true;
+}
+
+TArrayView<const uint8> FBSPReader::GetRawLump(EBSPLump Lump) const
+{
+	if (!IsOpen())
+	{
+		return TArrayView<const uint8>();
+	}
+	const FBSPLumpInfo& Info = Lumps[(int32)Lump];
+	return TArrayView<const uint8>(Data + Info.Offset, Info.Length);
+}
+
+uint32 FBSPReader::ComputeMapChecksum() const
+{
+	uint32 CRC = 0;
+	for (int32 i = 0; i < (int32)EBSPLump::Count; ++i)
+	{
+		// Entities are left out so -onlyents and entity lump edits keep clients compatible
+		if (i == (int32)EBSPLump::Entities)
+		{
+			continue;
+		}
+		TArrayView<const uint8> Lump = GetRawLump((EBSPLump)i);
+		CRC = FCrc::MemCrc32(Lump.GetData(), Lump.Num(), CRC);
+	}
+	return CRC;
+}
+
+bool FBSPReader::ReadLump(EBSPLump Lump, TArray<uint8>& OutData) const
+{
+	TArrayView<const uint8> Raw = GetRawLump(Lump);
+	const FBSPLumpInfo& Info = Lumps[(int32)Lump];
+
+	// The pakfile is never compressed as a whole; its entries are
+	if (Info.FourCC != 0 && Lump != EBSPLump::PakFile && FLZMADecoder::HasValveHeader(Raw.GetData(), Raw.Num()))
+	{
+		if (!FLZMADecoder::DecompressValve(Raw.GetData(), Raw.Num(), OutData))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("BSPReader: Lump %d is corrupt (LZMA)"), (int32)Lump);
+			return false;
+		}
+		return true;
+	}
+
+	OutData = TArray<uint8>(Raw.GetData(), Raw.Num());
+	return true;
+}
+
+// ---- Game lump ----
+
+void FBSPReader::ParseGameLumpDirectory() const
+{
+	bGameLumpsParsed = true;
+	GameLumps.Reset();
+
+	// The directory itself is never compressed: int32 count, then 16-byte dgamelump_t entries
+	TArrayView<const uint8> Raw = GetRawLump(EBSPLump::GameLump);
+	if (Raw.Num() < 4)
+	{
+		return;
+	}
+	const int32 Count = (int32)ReadLE32(Raw.GetData());
+	if (Count < 0 || 4 + (int64)Count * 16 > Raw.Num())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BSPReader: Game lump directory is corrupt (%d entries)"), Count);
+		return;
+	}
+
+	GameLumps.Reserve(Count);
+	for (int32 i = 0; i < Count; ++i)
+	{
+		const uint8* P = Raw.GetData() + 4 + i * 16;
+		FBSPGameLumpInfo& Info = GameLumps.AddDefaulted_GetRef();
+		Info.Id = (int32)ReadLE32(P);
+		Info.Flags = ReadLE16(P + 4);
+		Info.Version = ReadLE16(P + 6);
+		Info.Offset = (int32)ReadLE32(P + 8);
+		Info.Length = (int32)ReadLE32(P + 12);
+	}
+}
+
+const TArray<FBSPGameLumpInfo>& FBSPReader::GetGameLumps() const
+{
+	if (!bGameLumpsParsed && IsOpen())
+	{
+		ParseGameLumpDirectory();
+	}
+	return GameLumps;
+}
+
+bool FBSPReader::ReadGameLump(int32 Id, TArray<uint8>& OutData, int32& OutVersion) const
+{
+	const TArray<FBSPGameLumpInfo>& Entries = GetGameLumps();
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		const FBSPGameLumpInfo& Info = Entries[i];
+		if (Info.Id != Id)
+		{
+			continue;
+		}
+		OutVersion = Info.Version;
+
+		if (Info.Flags & 1)
+		{
+			// Compressed sub-lumps run to the next entry's offset (vbsp writes a terminating
+			// empty entry for this); Length is the uncompressed size
+			const int64 End = i + 1 < Entries.Num() ? Entries[i + 1].Offset : DataSize;
+			if (Info.Offset < 0 || End <= Info.Offset || End > DataSize
+				|| !FLZMADecoder::HasValveHeader(Data + Info.Offset, End - Info.Offset)
+				|| !FLZMADecoder::DecompressValve(Data + Info.Offset, End - Info.Offset, OutData))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("BSPReader: Game lump %08x is corrupt (LZMA)"), (uint32)Id);
+				return false;
+			}
+			return true;
+		}
+
+		if (Info.Offset < 0 || Info.Length < 0 || (int64)Info.Offset + Info.Length > DataSize)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("BSPReader: Game lump %08x is out of bounds"), (uint32)Id);
+			return false;
+		}
+		OutData = TArray<uint8>(Data + Info.Offset, Info.Length);
+		return true;
+	}
+	return false;
+}
+
+// ---- Entities ----
+
+FString FBSPReader::ReadEntityString() const
+{
+	TArray<uint8> Bytes;
+	if (!ReadLump(EBSPLump::Entities, Bytes) || Bytes.Num() == 0)
+	{
+		return FString();
+	}
+
+	// NUL-terminated; entity text is ASCII/UTF-8
+	int32 Length = Bytes.Find(0);
+	if (Length == INDEX_NONE)
+	{
+		Length = Bytes.Num();
+	}
+	FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Bytes.GetData()), Length);
+	return FString(Converted.Length(), Converted.Get());
+}
+
+TArray<FVMFKeyValues> FBSPReader::ReadEntities() const
+{
+	TArray<FVMFKeyValues> Blocks;
+	FString Text = ReadEntityString();
+
+	int32 Pos = 0;
+	for (;;)
+	{
+		SkipWhitespace(Text, Pos);
+		if (Pos >= Text.Len() || Text[Pos] != TEXT('{'))
+		{
+			break;
+		}
+		Pos++;
+
+		FVMFKeyValues Entity(TEXT("entity"));
+		FVMFKeyValues Connections(TEXT("connections"));
+
+		for (;;)
+		{
+			SkipWhitespace(Text, Pos);
+			if (Pos >= Text.Len())
+			{
+				break;
+			}
+			if (Text[Pos] == TEXT('}'))
+			{
+				Pos++;
+				break;
+			}
+
+			FString Key;
+			FString Value;
+			if (!ReadQuoted(Text, Pos, Key))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("BSPReader: Malformed entity lump near offset %d"), Pos);
+				return Blocks;
+			}
+			SkipWhitespace(Text, Pos);
+			if (!ReadQuoted(Text, Pos, Value))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("BSPReader: Malformed entity lump near offset %d"), Pos);
+				return Blocks;
+			}
+
+			if (IsEntityOutput(Value))
+			{
+				Connections.AddProperty(Key, Value);
+			}
+			else
+			{
+				Entity.AddProperty(Key, Value);
+			}
+		}
+
+		const TPair<FString, FString>* ClassName = Entity.Properties.FindByPredicate(
+			[](const TPair<FString, FString>& Prop) { return Prop.Key.Equals(TEXT("classname"), ESearchCase::IgnoreCase); });
+		if (ClassName && ClassName->Value.Equals(TEXT("worldspawn"), ESearchCase::IgnoreCase))
+		{
+			Entity.ClassName = TEXT("world");
+		}
+
+		if (Connections.Properties.Num() > 0)
+		{
+			Entity.Children.Add(MoveTemp(Connections));
+		}
+		Blocks.Add(MoveTemp(Entity));
+	}
+
+	return Blocks;
+}
+
+// ---- Pakfile ----
+
+bool FBSPReader::ParsePakDirectory() const
+{
+	bPakParsed = true;
+	PakEntries.Reset();
+	PakIndex.Reset();
+
+	TArrayView<const uint8> Pak = GetRawLump(EBSPLump::PakFile);
+	const uint8* P = Pak.GetData();
+	const int64 Size = Pak.Num();
+	if (Size < ZIP_END_OF_DIR_SIZE)
+	{
+		return Size == 0;
+	}
+
+	// The end-of-directory record is last, followed only by an optional comment
+	int64 EndOfDir = INDEX_NONE;
+	for (int64 i = Size - ZIP_END_OF_DIR_SIZE; i >= FMath::Max<int64>(0, Size - ZIP_END_OF_DIR_SIZE - 0xFFFF); --i)
+	{
+		if (ReadLE32(P + i) == ZIP_END_OF_DIR_SIG)
+		{
+			EndOfDir = i;
+			break;
+		}
+	}
+	if (EndOfDir == INDEX_NONE)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BSPReader: Pakfile has no ZIP directory"));
+		return false;
+	}
+
+	int32 EntryCount = ReadLE16(P + EndOfDir + 10);
+	int64 DirOffset = ReadLE32(P + EndOfDir + 16);
+
+	// Some old tools wrote offsets relative to the BSP file instead of the lump
+	int64 LumpOffset = Lumps[(int32)EBSPLump::PakFile].Offset;
+	int64 OffsetBase = 0;
+	if (DirOffset + 4 > Size || ReadLE32(P + DirOffset) != ZIP_CENTRAL_HEADER_SIG)
+	{
+		OffsetBase = LumpOffset;
+		DirOffset -= LumpOffset;
+		if (DirOffset < 0 || DirOffset + 4 > Size || ReadLE32(P + DirOffset) != ZIP_CENTRAL_HEADER_SIG)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("BSPReader: Pakfile ZIP directory offset is invalid"));
+			return false;
+		}
+	}
+
+	int64 Pos = DirOffset;
+	PakEntries.Reserve(EntryCount);
+	for (int32 i = 0; i < EntryCount; ++i)
+	{
+		if (Pos + ZIP_CENTRAL_HEADER_SIZE > Size || ReadLE32(P + Pos) != ZIP_CENTRAL_HEADER_SIG)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("BSPReader: Pakfile ZIP directory is truncated at entry %d"), i);
+			return false;
+		}
+
+		int32 NameLength = ReadLE16(P + Pos + 28);
+		int32 ExtraLength = ReadLE16(P + Pos + 30);
+		int32 CommentLength = ReadLE16(P + Pos + 32);
+		if (Pos + ZIP_CENTRAL_HEADER_SIZE + NameLength > Size)
+		{
+			return false;
+		}
+
+		FBSPPakEntry Entry;
+		Entry.Method = ReadLE16(P + Pos + 10);
+		Entry.DosTime = ReadLE32(P + Pos + 12);
+		Entry.CRC = ReadLE32(P + Pos + 16);
+		Entry.CompressedSize = ReadLE32(P + Pos + 20);
+		Entry.UncompressedSize = ReadLE32(P + Pos + 24);
+		Entry.LocalHeaderOffset = (int64)ReadLE32(P + Pos + 42) - OffsetBase;
+
+		FUTF8ToTCHAR Name(reinterpret_cast<const ANSICHAR*>(P + Pos + ZIP_CENTRAL_HEADER_SIZE), NameLength);
+		Entry.Path = NormalizePakPath(FString(Name.Length(), Name.Get()));
+
+		Pos += ZIP_CENTRAL_HEADER_SIZE + NameLength + ExtraLength + CommentLength;
+
+		// Directory entries carry no data
+		if (Entry.Path.EndsWith(TEXT("/")))
+		{
+			continue;
+		}
+
+		PakIndex.Add(Entry.Path, PakEntries.Num());
+		PakEntries.Add(MoveTemp(Entry));
+	}
+
+	return true;
+}
+
+const TArray<FBSPPakEntry>& FBSPReader::GetPakEntries() const
+{
+	if (!bPakParsed && IsOpen())
+	{
+		ParsePakDirectory();
+	}
+	return PakEntries;
+}
+
+const FBSPPakEntry* FBSPReader::FindPakEntry(const FString& Path) const
+{
+	GetPakEntries();
+	const int32* Index = PakIndex.Find(NormalizePakPath(Path));
+	return Index ? &PakEntries[*Index] : nullptr;
+}
+
+TArrayView<const uint8> FBSPReader::GetPakEntryData(const FBSPPakEntry& Entry) const
+{
+	TArrayView<const uint8> Pak = GetRawLump(EBSPLump::PakFile);
+	const uint8* P = Pak.GetData();
+	const int64 Size = Pak.Num();
+
+	int64 Local = Entry.LocalHeaderOffset;
+	if (Local < 0 || Local + ZIP_LOCAL_HEADER_SIZE > Size || ReadLE32(P + Local) != ZIP_LOCAL_HEADER_SIG)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BSPReader: Bad local header for pakfile entry %s"), *Entry.Path);
+		return TArrayView<const uint8>();
+	}
+
+	// The local header's name/extra lengths may differ from the central directory's
+	int64 DataStart = Local + ZIP_LOCAL_HEADER_SIZE + ReadLE16(P + Local + 26) + ReadLE16(P + Local + 28);
+	if (DataStart + Entry.CompressedSize > Size || Entry.UncompressedSize > MAX_int32)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BSPReader: Pakfile entry %s is truncated"), *Entry.Path);
+		return TArrayView<const uint8>();
+	}
+	return TArrayView<const uint8>(P + DataStart, (int32)Entry.CompressedSize);
+}
+
+bool FBSPReader::ReadPakFile(const FBSPPakEntry& Entry, TArray<uint8>& OutData) const
+{
+	TArrayView<const uint8> Stored = GetPakEntryData(Entry);
+	if (Stored.Num() == 0 && Entry.CompressedSize > 0)
+	{
+		return false;
+	}
+	const uint8* Compressed = Stored.GetData();
+
+	bool bOk = false;
+	switch (Entry.Method)
+	{
+	case ZIP_METHOD_STORED:
+		OutData = TArray<uint8>(Compressed, (int32)Entry.CompressedSize);
+		bOk = true;
+		break;
+
+	case ZIP_METHOD_DEFLATE:
+		// Negative window bits select a raw deflate stream, as stored in ZIP
+		OutData.SetNumUninitialized((int32)Entry.UncompressedSize);
+		bOk = FCompression::UncompressMemory(NAME_Zlib, OutData.GetData(), OutData.Num(),
+			Compressed, Entry.CompressedSize, COMPRESS_NoFlags, -DEFAULT_ZLIB_BIT_WINDOW);
+		break;
+
+	case ZIP_METHOD_LZMA:
+		bOk = FLZMADecoder::DecompressZipEntry(Compressed, Entry.CompressedSize, Entry.UncompressedSize, OutData);
+		break;
+
+	default:
+		UE_LOG(LogTemp, Warning, TEXT("BSPReader: Pakfile entry %s uses unsupported compression %d"),
+			*Entry.Path, Entry.Method);
+		return false;
+	}
+
+	if (!bOk)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BSPReader: Failed to decompress pakfile entry %s"), *Entry.Path);
+		OutData.Reset();
+		return false;
+	}
+
+	if (FCrc::MemCrc32(OutData.GetData(), OutData.Num()) != Entry.CRC)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BSPReader: CRC mismatch in pakfile entry %s"), *Entry.Path);
+	}
+	return true;
+}
+
+int32 FBSPReader::ExtractPakFile(const FString& OutputDir) const
+{
+	int32 Written = 0;
+	TArray<uint8> FileBytes;
+	for (const FBSPPakEntry& Entry : GetPakEntries())
+	{
+		// Never write outside OutputDir
+		if (Entry.Path.Contains(TEXT("..")) || FPaths::IsDrive(Entry.Path.Left(2)) || Entry.Path.StartsWith(TEXT("/")))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("BSPReader: Skipping unsafe pakfile path %s"), *Entry.Path);
+			continue;
+		}
+
+		if (ReadPakFile(Entry, FileBytes) && FFileHelper::SaveArrayToFile(FileBytes, *(OutputDir / Entry.Path)))
+		{
+			Written++;
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("BSPReader: Extracted %d/%d pakfile entries to %s"),
+		Written, PakEntries.Num(), *OutputDir);
+	return Written;
+}
+
+// ---- Texture data ----
+
+TArray<FString> FBSPReader::ReadTexDataStrings() const
+{
+	TArray<FString> Strings;
+
+	TArray<uint8> StringData;
+	TArray<int32> StringTable;
+	if (!ReadLump(EBSPLump::TexDataStringData, StringData) || !ReadLumpArray(EBSPLump::TexDataStringTable, StringTable))
+	{
+		return Strings;
+	}
+
+	Strings.Reserve(StringTable.Num());
+	for (int32 Offset : StringTable)
+	{
+		if (Offset < 0 || Offset >= StringData.Num())
+		{
+			Strings.Add(FString());
+			continue;
+		}
+
+		int32 Length = 0;
+		while (Offset + Length < StringData.Num() && StringData[Offset + Length] != 0)
+		{
+			Length++;
+		}
+		FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(StringData.GetData() + Offset), Length);
+		Strings.Add(FString(Converted.Length(), Converted.Get()));
+	}
+	return Strings;
+}
+
+TArray<FBSPTexData> FBSPReader::ReadTexData() const
+{
+#pragma pack(push, 1)
+	struct FDiskTexData
+	{
+		float Reflectivity[3];
+		int32 NameStringTableID;
+		int32 Width;
+		int32 Height;
+		int32 ViewWidth;
+		int32 ViewHeight;
+	};
+#pragma pack(pop)
+
+	TArray<FBSPTexData> Result;
+	TArray<FDiskTexData> Disk;
+	if (!ReadLumpArray(EBSPLump::TexData, Disk))
+	{
+		return Result;
+	}
+
+	TArray<FString> Names = ReadTexDataStrings();
+	Result.Reserve(Disk.Num());
+	for (const FDiskTexData& Item : Disk)
+	{
+		FBSPTexData& TexData = Result.AddDefaulted_GetRef();
+		TexData.Reflectivity = FVector3f(Item.Reflectivity[0], Item.Reflectivity[1], Item.Reflectivity[2]);
+		TexData.MaterialName = Names.IsValidIndex(Item.NameStringTableID) ? Names[Item.NameStringTableID] : FString();
+		TexData.Width = Item.Width;
+		TexData.Height = Item.Height;
+	}
+	return Result;
+}
@@ -0,0 +1,154 @@
+#include "Import/BSPStaticProps.h"
+#include "Import/BSPReader.h"
+
+// Game lump id of the static props ('sprp' as an int)
+static const int32 GAMELUMP_STATIC_PROPS = ('s' << 24) | ('p' << 16) | ('r' << 8) | 'p';
+
+// Length of a model dictionary name
+static const int32 STATIC_PROP_NAME_LENGTH = 128;
+
+// Record layout shared by every version, up to and including the lighting origin (v4 size)
+static const int32 STATIC_PROP_V4_SIZE = 56;
+
+// Source 2013 multiplayer (CS:S, TF2, HL2DM) v10 records, also shipped as "v7" by some TF2
+// maps: v6 plus uint32 flags at 64 and lightmap resolution at 68, no diffuse modulation
+static const int32 STATIC_PROP_SDK2013_SIZE = 72;
+
+static const int32 STATIC_PROP_MIN_VERSION = 4;
+static const int32 STATIC_PROP_MAX_VERSION = 11;
+
+namespace
+{
+	int32 ReadInt32(const uint8* P) { int32 V; FMemory::Memcpy(&V, P, 4); return V; }
+	uint16 ReadUInt16(const uint8* P) { uint16 V; FMemory::Memcpy(&V, P, 2); return V; }
+	float ReadFloat(const uint8* P) { float V; FMemory::Memcpy(&V, P, 4); return V; }
+	FVector3f ReadVector(const uint8* P) { return FVector3f(ReadFloat(P), ReadFloat(P + 4), ReadFloat(P + 8)); }
+}
+
+bool FBSPStaticProps::Read(const FBSPReader& Reader, FBSPStaticPropLump& OutLump)
+{
+	OutLump = FBSPStaticPropLump();
+
+	TArray<uint8> Bytes;
+	int32 Version = 0;
+	if (!Reader.ReadGameLump(GAMELUMP_STATIC_PROPS, Bytes, Version))
+	{
+		return false;
+	}
+	if (Version < STATIC_PROP_MIN_VERSION || Version > STATIC_PROP_MAX_VERSION)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BSPStaticProps: Unsupported sprp version %d"), Version);
+		return false;
+	}
+	OutLump.Version = Version;
+
+	const uint8* P = Bytes.GetData();
+	const uint8* End = P + Bytes.Num();
+	auto Has = [&P, End](int64 Size) { return Size >= 0 && End - P >= Size; };
+
+	// Model dictionary
+	if (!Has(4))
+	{
+		return false;
+	}
+	const int32 ModelCount = ReadInt32(P);
+	P += 4;
+	if (!Has((int64)ModelCount * STATIC_PROP_NAME_LENGTH))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BSPStaticProps: Model dictionary is corrupt (%d entries)"), ModelCount);
+		return false;
+	}
+	OutLump.Models.Reserve(ModelCount);
+	for (int32 i = 0; i < ModelCount; ++i, P += STATIC_PROP_NAME_LENGTH)
+	{
+		const ANSICHAR* Name = reinterpret_cast<const ANSICHAR*>(P);
+		int32 Length = 0;
+		while (Length < STATIC_PROP_NAME_LENGTH && Name[Length] != 0)
+		{
+			Length++;
+		}
+		OutLump.Models.Add(FString(Length, Name));
+	}
+
+	// Leaf list: only used by the engine for visibility
+	if (!Has(4))
+	{
+		return false;
+	}
+	const int32 LeafCount = ReadInt32(P);
+	P += 4;
+	if (!Has((int64)LeafCount * 2))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BSPStaticProps: Leaf list is corrupt (%d entries)"), LeafCount);
+		return false;
+	}
+	P += LeafCount * 2;
+
+	// Prop records
+	if (!Has(4))
+	{
+		return false;
+	}
+	const int32 PropCount = ReadInt32(P);
+	P += 4;
+	if (PropCount <= 0)
+	{
+		return PropCount == 0;
+	}
+
+	const int32 RecordSize = (int32)((End - P) / PropCount);
+	if (RecordSize < STATIC_PROP_V4_SIZE)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BSPStaticProps: %d props don't fit in %d bytes"), PropCount, (int32)(End - P));
+		return false;
+	}
+
+	const bool bSDK2013Layout = (Version == 10 || Version == 7) && RecordSize == STATIC_PROP_SDK2013_SIZE;
+
+	OutLump.Props.Reserve(PropCount);
+	for (int32 i = 0; i < PropCount; ++i, P += RecordSize)
+	{
+		const int32 ModelIndex = ReadUInt16(P + 24);
+		if (ModelIndex >= OutLump.Models.Num())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("BSPStaticProps: Prop %d references missing model %d"), i, ModelIndex);
+			continue;
+		}
+
+		FBSPStaticProp& Prop = OutLump.Props.AddDefaulted_GetRef();
+		Prop.ModelIndex = ModelIndex;
+		Prop.Origin = ReadVector(P);
+		Prop.Angles = ReadVector(P + 12);
+		// 26: first leaf, 28: leaf count
+		Prop.Solid = P[30];
+		Prop.Flags = P[31];
+		Prop.Skin = ReadInt32(P + 32);
+		Prop.FadeMinDist = ReadFloat(P + 36);
+		Prop.FadeMaxDist = ReadFloat(P + 40);
+		// 44: lighting origin
+
+		if (Version >= 5 && RecordSize >= 60)
+		{
+			Prop.ForcedFadeScale = ReadFloat(P + 56);
+		}
+		// 60: DX levels (v6-7, SDK 2013) or CPU/GPU levels (v8+)
+		// SDK 2013 has uint32 flags at 64 and lightmap resolution at 68 instead of the color
+		if (!bSDK2013Layout && Version >= 7 && RecordSize >= 68)
+		{
+			Prop.DiffuseModulation = FColor(P[64], P[65], P[66], P[67]);
+		}
+		// 68: X360 flag (v9+, padded)
+		if (!bSDK2013Layout && Version >= 10 && RecordSize >= 76)
+		{
+			Prop.FlagsEx = (uint32)ReadInt32(P + 72);
+		}
+		if (Version >= 11 && RecordSize >= 80)
+		{
+			Prop.UniformScale = ReadFloat(P + 76);
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("BSPStaticProps: Read %d static props of %d models (sprp v%d, %d-byte records)"),
+		OutLump.Props.Num(), OutLump.Models.Num(), Version, RecordSize);
+	return true;
+}
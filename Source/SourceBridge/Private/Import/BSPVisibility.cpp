@@ -0,0 +1,254 @@
+#include "Import/BSPVisibility.h"
+#include "Import/BSPReader.h"
+#include "Algo/Unique.h"
+
+// On-disk record sizes (BSP v19-21)
+static const int32 BSP_PLANE_SIZE = 20;
+static const int32 BSP_NODE_SIZE = 32;
+static const int32 BSP_MODEL_SIZE = 48;
+
+// dleaf_t: version 0 of the leafs lump still embeds a 24-byte ambient light cube
+static const int32 BSP_LEAF_SIZE = 32;
+static const int32 BSP_LEAF_V0_SIZE = 56;
+
+// Leaf contents vbsp never lets the camera into
+static const int32 CONTENTS_SOLID = 0x1;
+
+// Bump if the serialized layout changes
+static const int32 VIS_SERIAL_VERSION = 1;
+
+namespace
+{
+	int32 ReadInt32(const uint8* P) { int32 V; FMemory::Memcpy(&V, P, 4); return V; }
+	int16 ReadInt16(const uint8* P) { int16 V; FMemory::Memcpy(&V, P, 2); return V; }
+	float ReadFloat(const uint8* P) { float V; FMemory::Memcpy(&V, P, 4); return V; }
+}
+
+bool FBSPVisibility::Load(const FBSPReader& Reader)
+{
+	*this = FBSPVisibility();
+
+	TArray<uint8> Bytes;
+	if (!Reader.ReadLump(EBSPLump::Planes, Bytes))
+	{
+		return false;
+	}
+	Planes.Reserve(Bytes.Num() / BSP_PLANE_SIZE);
+	for (int32 Offset = 0; Offset + BSP_PLANE_SIZE <= Bytes.Num(); Offset += BSP_PLANE_SIZE)
+	{
+		const uint8* P = Bytes.GetData() + Offset;
+		Planes.Add(FVector4f(ReadFloat(P), ReadFloat(P + 4), ReadFloat(P + 8), ReadFloat(P + 12)));
+	}
+
+	if (!Reader.ReadLump(EBSPLump::Nodes, Bytes))
+	{
+		return false;
+	}
+	const int32 NumNodes = Bytes.Num() / BSP_NODE_SIZE;
+	NodePlanes.Reserve(NumNodes);
+	NodeChildren.Reserve(NumNodes * 2);
+	for (int32 i = 0; i < NumNodes; ++i)
+	{
+		const uint8* P = Bytes.GetData() + i * BSP_NODE_SIZE;
+		NodePlanes.Add(ReadInt32(P));
+		NodeChildren.Add(ReadInt32(P + 4));
+		NodeChildren.Add(ReadInt32(P + 8));
+	}
+
+	const int32 LeafSize = Reader.GetLumpInfo(EBSPLump::Leafs).Version == 0 ? BSP_LEAF_V0_SIZE : BSP_LEAF_SIZE;
+	if (!Reader.ReadLump(EBSPLump::Leafs, Bytes))
+	{
+		return false;
+	}
+	const int32 NumLeafs = Bytes.Num() / LeafSize;
+	LeafClusters.Reserve(NumLeafs);
+	for (int32 i = 0; i < NumLeafs; ++i)
+	{
+		const uint8* P = Bytes.GetData() + i * LeafSize;
+		const int32 Contents = ReadInt32(P);
+		LeafClusters.Add((Contents & CONTENTS_SOLID) ? -1 : (int32)ReadInt16(P + 4));
+	}
+
+	// The world is model 0; its head node is normally node 0
+	if (Reader.ReadLump(EBSPLump::Models, Bytes) && Bytes.Num() >= BSP_MODEL_SIZE)
+	{
+		HeadNode = ReadInt32(Bytes.GetData() + 36);
+	}
+
+	// Visibility: cluster count, then a PVS and a PAS offset per cluster
+	if (!Reader.ReadLump(EBSPLump::Visibility, VisData) || VisData.Num() < 4)
+	{
+		UE_LOG(LogTemp, Log, TEXT("BSPVisibility: Map has no visibility data (not vvis'd)"));
+		*this = FBSPVisibility();
+		return false;
+	}
+	const int32 Clusters = ReadInt32(VisData.GetData());
+	if (Clusters <= 0 || 4 + (int64)Clusters * 8 > VisData.Num())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BSPVisibility: Visibility lump is corrupt (%d clusters)"), Clusters);
+		*this = FBSPVisibility();
+		return false;
+	}
+	NumClusters = Clusters;
+	PVSOffsets.Reserve(NumClusters);
+	for (int32 i = 0; i < NumClusters; ++i)
+	{
+		PVSOffsets.Add(ReadInt32(VisData.GetData() + 4 + i * 8));
+	}
+
+	if (!NodePlanes.IsValidIndex(HeadNode))
+	{
+		*this = FBSPVisibility();
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("BSPVisibility: %d nodes, %d leafs, %d clusters"), NumNodes, NumLeafs, NumClusters);
+	return true;
+}
+
+int32 FBSPVisibility::FindLeaf(const FVector3f& Point) const
+{
+	int32 Node = HeadNode;
+	// Bounded walk: a corrupt tree with a cycle can't hang the editor
+	for (int32 Depth = 0; Node >= 0 && Depth < NodePlanes.Num(); ++Depth)
+	{
+		if (!NodePlanes.IsValidIndex(Node) || !Planes.IsValidIndex(NodePlanes[Node]))
+		{
+			return 0;
+		}
+		const FVector4f& Plane = Planes[NodePlanes[Node]];
+		const float Distance = Point.X * Plane.X + Point.Y * Plane.Y + Point.Z * Plane.Z - Plane.W;
+		Node = NodeChildren[Node * 2 + (Distance >= 0.0f ? 0 : 1)];
+	}
+	return Node < 0 ? -1 - Node : 0;
+}
+
+int32 FBSPVisibility::FindCluster(const FVector3f& Point) const
+{
+	const int32 Leaf = FindLeaf(Point);
+	return LeafClusters.IsValidIndex(Leaf) ? LeafClusters[Leaf] : -1;
+}
+
+bool FBSPVisibility::GetVisibleClusters(int32 Cluster, TBitArray<>& OutVisible) const
+{
+	OutVisible.Init(true, NumClusters);
+	if (!PVSOffsets.IsValidIndex(Cluster))
+	{
+		return false;
+	}
+
+	int32 Offset = PVSOffsets[Cluster];
+	if (Offset <= 0 || Offset >= VisData.Num())
+	{
+		return false;
+	}
+
+	// Literal bytes, except 0 followed by a count of zero bytes
+	OutVisible.Init(false, NumClusters);
+	const int32 RowBytes = (NumClusters + 7) >> 3;
+	int32 Byte = 0;
+	while (Byte < RowBytes && Offset < VisData.Num())
+	{
+		const uint8 Value = VisData[Offset++];
+		if (Value == 0)
+		{
+			if (Offset >= VisData.Num())
+			{
+				break;
+			}
+			Byte += VisData[Offset++];
+			continue;
+		}
+		for (int32 Bit = 0; Bit < 8; ++Bit)
+		{
+			const int32 Index = Byte * 8 + Bit;
+			if ((Value & (1 << Bit)) && Index < NumClusters)
+			{
+				OutVisible[Index] = true;
+			}
+		}
+		Byte++;
+	}
+	return true;
+}
+
+bool FBSPVisibility::IsClusterVisible(int32 From, int32 To) const
+{
+	if (From < 0 || To < 0 || From == To)
+	{
+		return true;
+	}
+	TBitArray<> Visible;
+	GetVisibleClusters(From, Visible);
+	return !Visible.IsValidIndex(To) || Visible[To];
+}
+
+void FBSPVisibility::GetClustersInBox(const FBox3f& Box, TArray<int32>& OutClusters) const
+{
+	OutClusters.Reset();
+	if (!IsValid() || !Box.IsValid)
+	{
+		return;
+	}
+
+	const FVector3f Center = Box.GetCenter();
+	const FVector3f Extent = Box.GetExtent();
+
+	TArray<int32, TInlineAllocator<64>> Stack;
+	Stack.Add(HeadNode);
+	int32 Visited = 0;
+	while (Stack.Num() > 0 && Visited++ < NodePlanes.Num() + LeafClusters.Num())
+	{
+		const int32 Child = Stack.Pop();
+		if (Child < 0)
+		{
+			const int32 Leaf = -1 - Child;
+			if (LeafClusters.IsValidIndex(Leaf) && LeafClusters[Leaf] >= 0)
+			{
+				OutClusters.Add(LeafClusters[Leaf]);
+			}
+			continue;
+		}
+		if (!NodePlanes.IsValidIndex(Child) || !Planes.IsValidIndex(NodePlanes[Child]))
+		{
+			continue;
+		}
+
+		// Which sides of the node's plane the box reaches
+		const FVector4f& Plane = Planes[NodePlanes[Child]];
+		const float Distance = Center.X * Plane.X + Center.Y * Plane.Y + Center.Z * Plane.Z - Plane.W;
+		const float Radius = Extent.X * FMath::Abs(Plane.X) + Extent.Y * FMath::Abs(Plane.Y) + Extent.Z * FMath::Abs(Plane.Z);
+		if (Distance >= -Radius)
+		{
+			Stack.Add(NodeChildren[Child * 2]);
+		}
+		if (Distance < Radius)
+		{
+			Stack.Add(NodeChildren[Child * 2 + 1]);
+		}
+	}
+
+	OutClusters.Sort();
+	OutClusters.SetNum(Algo::Unique(OutClusters));
+}
+
+FArchive& operator<<(FArchive& Ar, FBSPVisibility& Vis)
+{
+	int32 SerialVersion = VIS_SERIAL_VERSION;
+	Ar << SerialVersion;
+	if (Ar.IsLoading() && SerialVersion != VIS_SERIAL_VERSION)
+	{
+		Ar.SetError();
+		return Ar;
+	}
+
+	Ar << Vis.Planes;
+	Ar << Vis.NodePlanes;
+	Ar << Vis.NodeChildren;
+	Ar << Vis.HeadNode;
+	Ar << Vis.LeafClusters;
+	Ar << Vis.NumClusters;
+	Ar << Vis.PVSOffsets;
+	Ar << Vis.VisData;
+	return Ar;
+}
@@ -1,6 +1,7 @@
 #include "Import/MaterialImporter.h"
 #include "Import/VTFReader.h"
 #include "Import/VPKReader.h"
+#include "Import/VMFReader.h"
 #include "Materials/SourceMaterialManifest.h"
 #include "Compile/CompilePipeline.h"
 #include "UI/SourceBridgeSettings.h"
@@ -14,6 +15,8 @@
 #include "Materials/MaterialExpressionScalarParameter.h"
 #include "Materials/MaterialExpressionMultiply.h"
 #include "Materials/MaterialExpressionConstant.h"
+#include "Materials/MaterialExpressionTextureCoordinate.h"
+#include "Materials/MaterialInstanceDynamic.h"
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "Engine/Texture2D.h"
 #include "Misc/FileHelper.h"
@@ -32,177 +35,171 @@ TMap<FString, FString> FMaterialImporter::ReverseToolMappings;
 FString FMaterialImporter::AssetSearchPath;
 TArray<FString> FMaterialImporter::AdditionalSearchPaths;
 TArray<TSharedPtr<FVPKReader>> FMaterialImporter::VPKArchives;
+TMap<FString, TSharedPtr<const FVMTParsedMaterial>> FMaterialImporter::ParsedVMTCache;
 UMaterial* FMaterialImporter::CachedOpaqueMaterial = nullptr;
 UMaterial* FMaterialImporter::CachedMaskedMaterial = nullptr;
 UMaterial* FMaterialImporter::CachedTranslucentMaterial = nullptr;
 UMaterial* FMaterialImporter::CachedColorMaterial = nullptr;
 UMaterial* FMaterialImporter::CachedToolMaterial = nullptr;
+UMaterial* FMaterialImporter::CachedLightmappedOpaqueMaterial = nullptr;
+UMaterial* FMaterialImporter::CachedLightmappedMaskedMaterial = nullptr;
+UMaterial* FMaterialImporter::CachedLightmappedTranslucentMaterial = nullptr;
 
 // ===========================================================================
-// VMT Parsing (unchanged from original)
+// VMT Parsing
 // ===========================================================================
 
+/** Maximum nesting of patch materials (guards against include cycles). */
+static const int32 MaxVMTIncludeDepth = 8;
+
 FVMTParsedMaterial FMaterialImporter::ParseVMT(const FString& VMTContent)
 {
 	FVMTParsedMaterial Result;
 
-	const TCHAR* Ptr = *VMTContent;
-
-	auto SkipWS = [&]()
+	// VMTs don't use escape sequences ("models\nature" must stay intact)
+	TArray<FVMFKeyValues> Roots = FVMFReader::ParseString(VMTContent, false);
+	if (Roots.Num() == 0)
 	{
-		while (*Ptr)
-		{
-			if (*Ptr == ' ' || *Ptr == '\t' || *Ptr == '\r' || *Ptr == '\n')
-			{
-				Ptr++;
-			}
-			else if (*Ptr == '/' && *(Ptr + 1) == '/')
-			{
-				while (*Ptr && *Ptr != '\n') Ptr++;
-			}
-			else
-			{
-				break;
-			}
-		}
-	};
+		return Result;
+	}
 
-	auto ReadQuoted = [&]() -> FString
+	FVMFKeyValues& Root = Roots[0];
+	Result.ShaderName = Root.ClassName;
+	Result.Parameters.Reserve(Root.Properties.Num());
+	for (const TPair<FString, FString>& Prop : Root.Properties)
 	{
-		if (*Ptr != '"') return FString();
-		Ptr++;
-		FString Value;
-		while (*Ptr && *Ptr != '"')
+		if (!Prop.Key.IsEmpty())
 		{
-			Value += *Ptr;
-			Ptr++;
+			Result.Parameters.Add(Prop.Key.ToLower(), Prop.Value);
 		}
-		if (*Ptr == '"') Ptr++;
-		return Value;
-	};
+	}
+	Result.Blocks = MoveTemp(Root.Children);
 
-	auto ReadToken = [&]() -> FString
-	{
-		FString Token;
-		while (*Ptr && *Ptr != ' ' && *Ptr != '\t' && *Ptr != '\r' &&
-			*Ptr != '\n' && *Ptr != '{' && *Ptr != '}' && *Ptr != '"')
-		{
-			Token += *Ptr;
-			Ptr++;
-		}
-		return Token;
-	};
+	return Result;
+}
 
-	auto SkipInlineWS = [&]()
+FVMTParsedMaterial FMaterialImporter::ParseVMTFile(const FString& FilePath)
+{
+	FString Content;
+	if (FFileHelper::LoadFileToString(Content, *FilePath))
 	{
-		while (*Ptr == ' ' || *Ptr == '\t')
-		{
-			Ptr++;
-		}
-	};
+		return ParseVMT(Content);
+	}
+	return FVMTParsedMaterial();
+}
 
-	auto ReadRestOfLine = [&]() -> FString
-	{
-		FString Value;
-		while (*Ptr && *Ptr != '\r' && *Ptr != '\n' && *Ptr != '{' && *Ptr != '}')
-		{
-			if (*Ptr == '/' && *(Ptr + 1) == '/')
-			{
-				break;
-			}
-			Value += *Ptr;
-			Ptr++;
-		}
-		return Value.TrimStartAndEnd();
-	};
+TSharedPtr<const FVMTParsedMaterial> FMaterialImporter::FindParsedVMT(const FString& SourceMaterialPath)
+{
+	return FindParsedVMTInternal(SourceMaterialPath, 0);
+}
 
-	// Read shader name
-	SkipWS();
-	if (*Ptr == '"')
+TSharedPtr<const FVMTParsedMaterial> FMaterialImporter::FindParsedVMTInternal(
+	const FString& SourceMaterialPath, int32 IncludeDepth)
+{
+	FString Key = SourceMaterialPath.Replace(TEXT("\\"), TEXT("/")).ToLower();
+	if (const TSharedPtr<const FVMTParsedMaterial>* Cached = ParsedVMTCache.Find(Key))
 	{
-		Result.ShaderName = ReadQuoted();
+		return *Cached;
 	}
-	else
+
+	FString Content;
+	bool bFromVPK = false;
+	if (!FindVMTContent(SourceMaterialPath, Content, bFromVPK))
 	{
-		Result.ShaderName = ReadToken();
+		ParsedVMTCache.Add(Key, nullptr);
+		return nullptr;
 	}
 
-	// Find opening brace
-	SkipWS();
-	if (*Ptr == '{')
-	{
-		Ptr++;
-		int32 Depth = 1;
+	TSharedPtr<FVMTParsedMaterial> Parsed = MakeShared<FVMTParsedMaterial>(ParseVMT(Content));
+	Parsed->bFromVPK = bFromVPK;
 
-		while (*Ptr && Depth > 0)
+	if (Parsed->IsPatch())
+	{
+		// include "materials/foo/bar.vmt" -> "foo/bar"
+		FString IncludePath = Parsed->Parameters.FindRef(TEXT("include")).Replace(TEXT("\\"), TEXT("/"));
+		if (IncludePath.StartsWith(TEXT("materials/"), ESearchCase::IgnoreCase))
+		{
+			IncludePath = IncludePath.Mid(10);
+		}
+		if (IncludePath.EndsWith(TEXT(".vmt"), ESearchCase::IgnoreCase))
 		{
-			SkipWS();
+			IncludePath = IncludePath.LeftChop(4);
+		}
 
-			if (*Ptr == '{')
-			{
-				Depth++;
-				Ptr++;
-			}
-			else if (*Ptr == '}')
+		TSharedPtr<const FVMTParsedMaterial> Base;
+		if (IncludePath.IsEmpty())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("MaterialImporter: Patch material '%s' has no include"), *SourceMaterialPath);
+		}
+		else if (IncludeDepth >= MaxVMTIncludeDepth)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("MaterialImporter: Patch material '%s' exceeds include depth %d (cycle?)"),
+				*SourceMaterialPath, MaxVMTIncludeDepth);
+		}
+		else
+		{
+			Base = FindParsedVMTInternal(IncludePath, IncludeDepth + 1);
+			if (!Base.IsValid())
 			{
-				Depth--;
-				Ptr++;
+				UE_LOG(LogTemp, Warning, TEXT("MaterialImporter: Patch material '%s' includes missing VMT '%s'"),
+					*SourceMaterialPath, *IncludePath);
 			}
-			else if (Depth == 1 && (*Ptr == '"' || *Ptr == '$' || *Ptr == '%' || FChar::IsAlpha(*Ptr)))
-			{
-				FString Key;
-				if (*Ptr == '"')
-				{
-					Key = ReadQuoted();
-				}
-				else
-				{
-					Key = ReadToken();
-				}
-
-				SkipInlineWS();
+		}
 
-				FString Value;
-				if (*Ptr == '"')
-				{
-					Value = ReadQuoted();
-				}
-				else if (*Ptr && *Ptr != '\r' && *Ptr != '\n' && *Ptr != '{' && *Ptr != '}')
-				{
-					Value = ReadRestOfLine();
-				}
+		if (!Base.IsValid())
+		{
+			ParsedVMTCache.Add(Key, nullptr);
+			return nullptr;
+		}
 
-				if (!Key.IsEmpty())
-				{
-					Result.Parameters.Add(Key.ToLower(), Value);
-				}
-			}
-			else if (*Ptr == '"')
+		TSharedPtr<FVMTParsedMaterial> Resolved = MakeShared<FVMTParsedMaterial>(*Base);
+		Resolved->bFromVPK = bFromVPK;
+		for (const FVMFKeyValues& PatchBlock : Parsed->Blocks)
+		{
+			if (PatchBlock.ClassName.Equals(TEXT("insert"), ESearchCase::IgnoreCase))
 			{
-				ReadQuoted();
+				ApplyVMTPatchBlock(*Resolved, PatchBlock, true);
 			}
-			else if (*Ptr)
+			else if (PatchBlock.ClassName.Equals(TEXT("replace"), ESearchCase::IgnoreCase))
 			{
-				FString Tok = ReadToken();
-				if (Tok.IsEmpty())
-				{
-					Ptr++;
-				}
+				ApplyVMTPatchBlock(*Resolved, PatchBlock, false);
 			}
 		}
+		Parsed = Resolved;
 	}
 
-	return Result;
+	ParsedVMTCache.Add(Key, Parsed);
+	return Parsed;
 }
 
-FVMTParsedMaterial FMaterialImporter::ParseVMTFile(const FString& FilePath)
+void FMaterialImporter::ApplyVMTPatchBlock(FVMTParsedMaterial& Target, const FVMFKeyValues& PatchBlock, bool bInsert)
 {
-	FString Content;
-	if (FFileHelper::LoadFileToString(Content, *FilePath))
+	for (const TPair<FString, FString>& Prop : PatchBlock.Properties)
 	{
-		return ParseVMT(Content);
+		FString Key = Prop.Key.ToLower();
+		if (bInsert || Target.Parameters.Contains(Key))
+		{
+			Target.Parameters.Add(Key, Prop.Value);
+		}
+	}
+
+	// Nested blocks (e.g. Proxies) are swapped wholesale
+	for (const FVMFKeyValues& Child : PatchBlock.Children)
+	{
+		int32 Existing = Target.Blocks.IndexOfByPredicate([&Child](const FVMFKeyValues& Block)
+		{
+			return Block.ClassName.Equals(Child.ClassName, ESearchCase::IgnoreCase);
+		});
+
+		if (Existing != INDEX_NONE)
+		{
+			Target.Blocks[Existing] = Child;
+		}
+		else if (bInsert)
+		{
+			Target.Blocks.Add(Child);
+		}
 	}
-	return FVMTParsedMaterial();
 }
 
 // ===========================================================================
@@ -212,12 +209,14 @@ FVMTParsedMaterial FMaterialImporter::ParseVMTFile(const FString& FilePath)
 void FMaterialImporter::SetAssetSearchPath(const FString& Path)
 {
 	AssetSearchPath = Path;
+	ParsedVMTCache.Empty();
 	UE_LOG(LogTemp, Log, TEXT("MaterialImporter: Asset search path set to: %s"), *Path);
 }
 
 void FMaterialImporter::SetupGameSearchPaths(const FString& GameName)
 {
 	AdditionalSearchPaths.Empty();
+	ParsedVMTCache.Empty();
 
 	FString GameDir = FCompilePipeline::FindGameDirectory(GameName);
 	if (GameDir.IsEmpty())
@@ -475,85 +474,15 @@ UMaterialInterface* FMaterialImporter::FindExistingMaterial(const FString& Sourc
 
 UMaterialInterface* FMaterialImporter::CreateMaterialFromVMT(const FString& SourceMaterialPath)
 {
-	// Build the list of directories to search
-	TArray<FString> SearchRoots;
-	if (!AssetSearchPath.IsEmpty())
+	// ---- Find and parse VMT (shared cache, patch materials resolved) ----
+	TSharedPtr<const FVMTParsedMaterial> ParsedVMT = FindParsedVMT(SourceMaterialPath);
+	if (!ParsedVMT.IsValid())
 	{
-		SearchRoots.Add(AssetSearchPath);
-	}
-	SearchRoots.Append(AdditionalSearchPaths);
-
-	// ---- Find VMT ----
-	FString VMTFullPath;
-	FString VMTRelPath = TEXT("materials") / SourceMaterialPath + TEXT(".vmt");
-
-	// 1. Exact path on disk
-	for (const FString& Root : SearchRoots)
-	{
-		FString CandidatePath = Root / VMTRelPath;
-		CandidatePath = CandidatePath.Replace(TEXT("\\"), TEXT("/"));
-
-		if (FPaths::FileExists(CandidatePath))
-		{
-			VMTFullPath = CandidatePath;
-			break;
-		}
-	}
-
-	// 2. VPK archives
-	FVMTParsedMaterial VMTData;
-	bool bFoundInVPK = false;
-	if (VMTFullPath.IsEmpty())
-	{
-		FString VMTContent = FindVMTInVPK(SourceMaterialPath);
-		if (!VMTContent.IsEmpty())
-		{
-			VMTData = ParseVMT(VMTContent);
-			bFoundInVPK = true;
-		}
-	}
-
-	// 3. Case-insensitive disk search (last resort)
-	if (VMTFullPath.IsEmpty() && VMTData.ShaderName.IsEmpty())
-	{
-		FString SearchPath = SourceMaterialPath + TEXT(".vmt");
-		SearchPath = SearchPath.Replace(TEXT("\\"), TEXT("/"));
-
-		for (const FString& Root : SearchRoots)
-		{
-			FString MaterialsDir = Root / TEXT("materials");
-			if (!FPaths::DirectoryExists(MaterialsDir)) continue;
-
-			TArray<FString> AllVMTs;
-			IFileManager::Get().FindFilesRecursive(AllVMTs, *MaterialsDir, TEXT("*.vmt"), true, false);
-
-			for (const FString& FoundVMT : AllVMTs)
-			{
-				FString RelPath = FoundVMT;
-				FPaths::MakePathRelativeTo(RelPath, *(MaterialsDir + TEXT("/")));
-				RelPath = RelPath.Replace(TEXT("\\"), TEXT("/"));
-
-				if (RelPath.Equals(SearchPath, ESearchCase::IgnoreCase))
-				{
-					VMTFullPath = FoundVMT;
-					break;
-				}
-			}
-
-			if (!VMTFullPath.IsEmpty()) break;
-		}
-
-		if (VMTFullPath.IsEmpty())
-		{
-			return nullptr;
-		}
+		return nullptr;
 	}
 
-	// Parse from disk if not already parsed from VPK
-	if (!VMTFullPath.IsEmpty())
-	{
-		VMTData = ParseVMTFile(VMTFullPath);
-	}
+	const FVMTParsedMaterial& VMTData = *ParsedVMT;
+	const bool bFoundInVPK = VMTData.bFromVPK;
 
 	if (VMTData.ShaderName.IsEmpty())
 	{
@@ -1123,6 +1052,213 @@ UMaterial* FMaterialImporter::GetOrCreateBaseMaterial(ESourceAlphaMode AlphaMode
 	return Mat;
 }
 
+UMaterial* FMaterialImporter::GetOrCreateLightmappedBaseMaterial(ESourceAlphaMode AlphaMode)
+{
+	UMaterial** CachePtr = nullptr;
+	FString MaterialName;
+
+	switch (AlphaMode)
+	{
+	case ESourceAlphaMode::Opaque:
+		CachePtr = &CachedLightmappedOpaqueMaterial;
+		MaterialName = TEXT("M_SourceBridge_Lightmapped_Opaque");
+		break;
+	case ESourceAlphaMode::Masked:
+		CachePtr = &CachedLightmappedMaskedMaterial;
+		MaterialName = TEXT("M_SourceBridge_Lightmapped_Masked");
+		break;
+	case ESourceAlphaMode::Translucent:
+		CachePtr = &CachedLightmappedTranslucentMaterial;
+		MaterialName = TEXT("M_SourceBridge_Lightmapped_Translucent");
+		break;
+	}
+
+	if (*CachePtr && (*CachePtr)->IsValidLowLevel())
+	{
+		return *CachePtr;
+	}
+
+	FString AssetPath = FString::Printf(TEXT("/Game/SourceBridge/BaseMaterials/%s"), *MaterialName);
+	FString FullObjectPath = AssetPath + TEXT(".") + MaterialName;
+	UMaterial* Mat = LoadObject<UMaterial>(nullptr, *FullObjectPath);
+	if (Mat)
+	{
+		*CachePtr = Mat;
+		return Mat;
+	}
+
+	UPackage* Package = CreatePackage(*AssetPath);
+	if (!Package) return nullptr;
+
+	Mat = NewObject<UMaterial>(Package, *MaterialName, RF_Public | RF_Standalone);
+	if (!Mat) return nullptr;
+
+	// The baked lighting replaces UE's: unlit, emissive = base texture * lightmap * scale
+	Mat->SetShadingModel(MSM_Unlit);
+
+	UTexture2D* WhiteTexture = LoadObject<UTexture2D>(nullptr, TEXT("/Engine/EngineResources/WhiteSquareTexture.WhiteSquareTexture"));
+
+	UMaterialExpressionTextureSampleParameter2D* TexParam =
+		NewObject<UMaterialExpressionTextureSampleParameter2D>(Mat);
+	TexParam->ParameterName = FName(TEXT("BaseTexture"));
+	TexParam->SamplerType = SAMPLERTYPE_Color;
+	TexParam->Texture = WhiteTexture;
+	Mat->GetExpressionCollection().AddExpression(TexParam);
+
+	UMaterialExpressionTextureCoordinate* LightmapCoords = NewObject<UMaterialExpressionTextureCoordinate>(Mat);
+	LightmapCoords->CoordinateIndex = 1;
+	Mat->GetExpressionCollection().AddExpression(LightmapCoords);
+
+	UMaterialExpressionTextureSampleParameter2D* LightmapParam =
+		NewObject<UMaterialExpressionTextureSampleParameter2D>(Mat);
+	LightmapParam->ParameterName = FName(TEXT("Lightmap"));
+	LightmapParam->SamplerType = SAMPLERTYPE_LinearColor;
+	LightmapParam->Texture = WhiteTexture;
+	LightmapParam->Coordinates.Connect(0, LightmapCoords);
+	Mat->GetExpressionCollection().AddExpression(LightmapParam);
+
+	UMaterialExpressionScalarParameter* ScaleParam = NewObject<UMaterialExpressionScalarParameter>(Mat);
+	ScaleParam->ParameterName = FName(TEXT("LightmapScale"));
+	ScaleParam->DefaultValue = 1.0f;
+	Mat->GetExpressionCollection().AddExpression(ScaleParam);
+
+	UMaterialExpressionMultiply* LitNode = NewObject<UMaterialExpressionMultiply>(Mat);
+	LitNode->A.Connect(0, TexParam);
+	LitNode->B.Connect(0, LightmapParam);
+	Mat->GetExpressionCollection().AddExpression(LitNode);
+
+	UMaterialExpressionMultiply* ScaledNode = NewObject<UMaterialExpressionMultiply>(Mat);
+	ScaledNode->A.Connect(0, LitNode);
+	ScaledNode->B.Connect(0, ScaleParam);
+	Mat->GetExpressionCollection().AddExpression(ScaledNode);
+	Mat->GetEditorOnlyData()->EmissiveColor.Connect(0, ScaledNode);
+
+	if (AlphaMode == ESourceAlphaMode::Masked)
+	{
+		Mat->BlendMode = BLEND_Masked;
+		Mat->TwoSided = true;
+		Mat->GetEditorOnlyData()->OpacityMask.Connect(4, TexParam);
+	}
+	else if (AlphaMode == ESourceAlphaMode::Translucent)
+	{
+		Mat->BlendMode = BLEND_Translucent;
+		Mat->TwoSided = true;
+
+		UMaterialExpressionScalarParameter* OpacityScaleParam =
+			NewObject<UMaterialExpressionScalarParameter>(Mat);
+		OpacityScaleParam->ParameterName = FName(TEXT("OpacityScale"));
+		OpacityScaleParam->DefaultValue = 1.0f;
+		Mat->GetExpressionCollection().AddExpression(OpacityScaleParam);
+
+		UMaterialExpressionMultiply* MultiplyNode = NewObject<UMaterialExpressionMultiply>(Mat);
+		MultiplyNode->A.Connect(4, TexParam);
+		MultiplyNode->B.Connect(0, OpacityScaleParam);
+		Mat->GetExpressionCollection().AddExpression(MultiplyNode);
+
+		Mat->GetEditorOnlyData()->Opacity.Connect(0, MultiplyNode);
+	}
+
+	Mat->PreEditChange(nullptr);
+	Mat->PostEditChange();
+
+	Package->MarkPackageDirty();
+	FAssetRegistryModule::AssetCreated(Mat);
+	SaveAsset(Mat);
+
+	*CachePtr = Mat;
+	UE_LOG(LogTemp, Log, TEXT("MaterialImporter: Created persistent lightmapped base material: %s"), *MaterialName);
+	return Mat;
+}
+
+UTexture2D* FMaterialImporter::CreateLightmapTexture(const TArray<FFloat16Color>& Pixels, int32 Width, int32 Height,
+	const FString& AssetPath)
+{
+	if (Pixels.Num() != Width * Height || Width <= 0 || Height <= 0)
+	{
+		return nullptr;
+	}
+
+	// Re-imports overwrite the existing atlas so level references stay valid
+	FString AssetName = FPaths::GetCleanFilename(AssetPath);
+	FString FullObjectPath = AssetPath + TEXT(".") + AssetName;
+	UTexture2D* Texture = LoadObject<UTexture2D>(nullptr, *FullObjectPath);
+	if (!Texture)
+	{
+		UPackage* Package = CreatePackage(*AssetPath);
+		if (!Package)
+		{
+			UE_LOG(LogTemp, Error, TEXT("MaterialImporter: Failed to create package for lightmap: %s"), *AssetPath);
+			return nullptr;
+		}
+		Texture = NewObject<UTexture2D>(Package, *AssetName, RF_Public | RF_Standalone);
+		if (!Texture) return nullptr;
+		FAssetRegistryModule::AssetCreated(Texture);
+	}
+
+	Texture->PreEditChange(nullptr);
+	Texture->Source.Init(Width, Height, 1, 1, TSF_RGBA16F, reinterpret_cast<const uint8*>(Pixels.GetData()));
+	Texture->SRGB = false;
+	Texture->CompressionSettings = TC_HDR;
+	Texture->LODGroup = TEXTUREGROUP_Lightmap;
+	Texture->Filter = TF_Bilinear;
+	Texture->AddressX = TA_Clamp;
+	Texture->AddressY = TA_Clamp;
+	Texture->MipGenSettings = TMGS_NoMipmaps;
+	Texture->PostEditChange();
+
+	Texture->GetOutermost()->MarkPackageDirty();
+	SaveAsset(Texture);
+
+	UE_LOG(LogTemp, Log, TEXT("MaterialImporter: Created lightmap %dx%d: %s"), Width, Height, *AssetPath);
+	return Texture;
+}
+
+UMaterialInterface* FMaterialImporter::CreateLightmappedMaterial(UMaterialInterface* Material, UTexture2D* Lightmap,
+	UObject* Outer)
+{
+	if (!Material || !Lightmap)
+	{
+		return nullptr;
+	}
+
+	UTexture* BaseTexture = nullptr;
+	if (!Material->GetTextureParameterValue(FMaterialParameterInfo(TEXT("BaseTexture")), BaseTexture) || !BaseTexture)
+	{
+		return nullptr;
+	}
+
+	ESourceAlphaMode AlphaMode = ESourceAlphaMode::Opaque;
+	switch (Material->GetBlendMode())
+	{
+	case BLEND_Masked:
+		AlphaMode = ESourceAlphaMode::Masked;
+		break;
+	case BLEND_Translucent:
+		AlphaMode = ESourceAlphaMode::Translucent;
+		break;
+	default:
+		break;
+	}
+
+	UMaterial* Parent = GetOrCreateLightmappedBaseMaterial(AlphaMode);
+	if (!Parent)
+	{
+		return nullptr;
+	}
+
+	UMaterialInstanceDynamic* MID = UMaterialInstanceDynamic::Create(Parent, Outer);
+	MID->SetTextureParameterValue(TEXT("BaseTexture"), BaseTexture);
+	MID->SetTextureParameterValue(TEXT("Lightmap"), Lightmap);
+
+	float OpacityScale = 1.0f;
+	if (AlphaMode == ESourceAlphaMode::Translucent
+		&& Material->GetScalarParameterValue(FMaterialParameterInfo(TEXT("OpacityScale")), OpacityScale))
+	{
+		MID->SetScalarParameterValue(TEXT("OpacityScale"), OpacityScale);
+	}
+	return MID;
+}
+
 UMaterial* FMaterialImporter::GetOrCreateColorBaseMaterial()
 {
 	if (CachedColorMaterial && CachedColorMaterial->IsValidLowLevel())
@@ -1362,6 +1498,68 @@ FString FMaterialImporter::FindVMTInVPK(const FString& SourceMaterialPath)
 	return FString();
 }
 
+bool FMaterialImporter::FindVMTContent(const FString& SourceMaterialPath, FString& OutContent, bool& bOutFromVPK)
+{
+	bOutFromVPK = false;
+
+	// Build the list of directories to search
+	TArray<FString> SearchRoots;
+	if (!AssetSearchPath.IsEmpty())
+	{
+		SearchRoots.Add(AssetSearchPath);
+	}
+	SearchRoots.Append(AdditionalSearchPaths);
+
+	FString VMTRelPath = TEXT("materials") / SourceMaterialPath + TEXT(".vmt");
+
+	// 1. Exact path on disk
+	for (const FString& Root : SearchRoots)
+	{
+		FString CandidatePath = Root / VMTRelPath;
+		CandidatePath = CandidatePath.Replace(TEXT("\\"), TEXT("/"));
+
+		if (FPaths::FileExists(CandidatePath) && FFileHelper::LoadFileToString(OutContent, *CandidatePath))
+		{
+			return true;
+		}
+	}
+
+	// 2. VPK archives
+	OutContent = FindVMTInVPK(SourceMaterialPath);
+	if (!OutContent.IsEmpty())
+	{
+		bOutFromVPK = true;
+		return true;
+	}
+
+	// 3. Case-insensitive disk search (last resort)
+	FString SearchPath = SourceMaterialPath + TEXT(".vmt");
+	SearchPath = SearchPath.Replace(TEXT("\\"), TEXT("/"));
+
+	for (const FString& Root : SearchRoots)
+	{
+		FString MaterialsDir = Root / TEXT("materials");
+		if (!FPaths::DirectoryExists(MaterialsDir)) continue;
+
+		TArray<FString> AllVMTs;
+		IFileManager::Get().FindFilesRecursive(AllVMTs, *MaterialsDir, TEXT("*.vmt"), true, false);
+
+		for (const FString& FoundVMT : AllVMTs)
+		{
+			FString RelPath = FoundVMT;
+			FPaths::MakePathRelativeTo(RelPath, *(MaterialsDir + TEXT("/")));
+			RelPath = RelPath.Replace(TEXT("\\"), TEXT("/"));
+
+			if (RelPath.Equals(SearchPath, ESearchCase::IgnoreCase))
+			{
+				return FFileHelper::LoadFileToString(OutContent, *FoundVMT);
+			}
+		}
+	}
+
+	return false;
+}
+
 // ===========================================================================
 // Utility
 // ===========================================================================
@@ -1370,6 +1568,7 @@ void FMaterialImporter::ClearCache()
 {
 	MaterialCache.Empty();
 	TextureInfoCache.Empty();
+	ParsedVMTCache.Empty();
 	// NOTE: Do NOT clear AdditionalSearchPaths, VPKArchives, or base material pointers.
 	// Those are session-level configuration. ClearCache() only resets per-import state.
 }
@@ -1463,12 +1662,10 @@ UTexture2D* FMaterialImporter::LoadThumbnailTexture(const FString& SourceMateria
 	// Most materials have $basetexture matching the material name
 	FString TexturePath = SourceMaterialPath;
 
-	// Try to find and parse the VMT to get the actual $basetexture
-	FString VMTContent = FindVMTInVPK(SourceMaterialPath);
-	if (!VMTContent.IsEmpty())
+	// Find the VMT (shared parse cache) to get the actual $basetexture
+	if (TSharedPtr<const FVMTParsedMaterial> VMT = FindParsedVMT(SourceMaterialPath))
 	{
-		FVMTParsedMaterial VMT = ParseVMT(VMTContent);
-		FString BaseTex = VMT.GetBaseTexture();
+		FString BaseTex = VMT->GetBaseTexture();
 		if (!BaseTex.IsEmpty())
 		{
 			TexturePath = BaseTex;
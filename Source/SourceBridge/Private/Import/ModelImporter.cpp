@@ -268,6 +268,33 @@ bool FModelImporter::IsStockModel(const FString& SourceModelPath)
 	return false;
 }
 
+bool FModelImporter::MatchesStockFile(const FString& InternalPath, const FString& DiskPath)
+{
+	// Only read the file when some VPK has an entry to compare with
+	TArray<uint32, TInlineAllocator<4>> StockCRCs;
+	for (const auto& VPK : VPKArchives)
+	{
+		uint32 CRC;
+		if (VPK->GetCRC(InternalPath, CRC))
+		{
+			StockCRCs.Add(CRC);
+		}
+	}
+
+	if (StockCRCs.Num() == 0)
+	{
+		return false;
+	}
+
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *DiskPath, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	return StockCRCs.Contains(FCrc::MemCrc32(Data.GetData(), Data.Num()));
+}
+
 bool FModelImporter::FindModelDiskPaths(const FString& SourceModelPath,
 	TMap<FString, FString>& OutFilePaths)
 {
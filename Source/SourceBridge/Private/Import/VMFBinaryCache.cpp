@@ -0,0 +1,326 @@
+#include "Import/VMFBinaryCache.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+
+// Binary cache structures (packed, no alignment)
+#pragma pack(push, 1)
+struct FVMFCacheHeader
+{
+	uint32 Magic;           // 'VMFC'
+	uint32 Version;
+	int64 SourceSize;       // Size of the VMF this cache was built from
+	uint32 SourceCrc;       // CRC32 of the VMF bytes
+	uint32 StringCount;
+	uint32 NodeCount;
+	uint32 PropertyCount;
+	uint32 RootCount;       // Top-level blocks are nodes [0, RootCount)
+	uint32 StringDataSize;
+};
+
+struct FVMFCacheStringRef
+{
+	uint32 Offset;          // Into the UTF-8 string data
+	uint32 Length;          // In bytes, no terminator
+};
+
+struct FVMFCacheNode
+{
+	uint32 ClassName;       // String index
+	uint32 FirstProperty;
+	uint32 PropertyCount;
+	uint32 FirstChild;      // Node index; children are contiguous
+	uint32 ChildCount;
+};
+
+struct FVMFCacheProperty
+{
+	uint32 Key;             // String index
+	uint32 Value;           // String index
+};
+#pragma pack(pop)
+
+static const uint32 VMF_CACHE_MAGIC = 0x43464D56; // "VMFC"
+static const uint32 VMF_CACHE_VERSION = 1;
+
+FString FVMFBinaryCache::GetCachePath(const FString& VMFPath)
+{
+	return FPaths::ChangeExtension(VMFPath, TEXT("vmfc"));
+}
+
+uint32 FVMFBinaryCache::HashContent(const TArray<uint8>& VMFBytes)
+{
+	return FCrc::MemCrc32(VMFBytes.GetData(), VMFBytes.Num());
+}
+
+bool FVMFBinaryCache::Write(const FString& VMFPath, const TArray<FVMFKeyValues>& Blocks,
+	int64 SourceSize, uint32 SourceCrc)
+{
+	TArray<FVMFCacheStringRef> StringRefs;
+	TArray<uint8> StringData;
+	TMap<FString, uint32> StringIndices;
+
+	auto InternString = [&](const FString& Str) -> uint32
+	{
+		if (const uint32* Existing = StringIndices.Find(Str))
+		{
+			return *Existing;
+		}
+
+		FTCHARToUTF8 Utf8(*Str);
+		FVMFCacheStringRef Ref;
+		Ref.Offset = StringData.Num();
+		Ref.Length = Utf8.Length();
+		StringData.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+
+		uint32 Index = StringRefs.Add(Ref);
+		StringIndices.Add(Str, Index);
+		return Index;
+	};
+
+	// Breadth-first layout: node indices are assigned in enqueue order, so processing
+	// the queue front-to-back visits nodes in index order and keeps siblings contiguous.
+	TArray<const FVMFKeyValues*> Queue;
+	Queue.Reserve(Blocks.Num());
+	for (const FVMFKeyValues& Block : Blocks)
+	{
+		Queue.Add(&Block);
+	}
+
+	TArray<FVMFCacheNode> Nodes;
+	TArray<FVMFCacheProperty> Properties;
+
+	for (int32 QueueIdx = 0; QueueIdx < Queue.Num(); ++QueueIdx)
+	{
+		const FVMFKeyValues* KV = Queue[QueueIdx];
+
+		FVMFCacheNode Node;
+		Node.ClassName = InternString(KV->ClassName);
+		Node.FirstProperty = Properties.Num();
+		Node.PropertyCount = KV->Properties.Num();
+		Node.FirstChild = Queue.Num();
+		Node.ChildCount = KV->Children.Num();
+		Nodes.Add(Node);
+
+		for (const TPair<FString, FString>& Prop : KV->Properties)
+		{
+			FVMFCacheProperty CacheProp;
+			CacheProp.Key = InternString(Prop.Key);
+			CacheProp.Value = InternString(Prop.Value);
+			Properties.Add(CacheProp);
+		}
+
+		for (const FVMFKeyValues& Child : KV->Children)
+		{
+			Queue.Add(&Child);
+		}
+	}
+
+	FVMFCacheHeader Header;
+	Header.Magic = VMF_CACHE_MAGIC;
+	Header.Version = VMF_CACHE_VERSION;
+	Header.SourceSize = SourceSize;
+	Header.SourceCrc = SourceCrc;
+	Header.StringCount = StringRefs.Num();
+	Header.NodeCount = Nodes.Num();
+	Header.PropertyCount = Properties.Num();
+	Header.RootCount = Blocks.Num();
+	Header.StringDataSize = StringData.Num();
+
+	TArray<uint8> Out;
+	Out.Reserve(sizeof(Header)
+		+ StringRefs.Num() * sizeof(FVMFCacheStringRef)
+		+ Nodes.Num() * sizeof(FVMFCacheNode)
+		+ Properties.Num() * sizeof(FVMFCacheProperty)
+		+ StringData.Num());
+
+	Out.Append(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+	Out.Append(reinterpret_cast<const uint8*>(StringRefs.GetData()), StringRefs.Num() * sizeof(FVMFCacheStringRef));
+	Out.Append(reinterpret_cast<const uint8*>(Nodes.GetData()), Nodes.Num() * sizeof(FVMFCacheNode));
+	Out.Append(reinterpret_cast<const uint8*>(Properties.GetData()), Properties.Num() * sizeof(FVMFCacheProperty));
+	Out.Append(StringData);
+
+	FString CachePath = GetCachePath(VMFPath);
+	if (!FFileHelper::SaveArrayToFile(Out, *CachePath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("VMFBinaryCache: Failed to write '%s'"), *CachePath);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("VMFBinaryCache: Wrote '%s' (%d nodes, %d properties, %d unique strings, %d bytes)"),
+		*CachePath, Nodes.Num(), Properties.Num(), StringRefs.Num(), Out.Num());
+	return true;
+}
+
+namespace
+{
+	/** Bounds-checked view over a cache file image. */
+	struct FVMFCacheView
+	{
+		const FVMFCacheHeader* Header = nullptr;
+		const FVMFCacheStringRef* StringRefs = nullptr;
+		const FVMFCacheNode* Nodes = nullptr;
+		const FVMFCacheProperty* Properties = nullptr;
+		const ANSICHAR* StringData = nullptr;
+
+		bool Init(const uint8* Data, int64 Size)
+		{
+			if (Size < (int64)sizeof(FVMFCacheHeader))
+			{
+				return false;
+			}
+
+			Header = reinterpret_cast<const FVMFCacheHeader*>(Data);
+			if (Header->Magic != VMF_CACHE_MAGIC || Header->Version != VMF_CACHE_VERSION)
+			{
+				return false;
+			}
+
+			int64 Offset = sizeof(FVMFCacheHeader);
+			int64 Expected = Offset
+				+ (int64)Header->StringCount * sizeof(FVMFCacheStringRef)
+				+ (int64)Header->NodeCount * sizeof(FVMFCacheNode)
+				+ (int64)Header->PropertyCount * sizeof(FVMFCacheProperty)
+				+ (int64)Header->StringDataSize;
+			if (Expected != Size || Header->RootCount > Header->NodeCount)
+			{
+				return false;
+			}
+
+			StringRefs = reinterpret_cast<const FVMFCacheStringRef*>(Data + Offset);
+			Offset += (int64)Header->StringCount * sizeof(FVMFCacheStringRef);
+			Nodes = reinterpret_cast<const FVMFCacheNode*>(Data + Offset);
+			Offset += (int64)Header->NodeCount * sizeof(FVMFCacheNode);
+			Properties = reinterpret_cast<const FVMFCacheProperty*>(Data + Offset);
+			Offset += (int64)Header->PropertyCount * sizeof(FVMFCacheProperty);
+			StringData = reinterpret_cast<const ANSICHAR*>(Data + Offset);
+			return true;
+		}
+
+		bool DecodeStrings(TArray<FString>& OutStrings) const
+		{
+			OutStrings.SetNum(Header->StringCount);
+			for (uint32 i = 0; i < Header->StringCount; ++i)
+			{
+				const FVMFCacheStringRef& Ref = StringRefs[i];
+				if ((uint64)Ref.Offset + Ref.Length > Header->StringDataSize)
+				{
+					return false;
+				}
+				FUTF8ToTCHAR Converted(StringData + Ref.Offset, Ref.Length);
+				OutStrings[i] = FString(Converted.Length(), Converted.Get());
+			}
+			return true;
+		}
+
+		bool BuildNode(uint32 NodeIdx, const TArray<FString>& Strings, FVMFKeyValues& Out) const
+		{
+			const FVMFCacheNode& Node = Nodes[NodeIdx];
+			if (Node.ClassName >= Header->StringCount
+				|| (uint64)Node.FirstProperty + Node.PropertyCount > Header->PropertyCount
+				|| (uint64)Node.FirstChild + Node.ChildCount > Header->NodeCount
+				|| (Node.ChildCount > 0 && Node.FirstChild <= NodeIdx))
+			{
+				return false;
+			}
+
+			Out.ClassName = Strings[Node.ClassName];
+
+			Out.Properties.Reserve(Node.PropertyCount);
+			for (uint32 i = 0; i < Node.PropertyCount; ++i)
+			{
+				const FVMFCacheProperty& Prop = Properties[Node.FirstProperty + i];
+				if (Prop.Key >= Header->StringCount || Prop.Value >= Header->StringCount)
+				{
+					return false;
+				}
+				Out.Properties.Emplace(Strings[Prop.Key], Strings[Prop.Value]);
+			}
+
+			Out.Children.SetNum(Node.ChildCount);
+			for (uint32 i = 0; i < Node.ChildCount; ++i)
+			{
+				if (!BuildNode(Node.FirstChild + i, Strings, Out.Children[i]))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+}
+
+bool FVMFBinaryCache::TryRead(const FString& VMFPath, int64 SourceSize, uint32 SourceCrc,
+	TArray<FVMFKeyValues>& OutBlocks)
+{
+	OutBlocks.Reset();
+
+	FString CachePath = GetCachePath(VMFPath);
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*CachePath))
+	{
+		return false;
+	}
+
+	// Prefer a memory mapping; fall back to a plain read on platforms without one
+	TUniquePtr<IMappedFileHandle> MappedHandle(PlatformFile.OpenMapped(*CachePath));
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray<uint8> FileData;
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+
+	if (MappedHandle.IsValid())
+	{
+		MappedRegion.Reset(MappedHandle->MapRegion(0, MappedHandle->GetFileSize()));
+	}
+
+	if (MappedRegion.IsValid())
+	{
+		Data = MappedRegion->GetMappedPtr();
+		Size = MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		if (!FFileHelper::LoadFileToArray(FileData, *CachePath))
+		{
+			return false;
+		}
+		Data = FileData.GetData();
+		Size = FileData.Num();
+	}
+
+	FVMFCacheView View;
+	if (!View.Init(Data, Size))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("VMFBinaryCache: Ignoring invalid cache '%s'"), *CachePath);
+		return false;
+	}
+
+	if (View.Header->SourceSize != SourceSize || View.Header->SourceCrc != SourceCrc)
+	{
+		UE_LOG(LogTemp, Log, TEXT("VMFBinaryCache: Cache '%s' is stale, reparsing VMF"), *CachePath);
+		return false;
+	}
+
+	TArray<FString> Strings;
+	if (!View.DecodeStrings(Strings))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("VMFBinaryCache: Ignoring corrupt string table in '%s'"), *CachePath);
+		return false;
+	}
+
+	OutBlocks.SetNum(View.Header->RootCount);
+	for (uint32 i = 0; i < View.Header->RootCount; ++i)
+	{
+		if (!View.BuildNode(i, Strings, OutBlocks[i]))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("VMFBinaryCache: Ignoring corrupt node table in '%s'"), *CachePath);
+			OutBlocks.Reset();
+			return false;
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("VMFBinaryCache: Loaded '%s' (%d nodes)"), *CachePath, View.Header->NodeCount);
+	return true;
+}
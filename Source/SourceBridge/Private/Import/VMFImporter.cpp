@@ -1,10 +1,14 @@
 #include "Import/VMFImporter.h"
 #include "Import/VMFReader.h"
+#include "Import/BSPGeometry.h"
+#include "Import/BSPStaticProps.h"
+#include "Import/BSPVisibility.h"
 #include "Import/MaterialImporter.h"
 #include "Import/ModelImporter.h"
 #include "Import/MDLReader.h"
 #include "Actors/SourceEntityActor.h"
 #include "Runtime/SourceBridgeGameMode.h"
+#include "Runtime/SourceVisibility.h"
 #include "Entities/EntityIOConnection.h"
 #include "Engine/World.h"
 #include "Engine/DirectionalLight.h"
@@ -16,9 +20,27 @@
 #include "Engine/SpotLight.h"
 #include "Engine/SphereReflectionCapture.h"
 #include "Materials/MaterialInterface.h"
+#include "Engine/Texture2D.h"
 #include "EngineUtils.h"
+#include "Misc/Paths.h"
 #include "Misc/ScopedSlowTask.h"
 #include "ProceduralMeshComponent.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Algo/Unique.h"
+
+/** Whether an entity block is a prop_static (which BSP static props replace). */
+static bool IsPropStaticBlock(const FVMFKeyValues& Block)
+{
+	for (const auto& Prop : Block.Properties)
+	{
+		if (Prop.Key.Equals(TEXT("classname"), ESearchCase::IgnoreCase))
+		{
+			return Prop.Value.Equals(TEXT("prop_static"), ESearchCase::IgnoreCase);
+		}
+	}
+	return false;
+}
 
 FVMFImportResult FVMFImporter::ImportFile(const FString& FilePath, UWorld* World,
 	const FVMFImportSettings& Settings)
@@ -57,10 +79,17 @@ FVMFImportResult FVMFImporter::ImportBlocks(const TArray<FVMFKeyValues>& Blocks,
 	}
 
 	// Count total work items for progress bar
-	int32 TotalItems = 0;
+	const bool bCompiledWorld = Settings.CompiledModels && Settings.CompiledModels->Num() > 0;
+	const bool bBSPStaticProps = Settings.StaticProps && Settings.bImportEntities;
+	const bool bBSPVisibility = Settings.Visibility && Settings.Visibility->IsValid();
+	int32 TotalItems = (bBSPStaticProps ? 1 : 0) + (bBSPVisibility ? 1 : 0);
 	for (const FVMFKeyValues& Block : Blocks)
 	{
-		if (Block.ClassName.Equals(TEXT("world"), ESearchCase::IgnoreCase) && Settings.bImportBrushes)
+		if (Block.ClassName.Equals(TEXT("world"), ESearchCase::IgnoreCase) && Settings.bImportBrushes && bCompiledWorld)
+		{
+			TotalItems++;
+		}
+		else if (Block.ClassName.Equals(TEXT("world"), ESearchCase::IgnoreCase) && Settings.bImportBrushes)
 		{
 			for (const FVMFKeyValues& Child : Block.Children)
 			{
@@ -68,7 +97,8 @@ FVMFImportResult FVMFImporter::ImportBlocks(const TArray<FVMFKeyValues>& Blocks,
 					TotalItems++;
 			}
 		}
-		else if (Block.ClassName.Equals(TEXT("entity"), ESearchCase::IgnoreCase) && Settings.bImportEntities)
+		else if (Block.ClassName.Equals(TEXT("entity"), ESearchCase::IgnoreCase) && Settings.bImportEntities
+			&& !(bBSPStaticProps && IsPropStaticBlock(Block)))
 		{
 			TotalItems++;
 		}
@@ -78,6 +108,15 @@ FVMFImportResult FVMFImporter::ImportBlocks(const TArray<FVMFKeyValues>& Blocks,
 		FString::Printf(TEXT("Importing %d items..."), TotalItems)));
 	SlowTask.MakeDialog(true);
 
+	// Everything spawned below gets tagged with its visibility clusters at the end
+	TArray<TWeakObjectPtr<AActor>> SpawnedActors;
+	FDelegateHandle SpawnedHandle;
+	if (bBSPVisibility)
+	{
+		SpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateLambda(
+			[&SpawnedActors](AActor* Actor) { SpawnedActors.Add(Actor); }));
+	}
+
 	for (const FVMFKeyValues& Block : Blocks)
 	{
 		if (SlowTask.ShouldCancel())
@@ -85,8 +124,14 @@ FVMFImportResult FVMFImporter::ImportBlocks(const TArray<FVMFKeyValues>& Blocks,
 
 		if (Block.ClassName.Equals(TEXT("world"), ESearchCase::IgnoreCase))
 		{
+			// Compiled BSP: the world model replaces the solids
+			if (Settings.bImportBrushes && bCompiledWorld)
+			{
+				SlowTask.EnterProgressFrame(1.0f, FText::FromString(TEXT("World geometry")));
+				ImportCompiledWorld((*Settings.CompiledModels)[0], World, Settings, Result);
+			}
 			// Import worldspawn solids as plain brushes (not entities)
-			if (Settings.bImportBrushes)
+			else if (Settings.bImportBrushes)
 			{
 				for (const FVMFKeyValues& Child : Block.Children)
 				{
@@ -107,6 +152,9 @@ FVMFImportResult FVMFImporter::ImportBlocks(const TArray<FVMFKeyValues>& Blocks,
 		{
 			if (!Settings.bImportEntities) continue;
 
+			// Decompiled prop_statics duplicate the BSP's static props, imported instanced below
+			if (bBSPStaticProps && IsPropStaticBlock(Block)) continue;
+
 			SlowTask.EnterProgressFrame(1.0f, FText::FromString(
 				FString::Printf(TEXT("Entity %d/%d"), Result.EntitiesImported + 1, TotalItems)));
 			GLog->Flush();
@@ -122,7 +170,16 @@ FVMFImportResult FVMFImporter::ImportBlocks(const TArray<FVMFKeyValues>& Blocks,
 				}
 			}
 
-			if (bHasSolids && Settings.bImportBrushes)
+			const FBSPModelMesh* CompiledModel = Settings.bImportBrushes ? FindCompiledModel(Block, Settings) : nullptr;
+			if (CompiledModel)
+			{
+				ASourceBrushEntity* BrushEntity = ImportCompiledBrushEntity(Block, *CompiledModel, World, Settings, Result);
+				if (BrushEntity)
+				{
+					Result.SpawnedEntities.Add(BrushEntity);
+				}
+			}
+			else if (bHasSolids && Settings.bImportBrushes)
 			{
 				// Brush entity: create ONE ASourceBrushEntity with all solids as children
 				ASourceBrushEntity* BrushEntity = ImportBrushEntity(Block, World, Settings, Result);
@@ -138,11 +195,28 @@ FVMFImportResult FVMFImporter::ImportBlocks(const TArray<FVMFKeyValues>& Blocks,
 		}
 	}
 
+	if (bBSPStaticProps && !SlowTask.ShouldCancel())
+	{
+		SlowTask.EnterProgressFrame(1.0f, FText::FromString(FString::Printf(
+			TEXT("%d static props"), Settings.StaticProps->Props.Num())));
+		ImportStaticProps(*Settings.StaticProps, World, Settings, Result);
+	}
+
+	if (bBSPVisibility)
+	{
+		World->RemoveOnActorSpawnedHandler(SpawnedHandle);
+		if (!SlowTask.ShouldCancel())
+		{
+			SlowTask.EnterProgressFrame(1.0f, FText::FromString(TEXT("Visibility clusters")));
+			ImportVisibility(*Settings.Visibility, SpawnedActors, World, Settings, Result);
+		}
+	}
+
 	// Resolve parentname relationships after all entities are spawned
 	ResolveParentNames(Result);
 
 	// Redraw viewports
-	if ((Result.BrushesImported > 0 || Result.EntitiesImported > 0) && GEditor)
+	if ((Result.BrushesImported > 0 || Result.EntitiesImported > 0 || Result.StaticPropsImported > 0) && GEditor)
 	{
 		GEditor->RedrawLevelEditingViewports(true);
 
@@ -154,8 +228,9 @@ FVMFImportResult FVMFImporter::ImportBlocks(const TArray<FVMFKeyValues>& Blocks,
 		}
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("VMFImporter: Imported %d brushes, %d entities (%d warnings)"),
-		Result.BrushesImported, Result.EntitiesImported, Result.Warnings.Num());
+	UE_LOG(LogTemp, Log, TEXT("VMFImporter: Imported %d brushes, %d entities, %d static props in %d groups (%d warnings)"),
+		Result.BrushesImported, Result.EntitiesImported, Result.StaticPropsImported, Result.StaticPropGroups,
+		Result.Warnings.Num());
 
 	return Result;
 }
@@ -936,8 +1011,444 @@ ASourceBrushEntity* FVMFImporter::ImportBrushEntity(const FVMFKeyValues& EntityB
 	return Entity;
 }
 
+// ---- Compiled BSP Geometry ----
+
+const FBSPModelMesh* FVMFImporter::FindCompiledModel(const FVMFKeyValues& EntityBlock, const FVMFImportSettings& Settings)
+{
+	if (!Settings.CompiledModels)
+	{
+		return nullptr;
+	}
+
+	for (const auto& Prop : EntityBlock.Properties)
+	{
+		// Brush entities reference their model as "*N"; N = 0 is the world
+		if (Prop.Key.Equals(TEXT("model"), ESearchCase::IgnoreCase) && Prop.Value.StartsWith(TEXT("*")))
+		{
+			int32 ModelIndex = FCString::Atoi(*Prop.Value + 1);
+			if (ModelIndex > 0 && Settings.CompiledModels->IsValidIndex(ModelIndex))
+			{
+				return &(*Settings.CompiledModels)[ModelIndex];
+			}
+			break;
+		}
+	}
+	return nullptr;
+}
+
+UProceduralMeshComponent* FVMFImporter::BuildCompiledMesh(
+	AActor* OwnerActor,
+	const FString& MeshName,
+	const FString& LightmapName,
+	const FBSPMeshChunk& Chunk,
+	const FVMFImportSettings& Settings,
+	const FVector& ActorCenter,
+	const FVector& SourceOffset)
+{
+	if (!OwnerActor || Chunk.Sections.Num() == 0) return nullptr;
+
+	float Scale = Settings.ScaleMultiplier;
+
+	UProceduralMeshComponent* ProcMesh = NewObject<UProceduralMeshComponent>(OwnerActor, *MeshName);
+	ProcMesh->AttachToComponent(OwnerActor->GetRootComponent(),
+		FAttachmentTransformRules::KeepRelativeTransform);
+	ProcMesh->SetRelativeTransform(FTransform::Identity);
+	ProcMesh->CreationMethod = EComponentCreationMethod::Instance;
+
+	// Baked lighting: one atlas texture per chunk, sampled with UV channel 1
+	UTexture2D* Lightmap = nullptr;
+	if (Settings.bImportLightmaps && Settings.bImportMaterials && Chunk.Lightmap.IsValid() && !Settings.LightmapAssetPath.IsEmpty())
+	{
+		Lightmap = FMaterialImporter::CreateLightmapTexture(Chunk.Lightmap.Pixels, Chunk.Lightmap.Width,
+			Chunk.Lightmap.Height, Settings.LightmapAssetPath / LightmapName);
+	}
+
+	bool bAllToolTextures = true;
+	for (int32 i = 0; i < Chunk.Sections.Num(); i++)
+	{
+		const FBSPMeshSection& Section = Chunk.Sections[i];
+		const bool bLightmapped = Lightmap && Section.LightmapUVs.Num() == Section.Positions.Num();
+
+		TArray<FVector> Vertices;
+		TArray<FVector> Normals;
+		TArray<FVector2D> UVs;
+		TArray<FVector2D> LightmapUVs;
+		TArray<FProcMeshTangent> Tangents;
+		Vertices.Reserve(Section.Positions.Num());
+		Normals.Reserve(Section.Positions.Num());
+		UVs.Reserve(Section.Positions.Num());
+		Tangents.Reserve(Section.Positions.Num());
+		if (bLightmapped)
+		{
+			LightmapUVs.Reserve(Section.Positions.Num());
+			for (const FVector2f& LightmapUV : Section.LightmapUVs)
+			{
+				LightmapUVs.Add(FVector2D(LightmapUV));
+			}
+		}
+
+		for (int32 v = 0; v < Section.Positions.Num(); v++)
+		{
+			Vertices.Add(SourceToUE(FVector(Section.Positions[v]) + SourceOffset, Scale) - ActorCenter);
+			Normals.Add(SourceDirToUE(FVector(Section.Normals[v])));
+			Tangents.Add(FProcMeshTangent(SourceDirToUE(FVector(Section.TangentsU[v])), false));
+			UVs.Add(FVector2D(Section.TexelUVs[v].X / Section.TextureWidth, Section.TexelUVs[v].Y / Section.TextureHeight));
+		}
+
+		// Counter-clockwise in Source space is clockwise once Y is mirrored, as UE expects
+		ProcMesh->CreateMeshSection_LinearColor(i, Vertices, Section.Indices, Normals, UVs, LightmapUVs,
+			TArray<FVector2D>(), TArray<FVector2D>(), TArray<FLinearColor>(), Tangents, true);
+
+		if (Settings.bImportMaterials && !Section.Material.IsEmpty())
+		{
+			if (UMaterialInterface* Material = FMaterialImporter::ResolveSourceMaterial(Section.Material))
+			{
+				UMaterialInterface* LitMaterial = bLightmapped && !Section.bToolsMaterial
+					? FMaterialImporter::CreateLightmappedMaterial(Material, Lightmap, ProcMesh)
+					: nullptr;
+				ProcMesh->SetMaterial(i, LitMaterial ? LitMaterial : Material);
+			}
+		}
+
+		bAllToolTextures &= Section.bToolsMaterial;
+	}
+
+	// Same lighting treatment as solids made only of TOOLS faces
+	if (bAllToolTextures)
+	{
+		ProcMesh->SetCastShadow(false);
+		ProcMesh->bAffectDistanceFieldLighting = false;
+		ProcMesh->bAffectDynamicIndirectLighting = false;
+	}
+
+	ProcMesh->RegisterComponent();
+	return ProcMesh;
+}
+
+void FVMFImporter::ImportCompiledWorld(const FBSPModelMesh& Model, UWorld* World,
+	const FVMFImportSettings& Settings, FVMFImportResult& Result)
+{
+	float Scale = Settings.ScaleMultiplier;
+
+	for (const FBSPMeshChunk& Chunk : Model.Chunks)
+	{
+		FVector Center = SourceToUE(FVector(Chunk.Bounds.GetCenter()), Scale);
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		FTransform SpawnTransform;
+		SpawnTransform.SetLocation(Center);
+
+		ASourceBrushEntity* Entity = World->SpawnActor<ASourceBrushEntity>(
+			ASourceBrushEntity::StaticClass(), SpawnTransform, SpawnParams);
+		if (!Entity)
+		{
+			Result.Warnings.Add(TEXT("Failed to spawn ASourceBrushEntity for world geometry."));
+			continue;
+		}
+		Entity->SetActorLocation(Center);
+		Entity->SourceClassname = TEXT("worldspawn");
+		Entity->SetActorLabel(FString::Printf(TEXT("World_%d_%d_%d"), Chunk.Cell.X, Chunk.Cell.Y, Chunk.Cell.Z));
+
+		UProceduralMeshComponent* ProcMesh = BuildCompiledMesh(
+			Entity, TEXT("WorldMesh"), FString::Printf(TEXT("LM_World_%d_%d_%d"), Chunk.Cell.X, Chunk.Cell.Y, Chunk.Cell.Z),
+			Chunk, Settings, Center, FVector::ZeroVector);
+		if (ProcMesh)
+		{
+			Entity->BrushMeshes.Add(ProcMesh);
+		}
+		Result.BrushesImported++;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("VMFImporter: World geometry: %d faces, %d triangles in %d chunks"),
+		Model.FaceCount, Model.TriangleCount, Model.Chunks.Num());
+}
+
+ASourceBrushEntity* FVMFImporter::ImportCompiledBrushEntity(const FVMFKeyValues& EntityBlock, const FBSPModelMesh& Model,
+	UWorld* World, const FVMFImportSettings& Settings, FVMFImportResult& Result)
+{
+	float Scale = Settings.ScaleMultiplier;
+
+	// Models of entities with an origin (doors, rotating brushes) are stored relative to it
+	FVector SourceOrigin = FVector::ZeroVector;
+	bool bHasOrigin = false;
+	for (const auto& Prop : EntityBlock.Properties)
+	{
+		if (Prop.Key.Equals(TEXT("origin"), ESearchCase::IgnoreCase) && !Prop.Value.IsEmpty())
+		{
+			SourceOrigin = ParseOrigin(Prop.Value);
+			bHasOrigin = true;
+			break;
+		}
+	}
+
+	FBox3f Bounds(ForceInit);
+	for (const FBSPMeshChunk& Chunk : Model.Chunks)
+	{
+		Bounds += Chunk.Bounds;
+	}
+	if (!Bounds.IsValid)
+	{
+		Result.Warnings.Add(TEXT("Brush entity model has no drawable faces, skipping."));
+		return nullptr;
+	}
+
+	FVector EntityCenter = bHasOrigin
+		? SourceToUE(SourceOrigin, Scale)
+		: SourceToUE(FVector(Bounds.GetCenter()), Scale);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	FTransform SpawnTransform;
+	SpawnTransform.SetLocation(EntityCenter);
+
+	ASourceBrushEntity* Entity = World->SpawnActor<ASourceBrushEntity>(
+		ASourceBrushEntity::StaticClass(), SpawnTransform, SpawnParams);
+	if (!Entity)
+	{
+		Result.Warnings.Add(TEXT("Failed to spawn ASourceBrushEntity."));
+		return nullptr;
+	}
+	Entity->SetActorLocation(EntityCenter);
+
+	ApplyEntityProperties(Entity, EntityBlock);
+
+	// "*N" only means something inside this BSP
+	Entity->KeyValues.Remove(TEXT("model"));
+
+	if (!Entity->TargetName.IsEmpty())
+	{
+		Entity->SetActorLabel(FString::Printf(TEXT("%s (%s)"), *Entity->TargetName, *Entity->SourceClassname));
+	}
+	else
+	{
+		Entity->SetActorLabel(Entity->SourceClassname);
+	}
+
+	for (int32 ChunkIdx = 0; ChunkIdx < Model.Chunks.Num(); ChunkIdx++)
+	{
+		UProceduralMeshComponent* ProcMesh = BuildCompiledMesh(
+			Entity, FString::Printf(TEXT("BrushMesh_%d"), ChunkIdx),
+			FString::Printf(TEXT("LM_Model%d_%d"), Model.ModelIndex, ChunkIdx), Model.Chunks[ChunkIdx],
+			Settings, EntityCenter, SourceOrigin);
+		if (ProcMesh)
+		{
+			Entity->BrushMeshes.Add(ProcMesh);
+		}
+	}
+
+	Result.BrushesImported++;
+	Result.EntitiesImported++;
+
+	UE_LOG(LogTemp, Log, TEXT("VMFImporter: Brush entity '%s' (%s) from model *%d, %d faces"),
+		*Entity->TargetName, *Entity->SourceClassname, Model.ModelIndex, Model.FaceCount);
+
+	return Entity;
+}
+
 // ---- Common Entity Property Setter ----
 
+void FVMFImporter::ImportStaticProps(const FBSPStaticPropLump& StaticProps, UWorld* World,
+	const FVMFImportSettings& Settings, FVMFImportResult& Result)
+{
+	const float Scale = Settings.ScaleMultiplier;
+
+	// Group placements by everything that is per component rather than per instance
+	struct FGroupKey
+	{
+		int32 ModelIndex;
+		int32 Skin;
+		int32 Solid;
+		bool bNoShadow;
+		float FadeMinDist;
+		float FadeMaxDist;
+
+		bool operator==(const FGroupKey& Other) const
+		{
+			return ModelIndex == Other.ModelIndex && Skin == Other.Skin && Solid == Other.Solid
+				&& bNoShadow == Other.bNoShadow && FadeMinDist == Other.FadeMinDist && FadeMaxDist == Other.FadeMaxDist;
+		}
+		friend uint32 GetTypeHash(const FGroupKey& Key)
+		{
+			uint32 Hash = HashCombine(GetTypeHash(Key.ModelIndex), GetTypeHash(Key.Skin));
+			Hash = HashCombine(Hash, GetTypeHash(Key.Solid * 2 + (Key.bNoShadow ? 1 : 0)));
+			return HashCombine(Hash, HashCombine(GetTypeHash(Key.FadeMinDist), GetTypeHash(Key.FadeMaxDist)));
+		}
+	};
+
+	TMap<FGroupKey, TArray<int32>> Groups;
+	TMap<TPair<int32, int32>, UStaticMesh*> Meshes;
+	for (int32 i = 0; i < StaticProps.Props.Num(); ++i)
+	{
+		const FBSPStaticProp& Prop = StaticProps.Props[i];
+		FGroupKey Key{ Prop.ModelIndex, Prop.Skin, Prop.Solid, (Prop.Flags & EBSPStaticPropFlags::NoShadow) != 0,
+			Prop.FadeMaxDist > 0.0f ? Prop.FadeMinDist : 0.0f, FMath::Max(Prop.FadeMaxDist, 0.0f) };
+		Groups.FindOrAdd(Key).Add(i);
+		Meshes.Add(TPair<int32, int32>(Prop.ModelIndex, Prop.Skin), nullptr);
+	}
+
+	// Resolve every model/skin pair once up front, however many placements use it
+	for (auto& Pair : Meshes)
+	{
+		Pair.Value = FModelImporter::ResolveModel(StaticProps.Models[Pair.Key.Key], Pair.Key.Value);
+		if (!Pair.Value)
+		{
+			Result.Warnings.Add(FString::Printf(TEXT("Static prop model not found: %s"), *StaticProps.Models[Pair.Key.Key]));
+		}
+	}
+
+	for (const auto& Group : Groups)
+	{
+		const FGroupKey& Key = Group.Key;
+		const FString& ModelPath = StaticProps.Models[Key.ModelIndex];
+
+		// Instances are placed relative to the group's center
+		FBox Bounds(ForceInit);
+		TArray<FTransform> Transforms;
+		Transforms.Reserve(Group.Value.Num());
+		for (int32 PropIndex : Group.Value)
+		{
+			const FBSPStaticProp& Prop = StaticProps.Props[PropIndex];
+			const FVector Location = SourceToUE(FVector(Prop.Origin), Scale);
+
+			// Yaw negated for handedness; prop_static pitch is stored negated (see ImportPointEntity)
+			const FRotator Rotation(-Prop.Angles.X, -Prop.Angles.Y, Prop.Angles.Z);
+			Transforms.Add(FTransform(Rotation, Location, FVector(Prop.UniformScale)));
+			Bounds += Location;
+		}
+		const FVector Center = Bounds.GetCenter();
+		for (FTransform& Transform : Transforms)
+		{
+			Transform.SetLocation(Transform.GetLocation() - Center);
+		}
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		ASourceStaticPropGroup* PropGroup = World->SpawnActor<ASourceStaticPropGroup>(
+			ASourceStaticPropGroup::StaticClass(), FTransform(Center), SpawnParams);
+		if (!PropGroup)
+		{
+			Result.Warnings.Add(FString::Printf(TEXT("Failed to spawn static prop group for %s"), *ModelPath));
+			continue;
+		}
+		PropGroup->SetActorLabel(FString::Printf(TEXT("%s_skin%d"), *FPaths::GetBaseFilename(ModelPath), Key.Skin));
+		PropGroup->ModelPath = ModelPath;
+		PropGroup->Skin = Key.Skin;
+		PropGroup->Solid = Key.Solid;
+		PropGroup->bDisableShadows = Key.bNoShadow;
+		PropGroup->FadeMinDist = Key.FadeMinDist;
+		PropGroup->FadeMaxDist = Key.FadeMaxDist;
+		for (int32 PropIndex : Group.Value)
+		{
+			const FBSPStaticProp& Prop = StaticProps.Props[PropIndex];
+			PropGroup->InstanceFlags.Add(Prop.Flags);
+			PropGroup->InstanceColors.Add(Prop.DiffuseModulation);
+			PropGroup->InstanceScales.Add(Prop.UniformScale);
+		}
+
+		UHierarchicalInstancedStaticMeshComponent* Instances = PropGroup->InstancesComponent;
+		if (Instances)
+		{
+			if (UStaticMesh* Mesh = Meshes.FindRef(TPair<int32, int32>(Key.ModelIndex, Key.Skin)))
+			{
+				Instances->SetStaticMesh(Mesh);
+			}
+			Instances->SetCastShadow(!Key.bNoShadow);
+			if (Key.Solid == 0)
+			{
+				Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+			}
+			if (Key.FadeMaxDist > 0.0f)
+			{
+				Instances->InstanceStartCullDistance = FMath::RoundToInt(FMath::Max(Key.FadeMinDist, 0.0f) * Scale);
+				Instances->InstanceEndCullDistance = FMath::RoundToInt(Key.FadeMaxDist * Scale);
+			}
+			Instances->AddInstances(Transforms, false);
+		}
+
+		Result.StaticPropsImported += Group.Value.Num();
+		Result.StaticPropGroups++;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("VMFImporter: %d static props of %d models in %d instanced groups"),
+		Result.StaticPropsImported, Meshes.Num(), Result.StaticPropGroups);
+}
+
+void FVMFImporter::ImportVisibility(const FBSPVisibility& Visibility, const TArray<TWeakObjectPtr<AActor>>& Actors,
+	UWorld* World, const FVMFImportSettings& Settings, FVMFImportResult& Result)
+{
+	const float Scale = Settings.ScaleMultiplier;
+
+	// Reverse of SourceToUE, grown a little so faces lying on a leaf boundary touch both sides
+	auto ToSourceBox = [Scale](const FBox& Box)
+	{
+		return FBox3f(
+			FVector3f(Box.Min.X / Scale, -Box.Max.Y / Scale, Box.Min.Z / Scale),
+			FVector3f(Box.Max.X / Scale, -Box.Min.Y / Scale, Box.Max.Z / Scale)).ExpandBy(1.0f);
+	};
+
+	TArray<int32> Clusters;
+	TArray<int32> BoxClusters;
+	for (const TWeakObjectPtr<AActor>& Weak : Actors)
+	{
+		AActor* Actor = Weak.Get();
+		if (!Actor || Actor->FindComponentByClass<USourceVisClusterComponent>()) continue;
+
+		TArray<UMeshComponent*> MeshComponents;
+		Actor->GetComponents<UMeshComponent>(MeshComponents);
+		if (MeshComponents.Num() == 0) continue;
+
+		Clusters.Reset();
+		for (UMeshComponent* MeshComponent : MeshComponents)
+		{
+			// Instanced props can be spread over the whole map: tag with each instance's clusters
+			UInstancedStaticMeshComponent* Instances = Cast<UInstancedStaticMeshComponent>(MeshComponent);
+			if (Instances && Instances->GetStaticMesh())
+			{
+				const FBox MeshBox = Instances->GetStaticMesh()->GetBounds().GetBox();
+				for (int32 i = 0; i < Instances->GetInstanceCount(); ++i)
+				{
+					FTransform InstanceTransform;
+					if (!Instances->GetInstanceTransform(i, InstanceTransform, true)) continue;
+					Visibility.GetClustersInBox(ToSourceBox(MeshBox.TransformBy(InstanceTransform)), BoxClusters);
+					Clusters.Append(BoxClusters);
+				}
+				continue;
+			}
+
+			MeshComponent->UpdateBounds();
+			Visibility.GetClustersInBox(ToSourceBox(MeshComponent->Bounds.GetBox()), BoxClusters);
+			Clusters.Append(BoxClusters);
+		}
+		if (Clusters.Num() == 0) continue;
+
+		Clusters.Sort();
+		Clusters.SetNum(Algo::Unique(Clusters));
+
+		USourceVisClusterComponent* Tag = NewObject<USourceVisClusterComponent>(Actor, TEXT("VisClusters"));
+		Tag->Clusters = Clusters;
+		Actor->AddInstanceComponent(Tag);
+		Tag->RegisterComponent();
+		Result.VisTaggedActors++;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	ASourceVisibility* VisActor = World->SpawnActor<ASourceVisibility>(
+		ASourceVisibility::StaticClass(), FTransform::Identity, SpawnParams);
+	if (!VisActor)
+	{
+		Result.Warnings.Add(TEXT("Failed to spawn ASourceVisibility actor."));
+		return;
+	}
+	VisActor->SetActorLabel(TEXT("SourceVisibility"));
+	VisActor->ScaleMultiplier = Scale;
+	VisActor->SetVisibility(Visibility);
+
+	UE_LOG(LogTemp, Log, TEXT("VMFImporter: Tagged %d actors with visibility clusters (%d clusters)"),
+		Result.VisTaggedActors, Visibility.GetNumClusters());
+}
+
 void FVMFImporter::ApplyEntityProperties(ASourceEntityActor* Entity, const FVMFKeyValues& EntityBlock)
 {
 	if (!Entity) return;
@@ -1,19 +1,59 @@
 #include "Import/VMFReader.h"
+#include "Import/VMFBinaryCache.h"
 #include "Misc/FileHelper.h"
 
-TArray<FVMFKeyValues> FVMFReader::ParseFile(const FString& FilePath)
+TArray<FVMFKeyValues> FVMFReader::ParseFile(const FString& FilePath, bool bUseBinaryCache)
 {
-	FString Content;
-	if (!FFileHelper::LoadFileToString(Content, *FilePath))
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *FilePath))
 	{
 		UE_LOG(LogTemp, Error, TEXT("VMFReader: Failed to read file '%s'"), *FilePath);
 		return {};
 	}
 
+	if (bUseBinaryCache)
+	{
+		TArray<FVMFKeyValues> Cached;
+		if (FVMFBinaryCache::TryRead(FilePath, Bytes.Num(), FVMFBinaryCache::HashContent(Bytes), Cached))
+		{
+			return Cached;
+		}
+	}
+
+	FString Content;
+	FFileHelper::BufferToString(Content, Bytes.GetData(), Bytes.Num());
 	return ParseString(Content);
 }
 
-TArray<FVMFKeyValues> FVMFReader::ParseString(const FString& Content)
+TArray<FVMFKeyValues> FVMFReader::ParseFileAndUpdateCache(const FString& FilePath)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *FilePath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("VMFReader: Failed to read file '%s'"), *FilePath);
+		return {};
+	}
+
+	const uint32 Crc = FVMFBinaryCache::HashContent(Bytes);
+	TArray<FVMFKeyValues> Cached;
+	if (FVMFBinaryCache::TryRead(FilePath, Bytes.Num(), Crc, Cached))
+	{
+		return Cached;
+	}
+
+	FString Content;
+	FFileHelper::BufferToString(Content, Bytes.GetData(), Bytes.Num());
+	TArray<FVMFKeyValues> Blocks = ParseString(Content);
+
+	if (Blocks.Num() > 0)
+	{
+		FVMFBinaryCache::Write(FilePath, Blocks, Bytes.Num(), Crc);
+	}
+
+	return Blocks;
+}
+
+TArray<FVMFKeyValues> FVMFReader::ParseString(const FString& Content, bool bEscapeSequences)
 {
 	TArray<FVMFKeyValues> Blocks;
 	int32 Pos = 0;
@@ -31,28 +71,34 @@ TArray<FVMFKeyValues> FVMFReader::ParseString(const FString& Content)
 			continue;
 		}
 
-		FString ClassName = ReadUnquotedToken(Content, Pos);
-		if (ClassName.IsEmpty()) break;
+		FString ClassName = (Content[Pos] == TEXT('"'))
+			? ReadQuotedString(Content, Pos, bEscapeSequences)
+			: ReadUnquotedToken(Content, Pos);
+		if (ClassName.IsEmpty())
+		{
+			continue;
+		}
 
 		SkipWhitespaceAndComments(Content, Pos);
 		if (Pos >= Len) break;
 
 		if (Content[Pos] == TEXT('{'))
 		{
-			Blocks.Add(ParseBlock(Content, Pos, ClassName));
+			Blocks.Add(ParseBlock(Content, Pos, ClassName, bEscapeSequences));
 		}
 	}
 
 	return Blocks;
 }
 
-FVMFKeyValues FVMFReader::ParseBlock(const FString& Content, int32& Pos, const FString& ClassName)
+FVMFKeyValues FVMFReader::ParseBlock(const FString& Content, int32& Pos, const FString& ClassName, bool bEscapeSequences)
 {
 	FVMFKeyValues Block(ClassName);
+	const TCHAR* Data = *Content;
 	int32 Len = Content.Len();
 
 	// Skip opening brace
-	if (Pos < Len && Content[Pos] == TEXT('{'))
+	if (Pos < Len && Data[Pos] == TEXT('{'))
 	{
 		Pos++;
 	}
@@ -63,34 +109,68 @@ FVMFKeyValues FVMFReader::ParseBlock(const FString& Content, int32& Pos, const F
 		if (Pos >= Len) break;
 
 		// Closing brace ends this block
-		if (Content[Pos] == TEXT('}'))
+		if (Data[Pos] == TEXT('}'))
 		{
 			Pos++;
 			break;
 		}
 
-		// Quoted string = key-value pair
-		if (Content[Pos] == TEXT('"'))
+		// Anonymous block: parse to stay in sync, then drop it
+		if (Data[Pos] == TEXT('{'))
+		{
+			ParseBlock(Content, Pos, FString(), bEscapeSequences);
+			continue;
+		}
+
+		// Key (VMF: always quoted; VMT: quoted or bare)
+		FString Key = (Data[Pos] == TEXT('"'))
+			? ReadQuotedString(Content, Pos, bEscapeSequences)
+			: ReadUnquotedToken(Content, Pos);
+		bool bKeep = ReadConditional(Content, Pos);
+
+		// A value sits on the same line; a block may follow on a later line
+		SkipInlineWhitespace(Content, Pos);
+		if (Pos >= Len) break;
+
+		TCHAR Ch = Data[Pos];
+		if (Ch == TEXT('\r') || Ch == TEXT('\n') || (Ch == TEXT('/') && Pos + 1 < Len && Data[Pos + 1] == TEXT('/')))
 		{
-			FString Key = ReadQuotedString(Content, Pos);
 			SkipWhitespaceAndComments(Content, Pos);
+			if (Pos >= Len) break;
+			Ch = Data[Pos];
+		}
 
-			if (Pos < Len && Content[Pos] == TEXT('"'))
+		if (Ch == TEXT('{'))
+		{
+			FVMFKeyValues Child = ParseBlock(Content, Pos, Key, bEscapeSequences);
+			if (bKeep)
+			{
+				Block.Children.Add(MoveTemp(Child));
+			}
+		}
+		else if (Ch == TEXT('"'))
+		{
+			FString Value = ReadQuotedString(Content, Pos, bEscapeSequences);
+			bKeep &= ReadConditional(Content, Pos);
+			if (bKeep)
 			{
-				FString Value = ReadQuotedString(Content, Pos);
-				Block.Properties.Emplace(Key, Value);
+				Block.Properties.Emplace(MoveTemp(Key), MoveTemp(Value));
+			}
+		}
+		else if (Ch == TEXT('}'))
+		{
+			// Key with no value; the brace is consumed by the next iteration
+			if (bKeep)
+			{
+				Block.Properties.Emplace(MoveTemp(Key), FString());
 			}
 		}
 		else
 		{
-			// Unquoted token = child class name
-			FString ChildName = ReadUnquotedToken(Content, Pos);
-			if (ChildName.IsEmpty()) break;
-
-			SkipWhitespaceAndComments(Content, Pos);
-			if (Pos < Len && Content[Pos] == TEXT('{'))
+			FString Value = ReadRestOfLine(Content, Pos);
+			if (bKeep)
 			{
-				Block.Children.Add(ParseBlock(Content, Pos, ChildName));
+				Block.Properties.Emplace(MoveTemp(Key), MoveTemp(Value));
 			}
 		}
 	}
@@ -100,10 +180,11 @@ FVMFKeyValues FVMFReader::ParseBlock(const FString& Content, int32& Pos, const F
 
 void FVMFReader::SkipWhitespaceAndComments(const FString& Content, int32& Pos)
 {
+	const TCHAR* Data = *Content;
 	int32 Len = Content.Len();
 	while (Pos < Len)
 	{
-		TCHAR Ch = Content[Pos];
+		TCHAR Ch = Data[Pos];
 
 		if (Ch == TEXT(' ') || Ch == TEXT('\t') || Ch == TEXT('\r') || Ch == TEXT('\n'))
 		{
@@ -112,9 +193,9 @@ void FVMFReader::SkipWhitespaceAndComments(const FString& Content, int32& Pos)
 		}
 
 		// Skip // line comments
-		if (Ch == TEXT('/') && Pos + 1 < Len && Content[Pos + 1] == TEXT('/'))
+		if (Ch == TEXT('/') && Pos + 1 < Len && Data[Pos + 1] == TEXT('/'))
 		{
-			while (Pos < Len && Content[Pos] != TEXT('\n'))
+			while (Pos < Len && Data[Pos] != TEXT('\n'))
 			{
 				Pos++;
 			}
@@ -125,63 +206,169 @@ void FVMFReader::SkipWhitespaceAndComments(const FString& Content, int32& Pos)
 	}
 }
 
-FString FVMFReader::ReadQuotedString(const FString& Content, int32& Pos)
+void FVMFReader::SkipInlineWhitespace(const FString& Content, int32& Pos)
+{
+	const TCHAR* Data = *Content;
+	int32 Len = Content.Len();
+	while (Pos < Len && (Data[Pos] == TEXT(' ') || Data[Pos] == TEXT('\t')))
+	{
+		Pos++;
+	}
+}
+
+bool FVMFReader::ReadConditional(const FString& Content, int32& Pos)
+{
+	// KeyValues platform conditionals, e.g. "$envmap" "env_cubemap" [!$X360]
+	int32 Scan = Pos;
+	SkipInlineWhitespace(Content, Scan);
+	if (Scan >= Content.Len() || Content[Scan] != TEXT('['))
+	{
+		return true;
+	}
+
+	int32 Close = Content.Find(TEXT("]"), ESearchCase::CaseSensitive, ESearchDir::FromStart, Scan);
+	int32 LineEnd = Content.Find(TEXT("\n"), ESearchCase::CaseSensitive, ESearchDir::FromStart, Scan);
+	if (Close == INDEX_NONE || (LineEnd != INDEX_NONE && Close > LineEnd))
+	{
+		return true;
+	}
+	Pos = Close + 1;
+
+	// Evaluated as the PC build on Windows: || of && terms, each optionally negated
+	const FString Condition = Content.Mid(Scan + 1, Close - Scan - 1);
+	TArray<FString> Alternatives;
+	Condition.ParseIntoArray(Alternatives, TEXT("||"));
+	if (Alternatives.Num() == 0)
+	{
+		return true;
+	}
+	for (const FString& Alternative : Alternatives)
+	{
+		TArray<FString> Terms;
+		Alternative.ParseIntoArray(Terms, TEXT("&&"));
+		bool bAll = Terms.Num() > 0;
+		for (FString Term : Terms)
+		{
+			Term.TrimStartAndEndInline();
+			bool bNegate = false;
+			while (Term.RemoveFromStart(TEXT("!")))
+			{
+				bNegate = !bNegate;
+				Term.TrimStartInline();
+			}
+			const bool bDefined = Term.Equals(TEXT("$WIN32"), ESearchCase::IgnoreCase)
+				|| Term.Equals(TEXT("$WINDOWS"), ESearchCase::IgnoreCase);
+			bAll &= bDefined != bNegate;
+		}
+		if (bAll)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+FString FVMFReader::ReadQuotedString(const FString& Content, int32& Pos, bool bEscapeSequences)
 {
+	const TCHAR* Data = *Content;
 	int32 Len = Content.Len();
-	if (Pos >= Len || Content[Pos] != TEXT('"'))
+	if (Pos >= Len || Data[Pos] != TEXT('"'))
 	{
 		return FString();
 	}
 
 	Pos++; // skip opening quote
-	FString Result;
+	const int32 Start = Pos;
+
+	// Scan to the closing quote; only fall back to per-character copying if the
+	// string contains something that has to be rewritten
+	bool bNeedsRewrite = false;
+	while (Pos < Len && Data[Pos] != TEXT('"'))
+	{
+		if (Data[Pos] == TEXT('\\') && bEscapeSequences && Pos + 1 < Len)
+		{
+			bNeedsRewrite = true;
+			Pos += 2;
+			continue;
+		}
+		if (Data[Pos] == TEXT('\x1b'))
+		{
+			bNeedsRewrite = true;
+		}
+		Pos++;
+	}
 
-	while (Pos < Len && Content[Pos] != TEXT('"'))
+	const int32 End = FMath::Min(Pos, Len);
+	if (Pos < Len) Pos++; // skip closing quote
+
+	if (!bNeedsRewrite)
 	{
-		if (Content[Pos] == TEXT('\\') && Pos + 1 < Len)
+		return Content.Mid(Start, End - Start);
+	}
+
+	FString Result;
+	Result.Reserve(End - Start);
+	for (int32 i = Start; i < End; ++i)
+	{
+		if (bEscapeSequences && Data[i] == TEXT('\\') && i + 1 < End)
 		{
-			TCHAR Next = Content[Pos + 1];
+			TCHAR Next = Data[i + 1];
 			if (Next == TEXT('"') || Next == TEXT('\\'))
 			{
 				Result += Next;
-				Pos += 2;
+				i++;
 				continue;
 			}
 			if (Next == TEXT('n'))
 			{
 				Result += TEXT('\n');
-				Pos += 2;
+				i++;
 				continue;
 			}
 		}
 		// BSPSource decompiles I/O connections with 0x1b (ESC) as field separator
 		// instead of commas. Normalize to comma so downstream parsing works.
-		TCHAR Ch = Content[Pos++];
-		Result += (Ch == TEXT('\x1b')) ? TEXT(',') : Ch;
+		Result += (Data[i] == TEXT('\x1b')) ? TEXT(',') : Data[i];
 	}
-
-	if (Pos < Len) Pos++; // skip closing quote
 	return Result;
 }
 
 FString FVMFReader::ReadUnquotedToken(const FString& Content, int32& Pos)
 {
+	const TCHAR* Data = *Content;
 	int32 Len = Content.Len();
-	FString Token;
+	const int32 Start = Pos;
 
 	while (Pos < Len)
 	{
-		TCHAR Ch = Content[Pos];
-		if (FChar::IsAlnum(Ch) || Ch == TEXT('_') || Ch == TEXT('-') || Ch == TEXT('.'))
+		TCHAR Ch = Data[Pos];
+		if (Ch == TEXT(' ') || Ch == TEXT('\t') || Ch == TEXT('\r') || Ch == TEXT('\n')
+			|| Ch == TEXT('"') || Ch == TEXT('{') || Ch == TEXT('}'))
 		{
-			Token += Ch;
-			Pos++;
+			break;
 		}
-		else
+		Pos++;
+	}
+
+	return Content.Mid(Start, Pos - Start);
+}
+
+FString FVMFReader::ReadRestOfLine(const FString& Content, int32& Pos)
+{
+	const TCHAR* Data = *Content;
+	int32 Len = Content.Len();
+	const int32 Start = Pos;
+
+	while (Pos < Len)
+	{
+		TCHAR Ch = Data[Pos];
+		if (Ch == TEXT('\r') || Ch == TEXT('\n') || Ch == TEXT('{') || Ch == TEXT('}')
+			|| (Ch == TEXT('/') && Pos + 1 < Len && Data[Pos + 1] == TEXT('/')))
 		{
 			break;
 		}
+		Pos++;
 	}
 
-	return Token;
+	return Content.Mid(Start, Pos - Start).TrimStartAndEnd();
 }
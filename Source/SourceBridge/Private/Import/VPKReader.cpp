@@ -205,6 +205,18 @@ bool FVPKReader::Contains(const FString& FilePath) const
 	return Entries.Contains(Normalized);
 }
 
+bool FVPKReader::GetCRC(const FString& FilePath, uint32& OutCRC) const
+{
+	FString Normalized = FilePath.Replace(TEXT("\\"), TEXT("/")).ToLower();
+	const FVPKEntry* Entry = Entries.Find(Normalized);
+	if (!Entry)
+	{
+		return false;
+	}
+	OutCRC = Entry->CRC;
+	return true;
+}
+
 bool FVPKReader::ReadFile(const FString& FilePath, TArray<uint8>& OutData) const
 {
 	FString Normalized = FilePath.Replace(TEXT("\\"), TEXT("/")).ToLower();
@@ -50,6 +50,11 @@ FString FVMTWriter::Serialize() const
 		Result += FString::Printf(TEXT("\t\"%s\" \"%s\"\n"), *Key, *Value);
 	}
 
+	for (const FVMFKeyValues& Block : Blocks)
+	{
+		Result += Block.Serialize(1);
+	}
+
 	Result += TEXT("}\n");
 
 	return Result;
@@ -144,7 +149,8 @@ FString FVMTWriter::GenerateFromAnalysis(
 
 FString FVMTWriter::GenerateFromStoredParams(
 	const FString& Shader,
-	const TMap<FString, FString>& Params)
+	const TMap<FString, FString>& Params,
+	const TArray<FVMFKeyValues>& Blocks)
 {
 	FVMTWriter Writer;
 	Writer.SetShader(Shader.IsEmpty() ? TEXT("LightmappedGeneric") : Shader);
@@ -153,6 +159,7 @@ FString FVMTWriter::GenerateFromStoredParams(
 	{
 		Writer.SetParameter(Pair.Key, Pair.Value);
 	}
+	Writer.Blocks = Blocks;
 
 	return Writer.Serialize();
 }
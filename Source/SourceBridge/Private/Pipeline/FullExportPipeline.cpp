@@ -1,11 +1,19 @@
 #include "Pipeline/FullExportPipeline.h"
 #include "VMF/VMFExporter.h"
+#include "VMF/VMFPlaneTable.h"
 #include "Validation/ExportValidator.h"
+#include "Validation/LeakDetector.h"
+#include "Import/VMFReader.h"
 #include "Compile/CompilePipeline.h"
+#include "Compile/CompileJob.h"
+#include "Compile/CompileEstimator.h"
+#include "Compile/CompileScheduler.h"
+#include "Compile/ModelCompileCache.h"
 #include "Models/SMDExporter.h"
 #include "Models/QCWriter.h"
 #include "Models/SourceModelManifest.h"
 #include "Import/ModelImporter.h"
+#include "Import/MaterialImporter.h"
 #include "Import/SourceSoundManifest.h"
 #include "Import/SourceResourceManifest.h"
 #include "Materials/SourceMaterialManifest.h"
@@ -16,6 +24,11 @@
 #include "Entities/FGDParser.h"
 #include "SourceBridgeModule.h"
 #include "HAL/PlatformFilemanager.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Async/Async.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
 #include "Engine/World.h"
@@ -24,6 +37,147 @@
 #include "Engine/Texture2D.h"
 #include "EngineUtils.h"
 
+namespace
+{
+	void ReportPipelineProgress(const FOnPipelineProgress& ProgressCallback, const FString& Step, float Progress)
+	{
+		ProgressCallback.ExecuteIfBound(Step, Progress);
+	}
+
+	/**
+	 * Steps 5a-5c once the map compile has finished: record its results, pack custom
+	 * content into the BSP and report the lump budget. False if the compile failed.
+	 */
+	bool FinishMapCompile(const FFullExportSettings& Settings, const FCompileSettings& CompileSettings,
+		const FCompileResult& CompileResult, const FCompileTimeEstimate& Estimate,
+		const TMap<FString, FString>& PackFiles, double CompileSeconds,
+		FFullExportResult& Result, const FOnPipelineProgress& ProgressCallback)
+	{
+		Result.CompileSeconds = CompileSeconds;
+		Result.CompileStages = CompileResult.Stages;
+		Result.CompileTelemetry = CompileResult.Telemetry;
+		Result.CompileReportPath = CompileResult.ReportPath;
+
+		if (CompileResult.Telemetry.bLeaked)
+		{
+			Result.Warnings.Add(FString::Printf(TEXT("[Compile] Map leaked%s%s. Pointfile: %s"),
+				CompileResult.Telemetry.LeakEntity.IsEmpty() ? TEXT("") : TEXT(" at "),
+				*CompileResult.Telemetry.LeakEntity,
+				CompileResult.Telemetry.PointfilePath.IsEmpty() ? TEXT("(none)") : *CompileResult.Telemetry.PointfilePath));
+		}
+
+		if (!CompileResult.bSuccess)
+		{
+			Result.ErrorMessage = CompileResult.bCancelled
+				? TEXT("Compile cancelled.")
+				: TEXT("Compile failed: ") + CompileResult.ErrorMessage;
+			// VMF export was still successful
+			Result.bSuccess = true;
+			UE_LOG(LogTemp, Error, TEXT("SourceBridge: Compile failed: %s"), *CompileResult.ErrorMessage);
+			return false;
+		}
+
+		Result.BSPPath = FPaths::ChangeExtension(Result.VMFPath, TEXT(".bsp"));
+		UE_LOG(LogTemp, Log, TEXT("SourceBridge: %s completed in %.1f seconds (estimated %.0f-%.0f)."),
+			CompileResult.bEntitiesOnly ? TEXT("Entity-only compile") : TEXT("Compile"), Result.CompileSeconds,
+			Estimate.LowSeconds, Estimate.HighSeconds);
+
+		// An -onlyents patch says nothing about full compile times
+		if (!CompileResult.bEntitiesOnly)
+		{
+			FCompileEstimator::RecordCompile(Estimate, CompileResult.Stages, CompileSettings.ThreadCount);
+		}
+
+		// ---- Step 5b: Pack custom content into the BSP's pakfile ----
+		if (PackFiles.Num() > 0 && FPaths::FileExists(Result.BSPPath))
+		{
+			ReportPipelineProgress(ProgressCallback, TEXT("Packing custom content into BSP..."), 0.8f);
+			UE_LOG(LogTemp, Log, TEXT("SourceBridge: Packing %d content files into BSP..."),
+				PackFiles.Num());
+
+			FCompileResult PackResult = FCompilePipeline::PackCustomContent(
+				Result.BSPPath, PackFiles, Settings.bCompressPakfile);
+
+			if (PackResult.bSuccess)
+			{
+				UE_LOG(LogTemp, Log, TEXT("SourceBridge: Successfully packed %d files into BSP"),
+					PackFiles.Num());
+			}
+			else
+			{
+				Result.Warnings.Add(TEXT("[Pack] Packing failed: ") + PackResult.ErrorMessage);
+				UE_LOG(LogTemp, Warning, TEXT("SourceBridge: Packing failed: %s"),
+					*PackResult.ErrorMessage);
+			}
+		}
+
+		// ---- Step 5c: Budget report (after packing, so the pakfile counts) ----
+		if (FPaths::FileExists(Result.BSPPath) && FBSPBudget::Run(Result.BSPPath, Result.Budget))
+		{
+			Result.BudgetReportPath = FBSPBudget::GetReportPath(Result.BSPPath);
+			FBSPBudget::LogReport(Result.Budget);
+			Result.Warnings.Append(FBSPBudget::GetWarnings(Result.Budget));
+		}
+
+		return true;
+	}
+
+	/** Step 6: copy the BSP, VMF and content folders into a distributable package folder. */
+	void PackageExport(const FFullExportSettings& Settings, const FString& OutputDir,
+		FFullExportResult& Result, const FOnPipelineProgress& ProgressCallback)
+	{
+		ReportPipelineProgress(ProgressCallback, TEXT("Packaging distributable..."), 0.9f);
+		FString PackageDir = OutputDir / TEXT("package") / Settings.GameName;
+		FString PackageMaps = PackageDir / TEXT("maps");
+
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		PlatformFile.CreateDirectoryTree(*PackageMaps);
+
+		// Copy BSP to package
+		if (!Result.BSPPath.IsEmpty() && PlatformFile.FileExists(*Result.BSPPath))
+		{
+			FString DestBSP = PackageMaps / FPaths::GetCleanFilename(Result.BSPPath);
+			PlatformFile.CopyFile(*DestBSP, *Result.BSPPath);
+		}
+
+		// Copy VMF source to package (for editing)
+		if (PlatformFile.FileExists(*Result.VMFPath))
+		{
+			FString DestVMF = PackageMaps / FPaths::GetCleanFilename(Result.VMFPath);
+			PlatformFile.CopyFile(*DestVMF, *Result.VMFPath);
+		}
+
+		// Copy all content subdirectories from output to package
+		static const TArray<FString> ContentDirs = {
+			TEXT("materials"), TEXT("models"), TEXT("sound"), TEXT("resource")
+		};
+
+		for (const FString& DirName : ContentDirs)
+		{
+			FString SrcDir = OutputDir / DirName;
+			FString DstDir = PackageDir / DirName;
+			if (PlatformFile.DirectoryExists(*SrcDir))
+			{
+				PlatformFile.CreateDirectoryTree(*DstDir);
+				TArray<FString> Files;
+				PlatformFile.FindFilesRecursively(Files, *SrcDir, TEXT(""));
+				for (const FString& SrcFile : Files)
+				{
+					FString RelPath = SrcFile;
+					FPaths::MakePathRelativeTo(RelPath, *(SrcDir + TEXT("/")));
+					FString DstFile = DstDir / RelPath;
+					PlatformFile.CreateDirectoryTree(*FPaths::GetPath(DstFile));
+					PlatformFile.CopyFile(*DstFile, *SrcFile);
+				}
+			}
+		}
+
+		Result.PackagePath = PackageDir;
+		UE_LOG(LogTemp, Log, TEXT("SourceBridge: Package created at %s"), *PackageDir);
+	}
+
+}
+
 FFullExportResult FFullExportPipeline::Run(UWorld* World, const FFullExportSettings& Settings)
 {
 	return RunWithProgress(World, Settings, FOnPipelineProgress());
@@ -56,7 +210,8 @@ FFullExportResult FFullExportPipeline::RunWithProgress(
 	{
 		ReportProgress(TEXT("Validating scene..."), 0.0f);
 		UE_LOG(LogTemp, Log, TEXT("SourceBridge: Running pre-export validation..."));
-		FValidationResult Validation = FExportValidator::ValidateWorld(World);
+		// Leaks and compile limits are checked on the exported VMF right before compiling
+		FValidationResult Validation = FExportValidator::ValidateWorld(World, false);
 		Validation.LogAll();
 
 		if (Validation.HasErrors())
@@ -123,8 +278,8 @@ FFullExportResult FFullExportPipeline::RunWithProgress(
 	FString GameDir;
 	if (Settings.bCompile)
 	{
-		ToolsDir = FCompilePipeline::FindToolsDirectory();
-		GameDir = FCompilePipeline::FindGameDirectory(Settings.GameName);
+		ToolsDir = Settings.ToolsDir.IsEmpty() ? FCompilePipeline::FindToolsDirectory() : Settings.ToolsDir;
+		GameDir = Settings.GameDir.IsEmpty() ? FCompilePipeline::FindGameDirectory(Settings.GameName) : Settings.GameDir;
 	}
 
 	// ---- Step 3: Export and compile models (dependency: before map compile) ----
@@ -135,9 +290,15 @@ FFullExportResult FFullExportPipeline::RunWithProgress(
 		FString ModelsDir = OutputDir / TEXT("models");
 		PlatformFile.CreateDirectoryTree(*ModelsDir);
 
-		int32 ModelCount = 0;
+		double ModelStepStart = FPlatformTime::Seconds();
 		int32 ModelErrors = 0;
 
+		// Each unique mesh is exported and compiled once, however many actors place it.
+		// Meshes are only read here on the game thread; studiomdl then runs in a pool.
+		TMap<UStaticMesh*, int32> MeshToModel;
+		TMap<FString, int32> QCPathToModel;
+		TArray<FModelCompileSettings> ModelQueue;
+
 		for (TActorIterator<AStaticMeshActor> It(World); It; ++It)
 		{
 			AStaticMeshActor* Actor = *It;
@@ -156,6 +317,28 @@ FFullExportResult FFullExportPipeline::RunWithProgress(
 				continue;
 			}
 
+			if (const int32* Existing = MeshToModel.Find(Mesh))
+			{
+				Result.ModelCompiles[*Existing].Placements++;
+				continue;
+			}
+
+			FString BaseName = MeshName.ToLower();
+			if (BaseName.StartsWith(TEXT("SM_"))) BaseName = BaseName.Mid(3);
+			else if (BaseName.StartsWith(TEXT("S_"))) BaseName = BaseName.Mid(2);
+
+			FString QCPath = ModelsDir / BaseName + TEXT(".qc");
+
+			// Two meshes mapping to the same files would race in studiomdl; the first one wins
+			if (const int32* Existing = QCPathToModel.Find(QCPath))
+			{
+				Result.Warnings.Add(FString::Printf(TEXT("[Models] %s and %s both export as %s; only the first is compiled"),
+					*Result.ModelCompiles[*Existing].ModelName, *MeshName, *BaseName));
+				MeshToModel.Add(Mesh, *Existing);
+				Result.ModelCompiles[*Existing].Placements++;
+				continue;
+			}
+
 			// Export SMD
 			FSMDExportResult SMDResult = FSMDExporter::ExportStaticMesh(Mesh);
 			if (!SMDResult.bSuccess)
@@ -166,14 +349,9 @@ FFullExportResult FFullExportPipeline::RunWithProgress(
 				continue;
 			}
 
-			FString BaseName = MeshName.ToLower();
-			if (BaseName.StartsWith(TEXT("SM_"))) BaseName = BaseName.Mid(3);
-			else if (BaseName.StartsWith(TEXT("S_"))) BaseName = BaseName.Mid(2);
-
 			FString RefPath = ModelsDir / BaseName + TEXT("_ref.smd");
 			FString PhysPath = ModelsDir / BaseName + TEXT("_phys.smd");
 			FString IdlePath = ModelsDir / BaseName + TEXT("_idle.smd");
-			FString QCPath = ModelsDir / BaseName + TEXT(".qc");
 
 			FFileHelper::SaveStringToFile(SMDResult.ReferenceSMD, *RefPath);
 			FFileHelper::SaveStringToFile(SMDResult.PhysicsSMD, *PhysPath);
@@ -183,35 +361,99 @@ FFullExportResult FFullExportPipeline::RunWithProgress(
 			FString QCContent = FQCWriter::GenerateQC(QCSettings);
 			FFileHelper::SaveStringToFile(QCContent, *QCPath);
 
-			// Compile with studiomdl
-			FModelCompileSettings ModelSettings;
+			FModelCompileSettings& ModelSettings = ModelQueue.AddDefaulted_GetRef();
 			ModelSettings.ToolsDir = ToolsDir;
 			ModelSettings.GameDir = GameDir;
 			ModelSettings.QCPath = QCPath;
+			ModelSettings.bUseCache = Settings.bUseModelCache;
 
-			FCompileResult ModelResult = FCompilePipeline::CompileModel(ModelSettings);
-			if (ModelResult.bSuccess)
+			FModelCompileTiming& Timing = Result.ModelCompiles.AddDefaulted_GetRef();
+			Timing.ModelName = MeshName;
+			Timing.QCPath = QCPath;
+			Timing.Placements = 1;
+
+			MeshToModel.Add(Mesh, Result.ModelCompiles.Num() - 1);
+			QCPathToModel.Add(QCPath, Result.ModelCompiles.Num() - 1);
+		}
+
+		if (ModelQueue.Num() > 0)
+		{
+			// Compile on worker threads; keep ticking progress and forward cancellation from here
+			TSharedRef<FThreadSafeCounter> ModelsDone = MakeShared<FThreadSafeCounter>();
+			TSharedRef<FThreadSafeBool> bCancelModels = MakeShared<FThreadSafeBool>(false);
+			for (FModelCompileSettings& ModelSettings : ModelQueue)
 			{
-				ModelCount++;
+				ModelSettings.Hooks.ShouldCancel = [bCancelModels]() { return (bool)*bCancelModels; };
 			}
-			else
+
+			int32 ModelJobs = Settings.ModelCompileJobs;
+			TFuture<TArray<FCompileResult>> ModelBatch = Async(EAsyncExecution::Thread,
+				[ModelQueue, ModelJobs, ModelsDone]()
+				{
+					return FCompileScheduler::RunModelBatch(ModelQueue, ModelJobs,
+						[ModelsDone](int32, const FCompileResult&) { ModelsDone->Increment(); });
+				});
+
+			while (!ModelBatch.IsReady())
 			{
-				ModelErrors++;
-				Result.Warnings.Add(FString::Printf(TEXT("[Models] studiomdl failed for %s: %s"),
-					*BaseName, *ModelResult.ErrorMessage));
+				if (Settings.ShouldCancel && Settings.ShouldCancel())
+				{
+					*bCancelModels = true;
+				}
+
+				int32 Done = ModelsDone->GetValue();
+				ReportProgress(FString::Printf(TEXT("Compiling models (%d/%d)..."), Done, ModelQueue.Num()),
+					0.2f + 0.1f * Done / ModelQueue.Num());
+				FPlatformProcess::Sleep(0.1f);
+			}
+
+			TArray<FCompileResult> ModelResults = ModelBatch.Get();
+			for (int32 i = 0; i < ModelResults.Num(); ++i)
+			{
+				FModelCompileTiming& Timing = Result.ModelCompiles[i];
+				Timing.bSuccess = ModelResults[i].bSuccess;
+				Timing.Seconds = ModelResults[i].ElapsedSeconds;
+				Timing.bFromCache = ModelResults[i].bFromCache;
+
+				if (!Timing.bSuccess)
+				{
+					ModelErrors++;
+					Result.Warnings.Add(FString::Printf(TEXT("[Models] studiomdl failed for %s: %s"),
+						*FPaths::GetBaseFilename(Timing.QCPath), *ModelResults[i].ErrorMessage));
+				}
+			}
+
+			if (*bCancelModels)
+			{
+				Result.ErrorMessage = TEXT("Model compile cancelled.");
+				return Result;
+			}
+
+			if (Settings.bUseModelCache)
+			{
+				FModelCompileCache::Trim((int64)Settings.ModelCacheBudgetMB * 1024 * 1024);
 			}
 		}
 
-		if (ModelCount > 0 || ModelErrors > 0)
+		Result.ModelCompileSeconds = FPlatformTime::Seconds() - ModelStepStart;
+
+		if (Result.ModelCompiles.Num() > 0 || ModelErrors > 0)
 		{
-			UE_LOG(LogTemp, Log, TEXT("SourceBridge: Model compile: %d succeeded, %d failed"),
-				ModelCount, ModelErrors);
+			int32 Placements = 0;
+			int32 Cached = 0;
+			for (const FModelCompileTiming& Timing : Result.ModelCompiles)
+			{
+				Placements += Timing.Placements;
+				Cached += Timing.bFromCache ? 1 : 0;
+			}
+			UE_LOG(LogTemp, Log, TEXT("SourceBridge: Model compile: %d unique models for %d placements (%d from cache), %d failed, %.1f seconds"),
+				Result.ModelCompiles.Num(), Placements, Cached, ModelErrors, Result.ModelCompileSeconds);
 		}
 	}
 
 	// ---- Step 3b: Collect custom content for packing ----
 	// Uses FGD-aware entity scanning (auto-detect), force-pack overrides, and pack-all toggle.
-	// Collected files are staged to the output folder AND tracked for bspzip packing.
+	// Collected files are staged to the output folder AND tracked for packing into the BSP.
 	TMap<FString, FString> CustomContentFiles; // internal path → staged disk path
 	{
 		ReportProgress(TEXT("Collecting custom content..."), 0.3f);
@@ -272,28 +514,31 @@ FFullExportResult FFullExportPipeline::RunWithProgress(
 				// FGD-aware property scanning
 				if (bHasFGD && !Entity->SourceClassname.IsEmpty())
 				{
-					FFGDEntityClass Resolved = FGD.GetResolved(Entity->SourceClassname);
-					for (const FFGDProperty& Prop : Resolved.Properties)
+					TSharedPtr<const FFGDEntityClass> Resolved = FGD.FindResolved(Entity->SourceClassname);
+					if (Resolved.IsValid())
 					{
-						const FString* Val = Entity->KeyValues.Find(Prop.Name);
-						if (!Val || Val->IsEmpty()) continue;
+						for (const FFGDProperty& Prop : Resolved->Properties)
+						{
+							const FString* Val = Entity->KeyValues.Find(Prop.Name);
+							if (!Val || Val->IsEmpty()) continue;
 
-						FString NormVal = Val->ToLower();
-						NormVal.ReplaceInline(TEXT("\\"), TEXT("/"));
+							FString NormVal = Val->ToLower();
+							NormVal.ReplaceInline(TEXT("\\"), TEXT("/"));
 
-						if (Prop.Type == EFGDPropertyType::Studio || Prop.Type == EFGDPropertyType::Sprite)
-						{
-							ReferencedModelPaths.Add(NormVal);
-							ModelRefsFound++;
-						}
-						else if (Prop.Type == EFGDPropertyType::Sound)
-						{
-							ReferencedSoundPaths.Add(NormVal);
-							if (!NormVal.StartsWith(TEXT("sound/")))
-								ReferencedSoundPaths.Add(TEXT("sound/") + NormVal);
-							SoundRefsFound++;
+							if (Prop.Type == EFGDPropertyType::Studio || Prop.Type == EFGDPropertyType::Sprite)
+							{
+								ReferencedModelPaths.Add(NormVal);
+								ModelRefsFound++;
+							}
+							else if (Prop.Type == EFGDPropertyType::Sound)
+							{
+								ReferencedSoundPaths.Add(NormVal);
+								if (!NormVal.StartsWith(TEXT("sound/")))
+									ReferencedSoundPaths.Add(TEXT("sound/") + NormVal);
+								SoundRefsFound++;
+							}
+							// Materials are handled separately via VMF export UsedMaterialPaths
 						}
-						// Materials are handled separately via VMF export UsedMaterialPaths
 					}
 				}
 				else
@@ -332,6 +577,18 @@ FFullExportResult FFullExportPipeline::RunWithProgress(
 				}
 			}
 
+			// Instanced static props imported from a BSP
+			for (TActorIterator<ASourceStaticPropGroup> It(World); It; ++It)
+			{
+				if (!It->ModelPath.IsEmpty())
+				{
+					FString NormPath = It->ModelPath.ToLower();
+					NormPath.ReplaceInline(TEXT("\\"), TEXT("/"));
+					ReferencedModelPaths.Add(NormPath);
+					ModelRefsFound++;
+				}
+			}
+
 			UE_LOG(LogTemp, Log, TEXT("SourceBridge: Scanned %d entities: %d model refs, %d sound refs"),
 				EntityCount, ModelRefsFound, SoundRefsFound);
 		}
@@ -526,6 +783,7 @@ FFullExportResult FFullExportPipeline::RunWithProgress(
 	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Exporting scene to VMF..."));
 	TSet<FString> UsedMaterialPaths;
 	FString VMFContent = FVMFExporter::ExportScene(World, MapName, &UsedMaterialPaths);
+	Result.PlaneStats = FVMFPlaneTable::GetStats();
 
 	if (VMFContent.IsEmpty())
 	{
@@ -658,8 +916,11 @@ FFullExportResult FFullExportPipeline::RunWithProgress(
 					FString VMTContent;
 					if (Entry->Type == ESourceMaterialType::Imported && Entry->VMTParams.Num() > 0)
 					{
-						// Lossless re-export: use stored VMT params from import
-						VMTContent = FVMTWriter::GenerateFromStoredParams(Entry->VMTShader, Entry->VMTParams);
+						// Lossless re-export: use stored VMT params from import, plus the
+						// original's nested blocks (Proxies) when its VMT is still reachable
+						TSharedPtr<const FVMTParsedMaterial> OriginalVMT = FMaterialImporter::FindParsedVMT(Entry->SourcePath);
+						VMTContent = FVMTWriter::GenerateFromStoredParams(Entry->VMTShader, Entry->VMTParams,
+							OriginalVMT.IsValid() ? OriginalVMT->Blocks : TArray<FVMFKeyValues>());
 					}
 					else
 					{
@@ -705,17 +966,120 @@ FFullExportResult FFullExportPipeline::RunWithProgress(
 		}
 	}
 
+	// ---- Step 4c: Drop content identical to stock files ----
+	// Manifest stock flags can be stale, and a custom file may be a byte-for-byte copy of a
+	// VPK entry; either way the game already has it. Compared by the VPK directory's CRC32.
+	if (CustomContentFiles.Num() > 0)
+	{
+		FModelImporter::SetupGameSearchPaths(Settings.GameName);
+
+		int32 StockDuplicates = 0;
+		int64 StockBytes = 0;
+		for (auto It = CustomContentFiles.CreateIterator(); It; ++It)
+		{
+			if (FModelImporter::MatchesStockFile(It.Key(), It.Value()))
+			{
+				StockDuplicates++;
+				StockBytes += IFileManager::Get().FileSize(*It.Value());
+				It.RemoveCurrent();
+			}
+		}
+
+		if (StockDuplicates > 0)
+		{
+			UE_LOG(LogTemp, Log, TEXT("SourceBridge:   Skipped %d files identical to stock content (%.1f KB)"),
+				StockDuplicates, StockBytes / 1024.0);
+		}
+	}
+
 	// ---- Export Summary ----
 	UE_LOG(LogTemp, Log, TEXT("SourceBridge: === Export Summary ==="));
 	UE_LOG(LogTemp, Log, TEXT("SourceBridge:   Output: %s"), *OutputDir);
 	UE_LOG(LogTemp, Log, TEXT("SourceBridge:   VMF: %s"), *FPaths::GetCleanFilename(Result.VMFPath));
 	UE_LOG(LogTemp, Log, TEXT("SourceBridge:   Total content files: %d"), CustomContentFiles.Num());
+	if (Result.PlaneStats.Sides > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("SourceBridge:   Brush planes: %d (%d before canonicalization)"),
+			Result.PlaneStats.CanonicalPlanes, Result.PlaneStats.RawPlanes);
+	}
 	if (Result.Warnings.Num() > 0)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("SourceBridge:   Warnings: %d"), Result.Warnings.Num());
 	}
 
 	// ---- Step 5: Compile map (dependency: after materials and models) ----
+	TArray<FVMFKeyValues> ExportedBlocks;
+	if (Settings.bCompile && (Settings.bCheckLeaks || Settings.bCheckLimits))
+	{
+		ExportedBlocks = FVMFReader::ParseString(VMFContent);
+	}
+
+	if (Settings.bCompile && Settings.bCheckLimits)
+	{
+		ReportProgress(TEXT("Predicting compile limits..."), 0.54f);
+		Result.LimitEstimate = FCompileLimitEstimator::EstimateVMF(ExportedBlocks);
+		Result.Warnings.Append(FCompileLimitEstimator::GetWarnings(Result.LimitEstimate));
+
+		if (FCompileLimitEstimator::ExceedsLimits(Result.LimitEstimate))
+		{
+			TArray<FString> Over;
+			for (const FBSPBudgetEntry& Entry : Result.LimitEstimate.GetEntries())
+			{
+				if (Entry.GetUsed() > Entry.Limit)
+				{
+					Over.Add(FString::Printf(TEXT("%s %lld / %lld"), *Entry.Name, Entry.GetUsed(), Entry.Limit));
+				}
+			}
+			const FString OverList = FString::Join(Over, TEXT(", "));
+
+			// The estimate ignores instances, water, displacements and cubemap
+			// patches, so it is only a prediction; compile anyway unless asked not to.
+			if (Settings.bSkipCompileOverLimits)
+			{
+				Result.ErrorMessage = FString::Printf(
+					TEXT("Map is predicted to exceed Source limits (%s). Compile skipped."), *OverList);
+				// VMF was still exported successfully
+				Result.bSuccess = true;
+				UE_LOG(LogTemp, Error, TEXT("SourceBridge: %s"), *Result.ErrorMessage);
+				return Result;
+			}
+
+			const FString Warning = FString::Printf(
+				TEXT("Map is predicted to exceed Source limits (%s). Compiling anyway; vbsp may fail."), *OverList);
+			Result.Warnings.Add(Warning);
+			UE_LOG(LogTemp, Warning, TEXT("SourceBridge: %s"), *Warning);
+		}
+	}
+
+	if (Settings.bCompile && Settings.bCheckLeaks)
+	{
+		ReportProgress(TEXT("Checking for leaks..."), 0.55f);
+		Result.LeakCheck = FLeakDetector::CheckVMF(ExportedBlocks);
+
+		if (Result.LeakCheck.bLeaked)
+		{
+			FLeakDetector::WritePointfile(Result.VMFPath, Result.LeakCheck);
+
+			const FVector& Origin = Result.LeakCheck.LeakEntityOrigin;
+			Result.ErrorMessage = FString::Printf(
+				TEXT("Map leaks: %s at (%.0f %.0f %.0f) reaches the void. Compile skipped; see the leak path or %s."),
+				*Result.LeakCheck.LeakEntityClass, Origin.X, Origin.Y, Origin.Z,
+				*FPaths::GetCleanFilename(FPaths::ChangeExtension(Result.VMFPath, TEXT("lin"))));
+			// VMF was still exported successfully
+			Result.bSuccess = true;
+			UE_LOG(LogTemp, Error, TEXT("SourceBridge: %s"), *Result.ErrorMessage);
+			return Result;
+		}
+
+		if (Result.LeakCheck.HasLowCoverage())
+		{
+			Result.Warnings.Add(FString::Printf(
+				TEXT("Leak check flooded from only %d of %d entities (the rest are inside %d-unit solid voxels); vbsp may still find a leak."),
+				Result.LeakCheck.SeedEntityCount - Result.LeakCheck.EntitiesInSolid, Result.LeakCheck.SeedEntityCount,
+				Result.LeakCheck.VoxelSize));
+		}
+	}
+
 	if (Settings.bCompile)
 	{
 		ReportProgress(TEXT("Compiling map (vbsp/vvis/vrad)..."), 0.6f);
@@ -724,6 +1088,9 @@ FFullExportResult FFullExportPipeline::RunWithProgress(
 		CompileSettings.bFastCompile = Settings.bFastCompile;
 		CompileSettings.bFinalCompile = Settings.bFinalCompile;
 		CompileSettings.bCopyToGame = Settings.bCopyToGame;
+		CompileSettings.bAllowEntityOnlyCompile = Settings.bAllowEntityOnlyCompile;
+		CompileSettings.bUseArtifactCache = Settings.bUseCompileCache;
+		CompileSettings.ThreadCount = Settings.CompileThreads;
 		CompileSettings.ToolsDir = ToolsDir;
 		CompileSettings.GameDir = GameDir;
 
@@ -746,103 +1113,124 @@ FFullExportResult FFullExportPipeline::RunWithProgress(
 			return Result;
 		}
 
-		UE_LOG(LogTemp, Log, TEXT("SourceBridge: Compiling map..."));
-		double CompileStart = FPlatformTime::Seconds();
-		FCompileResult CompileResult = FCompilePipeline::CompileMap(CompileSettings);
-		Result.CompileSeconds = FPlatformTime::Seconds() - CompileStart;
-
-		if (!CompileResult.bSuccess)
+		if (Settings.bDeferMapCompile)
 		{
-			Result.ErrorMessage = TEXT("Compile failed: ") + CompileResult.ErrorMessage;
-			// VMF export was still successful
+			Result.bCompileDeferred = true;
+			Result.DeferredCompile = CompileSettings;
+			Result.DeferredPackFiles = CustomContentFiles;
 			Result.bSuccess = true;
-			UE_LOG(LogTemp, Error, TEXT("SourceBridge: Compile failed: %s"), *CompileResult.ErrorMessage);
+			UE_LOG(LogTemp, Log, TEXT("SourceBridge: Export finished; map compile deferred to the caller."));
 			return Result;
 		}
 
-		Result.BSPPath = FPaths::ChangeExtension(Result.VMFPath, TEXT(".bsp"));
-		UE_LOG(LogTemp, Log, TEXT("SourceBridge: Compile completed in %.1f seconds."), Result.CompileSeconds);
-
-		// ---- Step 5b: Pack custom content into BSP via bspzip ----
-		if (CustomContentFiles.Num() > 0 && FPaths::FileExists(Result.BSPPath))
-		{
-			ReportProgress(TEXT("Packing custom content into BSP..."), 0.8f);
-			UE_LOG(LogTemp, Log, TEXT("SourceBridge: Packing %d content files into BSP via bspzip..."),
-				CustomContentFiles.Num());
+		// Estimate now (needs the world on this thread); the measured result calibrates later estimates
+		FCompileTimeEstimate Estimate = FCompileEstimator::EstimateCompileTime(
+			World, Settings.bFastCompile, Settings.bFinalCompile);
+		UE_LOG(LogTemp, Log, TEXT("SourceBridge: %s"), *Estimate.GetSummary());
 
-			FCompileResult PackResult = FCompilePipeline::PackCustomContent(
-				Result.BSPPath, ToolsDir, CustomContentFiles);
+		UE_LOG(LogTemp, Log, TEXT("SourceBridge: Compiling map..."));
+		double CompileStart = FPlatformTime::Seconds();
 
-			if (PackResult.bSuccess)
-			{
-				UE_LOG(LogTemp, Log, TEXT("SourceBridge: Successfully packed %d files into BSP"),
-					CustomContentFiles.Num());
-			}
-			else
+		// The tools run on a worker thread; this blocks until the BSP is written (headless
+		// callers), reporting progress and forwarding cancellation. The editor uses RunAsync.
+		TSharedRef<FCompileJob> CompileJob = FCompileJob::StartMapCompile(CompileSettings);
+		while (!CompileJob->IsDone())
+		{
+			if (Settings.ShouldCancel && Settings.ShouldCancel())
 			{
-				Result.Warnings.Add(TEXT("[Pack] bspzip failed: ") + PackResult.ErrorMessage);
-				UE_LOG(LogTemp, Warning, TEXT("SourceBridge: bspzip failed: %s"),
-					*PackResult.ErrorMessage);
+				CompileJob->Cancel();
 			}
+
+			// Compile spans 0.6-0.8 of the pipeline, driven by parsed tool progress
+			FString Tool = CompileJob->GetCurrentTool();
+			FString Phase = CompileJob->GetCurrentPhase();
+			float CompileProgress = CompileJob->GetProgress();
+			ReportProgress(FString::Printf(TEXT("Compiling map: %s%s%s %d%% (%.0fs)..."),
+				Tool.IsEmpty() ? TEXT("starting") : *Tool,
+				Phase.IsEmpty() ? TEXT("") : TEXT(" "), *Phase,
+				FMath::RoundToInt(CompileProgress * 100.0f), CompileJob->GetElapsedSeconds()),
+				0.6f + 0.2f * CompileProgress);
+			FPlatformProcess::Sleep(0.1f);
+		}
+
+		if (!FinishMapCompile(Settings, CompileSettings, CompileJob->GetResult(), Estimate, CustomContentFiles,
+			FPlatformTime::Seconds() - CompileStart, Result, ProgressCallback))
+		{
+			return Result;
 		}
 	}
 
 	// ---- Step 6: Package distributable ----
 	if (Settings.bPackage)
 	{
-		ReportProgress(TEXT("Packaging distributable..."), 0.9f);
-		FString PackageDir = OutputDir / TEXT("package") / Settings.GameName;
-		FString PackageMaps = PackageDir / TEXT("maps");
+		PackageExport(Settings, OutputDir, Result, ProgressCallback);
+	}
 
-		PlatformFile.CreateDirectoryTree(*PackageMaps);
+	Result.bSuccess = true;
 
-		// Copy BSP to package
-		if (!Result.BSPPath.IsEmpty() && PlatformFile.FileExists(*Result.BSPPath))
-		{
-			FString DestBSP = PackageMaps / FPaths::GetCleanFilename(Result.BSPPath);
-			PlatformFile.CopyFile(*DestBSP, *Result.BSPPath);
-		}
+	double TotalTime = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Full pipeline completed in %.1f seconds."), TotalTime);
 
-		// Copy VMF source to package (for editing)
-		if (PlatformFile.FileExists(*Result.VMFPath))
-		{
-			FString DestVMF = PackageMaps / FPaths::GetCleanFilename(Result.VMFPath);
-			PlatformFile.CopyFile(*DestVMF, *Result.VMFPath);
-		}
+	return Result;
+}
 
-		// Copy all content subdirectories from output to package
-		static const TArray<FString> ContentDirs = {
-			TEXT("materials"), TEXT("models"), TEXT("sound"), TEXT("resource")
-		};
+TSharedPtr<FCompileJob> FFullExportPipeline::RunAsync(
+	UWorld* World,
+	const FFullExportSettings& Settings,
+	FOnPipelineProgress ProgressCallback,
+	FOnFullExportFinished OnFinished)
+{
+	const double StartTime = FPlatformTime::Seconds();
 
-		for (const FString& DirName : ContentDirs)
-		{
-			FString SrcDir = OutputDir / DirName;
-			FString DstDir = PackageDir / DirName;
-			if (PlatformFile.DirectoryExists(*SrcDir))
-			{
-				PlatformFile.CreateDirectoryTree(*DstDir);
-				TArray<FString> Files;
-				PlatformFile.FindFilesRecursively(Files, *SrcDir, TEXT(""));
-				for (const FString& SrcFile : Files)
-				{
-					FString RelPath = SrcFile;
-					FPaths::MakePathRelativeTo(RelPath, *(SrcDir + TEXT("/")));
-					FString DstFile = DstDir / RelPath;
-					PlatformFile.CreateDirectoryTree(*FPaths::GetPath(DstFile));
-					PlatformFile.CopyFile(*DstFile, *SrcFile);
-				}
-			}
-		}
+	// Everything before the map compile runs now, with the compile handed back
+	FFullExportSettings ExportSettings = Settings;
+	ExportSettings.bDeferMapCompile = true;
+	FFullExportResult Result = RunWithProgress(World, ExportSettings, ProgressCallback);
 
-		Result.PackagePath = PackageDir;
-		UE_LOG(LogTemp, Log, TEXT("SourceBridge: Package created at %s"), *PackageDir);
+	if (!Result.bCompileDeferred)
+	{
+		// Failed or stopped before compiling (or nothing to compile): already final
+		OnFinished.ExecuteIfBound(Result);
+		return nullptr;
 	}
 
-	Result.bSuccess = true;
+	const FCompileSettings CompileSettings = Result.DeferredCompile;
+	TMap<FString, FString> PackFiles = MoveTemp(Result.DeferredPackFiles);
+	Result.bCompileDeferred = false;
+	Result.DeferredCompile = FCompileSettings();
+	Result.bSuccess = false;
 
-	double TotalTime = FPlatformTime::Seconds() - StartTime;
-	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Full pipeline completed in %.1f seconds."), TotalTime);
+	// Estimate now (needs the world on this thread); the measured result calibrates later estimates
+	FCompileTimeEstimate Estimate = FCompileEstimator::EstimateCompileTime(
+		World, Settings.bFastCompile, Settings.bFinalCompile);
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: %s"), *Estimate.GetSummary());
 
-	return Result;
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Compiling map..."));
+	const double CompileStart = FPlatformTime::Seconds();
+
+	// The rest of the pipeline continues on the game thread when the job finishes.
+	// ProgressCallback and ShouldCancel may point at the caller's stack, so neither is used past here.
+	FFullExportSettings FinishSettings = Settings;
+	FinishSettings.ShouldCancel = nullptr;
+
+	TSharedRef<FCompileJob> CompileJob = FCompileJob::StartMapCompile(CompileSettings);
+	CompileJob->OnFinished.AddLambda([Settings = MoveTemp(FinishSettings), CompileSettings, PackFiles = MoveTemp(PackFiles), Estimate,
+		Result = MoveTemp(Result), CompileStart, StartTime, OnFinished](const FCompileResult& CompileResult) mutable
+	{
+		if (FinishMapCompile(Settings, CompileSettings, CompileResult, Estimate, PackFiles,
+			FPlatformTime::Seconds() - CompileStart, Result, FOnPipelineProgress()))
+		{
+			if (Settings.bPackage)
+			{
+				PackageExport(Settings, FPaths::GetPath(Result.VMFPath), Result, FOnPipelineProgress());
+			}
+
+			Result.bSuccess = true;
+			UE_LOG(LogTemp, Log, TEXT("SourceBridge: Full pipeline completed in %.1f seconds."),
+				FPlatformTime::Seconds() - StartTime);
+		}
+		OnFinished.ExecuteIfBound(Result);
+	});
+
+	return CompileJob;
 }
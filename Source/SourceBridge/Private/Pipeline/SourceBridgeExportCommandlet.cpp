@@ -0,0 +1,406 @@
+#include "Pipeline/SourceBridgeExportCommandlet.h"
+#include "Pipeline/FullExportPipeline.h"
+#include "Compile/CompilePipeline.h"
+#include "Compile/CompileScheduler.h"
+#include "Import/ModelImporter.h"
+#include "Import/MaterialImporter.h"
+#include "UI/SourceBridgeSettings.h"
+#include "Engine/World.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/PackageName.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/PlatformProcess.h"
+#include "UObject/Package.h"
+
+namespace
+{
+	struct FMapBuild
+	{
+		FString MapPath;
+		FString MapName;
+		FFullExportResult Export;
+		FCompileResult Compile;
+		bool bCompiled = false;
+		FString PackError;
+
+		bool Succeeded() const
+		{
+			return Export.bSuccess && Export.ErrorMessage.IsEmpty()
+				&& (!Export.bCompileDeferred || (bCompiled && Compile.bSuccess))
+				&& PackError.IsEmpty();
+		}
+	};
+
+	/** Load a map package and bring its world up far enough for actor iteration. */
+	UWorld* LoadWorld(const FString& MapPath, bool& bOutInitializedHere)
+	{
+		bOutInitializedHere = false;
+
+		UPackage* Package = LoadPackage(nullptr, *MapPath, LOAD_None);
+		UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+		if (!World)
+		{
+			return nullptr;
+		}
+
+		World->AddToRoot();
+		if (!World->bIsWorldInitialized)
+		{
+			World->WorldType = EWorldType::Editor;
+			World->InitWorld(UWorld::InitializationValues()
+				.RequiresHitProxies(false)
+				.ShouldSimulatePhysics(false)
+				.EnableTraceCollision(false)
+				.CreateNavigation(false)
+				.CreateAISystem(false)
+				.AllowAudioPlayback(false)
+				.CreatePhysicsScene(false));
+			World->UpdateWorldComponents(true, false);
+			bOutInitializedHere = true;
+		}
+		return World;
+	}
+
+	void ReleaseWorld(UWorld* World, bool bInitializedHere)
+	{
+		if (bInitializedHere)
+		{
+			World->DestroyWorld(false);
+		}
+		World->RemoveFromRoot();
+	}
+
+	TSharedRef<FJsonObject> MakeMapSummary(const FMapBuild& Build)
+	{
+		const FFullExportResult& Export = Build.Export;
+
+		TSharedRef<FJsonObject> Map = MakeShared<FJsonObject>();
+		Map->SetStringField(TEXT("map"), Build.MapPath);
+		Map->SetBoolField(TEXT("success"), Build.Succeeded());
+		Map->SetStringField(TEXT("vmf"), Export.VMFPath);
+		Map->SetNumberField(TEXT("brushes"), Export.BrushCount);
+		Map->SetNumberField(TEXT("entities"), Export.EntityCount);
+		Map->SetNumberField(TEXT("exportSeconds"), Export.ExportSeconds);
+
+		FString Error = !Export.ErrorMessage.IsEmpty() ? Export.ErrorMessage
+			: (Build.bCompiled && !Build.Compile.bSuccess ? Build.Compile.ErrorMessage : FString());
+		if (!Error.IsEmpty())
+		{
+			Map->SetStringField(TEXT("error"), Error);
+		}
+
+		TArray<TSharedPtr<FJsonValue>> Warnings;
+		for (const FString& Warning : Export.Warnings)
+		{
+			Warnings.Add(MakeShared<FJsonValueString>(Warning));
+		}
+		if (!Build.PackError.IsEmpty())
+		{
+			Warnings.Add(MakeShared<FJsonValueString>(TEXT("[Pack] Packing failed: ") + Build.PackError));
+		}
+		Map->SetArrayField(TEXT("warnings"), Warnings);
+
+		if (Export.ModelCompiles.Num() > 0)
+		{
+			TArray<TSharedPtr<FJsonValue>> Models;
+			for (const FModelCompileTiming& Model : Export.ModelCompiles)
+			{
+				TSharedRef<FJsonObject> ModelObject = MakeShared<FJsonObject>();
+				ModelObject->SetStringField(TEXT("name"), Model.ModelName);
+				ModelObject->SetNumberField(TEXT("placements"), Model.Placements);
+				ModelObject->SetNumberField(TEXT("seconds"), Model.Seconds);
+				ModelObject->SetBoolField(TEXT("success"), Model.bSuccess);
+				ModelObject->SetBoolField(TEXT("cached"), Model.bFromCache);
+				Models.Add(MakeShared<FJsonValueObject>(ModelObject));
+			}
+			Map->SetArrayField(TEXT("models"), Models);
+			Map->SetNumberField(TEXT("modelSeconds"), Export.ModelCompileSeconds);
+		}
+
+		if (Export.LeakCheck.bChecked)
+		{
+			TSharedRef<FJsonObject> Leak = MakeShared<FJsonObject>();
+			Leak->SetBoolField(TEXT("leaked"), Export.LeakCheck.bLeaked);
+			Leak->SetStringField(TEXT("entity"), Export.LeakCheck.LeakEntityClass);
+			Leak->SetNumberField(TEXT("seconds"), Export.LeakCheck.Seconds);
+			Map->SetObjectField(TEXT("leakCheck"), Leak);
+		}
+
+		if (Export.PlaneStats.Sides > 0)
+		{
+			TSharedRef<FJsonObject> Planes = MakeShared<FJsonObject>();
+			Planes->SetNumberField(TEXT("sides"), Export.PlaneStats.Sides);
+			Planes->SetNumberField(TEXT("raw"), Export.PlaneStats.RawPlanes);
+			Planes->SetNumberField(TEXT("canonical"), Export.PlaneStats.CanonicalPlanes);
+			Map->SetObjectField(TEXT("planes"), Planes);
+		}
+
+		if (Export.LimitEstimate.bChecked)
+		{
+			TSharedRef<FJsonObject> Limits = MakeShared<FJsonObject>();
+			for (const FBSPBudgetEntry& Entry : Export.LimitEstimate.GetEntries())
+			{
+				TSharedRef<FJsonObject> EntryObject = MakeShared<FJsonObject>();
+				EntryObject->SetNumberField(TEXT("predicted"), (double)Entry.GetUsed());
+				EntryObject->SetNumberField(TEXT("limit"), (double)Entry.Limit);
+				Limits->SetObjectField(Entry.Name, EntryObject);
+			}
+			Limits->SetNumberField(TEXT("seconds"), Export.LimitEstimate.Seconds);
+			Map->SetObjectField(TEXT("limitEstimate"), Limits);
+		}
+
+		if (Build.bCompiled)
+		{
+			const FCompileResult& Compile = Build.Compile;
+			TSharedRef<FJsonObject> CompileObject = MakeShared<FJsonObject>();
+			CompileObject->SetBoolField(TEXT("success"), Compile.bSuccess);
+			CompileObject->SetNumberField(TEXT("seconds"), Compile.ElapsedSeconds);
+			CompileObject->SetBoolField(TEXT("entitiesOnly"), Compile.bEntitiesOnly);
+			CompileObject->SetStringField(TEXT("bsp"), Compile.bSuccess ? FPaths::ChangeExtension(Export.VMFPath, TEXT("bsp")) : FString());
+			CompileObject->SetStringField(TEXT("report"), Compile.ReportPath);
+
+			TArray<TSharedPtr<FJsonValue>> Stages;
+			for (const FCompileStageStats& Stage : Compile.Stages)
+			{
+				TSharedRef<FJsonObject> StageObject = MakeShared<FJsonObject>();
+				StageObject->SetStringField(TEXT("tool"), Stage.ToolName);
+				StageObject->SetNumberField(TEXT("seconds"), Stage.WallSeconds);
+				StageObject->SetNumberField(TEXT("peakMemoryBytes"), (double)Stage.PeakMemoryBytes);
+				Stages.Add(MakeShared<FJsonValueObject>(StageObject));
+			}
+			CompileObject->SetArrayField(TEXT("stages"), Stages);
+			Map->SetObjectField(TEXT("compile"), CompileObject);
+		}
+
+		if (Export.Budget.IsValid())
+		{
+			TSharedRef<FJsonObject> Budget = Export.Budget.ToJson();
+			Budget->SetStringField(TEXT("report"), Export.BudgetReportPath);
+			Map->SetObjectField(TEXT("budget"), Budget);
+		}
+
+		return Map;
+	}
+}
+
+USourceBridgeExportCommandlet::USourceBridgeExportCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 USourceBridgeExportCommandlet::Main(const FString& Params)
+{
+	double StartTime = FPlatformTime::Seconds();
+
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	auto GetParam = [&ParamVals](const TCHAR* Name, const FString& Default = FString()) -> FString
+	{
+		const FString* Value = ParamVals.Find(Name);
+		return Value ? Value->TrimQuotes() : Default;
+	};
+	auto HasSwitch = [&Switches](const TCHAR* Name)
+	{
+		return Switches.ContainsByPredicate([Name](const FString& Switch) { return Switch.Equals(Name, ESearchCase::IgnoreCase); });
+	};
+
+	// ---- Map list ----
+	TArray<FString> MapPaths;
+	GetParam(TEXT("Maps")).ParseIntoArray(MapPaths, TEXT("+"), true);
+
+	FString MapListPath = GetParam(TEXT("MapList"));
+	if (!MapListPath.IsEmpty())
+	{
+		TArray<FString> Lines;
+		if (!FFileHelper::LoadFileToStringArray(Lines, *MapListPath))
+		{
+			UE_LOG(LogTemp, Error, TEXT("SourceBridgeExport: Cannot read map list %s"), *MapListPath);
+			return 1;
+		}
+		for (FString& Line : Lines)
+		{
+			Line.TrimStartAndEndInline();
+			if (!Line.IsEmpty() && !Line.StartsWith(TEXT("#")) && !Line.StartsWith(TEXT("//")))
+			{
+				MapPaths.Add(Line);
+			}
+		}
+	}
+
+	if (MapPaths.Num() == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("SourceBridgeExport: No maps given. Use -Maps=/Game/Maps/A+/Game/Maps/B or -MapList=<file>."));
+		return 1;
+	}
+
+	// ---- Shared settings ----
+	USourceBridgeSettings* BridgeSettings = USourceBridgeSettings::Get();
+	FString GameName = GetParam(TEXT("Game"), BridgeSettings->TargetGame);
+	FString OutputRoot = GetParam(TEXT("Output"));
+	FString SummaryPath = GetParam(TEXT("Summary"),
+		FPaths::ProjectSavedDir() / TEXT("SourceBridge") / TEXT("ExportSummary.json"));
+	bool bCompile = !HasSwitch(TEXT("NoCompile"));
+	int32 Jobs = FCString::Atoi(*GetParam(TEXT("Jobs"), TEXT("0")));
+	int32 Threads = FCString::Atoi(*GetParam(TEXT("Threads"), TEXT("0")));
+
+	FFullExportSettings BaseSettings;
+	BaseSettings.GameName = GameName;
+	BaseSettings.bCompile = bCompile;
+	BaseSettings.bDeferMapCompile = true;
+	BaseSettings.bFinalCompile = HasSwitch(TEXT("Final"));
+	BaseSettings.bFastCompile = !BaseSettings.bFinalCompile && BridgeSettings->bFastCompile;
+	BaseSettings.bCopyToGame = BridgeSettings->bCopyToGame;
+	BaseSettings.bAllowEntityOnlyCompile = BridgeSettings->bEntityOnlyCompile;
+	BaseSettings.bUseCompileCache = BridgeSettings->bCacheCompileStages;
+	BaseSettings.bCheckLeaks = BridgeSettings->bCheckLeaksBeforeCompile && !HasSwitch(TEXT("NoLeakCheck"));
+	BaseSettings.bCheckLimits = BridgeSettings->bCheckLimitsBeforeCompile && !HasSwitch(TEXT("NoLimitCheck"));
+	BaseSettings.bSkipCompileOverLimits = BridgeSettings->bSkipCompileOverLimits || HasSwitch(TEXT("SkipOverLimits"));
+	BaseSettings.bValidate = BridgeSettings->bValidateBeforeExport;
+	BaseSettings.ModelCompileJobs = BridgeSettings->MaxConcurrentModelCompiles;
+	BaseSettings.bUseModelCache = BridgeSettings->bCacheModelCompiles;
+	BaseSettings.ModelCacheBudgetMB = BridgeSettings->ModelCacheBudgetMB;
+	BaseSettings.bCompressPakfile = BridgeSettings->bCompressPakfile;
+	BaseSettings.ToolsDir = GetParam(TEXT("ToolsDir"));
+	BaseSettings.GameDir = GetParam(TEXT("GameDir"));
+
+	// Warm the game VPK index and search paths once; the importer caches persist across maps
+	FModelImporter::SetupGameSearchPaths(GameName);
+	FMaterialImporter::SetupGameSearchPaths(GameName);
+
+	// ---- Export every map (game thread), deferring compiles ----
+	TArray<FMapBuild> Builds;
+	for (const FString& MapPath : MapPaths)
+	{
+		FMapBuild& Build = Builds.AddDefaulted_GetRef();
+		Build.MapPath = MapPath;
+		Build.MapName = FPackageName::GetShortName(MapPath);
+
+		UE_LOG(LogTemp, Display, TEXT("SourceBridgeExport: Exporting %s (%d/%d)"),
+			*MapPath, Builds.Num(), MapPaths.Num());
+
+		bool bInitializedHere = false;
+		UWorld* World = LoadWorld(MapPath, bInitializedHere);
+		if (!World)
+		{
+			Build.Export.ErrorMessage = FString::Printf(TEXT("Could not load map %s"), *MapPath);
+			UE_LOG(LogTemp, Error, TEXT("SourceBridgeExport: %s"), *Build.Export.ErrorMessage);
+			continue;
+		}
+
+		FFullExportSettings Settings = BaseSettings;
+		Settings.MapName = Build.MapName;
+		if (!OutputRoot.IsEmpty())
+		{
+			Settings.OutputDir = OutputRoot / Build.MapName;
+		}
+
+		Build.Export = FFullExportPipeline::Run(World, Settings);
+		ReleaseWorld(World, bInitializedHere);
+
+		if (!Build.Export.ErrorMessage.IsEmpty())
+		{
+			UE_LOG(LogTemp, Error, TEXT("SourceBridgeExport: %s: %s"), *Build.MapName, *Build.Export.ErrorMessage);
+		}
+	}
+
+	// ---- Compile the exported maps concurrently ----
+	TArray<FCompileQueueItem> Queue;
+	TArray<int32> QueueBuild;
+	for (int32 i = 0; i < Builds.Num(); ++i)
+	{
+		if (Builds[i].Export.bCompileDeferred)
+		{
+			Queue.AddDefaulted_GetRef().Settings = Builds[i].Export.DeferredCompile;
+			QueueBuild.Add(i);
+		}
+	}
+
+	if (Queue.Num() > 0)
+	{
+		TSharedRef<FCompileBatch> Batch = FCompileScheduler::StartBatch(Queue, Threads, Jobs);
+		Batch->OnMapFinished.AddLambda([&](int32 QueueIndex, const FCompileResult& Result)
+		{
+			// Pack right after each compile, while the others keep running
+			FMapBuild& Build = Builds[QueueBuild[QueueIndex]];
+			if (!Result.bSuccess || Build.Export.DeferredPackFiles.Num() == 0)
+			{
+				return;
+			}
+
+			FString BSPPath = FPaths::ChangeExtension(Build.Export.VMFPath, TEXT("bsp"));
+			FCompileResult PackResult = FCompilePipeline::PackCustomContent(
+				BSPPath, Build.Export.DeferredPackFiles, BaseSettings.bCompressPakfile);
+			if (!PackResult.bSuccess)
+			{
+				Build.PackError = PackResult.ErrorMessage;
+			}
+		});
+
+		// Job and batch callbacks arrive as game thread tasks; nothing else pumps them here
+		while (!Batch->IsDone())
+		{
+			FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+			FPlatformProcess::Sleep(0.1f);
+		}
+		const FCompileBatchResult& BatchResult = Batch->GetResult();
+
+		for (int32 QueueIndex = 0; QueueIndex < Queue.Num(); ++QueueIndex)
+		{
+			FMapBuild& Build = Builds[QueueBuild[QueueIndex]];
+			Build.Compile = BatchResult.Results[QueueIndex];
+			Build.bCompiled = true;
+			if (Build.Compile.bSuccess)
+			{
+				Build.Export.BSPPath = FPaths::ChangeExtension(Build.Export.VMFPath, TEXT("bsp"));
+				if (FBSPBudget::Run(Build.Export.BSPPath, Build.Export.Budget))
+				{
+					Build.Export.BudgetReportPath = FBSPBudget::GetReportPath(Build.Export.BSPPath);
+					FBSPBudget::LogReport(Build.Export.Budget);
+					Build.Export.Warnings.Append(FBSPBudget::GetWarnings(Build.Export.Budget));
+				}
+			}
+		}
+	}
+
+	// ---- Summary ----
+	int32 Succeeded = 0;
+	TArray<TSharedPtr<FJsonValue>> Maps;
+	for (const FMapBuild& Build : Builds)
+	{
+		Succeeded += Build.Succeeded() ? 1 : 0;
+		Maps.Add(MakeShared<FJsonValueObject>(MakeMapSummary(Build)));
+	}
+
+	double TotalSeconds = FPlatformTime::Seconds() - StartTime;
+
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("date"), FDateTime::UtcNow().ToIso8601());
+	Root->SetStringField(TEXT("game"), GameName);
+	Root->SetNumberField(TEXT("totalSeconds"), TotalSeconds);
+	Root->SetNumberField(TEXT("succeeded"), Succeeded);
+	Root->SetNumberField(TEXT("failed"), Builds.Num() - Succeeded);
+	Root->SetArrayField(TEXT("maps"), Maps);
+
+	FString Json;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Root, Writer);
+	if (!FFileHelper::SaveStringToFile(Json, *SummaryPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("SourceBridgeExport: Failed to write summary %s"), *SummaryPath);
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("SourceBridgeExport: %d/%d maps succeeded in %.1f seconds. Summary: %s"),
+		Succeeded, Builds.Num(), TotalSeconds, *SummaryPath);
+
+	return Succeeded == Builds.Num() ? 0 : 1;
+}
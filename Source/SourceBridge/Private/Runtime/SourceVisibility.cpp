@@ -0,0 +1,234 @@
+#include "Runtime/SourceVisibility.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "EngineUtils.h"
+#if WITH_EDITOR
+#include "LevelEditorViewport.h"
+#endif
+
+ASourceVisibility::ASourceVisibility()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = true;
+
+	USceneComponent* Root = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	Root->SetMobility(EComponentMobility::Static);
+	SetRootComponent(Root);
+
+	SetActorHiddenInGame(true);
+}
+
+void ASourceVisibility::SetVisibility(const FBSPVisibility& InVisibility)
+{
+	Visibility = InVisibility;
+	NumClusters = Visibility.GetNumClusters();
+
+	VisData.Reset();
+	FMemoryWriter Writer(VisData);
+	Writer << Visibility;
+
+	bDirty = true;
+}
+
+void ASourceVisibility::PostLoad()
+{
+	Super::PostLoad();
+	LoadVisData();
+}
+
+void ASourceVisibility::PostDuplicate(bool bDuplicateForPIE)
+{
+	Super::PostDuplicate(bDuplicateForPIE);
+	LoadVisData();
+}
+
+void ASourceVisibility::LoadVisData()
+{
+	Visibility = FBSPVisibility();
+	if (VisData.Num() > 0)
+	{
+		FMemoryReader Reader(VisData);
+		Reader << Visibility;
+		if (Reader.IsError())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SourceBridge: Stored visibility data is unreadable, re-import the BSP"));
+			Visibility = FBSPVisibility();
+		}
+	}
+	NumClusters = Visibility.GetNumClusters();
+	bDirty = true;
+}
+
+void ASourceVisibility::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	UWorld* World = GetWorld();
+	if (!World || !Visibility.IsValid()) return;
+
+	const bool bGame = World->IsGameWorld();
+	if (bGame ? !bCullInGame : !bCullInEditor)
+	{
+		RestoreAll();
+		return;
+	}
+
+	// Camera position: the player's view while playing, the active level viewport otherwise
+	FVector CameraLocation;
+	if (bGame)
+	{
+		APlayerController* PC = World->GetFirstPlayerController();
+		if (!PC || !PC->PlayerCameraManager) return;
+		CameraLocation = PC->PlayerCameraManager->GetCameraLocation();
+	}
+	else
+	{
+#if WITH_EDITOR
+		if (!GCurrentLevelEditingViewportClient || GCurrentLevelEditingViewportClient->GetWorld() != World) return;
+		CameraLocation = GCurrentLevelEditingViewportClient->GetViewLocation();
+#else
+		return;
+#endif
+	}
+
+	// Reverse of FVMFImporter::SourceToUE
+	const float Scale = ScaleMultiplier > 0.0f ? ScaleMultiplier : 1.0f;
+	const FVector3f SourcePos(CameraLocation.X / Scale, -CameraLocation.Y / Scale, CameraLocation.Z / Scale);
+	const int32 Cluster = Visibility.FindCluster(SourcePos);
+
+	if (Cluster != CurrentCluster || bDirty || bCulledInGame != bGame)
+	{
+		ApplyCluster(Cluster);
+	}
+}
+
+void ASourceVisibility::ApplyCluster(int32 Cluster)
+{
+	UWorld* World = GetWorld();
+	if (!World) return;
+
+	const bool bGame = World->IsGameWorld();
+	if (bCulledInGame != bGame)
+	{
+		RestoreAll();
+		bCulledInGame = bGame;
+	}
+	CurrentCluster = Cluster;
+	bDirty = false;
+
+	// Outside the map (noclip, solid space): draw everything, like the engine's novis fallback
+	TBitArray<> Visible;
+	const bool bHasPVS = Cluster >= 0 && Visibility.GetVisibleClusters(Cluster, Visible);
+
+	TSet<AActor*> StillCulled;
+	int32 Hidden = 0;
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		AActor* Actor = *It;
+		const USourceVisClusterComponent* Tag = Actor ? Actor->FindComponentByClass<USourceVisClusterComponent>() : nullptr;
+		if (!Tag || Tag->Clusters.Num() == 0) continue;
+
+		bool bVisible = !bHasPVS;
+		for (int32 i = 0; i < Tag->Clusters.Num() && !bVisible; ++i)
+		{
+			bVisible = !Visible.IsValidIndex(Tag->Clusters[i]) || Visible[Tag->Clusters[i]];
+		}
+		if (bVisible) continue;
+
+		const bool bAlreadyCulled = CulledActors.Contains(Actor);
+		if (!bAlreadyCulled)
+		{
+			// Leave actors hidden by something else alone, so they aren't shown on restore
+			if (bGame)
+			{
+				if (Actor->IsHidden()) continue;
+				Actor->SetActorHiddenInGame(true);
+			}
+			else
+			{
+#if WITH_EDITOR
+				if (Actor->IsTemporarilyHiddenInEditor()) continue;
+				Actor->SetIsTemporarilyHiddenInEditor(true);
+#endif
+			}
+		}
+		StillCulled.Add(Actor);
+		Hidden++;
+	}
+
+	// Show what came back into view
+	for (const TWeakObjectPtr<AActor>& Weak : CulledActors)
+	{
+		AActor* Actor = Weak.Get();
+		if (!Actor || StillCulled.Contains(Actor)) continue;
+		if (bGame)
+		{
+			Actor->SetActorHiddenInGame(false);
+		}
+		else
+		{
+#if WITH_EDITOR
+			Actor->SetIsTemporarilyHiddenInEditor(false);
+#endif
+		}
+	}
+
+	CulledActors.Reset(StillCulled.Num());
+	for (AActor* Actor : StillCulled)
+	{
+		CulledActors.Add(Actor);
+	}
+
+	UE_LOG(LogTemp, Verbose, TEXT("SourceBridge: Visibility cluster %d, %d actors culled"), Cluster, Hidden);
+}
+
+void ASourceVisibility::RestoreAll()
+{
+	for (const TWeakObjectPtr<AActor>& Weak : CulledActors)
+	{
+		AActor* Actor = Weak.Get();
+		if (!Actor) continue;
+		if (bCulledInGame)
+		{
+			Actor->SetActorHiddenInGame(false);
+		}
+		else
+		{
+#if WITH_EDITOR
+			Actor->SetIsTemporarilyHiddenInEditor(false);
+#endif
+		}
+	}
+	CulledActors.Reset();
+	CurrentCluster = -1;
+	bDirty = true;
+}
+
+void ASourceVisibility::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	RestoreAll();
+	Super::EndPlay(EndPlayReason);
+}
+
+void ASourceVisibility::Destroyed()
+{
+	RestoreAll();
+	Super::Destroyed();
+}
+
+#if WITH_EDITOR
+void ASourceVisibility::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Ticking stops with bCullInEditor, so restore here rather than in Tick
+	if (!bCullInEditor && !bCulledInGame)
+	{
+		RestoreAll();
+	}
+	bDirty = true;
+}
+#endif
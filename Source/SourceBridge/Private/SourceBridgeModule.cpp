@@ -2,6 +2,10 @@
 #include "VMF/VMFExporter.h"
 #include "VMF/VisOptimizer.h"
 #include "Compile/CompilePipeline.h"
+#include "Compile/CompileJob.h"
+#include "Compile/CompileArtifactCache.h"
+#include "Compile/ModelCompileCache.h"
+#include "Compile/CompileScheduler.h"
 #include "Models/SMDExporter.h"
 #include "Models/QCWriter.h"
 #include "Pipeline/FullExportPipeline.h"
@@ -16,8 +20,11 @@
 #include "UI/SourceIOGraphEditor.h"
 #include "UI/SSourceMaterialBrowser.h"
 #include "UI/SourceAssetManager.h"
+#include "UI/SourceCompileOutput.h"
+#include "UI/SourceBridgeSettings.h"
 #include "Runtime/SourceBridgeGameMode.h"
 #include "HAL/PlatformFilemanager.h"
+#include "HAL/FileManager.h"
 #include "Misc/FileHelper.h"
 #include "Engine/World.h"
 #include "Engine/StaticMeshActor.h"
@@ -47,6 +54,7 @@ void FSourceBridgeModule::StartupModule()
 	FSourceIOGraphTab::Register();
 	FSourceMaterialBrowserTab::Register();
 	FSourceAssetManagerTab::Register();
+	FSourceCompileOutputTab::Register();
 
 	ExportTestBoxRoomCommand = MakeShared<FAutoConsoleCommand>(
 		TEXT("SourceBridge.ExportTestBoxRoom"),
@@ -144,16 +152,170 @@ void FSourceBridgeModule::StartupModule()
 				return;
 			}
 
-			FCompileResult Result = FCompilePipeline::CompileMap(Settings);
+			// Runs on a worker thread; output streams to the log and the compile output tab
+			TSharedRef<FCompileJob> Job = FCompileJob::StartMapCompile(Settings);
+			Job->OnFinished.AddLambda([](const FCompileResult& Result)
+			{
+				if (Result.bSuccess)
+				{
+					UE_LOG(LogTemp, Log, TEXT("SourceBridge: Compile succeeded in %.1f seconds."), Result.ElapsedSeconds);
+				}
+				else
+				{
+					UE_LOG(LogTemp, Error, TEXT("SourceBridge: Compile failed: %s"), *Result.ErrorMessage);
+				}
+			});
+		})
+	);
 
-			if (Result.bSuccess)
+	CancelCompileCommand = MakeShared<FAutoConsoleCommand>(
+		TEXT("SourceBridge.CancelCompile"),
+		TEXT("Cancel the running map compile or batch compile (kills the compile tools)."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			TSharedPtr<FCompileBatch> Batch = FCompileBatch::GetLatest();
+			if (Batch.IsValid() && !Batch->IsDone())
 			{
-				UE_LOG(LogTemp, Log, TEXT("SourceBridge: Compile succeeded in %.1f seconds."), Result.ElapsedSeconds);
+				Batch->Cancel();
+				return;
 			}
-			else
+
+			TSharedPtr<FCompileJob> Job = FCompileJob::GetLatest();
+			if (!Job.IsValid() || Job->IsDone())
+			{
+				UE_LOG(LogTemp, Log, TEXT("SourceBridge: No compile is running."));
+				return;
+			}
+			Job->Cancel();
+		})
+	);
+
+	CompileBatchCommand = MakeShared<FAutoConsoleCommand>(
+		TEXT("SourceBridge.CompileBatch"),
+		TEXT("Compile several maps concurrently within the thread budget. Usage: SourceBridge.CompileBatch <vmf_or_dir>[@priority] ... [-game=<name>]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			FString GameName = TEXT("cstrike");
+			TArray<FCompileQueueItem> Queue;
+
+			for (const FString& Arg : Args)
+			{
+				if (Arg.StartsWith(TEXT("-game=")))
+				{
+					GameName = Arg.Mid(6);
+					continue;
+				}
+
+				// "path@priority"; a directory queues every VMF directly inside it
+				FString Path = Arg;
+				int32 Priority = 0;
+				int32 AtIndex;
+				if (Arg.FindLastChar(TEXT('@'), AtIndex))
+				{
+					Path = Arg.Left(AtIndex);
+					Priority = FCString::Atoi(*Arg.Mid(AtIndex + 1));
+				}
+
+				TArray<FString> VMFPaths;
+				if (FPaths::DirectoryExists(Path))
+				{
+					TArray<FString> Found;
+					IFileManager::Get().FindFiles(Found, *(Path / TEXT("*.vmf")), true, false);
+					Found.Sort();
+					for (const FString& File : Found)
+					{
+						VMFPaths.Add(Path / File);
+					}
+				}
+				else
+				{
+					VMFPaths.Add(Path);
+				}
+
+				for (const FString& VMFPath : VMFPaths)
+				{
+					FCompileQueueItem& Item = Queue.AddDefaulted_GetRef();
+					Item.Settings.VMFPath = VMFPath;
+					Item.Priority = Priority;
+				}
+			}
+
+			if (Queue.Num() == 0)
+			{
+				UE_LOG(LogTemp, Error, TEXT("SourceBridge: Usage: SourceBridge.CompileBatch <vmf_or_dir>[@priority] ... [-game=<name>]"));
+				return;
+			}
+
+			USourceBridgeSettings* BridgeSettings = USourceBridgeSettings::Get();
+			FString ToolsDir = FCompilePipeline::FindToolsDirectory();
+			FString GameDir = FCompilePipeline::FindGameDirectory(GameName);
+
+			if (ToolsDir.IsEmpty() || GameDir.IsEmpty())
+			{
+				UE_LOG(LogTemp, Error, TEXT("SourceBridge: Could not auto-detect SDK paths. Install CS:S via Steam."));
+				return;
+			}
+
+			for (FCompileQueueItem& Item : Queue)
+			{
+				Item.Settings.ToolsDir = ToolsDir;
+				Item.Settings.GameDir = GameDir;
+				Item.Settings.bFastCompile = BridgeSettings->bFastCompile;
+				Item.Settings.bCopyToGame = BridgeSettings->bCopyToGame;
+				Item.Settings.bAllowEntityOnlyCompile = BridgeSettings->bEntityOnlyCompile;
+				Item.Settings.bUseArtifactCache = BridgeSettings->bCacheCompileStages;
+			}
+
+			int32 ThreadBudget = BridgeSettings->CompileThreadBudget;
+			int32 MaxConcurrent = BridgeSettings->MaxConcurrentCompiles;
+
+			// Each map runs as a compile job; SourceBridge.CancelCompile cancels the whole batch
+			TSharedRef<FCompileBatch> Batch = FCompileScheduler::StartBatch(Queue, ThreadBudget, MaxConcurrent);
+			Batch->OnFinished.AddLambda([Queue](const FCompileBatchResult& Result)
+			{
+				for (int32 i = 0; i < Result.Results.Num(); ++i)
+				{
+					if (!Result.Results[i].bSuccess)
+					{
+						UE_LOG(LogTemp, Error, TEXT("SourceBridge: Batch: %s failed: %s"),
+							*FPaths::GetBaseFilename(Queue[i].Settings.VMFPath), *Result.Results[i].ErrorMessage);
+					}
+				}
+			});
+		})
+	);
+
+	ClearCompileCacheCommand = MakeShared<FAutoConsoleCommand>(
+		TEXT("SourceBridge.ClearCompileCache"),
+		TEXT("Delete all cached vbsp/vvis/vrad stage outputs."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FCompileArtifactCache::Clear();
+		})
+	);
+
+	ModelCacheCommand = MakeShared<FAutoConsoleCommand>(
+		TEXT("SourceBridge.ModelCache"),
+		TEXT("Show model compile cache size and hit rate. Usage: SourceBridge.ModelCache [trim [budget_mb] | clear]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			if (Args.Num() > 0 && Args[0].Equals(TEXT("clear"), ESearchCase::IgnoreCase))
 			{
-				UE_LOG(LogTemp, Error, TEXT("SourceBridge: Compile failed: %s"), *Result.ErrorMessage);
+				FModelCompileCache::Clear();
+				return;
 			}
+
+			if (Args.Num() > 0 && Args[0].Equals(TEXT("trim"), ESearchCase::IgnoreCase))
+			{
+				int32 BudgetMB = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : USourceBridgeSettings::Get()->ModelCacheBudgetMB;
+				FModelCompileCache::Trim((int64)FMath::Max(BudgetMB, 0) * 1024 * 1024);
+			}
+
+			FModelCacheStats Stats = FModelCompileCache::GetStats();
+			UE_LOG(LogTemp, Log, TEXT("SourceBridge: Model cache: %d models, %.1f / %d MB"),
+				Stats.EntryCount, Stats.TotalBytes / (1024.0 * 1024.0), USourceBridgeSettings::Get()->ModelCacheBudgetMB);
+			UE_LOG(LogTemp, Log, TEXT("SourceBridge: Model cache this session: %d hits, %d misses (%.0f%% hit rate)"),
+				Stats.Hits, Stats.Misses, Stats.GetHitRate() * 100.0f);
 		})
 	);
 
@@ -455,8 +617,8 @@ void FSourceBridgeModule::StartupModule()
 			FVMFImportSettings Settings;
 			FVMFImportResult Result = FBSPImporter::ImportFile(Args[0], World, Settings);
 
-			UE_LOG(LogTemp, Log, TEXT("SourceBridge: BSP import complete. %d brushes, %d entities."),
-				Result.BrushesImported, Result.EntitiesImported);
+			UE_LOG(LogTemp, Log, TEXT("SourceBridge: BSP import complete. %d brushes, %d entities, %d static props."),
+				Result.BrushesImported, Result.EntitiesImported, Result.StaticPropsImported);
 
 			for (const FString& Warning : Result.Warnings)
 			{
@@ -505,6 +667,7 @@ void FSourceBridgeModule::StartupModule()
 
 void FSourceBridgeModule::ShutdownModule()
 {
+	FSourceCompileOutputTab::Unregister();
 	FSourceAssetManagerTab::Unregister();
 	FSourceMaterialBrowserTab::Unregister();
 	FSourceIOGraphTab::Unregister();
@@ -516,6 +679,10 @@ void FSourceBridgeModule::ShutdownModule()
 	ExportTestBoxRoomCommand.Reset();
 	ExportSceneCommand.Reset();
 	CompileMapCommand.Reset();
+	CancelCompileCommand.Reset();
+	CompileBatchCommand.Reset();
+	ClearCompileCacheCommand.Reset();
+	ModelCacheCommand.Reset();
 	ExportModelCommand.Reset();
 	FullExportCommand.Reset();
 	ValidateCommand.Reset();
@@ -72,7 +72,7 @@ void SSourceIOGraphNode::CreateBelowPinControls(TSharedPtr<SVerticalBox> MainBox
 	ConnectionsBox = SNew(SVerticalBox);
 
 	// === Properties section (collapsible) ===
-	if (IONode->bHasFGDData && IONode->ResolvedFGDClass.Properties.Num() > 0)
+	if (IONode->bHasFGDData && IONode->ResolvedFGDClass->Properties.Num() > 0)
 	{
 		MainBox->AddSlot()
 			.AutoHeight()
@@ -153,7 +153,7 @@ void SSourceIOGraphNode::BuildPropertyWidgets()
 		TEXT("origin"), TEXT("angles"), TEXT("targetname"), TEXT("classname")
 	};
 
-	for (const FFGDProperty& Prop : IONode->ResolvedFGDClass.Properties)
+	for (const FFGDProperty& Prop : IONode->ResolvedFGDClass->Properties)
 	{
 		if (SkipKeys.Contains(Prop.Name.ToLower())) continue;
 
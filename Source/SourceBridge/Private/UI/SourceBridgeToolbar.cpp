@@ -3,7 +3,10 @@
 #include "VMF/VMFExporter.h"
 #include "VMF/BrushConverter.h"
 #include "Pipeline/FullExportPipeline.h"
+#include "Compile/CompileScheduler.h"
+#include "Compile/CompileJob.h"
 #include "Validation/ExportValidator.h"
+#include "Validation/LeakDetector.h"
 #include "Import/VMFImporter.h"
 #include "Import/BSPImporter.h"
 #include "Import/MaterialImporter.h"
@@ -24,6 +27,7 @@
 #include "Misc/FileHelper.h"
 #include "Misc/MessageDialog.h"
 #include "Misc/ScopedSlowTask.h"
+#include "Containers/Ticker.h"
 #include "Framework/MultiBox/MultiBoxBuilder.h"
 #include "Framework/Docking/TabManager.h"
 #include "Framework/Notifications/NotificationManager.h"
@@ -117,6 +121,16 @@ void FSourceBridgeToolbar::Register()
 					}))
 				);
 
+				MenuBuilder.AddMenuEntry(
+					LOCTEXT("CompileOutput", "Compile Output"),
+					LOCTEXT("CompileOutputTooltip", "Live vbsp/vvis/vrad output for the running compile, with cancel"),
+					FSlateIcon(),
+					FUIAction(FExecuteAction::CreateLambda([]()
+					{
+						FGlobalTabmanager::Get()->TryInvokeTab(FName(TEXT("SourceCompileOutput")));
+					}))
+				);
+
 				MenuBuilder.AddMenuEntry(
 					LOCTEXT("IOGraph", "I/O Graph"),
 					LOCTEXT("IOGraphTooltip", "Visual node graph for Source entity I/O connections"),
@@ -306,32 +320,125 @@ void FSourceBridgeToolbar::OnFullExport()
 	ExportSettings.bCompile = Settings->bCompileAfterExport;
 	ExportSettings.bFastCompile = Settings->bFastCompile;
 	ExportSettings.bCopyToGame = Settings->bCopyToGame;
+	ExportSettings.bAllowEntityOnlyCompile = Settings->bEntityOnlyCompile;
+	ExportSettings.bUseCompileCache = Settings->bCacheCompileStages;
+	ExportSettings.bCheckLeaks = Settings->bCheckLeaksBeforeCompile;
+	ExportSettings.bCheckLimits = Settings->bCheckLimitsBeforeCompile;
+	ExportSettings.bSkipCompileOverLimits = Settings->bSkipCompileOverLimits;
+	ExportSettings.CompileThreads = FCompileScheduler::GetThreadBudget(Settings->CompileThreadBudget);
+	ExportSettings.ModelCompileJobs = Settings->MaxConcurrentModelCompiles;
+	ExportSettings.bUseModelCache = Settings->bCacheModelCompiles;
+	ExportSettings.ModelCacheBudgetMB = Settings->ModelCacheBudgetMB;
+	ExportSettings.bCompressPakfile = Settings->bCompressPakfile;
 	ExportSettings.bValidate = Settings->bValidateBeforeExport;
 
-	// Progress bar with steps
-	FScopedSlowTask SlowTask(100.0f, LOCTEXT("ExportProgress", "SourceBridge: Exporting..."));
-	SlowTask.MakeDialog(true);
+	if (ExportSettings.bCompile)
+	{
+		FGlobalTabmanager::Get()->TryInvokeTab(FName(TEXT("SourceCompileOutput")));
+	}
 
-	// Run pipeline with progress callback
-	FOnPipelineProgress ProgressCallback;
-	ProgressCallback.BindLambda([&SlowTask](const FString& StepName, float Progress)
+	TWeakObjectPtr<UWorld> WeakWorld = World;
+	FOnFullExportFinished OnFinished;
+	OnFinished.BindLambda([WeakWorld](const FFullExportResult& Result)
 	{
-		float StepAmount = Progress * 100.0f - SlowTask.CompletedWork;
-		if (StepAmount > 0.0f)
+		if (Result.LeakCheck.bChecked && WeakWorld.IsValid())
 		{
-			SlowTask.EnterProgressFrame(StepAmount, FText::FromString(StepName));
+			FLeakDetector::DrawLeakPath(WeakWorld.Get(), Result.LeakCheck);
 		}
+		ShowFullExportResult(Result);
 	});
 
-	FFullExportResult Result = FFullExportPipeline::RunWithProgress(World, ExportSettings, ProgressCallback);
+	TSharedPtr<FCompileJob> CompileJob;
+	{
+		// Progress bar for the export steps; the map compile runs in the background
+		FScopedSlowTask SlowTask(100.0f, LOCTEXT("ExportProgress", "SourceBridge: Exporting..."));
+		SlowTask.MakeDialog(true);
+
+		ExportSettings.ShouldCancel = [&SlowTask]()
+		{
+			return SlowTask.ShouldCancel();
+		};
+
+		FOnPipelineProgress ProgressCallback;
+		ProgressCallback.BindLambda([&SlowTask](const FString& StepName, float Progress)
+		{
+			float StepAmount = Progress * 100.0f - SlowTask.CompletedWork;
+			if (StepAmount > 0.0f)
+			{
+				SlowTask.EnterProgressFrame(StepAmount, FText::FromString(StepName));
+			}
+			else
+			{
+				SlowTask.FrameMessage = FText::FromString(StepName);
+				SlowTask.TickProgress();
+			}
+		});
+
+		CompileJob = FFullExportPipeline::RunAsync(World, ExportSettings, ProgressCallback, OnFinished);
+
+		float Remaining = 100.0f - SlowTask.CompletedWork;
+		if (Remaining > 0.0f)
+		{
+			SlowTask.EnterProgressFrame(Remaining, LOCTEXT("StepDone", "Complete"));
+		}
+	}
+
+	if (!CompileJob.IsValid())
+	{
+		return;
+	}
 
-	// Complete remaining progress
-	float Remaining = 100.0f - SlowTask.CompletedWork;
-	if (Remaining > 0.0f)
+	// Compile progress and cancel in a notification, polled until the job finishes
+	TWeakPtr<FCompileJob> WeakJob = CompileJob;
+	FNotificationInfo Info(LOCTEXT("CompilingNotif", "Compiling map..."));
+	Info.bFireAndForget = false;
+	Info.ButtonDetails.Add(FNotificationButtonInfo(
+		LOCTEXT("CancelCompile", "Cancel"), FText::GetEmpty(),
+		FSimpleDelegate::CreateLambda([WeakJob]()
+		{
+			if (TSharedPtr<FCompileJob> Job = WeakJob.Pin())
+			{
+				Job->Cancel();
+			}
+		}),
+		SNotificationItem::CS_Pending));
+
+	TSharedPtr<SNotificationItem> Notification = FSlateNotificationManager::Get().AddNotification(Info);
+	if (!Notification.IsValid())
 	{
-		SlowTask.EnterProgressFrame(Remaining, LOCTEXT("StepDone", "Complete"));
+		return;
 	}
+	Notification->SetCompletionState(SNotificationItem::CS_Pending);
 
+	TWeakPtr<SNotificationItem> WeakNotification = Notification;
+	FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakJob, WeakNotification](float)
+	{
+		TSharedPtr<SNotificationItem> Item = WeakNotification.Pin();
+		TSharedPtr<FCompileJob> Job = WeakJob.Pin();
+		if (!Item.IsValid())
+		{
+			return false;
+		}
+		if (!Job.IsValid() || Job->IsDone())
+		{
+			// The result itself is shown by OnFinished
+			Item->SetCompletionState(SNotificationItem::CS_None);
+			Item->ExpireAndFadeout();
+			return false;
+		}
+
+		FString Tool = Job->GetCurrentTool();
+		FString Phase = Job->GetCurrentPhase();
+		Item->SetText(FText::FromString(FString::Printf(TEXT("Compiling map: %s%s%s %d%% (%.0fs)"),
+			Tool.IsEmpty() ? TEXT("starting") : *Tool,
+			Phase.IsEmpty() ? TEXT("") : TEXT(" "), *Phase,
+			FMath::RoundToInt(Job->GetProgress() * 100.0f), Job->GetElapsedSeconds())));
+		return true;
+	}), 0.25f);
+}
+
+void FSourceBridgeToolbar::ShowFullExportResult(const FFullExportResult& Result)
+{
 	// Show result notification
 	FNotificationInfo Info(FText::GetEmpty());
 	Info.bFireAndForget = true;
@@ -370,6 +477,20 @@ void FSourceBridgeToolbar::OnFullExport()
 		Msg += FString::Printf(TEXT("\nExport: %.1fs, Compile: %.1fs"),
 			Result.ExportSeconds, Result.CompileSeconds);
 
+		if (Result.ModelCompiles.Num() > 0)
+		{
+			// Slowest studiomdl runs first
+			TArray<FModelCompileTiming> Models = Result.ModelCompiles;
+			Models.Sort([](const FModelCompileTiming& A, const FModelCompileTiming& B) { return A.Seconds > B.Seconds; });
+
+			Msg += FString::Printf(TEXT("\nModels: %d compiled in %.1fs"), Models.Num(), Result.ModelCompileSeconds);
+			for (int32 i = 0; i < FMath::Min(Models.Num(), 5); ++i)
+			{
+				Msg += FString::Printf(TEXT("\n  %s: %.1fs (%d placements)%s"), *Models[i].ModelName,
+					Models[i].Seconds, Models[i].Placements, Models[i].bFromCache ? TEXT(" cached") : (Models[i].bSuccess ? TEXT("") : TEXT(" FAILED")));
+			}
+		}
+
 		if (Result.Warnings.Num() > 0)
 		{
 			Msg += TEXT("\n\nWarnings:");
@@ -551,10 +672,13 @@ void FSourceBridgeToolbar::OnImportBSP()
 	Settings.bImportBrushes = PluginSettings->bImportBrushes;
 	Settings.bImportEntities = PluginSettings->bImportEntities;
 	Settings.bImportMaterials = PluginSettings->bImportMaterials;
+	Settings.bUseCompiledBSPGeometry = PluginSettings->bImportCompiledBSPGeometry;
+	Settings.bImportLightmaps = PluginSettings->bImportBSPLightmaps;
+	Settings.bImportVisibility = PluginSettings->bImportBSPVisibility;
 	FVMFImportResult Result = FBSPImporter::ImportFile(OutFiles[0], World, Settings);
 
-	FString Msg = FString::Printf(TEXT("BSP Import Complete\n\nBrushes: %d\nEntities: %d"),
-		Result.BrushesImported, Result.EntitiesImported);
+	FString Msg = FString::Printf(TEXT("BSP Import Complete\n\nBrushes: %d\nEntities: %d\nStatic props: %d (%d groups)"),
+		Result.BrushesImported, Result.EntitiesImported, Result.StaticPropsImported, Result.StaticPropGroups);
 	if (Result.Warnings.Num() > 0)
 	{
 		Msg += FString::Printf(TEXT("\nWarnings: %d"), Result.Warnings.Num());
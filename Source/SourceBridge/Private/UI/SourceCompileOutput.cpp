@@ -0,0 +1,198 @@
+#include "UI/SourceCompileOutput.h"
+#include "Compile/CompileJob.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Views/STableRow.h"
+#include "WorkspaceMenuStructure.h"
+#include "WorkspaceMenuStructureModule.h"
+#include "Framework/Docking/TabManager.h"
+
+#define LOCTEXT_NAMESPACE "SourceCompileOutput"
+
+const FName FSourceCompileOutputTab::TabId(TEXT("SourceCompileOutput"));
+
+void SSourceCompileOutput::Construct(const FArguments& InArgs)
+{
+	ChildSlot
+	[
+		SNew(SVerticalBox)
+
+		// Status + cancel
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(4)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot()
+			.FillWidth(1.0f)
+			.VAlign(VAlign_Center)
+			.Padding(2)
+			[
+				SNew(STextBlock)
+				.Text(this, &SSourceCompileOutput::GetStatusText)
+				.Font(FCoreStyle::GetDefaultFontStyle("Regular", 9))
+				.AutoWrapText(true)
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(2)
+			[
+				SNew(SButton)
+				.Text(LOCTEXT("Cancel", "Cancel Compile"))
+				.ToolTipText(LOCTEXT("CancelTooltip", "Kill the running compile tool"))
+				.IsEnabled(this, &SSourceCompileOutput::IsCancelEnabled)
+				.OnClicked(this, &SSourceCompileOutput::OnCancelCompile)
+			]
+		]
+
+		// Tool output
+		+ SVerticalBox::Slot()
+		.FillHeight(1.0f)
+		.Padding(4)
+		[
+			SAssignNew(OutputListView, SListView<TSharedPtr<FString>>)
+			.ListItemsSource(&OutputLines)
+			.OnGenerateRow(this, &SSourceCompileOutput::OnGenerateRow)
+			.SelectionMode(ESelectionMode::Multi)
+		]
+	];
+
+	RegisterActiveTimer(0.1f, FWidgetActiveTimerDelegate::CreateSP(this, &SSourceCompileOutput::OnPollJob));
+}
+
+EActiveTimerReturnType SSourceCompileOutput::OnPollJob(double InCurrentTime, float InDeltaTime)
+{
+	TSharedPtr<FCompileJob> Latest = FCompileJob::GetLatest();
+	if (!Latest.IsValid())
+	{
+		return EActiveTimerReturnType::Continue;
+	}
+
+	// A new compile started: clear the window and follow it
+	if (Latest != WatchedJob.Pin())
+	{
+		WatchedJob = Latest;
+		NextLine = 0;
+		StageSummary.Reset();
+		OutputLines.Reset();
+	}
+
+	TArray<FString> NewLines;
+	Latest->GetOutputSince(NextLine, NewLines);
+
+	if (Latest->IsDone() && StageSummary.IsEmpty())
+	{
+		FCompileResult Result = Latest->GetResult();
+		for (const FCompileStageStats& Stage : Result.Stages)
+		{
+			StageSummary += FString::Printf(TEXT("%s%s %.1fs / %.0f MB"),
+				StageSummary.IsEmpty() ? TEXT("") : TEXT(" | "),
+				*Stage.ToolName, Stage.WallSeconds, Stage.PeakMemoryBytes / (1024.0 * 1024.0));
+		}
+		if (StageSummary.IsEmpty())
+		{
+			StageSummary = TEXT("No tools ran");
+		}
+	}
+
+	if (NewLines.Num() > 0)
+	{
+		for (FString& Line : NewLines)
+		{
+			OutputLines.Add(MakeShared<FString>(MoveTemp(Line)));
+		}
+		OutputListView->RequestListRefresh();
+		OutputListView->ScrollToBottom();
+	}
+
+	return EActiveTimerReturnType::Continue;
+}
+
+FReply SSourceCompileOutput::OnCancelCompile()
+{
+	if (TSharedPtr<FCompileJob> Job = WatchedJob.Pin())
+	{
+		Job->Cancel();
+	}
+	return FReply::Handled();
+}
+
+bool SSourceCompileOutput::IsCancelEnabled() const
+{
+	TSharedPtr<FCompileJob> Job = WatchedJob.Pin();
+	return Job.IsValid() && !Job->IsDone() && !Job->IsCancelRequested();
+}
+
+FText SSourceCompileOutput::GetStatusText() const
+{
+	TSharedPtr<FCompileJob> Job = WatchedJob.Pin();
+	if (!Job.IsValid())
+	{
+		return LOCTEXT("NoCompile", "No compile has run this session.");
+	}
+
+	if (!Job->IsDone())
+	{
+		FString Tool = Job->GetCurrentTool();
+		FString Phase = Job->GetCurrentPhase();
+		if (!Phase.IsEmpty())
+		{
+			Tool += TEXT(" ") + Phase;
+		}
+		return FText::Format(LOCTEXT("Running", "{0} {1} - {2}% ({3}s)"),
+			Job->IsCancelRequested() ? LOCTEXT("Cancelling", "Cancelling") : LOCTEXT("Compiling", "Compiling"),
+			FText::FromString(Tool.IsEmpty() ? TEXT("...") : Tool),
+			FText::AsNumber(FMath::RoundToInt(Job->GetProgress() * 100.0f)),
+			FText::AsNumber(FMath::FloorToInt(Job->GetElapsedSeconds())));
+	}
+
+	FCompileResult Result = Job->GetResult();
+	FText Outcome = Result.bSuccess ? LOCTEXT("Succeeded", "Compile succeeded")
+		: (Result.bCancelled ? LOCTEXT("Cancelled", "Compile cancelled") : LOCTEXT("Failed", "Compile failed"));
+	return FText::Format(LOCTEXT("Finished", "{0} in {1}s: {2}"),
+		Outcome,
+		FText::AsNumber(FMath::RoundToInt(Job->GetElapsedSeconds())),
+		FText::FromString(StageSummary));
+}
+
+TSharedRef<ITableRow> SSourceCompileOutput::OnGenerateRow(
+	TSharedPtr<FString> Item,
+	const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(STableRow<TSharedPtr<FString>>, OwnerTable)
+		[
+			SNew(STextBlock)
+			.Text(FText::FromString(*Item))
+			.Font(FCoreStyle::GetDefaultFontStyle("Mono", 8))
+		];
+}
+
+// --- Tab Registration ---
+
+void FSourceCompileOutputTab::Register()
+{
+	FGlobalTabmanager::Get()->RegisterNomadTabSpawner(
+		TabId,
+		FOnSpawnTab::CreateStatic(&FSourceCompileOutputTab::SpawnTab))
+		.SetDisplayName(LOCTEXT("CompileTabTitle", "Source Compile Output"))
+		.SetTooltipText(LOCTEXT("CompileTabTooltip", "Live vbsp/vvis/vrad output with cancel"))
+		.SetGroup(WorkspaceMenu::GetMenuStructure().GetLevelEditorCategory())
+		.SetIcon(FSlateIcon(FAppStyle::GetAppStyleSetName(), "LevelEditor.GameSettings"));
+}
+
+void FSourceCompileOutputTab::Unregister()
+{
+	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(TabId);
+}
+
+TSharedRef<SDockTab> FSourceCompileOutputTab::SpawnTab(const FSpawnTabArgs& Args)
+{
+	return SNew(SDockTab)
+		.TabRole(ETabRole::NomadTab)
+		.Label(LOCTEXT("CompileTabLabel", "Compile Output"))
+		[
+			SNew(SSourceCompileOutput)
+		];
+}
+
+#undef LOCTEXT_NAMESPACE
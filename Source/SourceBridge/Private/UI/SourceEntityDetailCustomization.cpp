@@ -87,7 +87,7 @@ void FSourceEntityDetailCustomization::CustomizeDetails(IDetailLayoutBuilder& De
 				}
 
 				// Show keyvalue count
-				FFGDEntityClass Resolved = FGD.GetResolved(SourceActor->SourceClassname);
+				TSharedPtr<const FFGDEntityClass> Resolved = FGD.FindResolved(SourceActor->SourceClassname);
 				SourceCategory.AddCustomRow(LOCTEXT("FGDInfo", "FGD Info"))
 					.NameContent()
 					[
@@ -100,14 +100,14 @@ void FSourceEntityDetailCustomization::CustomizeDetails(IDetailLayoutBuilder& De
 						SNew(STextBlock)
 						.Text(FText::Format(
 							LOCTEXT("FGDInfoValue", "{0} keyvalues, {1} inputs, {2} outputs"),
-							FText::AsNumber(Resolved.Properties.Num()),
-							FText::AsNumber(Resolved.Inputs.Num()),
-							FText::AsNumber(Resolved.Outputs.Num())))
+							FText::AsNumber(Resolved->Properties.Num()),
+							FText::AsNumber(Resolved->Inputs.Num()),
+							FText::AsNumber(Resolved->Outputs.Num())))
 						.Font(IDetailLayoutBuilder::GetDetailFont())
 					];
 
 				// Build dynamic property widgets from FGD
-				BuildFGDPropertyWidgets(DetailBuilder, SourceActor, Resolved);
+				BuildFGDPropertyWidgets(DetailBuilder, SourceActor, *Resolved);
 			}
 			else
 			{
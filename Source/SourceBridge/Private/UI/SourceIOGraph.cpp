@@ -25,12 +25,8 @@ void USourceIOGraphNode::InitFromActor(ASourceEntityActor* Actor)
 	const FFGDDatabase& FGD = FSourceBridgeModule::GetFGDDatabase();
 	if (FGD.Classes.Num() > 0)
 	{
-		const FFGDEntityClass* FGDClass = FGD.FindClass(CachedClassname);
-		if (FGDClass)
-		{
-			ResolvedFGDClass = FGD.GetResolved(CachedClassname);
-			bHasFGDData = true;
-		}
+		ResolvedFGDClass = FGD.FindResolved(CachedClassname);
+		bHasFGDData = ResolvedFGDClass.IsValid();
 	}
 }
 
@@ -48,7 +44,7 @@ void USourceIOGraphNode::AllocateDefaultPins()
 	if (bHasFGDData)
 	{
 		// Create output pins from FGD outputs
-		for (const FFGDIODef& Output : ResolvedFGDClass.Outputs)
+		for (const FFGDIODef& Output : ResolvedFGDClass->Outputs)
 		{
 			UEdGraphPin* Pin = CreatePin(EGPD_Output, TEXT("SourceIO"), FName(*Output.Name));
 			if (Pin)
@@ -60,7 +56,7 @@ void USourceIOGraphNode::AllocateDefaultPins()
 		}
 
 		// Create input pins from FGD inputs
-		for (const FFGDIODef& Input : ResolvedFGDClass.Inputs)
+		for (const FFGDIODef& Input : ResolvedFGDClass->Inputs)
 		{
 			UEdGraphPin* Pin = CreatePin(EGPD_Input, TEXT("SourceIO"), FName(*Input.Name));
 			if (Pin)
@@ -384,8 +380,8 @@ void USourceIOGraphSchema::GetGraphContextActions(FGraphContextMenuBuilder& Cont
 			if (FGDClass->Inputs.Num() == 0 && FGDClass->Outputs.Num() == 0)
 			{
 				// Check resolved (inherits from base with I/O)
-				FFGDEntityClass Resolved = FGD.GetResolved(Name);
-				if (Resolved.Inputs.Num() == 0 && Resolved.Outputs.Num() == 0) continue;
+				TSharedPtr<const FFGDEntityClass> Resolved = FGD.FindResolved(Name);
+				if (!Resolved.IsValid() || (Resolved->Inputs.Num() == 0 && Resolved->Outputs.Num() == 0)) continue;
 			}
 
 			FString Category;
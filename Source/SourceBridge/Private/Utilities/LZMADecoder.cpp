@@ -0,0 +1,443 @@
+#include "Utilities/LZMADecoder.h"
+
+// Valve's lzma_header_t: id, actualSize, lzmaSize, properties[5]
+static const uint32 VALVE_LZMA_ID = (('A' << 24) | ('M' << 16) | ('Z' << 8) | 'L');
+static const int32 VALVE_LZMA_HEADER_SIZE = 17;
+
+namespace
+{
+	typedef uint16 FProb;
+
+	constexpr int32 NumBitModelTotalBits = 11;
+	constexpr uint32 BitModelTotal = 1u << NumBitModelTotalBits;
+	constexpr int32 NumMoveBits = 5;
+	constexpr uint32 TopValue = 1u << 24;
+	constexpr FProb ProbInitValue = BitModelTotal / 2;
+
+	constexpr int32 NumStates = 12;
+	constexpr int32 NumPosBitsMax = 4;
+	constexpr int32 NumLenToPosStates = 4;
+	constexpr int32 NumAlignBits = 4;
+	constexpr int32 StartPosModelIndex = 4;
+	constexpr int32 EndPosModelIndex = 14;
+	constexpr int32 NumFullDistances = 1 << (EndPosModelIndex >> 1);
+	constexpr int32 MatchMinLen = 2;
+
+	void InitProbs(FProb* Probs, int32 Num)
+	{
+		for (int32 i = 0; i < Num; ++i)
+		{
+			Probs[i] = ProbInitValue;
+		}
+	}
+
+	struct FRangeDecoder
+	{
+		const uint8* Src = nullptr;
+		const uint8* SrcEnd = nullptr;
+		uint32 Range = 0xFFFFFFFF;
+		uint32 Code = 0;
+		bool bCorrupted = false;
+
+		uint8 ReadByte()
+		{
+			if (Src >= SrcEnd)
+			{
+				bCorrupted = true;
+				return 0;
+			}
+			return *Src++;
+		}
+
+		bool Init(const uint8* InSrc, int64 Size)
+		{
+			Src = InSrc;
+			SrcEnd = InSrc + Size;
+			Range = 0xFFFFFFFF;
+			Code = 0;
+
+			uint8 First = ReadByte();
+			for (int32 i = 0; i < 4; ++i)
+			{
+				Code = (Code << 8) | ReadByte();
+			}
+			return First == 0 && Code != Range && !bCorrupted;
+		}
+
+		void Normalize()
+		{
+			if (Range < TopValue)
+			{
+				Range <<= 8;
+				Code = (Code << 8) | ReadByte();
+			}
+		}
+
+		uint32 DecodeDirectBits(int32 NumBits)
+		{
+			uint32 Result = 0;
+			do
+			{
+				Range >>= 1;
+				Code -= Range;
+				uint32 T = 0 - (Code >> 31);
+				Code += Range & T;
+				if (Code == Range)
+				{
+					bCorrupted = true;
+				}
+				Normalize();
+				Result = (Result << 1) + (T + 1);
+			}
+			while (--NumBits);
+			return Result;
+		}
+
+		uint32 DecodeBit(FProb* Prob)
+		{
+			uint32 V = *Prob;
+			uint32 Bound = (Range >> NumBitModelTotalBits) * V;
+			uint32 Symbol;
+			if (Code < Bound)
+			{
+				V += (BitModelTotal - V) >> NumMoveBits;
+				Range = Bound;
+				Symbol = 0;
+			}
+			else
+			{
+				V -= V >> NumMoveBits;
+				Code -= Bound;
+				Range -= Bound;
+				Symbol = 1;
+			}
+			*Prob = (FProb)V;
+			Normalize();
+			return Symbol;
+		}
+
+		uint32 DecodeBitTree(FProb* Probs, int32 NumBits)
+		{
+			uint32 M = 1;
+			for (int32 i = 0; i < NumBits; ++i)
+			{
+				M = (M << 1) + DecodeBit(&Probs[M]);
+			}
+			return M - (1u << NumBits);
+		}
+
+		uint32 DecodeReverseBitTree(FProb* Probs, int32 NumBits)
+		{
+			uint32 M = 1;
+			uint32 Symbol = 0;
+			for (int32 i = 0; i < NumBits; ++i)
+			{
+				uint32 Bit = DecodeBit(&Probs[M]);
+				M = (M << 1) + Bit;
+				Symbol |= Bit << i;
+			}
+			return Symbol;
+		}
+	};
+
+	struct FLenDecoder
+	{
+		FProb Choice;
+		FProb Choice2;
+		FProb Low[1 << NumPosBitsMax][1 << 3];
+		FProb Mid[1 << NumPosBitsMax][1 << 3];
+		FProb High[1 << 8];
+
+		void Init()
+		{
+			Choice = ProbInitValue;
+			Choice2 = ProbInitValue;
+			InitProbs(&Low[0][0], sizeof(Low) / sizeof(FProb));
+			InitProbs(&Mid[0][0], sizeof(Mid) / sizeof(FProb));
+			InitProbs(High, sizeof(High) / sizeof(FProb));
+		}
+
+		uint32 Decode(FRangeDecoder& Rc, uint32 PosState)
+		{
+			if (Rc.DecodeBit(&Choice) == 0)
+			{
+				return Rc.DecodeBitTree(Low[PosState], 3);
+			}
+			if (Rc.DecodeBit(&Choice2) == 0)
+			{
+				return 8 + Rc.DecodeBitTree(Mid[PosState], 3);
+			}
+			return 16 + Rc.DecodeBitTree(High, 8);
+		}
+	};
+
+	/** All adaptive probabilities of one stream (about 28 KB plus literals). */
+	struct FLZMAState
+	{
+		FProb IsMatch[NumStates << NumPosBitsMax];
+		FProb IsRep[NumStates];
+		FProb IsRepG0[NumStates];
+		FProb IsRepG1[NumStates];
+		FProb IsRepG2[NumStates];
+		FProb IsRep0Long[NumStates << NumPosBitsMax];
+		FProb PosSlot[NumLenToPosStates][1 << 6];
+		FProb PosDecoders[1 + NumFullDistances - EndPosModelIndex];
+		FProb Align[1 << NumAlignBits];
+		FLenDecoder LenDecoder;
+		FLenDecoder RepLenDecoder;
+
+		void Init()
+		{
+			InitProbs(IsMatch, UE_ARRAY_COUNT(IsMatch));
+			InitProbs(IsRep, NumStates);
+			InitProbs(IsRepG0, NumStates);
+			InitProbs(IsRepG1, NumStates);
+			InitProbs(IsRepG2, NumStates);
+			InitProbs(IsRep0Long, UE_ARRAY_COUNT(IsRep0Long));
+			InitProbs(&PosSlot[0][0], sizeof(PosSlot) / sizeof(FProb));
+			InitProbs(PosDecoders, UE_ARRAY_COUNT(PosDecoders));
+			InitProbs(Align, UE_ARRAY_COUNT(Align));
+			LenDecoder.Init();
+			RepLenDecoder.Init();
+		}
+
+		uint32 DecodeDistance(FRangeDecoder& Rc, uint32 Len)
+		{
+			uint32 LenState = FMath::Min<uint32>(Len, NumLenToPosStates - 1);
+			uint32 Slot = Rc.DecodeBitTree(PosSlot[LenState], 6);
+			if (Slot < (uint32)StartPosModelIndex)
+			{
+				return Slot;
+			}
+
+			int32 NumDirectBits = (int32)((Slot >> 1) - 1);
+			uint32 Dist = (2 | (Slot & 1)) << NumDirectBits;
+			if (Slot < (uint32)EndPosModelIndex)
+			{
+				Dist += Rc.DecodeReverseBitTree(PosDecoders + Dist - Slot, NumDirectBits);
+			}
+			else
+			{
+				Dist += Rc.DecodeDirectBits(NumDirectBits - NumAlignBits) << NumAlignBits;
+				Dist += Rc.DecodeReverseBitTree(Align, NumAlignBits);
+			}
+			return Dist;
+		}
+	};
+
+	uint32 ReadLE32(const uint8* Data)
+	{
+		return (uint32)Data[0] | ((uint32)Data[1] << 8) | ((uint32)Data[2] << 16) | ((uint32)Data[3] << 24);
+	}
+}
+
+bool FLZMADecoder::Decompress(const uint8* Properties, const uint8* Src, int64 SrcSize, uint8* Dst, int64 OutSize)
+{
+	uint32 D = Properties[0];
+	if (D >= 9 * 5 * 5)
+	{
+		return false;
+	}
+	const uint32 Lc = D % 9;
+	D /= 9;
+	const uint32 Lp = D % 5;
+	const uint32 Pb = D / 5;
+
+	TArray<FProb> LiteralProbs;
+	LiteralProbs.SetNumUninitialized(0x300 << (Lc + Lp));
+	InitProbs(LiteralProbs.GetData(), LiteralProbs.Num());
+
+	TUniquePtr<FLZMAState> State = MakeUnique<FLZMAState>();
+	State->Init();
+
+	FRangeDecoder Rc;
+	if (!Rc.Init(Src, SrcSize))
+	{
+		return false;
+	}
+
+	const uint32 PbMask = (1u << Pb) - 1;
+	const uint32 LpMask = (1u << Lp) - 1;
+
+	int64 Pos = 0;
+	uint32 St = 0;
+	uint32 Rep0 = 0, Rep1 = 0, Rep2 = 0, Rep3 = 0;
+
+	while (Pos < OutSize)
+	{
+		if (Rc.bCorrupted)
+		{
+			return false;
+		}
+
+		uint32 PosState = (uint32)Pos & PbMask;
+
+		if (Rc.DecodeBit(&State->IsMatch[(St << NumPosBitsMax) + PosState]) == 0)
+		{
+			// Literal, matched against the byte at rep0 after a match
+			uint32 PrevByte = Pos > 0 ? Dst[Pos - 1] : 0;
+			uint32 LitState = (((uint32)Pos & LpMask) << Lc) + (PrevByte >> (8 - Lc));
+			FProb* Probs = &LiteralProbs[0x300 * LitState];
+
+			uint32 Symbol = 1;
+			if (St >= 7)
+			{
+				if ((int64)Rep0 >= Pos)
+				{
+					return false;
+				}
+				uint32 MatchByte = Dst[Pos - Rep0 - 1];
+				do
+				{
+					uint32 MatchBit = (MatchByte >> 7) & 1;
+					MatchByte <<= 1;
+					uint32 Bit = Rc.DecodeBit(&Probs[((1 + MatchBit) << 8) + Symbol]);
+					Symbol = (Symbol << 1) | Bit;
+					if (MatchBit != Bit)
+					{
+						break;
+					}
+				}
+				while (Symbol < 0x100);
+			}
+			while (Symbol < 0x100)
+			{
+				Symbol = (Symbol << 1) | Rc.DecodeBit(&Probs[Symbol]);
+			}
+
+			Dst[Pos++] = (uint8)(Symbol - 0x100);
+			St = St < 4 ? 0 : (St < 10 ? St - 3 : St - 6);
+			continue;
+		}
+
+		uint32 Len;
+		if (Rc.DecodeBit(&State->IsRep[St]) != 0)
+		{
+			if (Pos == 0)
+			{
+				return false;
+			}
+
+			if (Rc.DecodeBit(&State->IsRepG0[St]) == 0)
+			{
+				if (Rc.DecodeBit(&State->IsRep0Long[(St << NumPosBitsMax) + PosState]) == 0)
+				{
+					// Short rep: one byte from rep0
+					St = St < 7 ? 9 : 11;
+					Dst[Pos] = Dst[Pos - Rep0 - 1];
+					Pos++;
+					continue;
+				}
+			}
+			else
+			{
+				uint32 Dist;
+				if (Rc.DecodeBit(&State->IsRepG1[St]) == 0)
+				{
+					Dist = Rep1;
+				}
+				else
+				{
+					if (Rc.DecodeBit(&State->IsRepG2[St]) == 0)
+					{
+						Dist = Rep2;
+					}
+					else
+					{
+						Dist = Rep3;
+						Rep3 = Rep2;
+					}
+					Rep2 = Rep1;
+				}
+				Rep1 = Rep0;
+				Rep0 = Dist;
+			}
+
+			Len = State->RepLenDecoder.Decode(Rc, PosState);
+			St = St < 7 ? 8 : 11;
+		}
+		else
+		{
+			Rep3 = Rep2;
+			Rep2 = Rep1;
+			Rep1 = Rep0;
+			Len = State->LenDecoder.Decode(Rc, PosState);
+			St = St < 7 ? 7 : 10;
+			Rep0 = State->DecodeDistance(Rc, Len);
+
+			if (Rep0 == 0xFFFFFFFF)
+			{
+				// End marker before the expected size
+				return false;
+			}
+		}
+
+		Len += MatchMinLen;
+		if ((int64)Rep0 >= Pos)
+		{
+			return false;
+		}
+
+		int64 CopyLen = FMath::Min<int64>(Len, OutSize - Pos);
+		const uint8* From = Dst + Pos - Rep0 - 1;
+		for (int64 i = 0; i < CopyLen; ++i)
+		{
+			// Byte by byte: the source may overlap what is being written
+			Dst[Pos + i] = From[i];
+		}
+		Pos += CopyLen;
+	}
+
+	return !Rc.bCorrupted;
+}
+
+bool FLZMADecoder::HasValveHeader(const uint8* Data, int64 Size)
+{
+	return Size >= VALVE_LZMA_HEADER_SIZE && ReadLE32(Data) == VALVE_LZMA_ID;
+}
+
+bool FLZMADecoder::DecompressValve(const uint8* Data, int64 Size, TArray<uint8>& Out)
+{
+	if (!HasValveHeader(Data, Size))
+	{
+		return false;
+	}
+
+	uint32 ActualSize = ReadLE32(Data + 4);
+	uint32 LZMASize = ReadLE32(Data + 8);
+	const uint8* Properties = Data + 12;
+	if ((int64)LZMASize > Size - VALVE_LZMA_HEADER_SIZE || ActualSize > (uint32)MAX_int32)
+	{
+		return false;
+	}
+
+	Out.SetNumUninitialized(ActualSize);
+	if (!Decompress(Properties, Data + VALVE_LZMA_HEADER_SIZE, LZMASize, Out.GetData(), ActualSize))
+	{
+		Out.Reset();
+		return false;
+	}
+	return true;
+}
+
+bool FLZMADecoder::DecompressZipEntry(const uint8* Data, int64 Size, int64 UncompressedSize, TArray<uint8>& Out)
+{
+	if (Size < 4 || UncompressedSize < 0 || UncompressedSize > MAX_int32)
+	{
+		return false;
+	}
+
+	int32 PropsSize = Data[2] | (Data[3] << 8);
+	if (PropsSize != PropertiesSize || Size < 4 + PropsSize)
+	{
+		return false;
+	}
+
+	Out.SetNumUninitialized((int32)UncompressedSize);
+	if (!Decompress(Data + 4, Data + 4 + PropsSize, Size - 4 - PropsSize, Out.GetData(), UncompressedSize))
+	{
+		Out.Reset();
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,394 @@
+#include "Utilities/LZMAEncoder.h"
+
+namespace
+{
+	typedef uint16 FProb;
+
+	constexpr int32 NumBitModelTotalBits = 11;
+	constexpr uint32 BitModelTotal = 1u << NumBitModelTotalBits;
+	constexpr int32 NumMoveBits = 5;
+	constexpr uint32 TopValue = 1u << 24;
+	constexpr FProb ProbInitValue = BitModelTotal / 2;
+
+	constexpr int32 NumStates = 12;
+	constexpr int32 NumPosBitsMax = 4;
+	constexpr int32 NumLenToPosStates = 4;
+	constexpr int32 NumAlignBits = 4;
+	constexpr int32 EndPosModelIndex = 14;
+	constexpr int32 NumFullDistances = 1 << (EndPosModelIndex >> 1);
+	constexpr int32 MatchMinLen = 2;
+	constexpr int32 MatchMaxLen = 273;
+
+	// lc=3, lp=0, pb=2: the LZMA default
+	constexpr uint32 Lc = 3;
+	constexpr uint32 Lp = 0;
+	constexpr uint32 Pb = 2;
+
+	// Match finder
+	constexpr int32 HashBits = 16;
+	constexpr int32 MaxChainLength = 48;
+	constexpr int32 MinEncodedMatch = 3;
+
+	void InitProbs(FProb* Probs, int32 Num)
+	{
+		for (int32 i = 0; i < Num; ++i)
+		{
+			Probs[i] = ProbInitValue;
+		}
+	}
+
+	struct FRangeEncoder
+	{
+		TArray<uint8>& Out;
+		uint64 Low = 0;
+		uint32 Range = 0xFFFFFFFF;
+		uint8 Cache = 0;
+		int64 CacheSize = 1;
+
+		explicit FRangeEncoder(TArray<uint8>& InOut) : Out(InOut) {}
+
+		void ShiftLow()
+		{
+			if ((uint32)Low < 0xFF000000u || (uint32)(Low >> 32) != 0)
+			{
+				uint8 Temp = Cache;
+				do
+				{
+					Out.Add((uint8)(Temp + (uint8)(Low >> 32)));
+					Temp = 0xFF;
+				}
+				while (--CacheSize != 0);
+				Cache = (uint8)((uint32)Low >> 24);
+			}
+			CacheSize++;
+			Low = (uint64)((uint32)Low << 8);
+		}
+
+		void EncodeBit(FProb* Prob, uint32 Bit)
+		{
+			uint32 V = *Prob;
+			uint32 Bound = (Range >> NumBitModelTotalBits) * V;
+			if (Bit == 0)
+			{
+				Range = Bound;
+				V += (BitModelTotal - V) >> NumMoveBits;
+			}
+			else
+			{
+				Low += Bound;
+				Range -= Bound;
+				V -= V >> NumMoveBits;
+			}
+			*Prob = (FProb)V;
+			while (Range < TopValue)
+			{
+				Range <<= 8;
+				ShiftLow();
+			}
+		}
+
+		void EncodeDirectBits(uint32 Value, int32 NumBits)
+		{
+			do
+			{
+				Range >>= 1;
+				Low += Range & (0 - ((Value >> --NumBits) & 1));
+				while (Range < TopValue)
+				{
+					Range <<= 8;
+					ShiftLow();
+				}
+			}
+			while (NumBits);
+		}
+
+		void EncodeBitTree(FProb* Probs, int32 NumBits, uint32 Symbol)
+		{
+			uint32 M = 1;
+			for (int32 i = NumBits - 1; i >= 0; --i)
+			{
+				uint32 Bit = (Symbol >> i) & 1;
+				EncodeBit(&Probs[M], Bit);
+				M = (M << 1) | Bit;
+			}
+		}
+
+		void EncodeReverseBitTree(FProb* Probs, int32 NumBits, uint32 Symbol)
+		{
+			uint32 M = 1;
+			for (int32 i = 0; i < NumBits; ++i)
+			{
+				uint32 Bit = Symbol & 1;
+				Symbol >>= 1;
+				EncodeBit(&Probs[M], Bit);
+				M = (M << 1) | Bit;
+			}
+		}
+
+		void Flush()
+		{
+			for (int32 i = 0; i < 5; ++i)
+			{
+				ShiftLow();
+			}
+		}
+	};
+
+	struct FLenEncoder
+	{
+		FProb Choice;
+		FProb Choice2;
+		FProb Low[1 << NumPosBitsMax][1 << 3];
+		FProb Mid[1 << NumPosBitsMax][1 << 3];
+		FProb High[1 << 8];
+
+		void Init()
+		{
+			Choice = ProbInitValue;
+			Choice2 = ProbInitValue;
+			InitProbs(&Low[0][0], sizeof(Low) / sizeof(FProb));
+			InitProbs(&Mid[0][0], sizeof(Mid) / sizeof(FProb));
+			InitProbs(High, sizeof(High) / sizeof(FProb));
+		}
+
+		/** Len is the match length minus MatchMinLen. */
+		void Encode(FRangeEncoder& Rc, uint32 Len, uint32 PosState)
+		{
+			if (Len < 8)
+			{
+				Rc.EncodeBit(&Choice, 0);
+				Rc.EncodeBitTree(Low[PosState], 3, Len);
+			}
+			else if (Len < 16)
+			{
+				Rc.EncodeBit(&Choice, 1);
+				Rc.EncodeBit(&Choice2, 0);
+				Rc.EncodeBitTree(Mid[PosState], 3, Len - 8);
+			}
+			else
+			{
+				Rc.EncodeBit(&Choice, 1);
+				Rc.EncodeBit(&Choice2, 1);
+				Rc.EncodeBitTree(High, 8, Len - 16);
+			}
+		}
+	};
+
+	/** The same adaptive models as the decoder, updated in the same order. */
+	struct FEncoderState
+	{
+		FProb IsMatch[NumStates << NumPosBitsMax];
+		FProb IsRep[NumStates];
+		FProb PosSlot[NumLenToPosStates][1 << 6];
+		FProb PosEncoders[1 + NumFullDistances - EndPosModelIndex];
+		FProb Align[1 << NumAlignBits];
+		FLenEncoder LenEncoder;
+
+		void Init()
+		{
+			InitProbs(IsMatch, UE_ARRAY_COUNT(IsMatch));
+			InitProbs(IsRep, NumStates);
+			InitProbs(&PosSlot[0][0], sizeof(PosSlot) / sizeof(FProb));
+			InitProbs(PosEncoders, UE_ARRAY_COUNT(PosEncoders));
+			InitProbs(Align, UE_ARRAY_COUNT(Align));
+			LenEncoder.Init();
+		}
+
+		void EncodeDistance(FRangeEncoder& Rc, uint32 Dist, uint32 Len)
+		{
+			uint32 LenState = FMath::Min<uint32>(Len, NumLenToPosStates - 1);
+
+			uint32 Slot;
+			if (Dist < 4)
+			{
+				Slot = Dist;
+			}
+			else
+			{
+				uint32 HighBit = FMath::FloorLog2(Dist);
+				Slot = (HighBit << 1) | ((Dist >> (HighBit - 1)) & 1);
+			}
+			Rc.EncodeBitTree(PosSlot[LenState], 6, Slot);
+
+			if (Slot >= 4)
+			{
+				int32 NumDirectBits = (int32)((Slot >> 1) - 1);
+				uint32 Base = (2 | (Slot & 1)) << NumDirectBits;
+				uint32 Reduced = Dist - Base;
+				if (Slot < (uint32)EndPosModelIndex)
+				{
+					Rc.EncodeReverseBitTree(PosEncoders + Base - Slot, NumDirectBits, Reduced);
+				}
+				else
+				{
+					Rc.EncodeDirectBits(Reduced >> NumAlignBits, NumDirectBits - NumAlignBits);
+					Rc.EncodeReverseBitTree(Align, NumAlignBits, Reduced & ((1 << NumAlignBits) - 1));
+				}
+			}
+		}
+	};
+
+	uint32 Hash3(const uint8* P)
+	{
+		return ((P[0] << 16) ^ (P[1] << 8) ^ P[2]) * 2654435761u >> (32 - HashBits);
+	}
+}
+
+void FLZMAEncoder::Compress(const uint8* Src, int64 Size, TArray<uint8>& OutStream, uint8 OutProperties[5])
+{
+	// Dictionary: the whole input, rounded up to a power of two (4 KB to 16 MB)
+	uint32 DictSize = (uint32)FMath::Clamp<int64>(FMath::RoundUpToPowerOfTwo64(FMath::Max<int64>(Size, 1)), 1 << 12, 1 << 24);
+
+	OutProperties[0] = (uint8)((Pb * 5 + Lp) * 9 + Lc);
+	for (int32 i = 0; i < 4; ++i)
+	{
+		OutProperties[1 + i] = (uint8)(DictSize >> (8 * i));
+	}
+
+	OutStream.Reset();
+	OutStream.Reserve(Size / 2 + 64);
+
+	TArray<FProb> LiteralProbs;
+	LiteralProbs.SetNumUninitialized(0x300 << (Lc + Lp));
+	InitProbs(LiteralProbs.GetData(), LiteralProbs.Num());
+
+	TUniquePtr<FEncoderState> State = MakeUnique<FEncoderState>();
+	State->Init();
+
+	// Hash chains over 3-byte prefixes, restricted to the dictionary window
+	TArray<int32> Head;
+	Head.Init(-1, 1 << HashBits);
+	TArray<int32> Prev;
+	Prev.SetNumUninitialized((int32)FMath::Min<int64>(Size, DictSize));
+
+	auto Insert = [&](int64 Pos)
+	{
+		if (Pos + 3 <= Size)
+		{
+			uint32 H = Hash3(Src + Pos);
+			Prev[Pos % Prev.Num()] = Head[H];
+			Head[H] = (int32)Pos;
+		}
+	};
+
+	FRangeEncoder Rc(OutStream);
+	const uint32 PbMask = (1u << Pb) - 1;
+	uint32 St = 0;
+	uint32 Rep0 = 0;
+
+	int64 Pos = 0;
+	while (Pos < Size)
+	{
+		// Longest match within the window
+		int32 BestLen = 0;
+		uint32 BestDist = 0;
+		if (Pos + MinEncodedMatch <= Size)
+		{
+			int32 MaxLen = (int32)FMath::Min<int64>(MatchMaxLen, Size - Pos);
+			int32 Candidate = Head[Hash3(Src + Pos)];
+			for (int32 Chain = 0; Chain < MaxChainLength && Candidate >= 0; ++Chain)
+			{
+				int64 Dist = Pos - Candidate;
+				if (Dist <= 0 || Dist > (int64)DictSize || Dist > Prev.Num())
+				{
+					break;
+				}
+
+				const uint8* A = Src + Candidate;
+				const uint8* B = Src + Pos;
+				if (A[BestLen] == B[BestLen])
+				{
+					int32 Len = 0;
+					while (Len < MaxLen && A[Len] == B[Len])
+					{
+						Len++;
+					}
+					if (Len > BestLen)
+					{
+						BestLen = Len;
+						BestDist = (uint32)(Dist - 1);
+						if (Len == MaxLen)
+						{
+							break;
+						}
+					}
+				}
+				Candidate = Prev[Candidate % Prev.Num()];
+			}
+
+			// Short matches far away cost more than their literals
+			if (BestLen < MinEncodedMatch || (BestLen == MinEncodedMatch && BestDist >= (1u << 14)))
+			{
+				BestLen = 0;
+			}
+		}
+
+		uint32 PosState = (uint32)Pos & PbMask;
+
+		if (BestLen == 0)
+		{
+			Rc.EncodeBit(&State->IsMatch[(St << NumPosBitsMax) + PosState], 0);
+
+			uint32 PrevByte = Pos > 0 ? Src[Pos - 1] : 0;
+			uint32 LitState = (((uint32)Pos & ((1u << Lp) - 1)) << Lc) + (PrevByte >> (8 - Lc));
+			FProb* Probs = &LiteralProbs[0x300 * LitState];
+			uint32 Byte = Src[Pos];
+
+			// After a match, code against the byte the last distance points at
+			bool bMatched = St >= 7;
+			uint32 MatchByte = bMatched ? Src[Pos - Rep0 - 1] : 0;
+			uint32 Symbol = 1;
+			for (int32 i = 7; i >= 0; --i)
+			{
+				uint32 Bit = (Byte >> i) & 1;
+				if (bMatched)
+				{
+					uint32 MatchBit = (MatchByte >> i) & 1;
+					Rc.EncodeBit(&Probs[((1 + MatchBit) << 8) + Symbol], Bit);
+					bMatched = MatchBit == Bit;
+				}
+				else
+				{
+					Rc.EncodeBit(&Probs[Symbol], Bit);
+				}
+				Symbol = (Symbol << 1) | Bit;
+			}
+
+			St = St < 4 ? 0 : (St < 10 ? St - 3 : St - 6);
+			Insert(Pos);
+			Pos++;
+			continue;
+		}
+
+		Rc.EncodeBit(&State->IsMatch[(St << NumPosBitsMax) + PosState], 1);
+		Rc.EncodeBit(&State->IsRep[St], 0);
+		State->LenEncoder.Encode(Rc, BestLen - MatchMinLen, PosState);
+		State->EncodeDistance(Rc, BestDist, BestLen - MatchMinLen);
+		St = St < 7 ? 7 : 10;
+		Rep0 = BestDist;
+
+		for (int32 i = 0; i < BestLen; ++i)
+		{
+			Insert(Pos + i);
+		}
+		Pos += BestLen;
+	}
+
+	Rc.Flush();
+}
+
+void FLZMAEncoder::CompressZipEntry(const uint8* Src, int64 Size, TArray<uint8>& OutPayload)
+{
+	uint8 Properties[5];
+	TArray<uint8> Stream;
+	Compress(Src, Size, Stream, Properties);
+
+	// LZMA SDK version 9.20, then the properties block size
+	OutPayload.Reset(4 + 5 + Stream.Num());
+	OutPayload.Add(9);
+	OutPayload.Add(20);
+	OutPayload.Add(5);
+	OutPayload.Add(0);
+	OutPayload.Append(Properties, 5);
+	OutPayload.Append(Stream);
+}
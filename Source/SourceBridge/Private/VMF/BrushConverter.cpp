@@ -149,10 +149,23 @@ FBrushConversionResult FBrushConverter::ConvertBrush(
 			continue;
 		}
 
-		FString PlaneStr = FString::Printf(TEXT("(%g %g %g) (%g %g %g) (%g %g %g)"),
-			FMath::RoundToFloat(P1.X), FMath::RoundToFloat(P1.Y), FMath::RoundToFloat(P1.Z),
-			FMath::RoundToFloat(P2.X), FMath::RoundToFloat(P2.Y), FMath::RoundToFloat(P2.Z),
-			FMath::RoundToFloat(P3.X), FMath::RoundToFloat(P3.Y), FMath::RoundToFloat(P3.Z));
+		FString PlaneStr;
+		if (FVMFPlaneTable::IsEnabled())
+		{
+			// Snap onto the export's shared plane instead of rounding this face's own points
+			const FVector RawPoints[3] = {
+				FVector(FMath::RoundToFloat(P1.X), FMath::RoundToFloat(P1.Y), FMath::RoundToFloat(P1.Z)),
+				FVector(FMath::RoundToFloat(P2.X), FMath::RoundToFloat(P2.Y), FMath::RoundToFloat(P2.Z)),
+				FVector(FMath::RoundToFloat(P3.X), FMath::RoundToFloat(P3.Y), FMath::RoundToFloat(P3.Z)) };
+			PlaneStr = FVMFPlaneTable::GetPlaneString(Verts, RawPoints, Result.Planes);
+		}
+		else
+		{
+			PlaneStr = FString::Printf(TEXT("(%g %g %g) (%g %g %g) (%g %g %g)"),
+				FMath::RoundToFloat(P1.X), FMath::RoundToFloat(P1.Y), FMath::RoundToFloat(P1.Z),
+				FMath::RoundToFloat(P2.X), FMath::RoundToFloat(P2.Y), FMath::RoundToFloat(P2.Z),
+				FMath::RoundToFloat(P3.X), FMath::RoundToFloat(P3.Y), FMath::RoundToFloat(P3.Z));
+		}
 
 		// Resolve material
 		FString MaterialPath = DefaultMaterial;
@@ -0,0 +1,538 @@
+#include "VMF/BrushMerger.h"
+#include "VMF/VMFPlaneTable.h"
+#include "Utilities/ToolTextureClassifier.h"
+
+// Half-size of the base winding each side's polygon is clipped from
+static const double BASE_WINDING_SIZE = 65536.0;
+
+// How far a point may be in front of a plane and still count as on it
+static const double POINT_EPSILON = 0.05;
+
+// Spatial hash cell size (Source units)
+static const double MERGE_CELL_SIZE = 256.0;
+
+// Solids spanning more cells than this are checked against every solid instead
+static const int32 MAX_CELLS_PER_SOLID = 512;
+
+// Merge passes over all solids before giving up on convergence
+static const int32 MAX_MERGE_PASSES = 8;
+
+namespace
+{
+	struct FMergeSide
+	{
+		/** Outward plane as vbsp reads it: n = (p0 - p1) x (p2 - p1), dist from p0 */
+		FVector3d Normal = FVector3d::ZeroVector;
+		double Dist = 0.0;
+
+		/** Material, texture axes and lightmap scale: sides merge only with equal keys */
+		FString Key;
+
+		FVMFKeyValues Block;
+	};
+
+	struct FMergeBrush
+	{
+		/** The solid's own properties (id) and any non-side children */
+		FVMFKeyValues Solid;
+		TArray<FMergeSide> Sides;
+
+		/** Winding points of every side */
+		TArray<FVector3d> Points;
+		FBox3d Bounds = FBox3d(ForceInit);
+		double Volume = 0.0;
+
+		/** Tool texture types of the sides (merging must not change the brush's contents) */
+		uint32 Contents = 0;
+	};
+
+	const FString* FindProperty(const FVMFKeyValues& Block, const TCHAR* Key)
+	{
+		for (const TPair<FString, FString>& Prop : Block.Properties)
+		{
+			if (Prop.Key.Equals(Key, ESearchCase::IgnoreCase))
+			{
+				return &Prop.Value;
+			}
+		}
+		return nullptr;
+	}
+
+	/** "(x y z) (x y z) (x y z)" */
+	bool ParsePlanePoints(const FString& Text, FVector3d OutPoints[3])
+	{
+		FString Clean = Text.Replace(TEXT("("), TEXT(" ")).Replace(TEXT(")"), TEXT(" "));
+		TArray<FString> Parts;
+		Clean.ParseIntoArrayWS(Parts);
+		if (Parts.Num() != 9)
+		{
+			return false;
+		}
+		for (int32 i = 0; i < 3; ++i)
+		{
+			OutPoints[i] = FVector3d(
+				FCString::Atod(*Parts[i * 3]),
+				FCString::Atod(*Parts[i * 3 + 1]),
+				FCString::Atod(*Parts[i * 3 + 2]));
+		}
+		return true;
+	}
+
+	bool PlaneEquals(const FVector3d& NormalA, double DistA, const FVector3d& NormalB, double DistB)
+	{
+		return FMath::Abs(NormalA.X - NormalB.X) < FVMFPlaneSet::VBSPNormalEpsilon
+			&& FMath::Abs(NormalA.Y - NormalB.Y) < FVMFPlaneSet::VBSPNormalEpsilon
+			&& FMath::Abs(NormalA.Z - NormalB.Z) < FVMFPlaneSet::VBSPNormalEpsilon
+			&& FMath::Abs(DistA - DistB) < FVMFPlaneSet::VBSPDistEpsilon;
+	}
+
+	TArray<FVector3d> BaseWinding(const FVector3d& Normal, double Dist)
+	{
+		int32 Major = 0;
+		for (int32 i = 1; i < 3; ++i)
+		{
+			if (FMath::Abs(Normal[i]) > FMath::Abs(Normal[Major]))
+			{
+				Major = i;
+			}
+		}
+		FVector3d Up = Major == 2 ? FVector3d(1, 0, 0) : FVector3d(0, 0, 1);
+		Up = (Up - Normal * FVector3d::DotProduct(Up, Normal)).GetSafeNormal();
+		const FVector3d Right = FVector3d::CrossProduct(Up, Normal) * BASE_WINDING_SIZE;
+		Up *= BASE_WINDING_SIZE;
+
+		const FVector3d Center = Normal * Dist;
+		return { Center - Right + Up, Center + Right + Up, Center + Right - Up, Center - Right - Up };
+	}
+
+	/** Keep the part of Winding behind the plane. */
+	void ChopWinding(TArray<FVector3d>& Winding, const FVector3d& Normal, double Dist)
+	{
+		TArray<double, TInlineAllocator<16>> Dists;
+		bool bAnyFront = false;
+		bool bAnyBack = false;
+		for (const FVector3d& Point : Winding)
+		{
+			const double D = FVector3d::DotProduct(Point, Normal) - Dist;
+			Dists.Add(D);
+			bAnyFront |= D > 0.0;
+			bAnyBack |= D < 0.0;
+		}
+		if (!bAnyFront)
+		{
+			return;
+		}
+		if (!bAnyBack)
+		{
+			Winding.Reset();
+			return;
+		}
+
+		TArray<FVector3d> Clipped;
+		for (int32 i = 0; i < Winding.Num(); ++i)
+		{
+			const int32 Next = (i + 1) % Winding.Num();
+			if (Dists[i] <= 0.0)
+			{
+				Clipped.Add(Winding[i]);
+			}
+			if ((Dists[i] < 0.0 && Dists[Next] > 0.0) || (Dists[i] > 0.0 && Dists[Next] < 0.0))
+			{
+				const double T = Dists[i] / (Dists[i] - Dists[Next]);
+				Clipped.Add(Winding[i] + (Winding[Next] - Winding[i]) * T);
+			}
+		}
+		Winding = MoveTemp(Clipped);
+	}
+
+	/**
+	 * Clip every side's winding by the others, dropping sides left without area, and fill
+	 * in the points, bounds and volume. Returns false if the sides don't close a solid.
+	 */
+	bool BuildBrush(FMergeBrush& Brush)
+	{
+		Brush.Points.Reset();
+		Brush.Bounds = FBox3d(ForceInit);
+		Brush.Volume = 0.0;
+
+		TArray<FMergeSide> Kept;
+		for (int32 i = 0; i < Brush.Sides.Num(); ++i)
+		{
+			const FMergeSide& Side = Brush.Sides[i];
+			TArray<FVector3d> Winding = BaseWinding(Side.Normal, Side.Dist);
+			for (int32 j = 0; j < Brush.Sides.Num() && Winding.Num() > 0; ++j)
+			{
+				if (i != j)
+				{
+					ChopWinding(Winding, Brush.Sides[j].Normal, Brush.Sides[j].Dist);
+				}
+			}
+
+			FVector3d AreaVector = FVector3d::ZeroVector;
+			for (int32 k = 2; k < Winding.Num(); ++k)
+			{
+				AreaVector += FVector3d::CrossProduct(Winding[k - 1] - Winding[0], Winding[k] - Winding[0]);
+			}
+			const double Area = AreaVector.Length() * 0.5;
+			if (Area < UE_KINDA_SMALL_NUMBER)
+			{
+				continue;
+			}
+
+			// Divergence theorem over the faces: V = sum(dist * area) / 3
+			Brush.Volume += Side.Dist * Area / 3.0;
+			for (const FVector3d& Point : Winding)
+			{
+				Brush.Points.Add(Point);
+				Brush.Bounds += Point;
+			}
+			Kept.Add(Side);
+		}
+
+		Brush.Sides = MoveTemp(Kept);
+		return Brush.Sides.Num() >= 4 && Brush.Volume > UE_KINDA_SMALL_NUMBER;
+	}
+
+	bool ParseBrush(const FVMFKeyValues& Solid, FMergeBrush& OutBrush)
+	{
+		OutBrush.Solid.ClassName = Solid.ClassName;
+		OutBrush.Solid.Properties = Solid.Properties;
+
+		for (const FVMFKeyValues& Child : Solid.Children)
+		{
+			if (!Child.ClassName.Equals(TEXT("side"), ESearchCase::IgnoreCase))
+			{
+				OutBrush.Solid.Children.Add(Child);
+				continue;
+			}
+
+			const FString* PlaneText = FindProperty(Child, TEXT("plane"));
+			FVector3d Points[3];
+			if (!PlaneText || !ParsePlanePoints(*PlaneText, Points))
+			{
+				return false;
+			}
+
+			FMergeSide& Side = OutBrush.Sides.AddDefaulted_GetRef();
+			Side.Normal = FVector3d::CrossProduct(Points[0] - Points[1], Points[2] - Points[1]);
+			if (!Side.Normal.Normalize())
+			{
+				return false;
+			}
+			Side.Dist = FVector3d::DotProduct(Points[0], Side.Normal);
+			Side.Block = Child;
+
+			const FString* Material = FindProperty(Child, TEXT("material"));
+			const FString* UAxis = FindProperty(Child, TEXT("uaxis"));
+			const FString* VAxis = FindProperty(Child, TEXT("vaxis"));
+			const FString* Scale = FindProperty(Child, TEXT("lightmapscale"));
+			const FString* Smoothing = FindProperty(Child, TEXT("smoothing_groups"));
+			Side.Key = FString::Printf(TEXT("%s|%s|%s|%s|%s"),
+				Material ? *Material->ToLower() : TEXT(""), UAxis ? **UAxis : TEXT(""), VAxis ? **VAxis : TEXT(""),
+				Scale ? **Scale : TEXT(""), Smoothing ? **Smoothing : TEXT(""));
+
+			// Hint and skip faces are vis splits a merge would drop as interior faces
+			EToolTextureType Type = Material ? FToolTextureClassifier::Classify(*Material) : EToolTextureType::Normal;
+			if (Type == EToolTextureType::Hint || Type == EToolTextureType::Skip)
+			{
+				return false;
+			}
+
+			// Nodraw faces don't change what the brush is
+			if (Type == EToolTextureType::NoDraw)
+			{
+				Type = EToolTextureType::Normal;
+			}
+			OutBrush.Contents |= 1u << (uint32)Type;
+		}
+
+		// Only exact solids merge; anything vbsp would trim is left as written
+		const int32 NumSides = OutBrush.Sides.Num();
+		return BuildBrush(OutBrush) && OutBrush.Sides.Num() == NumSides;
+	}
+
+	bool AllBehind(const TArray<FVector3d>& Points, const FMergeSide& Side)
+	{
+		for (const FVector3d& Point : Points)
+		{
+			if (FVector3d::DotProduct(Point, Side.Normal) - Side.Dist > POINT_EPSILON)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/** Merge B into A if the union of the two is a convex solid. */
+	bool TryMerge(const FMergeBrush& A, const FMergeBrush& B, FMergeBrush& OutMerged)
+	{
+		if (A.Contents != B.Contents || !A.Bounds.ExpandBy(POINT_EPSILON).Intersect(B.Bounds))
+		{
+			return false;
+		}
+
+		// The faces they touch on disappear
+		TArray<bool, TInlineAllocator<32>> RemoveA;
+		TArray<bool, TInlineAllocator<32>> RemoveB;
+		RemoveA.Init(false, A.Sides.Num());
+		RemoveB.Init(false, B.Sides.Num());
+		bool bTouching = false;
+		for (int32 i = 0; i < A.Sides.Num(); ++i)
+		{
+			for (int32 j = 0; j < B.Sides.Num(); ++j)
+			{
+				if (PlaneEquals(A.Sides[i].Normal, A.Sides[i].Dist, -B.Sides[j].Normal, -B.Sides[j].Dist))
+				{
+					RemoveA[i] = true;
+					RemoveB[j] = true;
+					bTouching = true;
+				}
+			}
+		}
+		if (!bTouching)
+		{
+			return false;
+		}
+
+		OutMerged = FMergeBrush();
+		OutMerged.Solid = A.Solid;
+		OutMerged.Contents = A.Contents;
+
+		for (int32 i = 0; i < A.Sides.Num(); ++i)
+		{
+			if (!RemoveA[i])
+			{
+				if (!AllBehind(B.Points, A.Sides[i]))
+				{
+					return false;
+				}
+				OutMerged.Sides.Add(A.Sides[i]);
+			}
+		}
+
+		const int32 NumFromA = OutMerged.Sides.Num();
+		for (int32 j = 0; j < B.Sides.Num(); ++j)
+		{
+			if (RemoveB[j])
+			{
+				continue;
+			}
+			if (!AllBehind(A.Points, B.Sides[j]))
+			{
+				return false;
+			}
+
+			// A face continuing across both solids becomes one face, so it must look the same
+			bool bShared = false;
+			for (int32 i = 0; i < NumFromA; ++i)
+			{
+				const FMergeSide& Side = OutMerged.Sides[i];
+				if (PlaneEquals(Side.Normal, Side.Dist, B.Sides[j].Normal, B.Sides[j].Dist))
+				{
+					if (Side.Key != B.Sides[j].Key)
+					{
+						return false;
+					}
+					bShared = true;
+					break;
+				}
+			}
+			if (!bShared)
+			{
+				OutMerged.Sides.Add(B.Sides[j]);
+			}
+		}
+
+		// The remaining planes enclose both; they are the union only if nothing else is inside
+		if (!BuildBrush(OutMerged) || OutMerged.Sides.Num() > FBrushMerger::MaxBrushSides)
+		{
+			return false;
+		}
+		const double Combined = A.Volume + B.Volume;
+		return FMath::Abs(OutMerged.Volume - Combined) <= FMath::Max(Combined * 0.0001, 0.5);
+	}
+
+	/** Solid indices by the hash cells their bounds overlap. */
+	class FMergeGrid
+	{
+	public:
+		void Add(int32 Index, const FBox3d& Bounds)
+		{
+			FIntVector Min, Max;
+			if (!GetCells(Bounds, Min, Max))
+			{
+				Large.Add(Index);
+				return;
+			}
+			for (int32 X = Min.X; X <= Max.X; ++X)
+			{
+				for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+				{
+					for (int32 Z = Min.Z; Z <= Max.Z; ++Z)
+					{
+						Cells.FindOrAdd(FIntVector(X, Y, Z)).Add(Index);
+					}
+				}
+			}
+		}
+
+		/** Solids that may touch Bounds, in ascending order. */
+		void Query(const FBox3d& Bounds, TArray<int32>& OutIndices) const
+		{
+			TSet<int32> Found;
+			Found.Append(Large);
+
+			FIntVector Min, Max;
+			if (!GetCells(Bounds, Min, Max))
+			{
+				for (const TPair<FIntVector, TArray<int32>>& Cell : Cells)
+				{
+					Found.Append(Cell.Value);
+				}
+			}
+			else
+			{
+				for (int32 X = Min.X; X <= Max.X; ++X)
+				{
+					for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+					{
+						for (int32 Z = Min.Z; Z <= Max.Z; ++Z)
+						{
+							if (const TArray<int32>* Indices = Cells.Find(FIntVector(X, Y, Z)))
+							{
+								Found.Append(*Indices);
+							}
+						}
+					}
+				}
+			}
+
+			OutIndices = Found.Array();
+			OutIndices.Sort();
+		}
+
+	private:
+		/** Cell range of the bounds (grown to catch touching solids); false if it's too large. */
+		static bool GetCells(const FBox3d& Bounds, FIntVector& OutMin, FIntVector& OutMax)
+		{
+			const FBox3d Grown = Bounds.ExpandBy(POINT_EPSILON);
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				OutMin[Axis] = FMath::FloorToInt(Grown.Min[Axis] / MERGE_CELL_SIZE);
+				OutMax[Axis] = FMath::FloorToInt(Grown.Max[Axis] / MERGE_CELL_SIZE);
+			}
+			const int64 Count = (int64)(OutMax.X - OutMin.X + 1) * (OutMax.Y - OutMin.Y + 1) * (OutMax.Z - OutMin.Z + 1);
+			return Count <= MAX_CELLS_PER_SOLID;
+		}
+
+		TMap<FIntVector, TArray<int32>> Cells;
+		TArray<int32> Large;
+	};
+}
+
+FBrushMergeStats FBrushMerger::MergeSolids(TArray<FVMFKeyValues>& Solids)
+{
+	FBrushMergeStats Stats;
+	const double StartTime = FPlatformTime::Seconds();
+
+	TArray<FMergeBrush> Brushes;
+	TArray<bool> Mergeable;
+	Brushes.SetNum(Solids.Num());
+	Mergeable.SetNum(Solids.Num());
+	for (int32 i = 0; i < Solids.Num(); ++i)
+	{
+		Stats.SidesBefore += Solids[i].Children.Num();
+		Mergeable[i] = ParseBrush(Solids[i], Brushes[i]);
+	}
+	Stats.BrushesBefore = Solids.Num();
+
+	FMergeGrid Grid;
+	for (int32 i = 0; i < Brushes.Num(); ++i)
+	{
+		if (Mergeable[i])
+		{
+			Grid.Add(i, Brushes[i].Bounds);
+		}
+	}
+
+	// Solids absorbed into another one
+	TArray<bool> Merged;
+	Merged.Init(false, Solids.Num());
+
+	bool bChanged = true;
+	for (int32 Pass = 0; Pass < MAX_MERGE_PASSES && bChanged; ++Pass)
+	{
+		bChanged = false;
+		for (int32 i = 0; i < Brushes.Num(); ++i)
+		{
+			if (!Mergeable[i] || Merged[i])
+			{
+				continue;
+			}
+
+			// Keep growing this solid until no neighbour fits
+			bool bGrew = true;
+			while (bGrew)
+			{
+				bGrew = false;
+				TArray<int32> Candidates;
+				Grid.Query(Brushes[i].Bounds, Candidates);
+				for (int32 j : Candidates)
+				{
+					if (j == i || Merged[j])
+					{
+						continue;
+					}
+
+					FMergeBrush Combined;
+					if (TryMerge(Brushes[i], Brushes[j], Combined))
+					{
+						Brushes[i] = MoveTemp(Combined);
+						Merged[j] = true;
+						Grid.Add(i, Brushes[i].Bounds);
+						bGrew = true;
+						bChanged = true;
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	TArray<FVMFKeyValues> Result;
+	for (int32 i = 0; i < Brushes.Num(); ++i)
+	{
+		if (Merged[i])
+		{
+			continue;
+		}
+
+		if (!Mergeable[i])
+		{
+			Result.Add(MoveTemp(Solids[i]));
+			continue;
+		}
+
+		FVMFKeyValues Solid = MoveTemp(Brushes[i].Solid);
+		TArray<FVMFKeyValues> Extra = MoveTemp(Solid.Children);
+		Solid.Children.Reset();
+		for (FMergeSide& Side : Brushes[i].Sides)
+		{
+			Solid.Children.Add(MoveTemp(Side.Block));
+		}
+		Solid.Children.Append(MoveTemp(Extra));
+		Result.Add(MoveTemp(Solid));
+	}
+
+	for (const FVMFKeyValues& Solid : Result)
+	{
+		Stats.SidesAfter += Solid.Children.Num();
+	}
+	Stats.BrushesAfter = Result.Num();
+	Solids = MoveTemp(Result);
+	Stats.Seconds = FPlatformTime::Seconds() - StartTime;
+
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: %d solids merged into %d, %d sides into %d (%.2fs)."),
+		Stats.BrushesBefore, Stats.BrushesAfter, Stats.SidesBefore, Stats.SidesAfter, Stats.Seconds);
+	return Stats;
+}
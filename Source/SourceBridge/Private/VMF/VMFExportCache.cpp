@@ -0,0 +1,287 @@
+#include "VMF/VMFExportCache.h"
+#include "Materials/MaterialMapper.h"
+#include "UI/SourceBridgeSettings.h"
+#include "Hash/CityHash.h"
+
+TMap<uint64, FVMFExportCache::FEntry> FVMFExportCache::Entries;
+uint32 FVMFExportCache::ExportSerial = 0;
+int32 FVMFExportCache::Hits = 0;
+int32 FVMFExportCache::Misses = 0;
+bool FVMFExportCache::bEnabled = true;
+bool FVMFExportCache::bCanonicalPlanes = true;
+
+// Stands in for a templated ID while the blocks are serialized
+static const TCHAR VMF_ID_SENTINEL = TEXT('\x01');
+
+// ---- FVMFBlockTemplate ----
+
+FVMFIdCounters FVMFBlockTemplate::MakeVirtualCounters()
+{
+	FVMFIdCounters Counters;
+	for (int32 i = 0; i < (int32)EVMFIdCounter::Num; ++i)
+	{
+		Counters.Counters[i] = VirtualIdBase;
+	}
+	return Counters;
+}
+
+static void ExtractIdSlots(FVMFKeyValues& Node, EVMFIdCounter EntityIdKind, TArray<FVMFBlockTemplate::FSlot>& OutSlots)
+{
+	TOptional<EVMFIdCounter> Kind;
+	if (Node.ClassName == TEXT("solid"))
+	{
+		Kind = EVMFIdCounter::Solid;
+	}
+	else if (Node.ClassName == TEXT("side"))
+	{
+		Kind = EVMFIdCounter::Side;
+	}
+	else if (Node.ClassName == TEXT("entity"))
+	{
+		Kind = EntityIdKind;
+	}
+
+	if (Kind.IsSet())
+	{
+		for (TPair<FString, FString>& Prop : Node.Properties)
+		{
+			if (Prop.Key != TEXT("id"))
+			{
+				continue;
+			}
+
+			int64 Id = FCString::Atoi64(*Prop.Value);
+			if (Id >= FVMFBlockTemplate::VirtualIdBase)
+			{
+				FVMFBlockTemplate::FSlot Slot;
+				Slot.Kind = Kind.GetValue();
+				Slot.Offset = (int32)(Id - FVMFBlockTemplate::VirtualIdBase);
+				OutSlots.Add(Slot);
+				Prop.Value = FString::Chr(VMF_ID_SENTINEL);
+			}
+			break;
+		}
+	}
+
+	// Serialize() writes properties before children, so pre-order matches text order
+	for (FVMFKeyValues& Child : Node.Children)
+	{
+		ExtractIdSlots(Child, EntityIdKind, OutSlots);
+	}
+}
+
+bool FVMFBlockTemplate::Build(const TArray<FVMFKeyValues>& Blocks, int32 IndentLevel,
+	EVMFIdCounter EntityIdKind, const FVMFIdCounters& VirtualCountersAfter)
+{
+	Segments.Reset();
+	Slots.Reset();
+
+	for (int32 i = 0; i < (int32)EVMFIdCounter::Num; ++i)
+	{
+		IdsUsed.Counters[i] = VirtualCountersAfter.Counters[i] - VirtualIdBase;
+		if (IdsUsed.Counters[i] < 0)
+		{
+			return false;
+		}
+	}
+
+	FString Text;
+	for (const FVMFKeyValues& Block : Blocks)
+	{
+		FVMFKeyValues Templated = Block;
+		ExtractIdSlots(Templated, EntityIdKind, Slots);
+		Text += Templated.Serialize(IndentLevel);
+	}
+
+	for (const FSlot& Slot : Slots)
+	{
+		if (Slot.Offset >= IdsUsed[Slot.Kind])
+		{
+			return false;
+		}
+	}
+
+	// Split on the sentinel; a stray one in a keyvalue would misalign the slots
+	int32 Start = 0;
+	for (int32 i = 0; i < Text.Len(); ++i)
+	{
+		if (Text[i] == VMF_ID_SENTINEL)
+		{
+			Segments.Add(Text.Mid(Start, i - Start));
+			Start = i + 1;
+		}
+	}
+	Segments.Add(Text.Mid(Start));
+
+	return Segments.Num() == Slots.Num() + 1;
+}
+
+void FVMFBlockTemplate::Render(FString& Out, FVMFIdCounters& Counters) const
+{
+	for (int32 i = 0; i < Segments.Num(); ++i)
+	{
+		Out += Segments[i];
+		if (Slots.IsValidIndex(i))
+		{
+			Out += FString::FromInt(Counters[Slots[i].Kind] + Slots[i].Offset);
+		}
+	}
+
+	for (int32 i = 0; i < (int32)EVMFIdCounter::Num; ++i)
+	{
+		Counters.Counters[i] += IdsUsed.Counters[i];
+	}
+}
+
+// ---- FVMFFingerprint ----
+
+FVMFFingerprint::FVMFFingerprint(const TCHAR* Domain)
+{
+	Buffer.Reserve(512);
+	Add(FString(Domain));
+}
+
+void FVMFFingerprint::Add(const FString& Value)
+{
+	Add((int32)Value.Len());
+	Buffer.Append(reinterpret_cast<const uint8*>(*Value), Value.Len() * sizeof(TCHAR));
+}
+
+void FVMFFingerprint::Add(const FName& Value)
+{
+	Add(Value.ToString());
+}
+
+void FVMFFingerprint::Add(int32 Value)
+{
+	Buffer.Append(reinterpret_cast<const uint8*>(&Value), sizeof(Value));
+}
+
+void FVMFFingerprint::Add(uint32 Value)
+{
+	Buffer.Append(reinterpret_cast<const uint8*>(&Value), sizeof(Value));
+}
+
+void FVMFFingerprint::Add(double Value)
+{
+	Buffer.Append(reinterpret_cast<const uint8*>(&Value), sizeof(Value));
+}
+
+void FVMFFingerprint::Add(const FVector& Value)
+{
+	Add(Value.X);
+	Add(Value.Y);
+	Add(Value.Z);
+}
+
+void FVMFFingerprint::Add(const FTransform& Value)
+{
+	Add(Value.GetLocation());
+	FQuat Rotation = Value.GetRotation();
+	Add(Rotation.X);
+	Add(Rotation.Y);
+	Add(Rotation.Z);
+	Add(Rotation.W);
+	Add(Value.GetScale3D());
+}
+
+void FVMFFingerprint::Add(const FGuid& Value)
+{
+	Add(Value.A);
+	Add(Value.B);
+	Add(Value.C);
+	Add(Value.D);
+}
+
+uint64 FVMFFingerprint::Get() const
+{
+	return CityHash64(reinterpret_cast<const char*>(Buffer.GetData()), Buffer.Num());
+}
+
+// ---- FVMFMaterialMemo ----
+
+const FString& FVMFMaterialMemo::Map(UMaterialInterface* Material)
+{
+	if (const FString* Existing = Paths.Find(Material))
+	{
+		return *Existing;
+	}
+	return Paths.Add(Material, Mapper.MapMaterial(Material));
+}
+
+// ---- FVMFExportCache ----
+
+void FVMFExportCache::BeginExport()
+{
+	USourceBridgeSettings* Settings = USourceBridgeSettings::Get();
+	bEnabled = !Settings || Settings->bIncrementalExport;
+
+	// Plane points differ with and without canonical planes
+	const bool bCanonical = !Settings || Settings->bCanonicalizePlanes;
+	if (!bEnabled || bCanonical != bCanonicalPlanes)
+	{
+		Entries.Empty();
+	}
+	bCanonicalPlanes = bCanonical;
+
+	ExportSerial++;
+	Hits = 0;
+	Misses = 0;
+}
+
+void FVMFExportCache::EndExport()
+{
+	if (!bEnabled)
+	{
+		return;
+	}
+
+	int32 Pruned = 0;
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		if (It.Value().LastUsedExport != ExportSerial)
+		{
+			It.RemoveCurrent();
+			Pruned++;
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Export cache: %d blocks reused, %d regenerated, %d pruned (%d cached)."),
+		Hits, Misses, Pruned, Entries.Num());
+}
+
+const FVMFExportCache::FEntry* FVMFExportCache::Find(uint64 Fingerprint)
+{
+	if (!bEnabled)
+	{
+		return nullptr;
+	}
+
+	FEntry* Entry = Entries.Find(Fingerprint);
+	if (!Entry)
+	{
+		Misses++;
+		return nullptr;
+	}
+
+	Entry->LastUsedExport = ExportSerial;
+	Hits++;
+	return Entry;
+}
+
+void FVMFExportCache::Add(uint64 Fingerprint, FEntry&& Entry)
+{
+	if (!bEnabled)
+	{
+		return;
+	}
+
+	Entry.LastUsedExport = ExportSerial;
+	Entries.Add(Fingerprint, MoveTemp(Entry));
+}
+
+void FVMFExportCache::Clear()
+{
+	Entries.Empty();
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: VMF export cache cleared."));
+}
@@ -1,5 +1,8 @@
 #include "VMF/VMFExporter.h"
+#include "VMF/VMFExportCache.h"
+#include "VMF/VMFPlaneTable.h"
 #include "VMF/BrushConverter.h"
+#include "VMF/BrushMerger.h"
 #include "VMF/SkyboxExporter.h"
 #include "VMF/VisOptimizer.h"
 #include "Entities/EntityExporter.h"
@@ -7,13 +10,214 @@
 #include "Materials/MaterialMapper.h"
 #include "Utilities/SourceCoord.h"
 #include "Actors/SourceEntityActor.h"
+#include "UI/SourceBridgeSettings.h"
 #include "Engine/Brush.h"
+#include "Engine/Polys.h"
+#include "Model.h"
 #include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "StaticMeshResources.h"
 #include "Engine/TriggerVolume.h"
 #include "Engine/TriggerBox.h"
+#include "Components/StaticMeshComponent.h"
 #include "EngineUtils.h"
 #include "GameFramework/Volume.h"
 
+/** Hash everything FBrushConverter::ConvertBrush reads from a brush actor. */
+static void FingerprintBrush(FVMFFingerprint& Fp, ABrush* Brush, FVMFMaterialMemo& MaterialMemo)
+{
+	Fp.Add(Brush->GetName());
+	Fp.Add(Brush->GetActorTransform());
+	Fp.Add((int32)Brush->BrushType);
+
+	for (const FName& Tag : Brush->Tags)
+	{
+		Fp.Add(Tag);
+	}
+
+	if (!Brush->Brush || !Brush->Brush->Polys)
+	{
+		Fp.Add(-1);
+		return;
+	}
+
+	const TArray<FPoly>& Polys = Brush->Brush->Polys->Element;
+	Fp.Add(Polys.Num());
+	for (const FPoly& Poly : Polys)
+	{
+		Fp.Add(Poly.Vertices.Num());
+		for (const FVector3f& Vert : Poly.Vertices)
+		{
+			Fp.Add(FVector(Vert));
+		}
+		Fp.Add(FVector(Poly.Normal));
+		Fp.Add(FVector(Poly.TextureU));
+		Fp.Add(FVector(Poly.TextureV));
+		Fp.Add(FVector(Poly.Base));
+
+		// The resolved Source path, not the UE asset, so mapping changes invalidate too
+		if (Poly.Vertices.Num() >= 3)
+		{
+			Fp.Add(MaterialMemo.Map(Poly.Material));
+		}
+	}
+}
+
+/** Hash every field FEntityExporter::EntityToVMF writes. */
+static void FingerprintEntity(FVMFFingerprint& Fp, const FSourceEntity& Entity)
+{
+	Fp.Add(Entity.ClassName);
+	Fp.Add(Entity.TargetName);
+	Fp.Add(Entity.Origin);
+	Fp.Add(Entity.Angles.Pitch);
+	Fp.Add(Entity.Angles.Yaw);
+	Fp.Add(Entity.Angles.Roll);
+
+	Fp.Add(Entity.KeyValues.Num());
+	for (const auto& KV : Entity.KeyValues)
+	{
+		Fp.Add(KV.Key);
+		Fp.Add(KV.Value);
+	}
+
+	Fp.Add(Entity.Connections.Num());
+	for (const FEntityIOConnection& Conn : Entity.Connections)
+	{
+		Fp.Add(Conn.OutputName);
+		Fp.Add(Conn.FormatValue());
+	}
+}
+
+/** Hash everything FPropExporter::ConvertMeshToBrush reads from a static mesh actor. */
+static void FingerprintMeshBrush(FVMFFingerprint& Fp, AStaticMeshActor* Actor, const FString& BrushClass)
+{
+	// The name only shows up in warnings, which are cached with the blocks
+	Fp.Add(Actor->GetName());
+	Fp.Add(Actor->GetActorTransform());
+	Fp.Add(BrushClass);
+
+	UStaticMeshComponent* MeshComp = Actor->GetStaticMeshComponent();
+	UStaticMesh* Mesh = MeshComp ? MeshComp->GetStaticMesh() : nullptr;
+	if (!Mesh || !Mesh->GetRenderData() || Mesh->GetRenderData()->LODResources.Num() == 0)
+	{
+		Fp.Add(-1);
+		return;
+	}
+
+	// The LOD 0 geometry the brush faces are merged from
+	const FStaticMeshLODResources& LOD = Mesh->GetRenderData()->LODResources[0];
+	const FPositionVertexBuffer& PosBuffer = LOD.VertexBuffers.PositionVertexBuffer;
+	Fp.Add(PosBuffer.GetNumVertices());
+	for (uint32 i = 0; i < PosBuffer.GetNumVertices(); ++i)
+	{
+		Fp.Add(FVector(PosBuffer.VertexPosition(i)));
+	}
+
+	TArray<uint32> Indices;
+	LOD.IndexBuffer.GetCopy(Indices);
+	Fp.Add(Indices.Num());
+	for (uint32 Index : Indices)
+	{
+		Fp.Add(Index);
+	}
+
+	// Section layout assigns triangles to materials, written by name
+	Fp.Add(LOD.Sections.Num());
+	for (int32 i = 0; i < LOD.Sections.Num(); ++i)
+	{
+		Fp.Add(LOD.Sections[i].MaterialIndex);
+		Fp.Add((int32)LOD.Sections[i].NumTriangles);
+
+		UMaterialInterface* Mat = MeshComp->GetMaterial(i);
+		Fp.Add(Mat ? Mat->GetName() : FString());
+	}
+}
+
+/** Hash the stored solids of an imported worldspawn actor, collecting their materials. */
+static void FingerprintStoredBrushes(FVMFFingerprint& Fp, const ASourceBrushEntity* BrushEntity,
+	TSet<FString>& OutMaterialPaths)
+{
+	for (const FImportedBrushData& BrushData : BrushEntity->StoredBrushData)
+	{
+		Fp.Add(BrushData.SolidId);
+		Fp.Add(BrushData.Sides.Num());
+		for (const FImportedSideData& Side : BrushData.Sides)
+		{
+			Fp.Add(Side.PlaneP1);
+			Fp.Add(Side.PlaneP2);
+			Fp.Add(Side.PlaneP3);
+			Fp.Add(Side.Material);
+			Fp.Add(Side.UAxisStr);
+			Fp.Add(Side.VAxisStr);
+			Fp.Add(Side.LightmapScale);
+
+			if (!Side.Material.IsEmpty())
+			{
+				OutMaterialPaths.Add(Side.Material);
+			}
+		}
+	}
+}
+
+/** What the caller needs to know about blocks emitted through the cache. */
+struct FVMFEmittedBlocks
+{
+	int32 SolidCount = 0;
+	bool bHasWarnings = false;
+};
+
+/**
+ * Emit one actor's blocks through FVMFExportCache.
+ * A hit renders the cached template at the current counters. A miss runs
+ * Generate(Ids, Entry), which builds the blocks against the given counters and records
+ * warnings and the solid count in Entry.
+ */
+template<typename GenerateFunc>
+static FVMFEmittedBlocks EmitCachedBlocks(uint64 Fingerprint, int32 IndentLevel, EVMFIdCounter EntityIdKind,
+	FVMFIdCounters& Ids, FString& Out, GenerateFunc&& Generate)
+{
+	auto Finish = [](const FVMFExportCache::FEntry& Entry)
+	{
+		for (const FString& Warning : Entry.Warnings)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SourceBridge: %s"), *Warning);
+		}
+		FVMFPlaneTable::Record(Entry.Planes);
+
+		FVMFEmittedBlocks Emitted;
+		Emitted.SolidCount = Entry.SolidCount;
+		Emitted.bHasWarnings = Entry.Warnings.Num() > 0;
+		return Emitted;
+	};
+
+	if (const FVMFExportCache::FEntry* Cached = FVMFExportCache::Find(Fingerprint))
+	{
+		Cached->Template.Render(Out, Ids);
+		return Finish(*Cached);
+	}
+
+	FVMFExportCache::FEntry Entry;
+	FVMFIdCounters VirtualIds = FVMFBlockTemplate::MakeVirtualCounters();
+	TArray<FVMFKeyValues> Blocks = Generate(VirtualIds, Entry);
+	if (Entry.Template.Build(Blocks, IndentLevel, EntityIdKind, VirtualIds))
+	{
+		Entry.Template.Render(Out, Ids);
+		FVMFEmittedBlocks Emitted = Finish(Entry);
+		FVMFExportCache::Add(Fingerprint, MoveTemp(Entry));
+		return Emitted;
+	}
+
+	// Blocks that can't be templated are regenerated with the real counters and not cached
+	FVMFExportCache::FEntry Uncached;
+	Blocks = Generate(Ids, Uncached);
+	for (const FVMFKeyValues& Block : Blocks)
+	{
+		Out += Block.Serialize(IndentLevel);
+	}
+	return Finish(Uncached);
+}
+
 FString FVMFExporter::ExportScene(UWorld* World, const FString& MapName, TSet<FString>* OutUsedMaterials)
 {
 	if (!World)
@@ -22,6 +226,9 @@ FString FVMFExporter::ExportScene(UWorld* World, const FString& MapName, TSet<FS
 		return FString();
 	}
 
+	FVMFExportCache::BeginExport();
+	FVMFPlaneTable::BeginExport();
+
 	FString Result;
 
 	Result += BuildVersionInfo().Serialize();
@@ -64,9 +271,22 @@ FString FVMFExporter::ExportScene(UWorld* World, const FString& MapName, TSet<FS
 	{
 		MatMapper.SetMapName(MapName);
 	}
+	FVMFMaterialMemo MaterialMemo(MatMapper);
+
+	FVMFIdCounters Ids;
+	Ids[EVMFIdCounter::Solid] = SolidIdCounter;
+	Ids[EVMFIdCounter::Side] = SideIdCounter;
 
-	// Deferred brush entities (func_detail, func_wall, etc.) - written after worldspawn
-	TArray<FVMFKeyValues> BrushEntities;
+	// Worldspawn solids (serialized inside the world block) and deferred brush
+	// entities (func_detail, func_wall, etc.) written after worldspawn
+	FString WorldSolidsText;
+	FString BrushEntitiesText;
+	int32 BrushEntityCount = 0;
+
+	// Structural brushes collected for merging instead of being written one by one
+	USourceBridgeSettings* BridgeSettings = USourceBridgeSettings::Get();
+	const bool bMergeBrushes = BridgeSettings && BridgeSettings->bMergeBrushes;
+	TArray<FVMFKeyValues> MergeSolids;
 
 	for (TActorIterator<ABrush> It(World); It; ++It)
 	{
@@ -149,90 +369,175 @@ FString FVMFExporter::ExportScene(UWorld* World, const FString& MapName, TSet<FS
 			}
 		}
 
-		FBrushConversionResult ConvResult = FBrushConverter::ConvertBrush(
-			Brush, SolidIdCounter, SideIdCounter, &MatMapper);
+		const bool bIsBrushEntity = !BrushEntityClass.IsEmpty();
 
-		for (const FString& Warning : ConvResult.Warnings)
+		if (bMergeBrushes && !bIsBrushEntity)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("SourceBridge: %s"), *Warning);
-		}
+			// Merged with their neighbours below, so they can't be reused from the cache
+			FBrushConversionResult ConvResult = FBrushConverter::ConvertBrush(
+				Brush, Ids[EVMFIdCounter::Solid], Ids[EVMFIdCounter::Side], &MatMapper);
 
-		if (ConvResult.Solids.Num() == 0)
-		{
-			if (ConvResult.Warnings.Num() > 0)
+			for (const FString& Warning : ConvResult.Warnings)
 			{
-				SkippedCount++;
+				UE_LOG(LogTemp, Warning, TEXT("SourceBridge: %s"), *Warning);
 			}
+			FVMFPlaneTable::Record(ConvResult.Planes);
+
+			if (ConvResult.Solids.Num() == 0)
+			{
+				if (ConvResult.Warnings.Num() > 0)
+				{
+					SkippedCount++;
+				}
+				continue;
+			}
+
+			BrushCount += ConvResult.Solids.Num();
+			MergeSolids.Append(MoveTemp(ConvResult.Solids));
 			continue;
 		}
 
-		if (!BrushEntityClass.IsEmpty())
-		{
-			// Emit as a brush entity
-			FVMFKeyValues BrushEntity(TEXT("entity"));
-			BrushEntity.AddProperty(TEXT("id"), SolidIdCounter++);
-			BrushEntity.AddProperty(TEXT("classname"), BrushEntityClass);
+		FVMFFingerprint Fp(TEXT("brush"));
+		FingerprintBrush(Fp, Brush, MaterialMemo);
 
-			if (!BrushTargetName.IsEmpty())
+		FVMFEmittedBlocks Emitted = EmitCachedBlocks(Fp.Get(), bIsBrushEntity ? 0 : 1, EVMFIdCounter::Solid,
+			Ids, bIsBrushEntity ? BrushEntitiesText : WorldSolidsText,
+			[&](FVMFIdCounters& BlockIds, FVMFExportCache::FEntry& Entry)
 			{
-				BrushEntity.AddProperty(TEXT("targetname"), BrushTargetName);
-			}
+				FBrushConversionResult ConvResult = FBrushConverter::ConvertBrush(
+					Brush, BlockIds[EVMFIdCounter::Solid], BlockIds[EVMFIdCounter::Side], &MatMapper);
 
-			for (const auto& KV : BrushExtraKV)
-			{
-				BrushEntity.AddProperty(KV.Key, KV.Value);
-			}
+				Entry.Warnings = MoveTemp(ConvResult.Warnings);
+				Entry.SolidCount = ConvResult.Solids.Num();
+				Entry.Planes = MoveTemp(ConvResult.Planes);
+
+				if (!bIsBrushEntity || ConvResult.Solids.Num() == 0)
+				{
+					// Structural geometry goes into worldspawn
+					return MoveTemp(ConvResult.Solids);
+				}
 
-			for (FVMFKeyValues& Solid : ConvResult.Solids)
+				// Emit as a brush entity
+				FVMFKeyValues BrushEntity(TEXT("entity"));
+				BrushEntity.AddProperty(TEXT("id"), BlockIds[EVMFIdCounter::Solid]++);
+				BrushEntity.AddProperty(TEXT("classname"), BrushEntityClass);
+
+				if (!BrushTargetName.IsEmpty())
+				{
+					BrushEntity.AddProperty(TEXT("targetname"), BrushTargetName);
+				}
+
+				for (const auto& KV : BrushExtraKV)
+				{
+					BrushEntity.AddProperty(KV.Key, KV.Value);
+				}
+
+				for (FVMFKeyValues& Solid : ConvResult.Solids)
+				{
+					BrushEntity.Children.Add(MoveTemp(Solid));
+				}
+
+				TArray<FVMFKeyValues> Blocks;
+				Blocks.Add(MoveTemp(BrushEntity));
+				return Blocks;
+			});
+
+		if (Emitted.SolidCount == 0)
+		{
+			if (Emitted.bHasWarnings)
 			{
-				BrushEntity.Children.Add(MoveTemp(Solid));
-				BrushCount++;
+				SkippedCount++;
 			}
+			continue;
+		}
 
-			BrushEntities.Add(MoveTemp(BrushEntity));
+		BrushCount += Emitted.SolidCount;
+		if (bIsBrushEntity)
+		{
+			BrushEntityCount++;
 		}
-		else
+	}
+
+	if (MergeSolids.Num() > 0)
+	{
+		FBrushMergeStats MergeStats = FBrushMerger::MergeSolids(MergeSolids);
+		BrushCount -= MergeStats.BrushesBefore - MergeStats.BrushesAfter;
+		for (const FVMFKeyValues& Solid : MergeSolids)
 		{
-			// Add to worldspawn as structural geometry
-			for (FVMFKeyValues& Solid : ConvResult.Solids)
-			{
-				WorldNode.Children.Add(MoveTemp(Solid));
-				BrushCount++;
-			}
+			WorldSolidsText += Solid.Serialize(1);
 		}
+
+		UE_LOG(LogTemp, Log, TEXT("SourceBridge: Merged world brushes: %d -> %d solids, %d -> %d sides."),
+			MergeStats.BrushesBefore, MergeStats.BrushesAfter, MergeStats.SidesBefore, MergeStats.SidesAfter);
 	}
 
-	// Collect static mesh actors tagged for brush conversion (source:worldspawn, source:func_detail, etc.)
+	// Static mesh actors tagged for brush conversion (source:worldspawn, source:func_detail, etc.)
 	int32 MeshBrushCount = 0;
-	TArray<FMeshToBrushResult> MeshBrushes = FPropExporter::CollectMeshBrushes(
-		World, SolidIdCounter, SideIdCounter);
-	for (FMeshToBrushResult& MBR : MeshBrushes)
+	for (TActorIterator<AStaticMeshActor> It(World); It; ++It)
 	{
-		if (MBR.EntityClass.IsEmpty())
+		AStaticMeshActor* Actor = *It;
+		if (!Actor) continue;
+
+		bool bNoExport = false;
+		for (const FName& Tag : Actor->Tags)
 		{
-			// Worldspawn — add solids to world node
-			for (FVMFKeyValues& Solid : MBR.Solids)
+			if (Tag.ToString().Equals(TEXT("noexport"), ESearchCase::IgnoreCase))
 			{
-				WorldNode.Children.Add(MoveTemp(Solid));
-				BrushCount++;
-				MeshBrushCount++;
+				bNoExport = true;
+				break;
 			}
 		}
-		else
-		{
-			// Brush entity (func_detail, etc.) — create entity block
-			FVMFKeyValues MeshEntity(TEXT("entity"));
-			MeshEntity.AddProperty(TEXT("id"), SolidIdCounter++);
-			MeshEntity.AddProperty(TEXT("classname"), MBR.EntityClass);
+		if (bNoExport) continue;
+
+		TOptional<FString> BrushClass = FPropExporter::ShouldConvertToBrush(Actor);
+		if (!BrushClass.IsSet()) continue;
 
-			for (FVMFKeyValues& Solid : MBR.Solids)
+		// Empty class = worldspawn, otherwise a brush entity (func_detail, etc.)
+		const FString& EntityClass = BrushClass.GetValue();
+		const bool bIsBrushEntity = !EntityClass.IsEmpty();
+
+		FVMFFingerprint Fp(TEXT("meshbrush"));
+		FingerprintMeshBrush(Fp, Actor, EntityClass);
+
+		FVMFEmittedBlocks Emitted = EmitCachedBlocks(Fp.Get(), bIsBrushEntity ? 0 : 1, EVMFIdCounter::Solid,
+			Ids, bIsBrushEntity ? BrushEntitiesText : WorldSolidsText,
+			[&](FVMFIdCounters& BlockIds, FVMFExportCache::FEntry& Entry)
 			{
-				MeshEntity.Children.Add(MoveTemp(Solid));
-				BrushCount++;
-				MeshBrushCount++;
-			}
+				FMeshToBrushResult MBR = FPropExporter::ConvertMeshToBrush(
+					Actor, BlockIds[EVMFIdCounter::Solid], BlockIds[EVMFIdCounter::Side], EntityClass);
 
-			BrushEntities.Add(MoveTemp(MeshEntity));
+				TArray<FVMFKeyValues> Blocks;
+				if (!MBR.bSuccess)
+				{
+					Entry.Warnings = MoveTemp(MBR.Warnings);
+					return Blocks;
+				}
+
+				Entry.SolidCount = MBR.Solids.Num();
+				Entry.Planes = MoveTemp(MBR.Planes);
+				if (!bIsBrushEntity)
+				{
+					return MoveTemp(MBR.Solids);
+				}
+
+				FVMFKeyValues MeshEntity(TEXT("entity"));
+				MeshEntity.AddProperty(TEXT("id"), BlockIds[EVMFIdCounter::Solid]++);
+				MeshEntity.AddProperty(TEXT("classname"), MBR.EntityClass);
+
+				for (FVMFKeyValues& Solid : MBR.Solids)
+				{
+					MeshEntity.Children.Add(MoveTemp(Solid));
+				}
+
+				Blocks.Add(MoveTemp(MeshEntity));
+				return Blocks;
+			});
+
+		BrushCount += Emitted.SolidCount;
+		MeshBrushCount += Emitted.SolidCount;
+		if (bIsBrushEntity && Emitted.SolidCount > 0)
+		{
+			BrushEntityCount++;
 		}
 	}
 
@@ -247,48 +552,55 @@ FString FVMFExporter::ExportScene(UWorld* World, const FString& MapName, TSet<FS
 		if (BrushEntity->SourceClassname != TEXT("worldspawn")) continue;
 		if (BrushEntity->StoredBrushData.Num() == 0) continue;
 
-		for (const FImportedBrushData& BrushData : BrushEntity->StoredBrushData)
-		{
-			FVMFKeyValues SolidNode(TEXT("solid"));
-			SolidNode.AddProperty(TEXT("id"), BrushData.SolidId > 0 ? BrushData.SolidId : SolidIdCounter++);
+		FVMFFingerprint Fp(TEXT("storedworld"));
+		FingerprintStoredBrushes(Fp, BrushEntity, WorldspawnMaterialPaths);
 
-			for (const FImportedSideData& Side : BrushData.Sides)
+		FVMFEmittedBlocks Emitted = EmitCachedBlocks(Fp.Get(), 1, EVMFIdCounter::Solid, Ids, WorldSolidsText,
+			[&](FVMFIdCounters& BlockIds, FVMFExportCache::FEntry& Entry)
 			{
-				FVMFKeyValues SideNode(TEXT("side"));
-				SideNode.AddProperty(TEXT("id"), SideIdCounter++);
-
-				FString PlaneStr = FString::Printf(TEXT("(%g %g %g) (%g %g %g) (%g %g %g)"),
-					Side.PlaneP1.X, Side.PlaneP1.Y, Side.PlaneP1.Z,
-					Side.PlaneP2.X, Side.PlaneP2.Y, Side.PlaneP2.Z,
-					Side.PlaneP3.X, Side.PlaneP3.Y, Side.PlaneP3.Z);
-				SideNode.AddProperty(TEXT("plane"), PlaneStr);
-				SideNode.AddProperty(TEXT("material"), Side.Material);
-
-				if (!Side.UAxisStr.IsEmpty())
+				TArray<FVMFKeyValues> Solids;
+				for (const FImportedBrushData& BrushData : BrushEntity->StoredBrushData)
 				{
-					SideNode.AddProperty(TEXT("uaxis"), Side.UAxisStr);
+					FVMFKeyValues SolidNode(TEXT("solid"));
+					SolidNode.AddProperty(TEXT("id"), BrushData.SolidId > 0 ? BrushData.SolidId : BlockIds[EVMFIdCounter::Solid]++);
+
+					for (const FImportedSideData& Side : BrushData.Sides)
+					{
+						FVMFKeyValues SideNode(TEXT("side"));
+						SideNode.AddProperty(TEXT("id"), BlockIds[EVMFIdCounter::Side]++);
+
+						FString PlaneStr = FString::Printf(TEXT("(%g %g %g) (%g %g %g) (%g %g %g)"),
+							Side.PlaneP1.X, Side.PlaneP1.Y, Side.PlaneP1.Z,
+							Side.PlaneP2.X, Side.PlaneP2.Y, Side.PlaneP2.Z,
+							Side.PlaneP3.X, Side.PlaneP3.Y, Side.PlaneP3.Z);
+						SideNode.AddProperty(TEXT("plane"), PlaneStr);
+						SideNode.AddProperty(TEXT("material"), Side.Material);
+
+						if (!Side.UAxisStr.IsEmpty())
+						{
+							SideNode.AddProperty(TEXT("uaxis"), Side.UAxisStr);
+						}
+						if (!Side.VAxisStr.IsEmpty())
+						{
+							SideNode.AddProperty(TEXT("vaxis"), Side.VAxisStr);
+						}
+
+						SideNode.AddProperty(TEXT("rotation"), 0);
+						SideNode.AddProperty(TEXT("lightmapscale"), FString::FromInt(Side.LightmapScale));
+						SideNode.AddProperty(TEXT("smoothing_groups"), 0);
+
+						SolidNode.Children.Add(MoveTemp(SideNode));
+					}
+
+					Solids.Add(MoveTemp(SolidNode));
 				}
-				if (!Side.VAxisStr.IsEmpty())
-				{
-					SideNode.AddProperty(TEXT("vaxis"), Side.VAxisStr);
-				}
-
-				SideNode.AddProperty(TEXT("rotation"), 0);
-				SideNode.AddProperty(TEXT("lightmapscale"), FString::FromInt(Side.LightmapScale));
-				SideNode.AddProperty(TEXT("smoothing_groups"), 0);
 
-				SolidNode.Children.Add(MoveTemp(SideNode));
+				Entry.SolidCount = Solids.Num();
+				return Solids;
+			});
 
-				if (!Side.Material.IsEmpty())
-				{
-					WorldspawnMaterialPaths.Add(Side.Material);
-				}
-			}
-
-			WorldNode.Children.Add(MoveTemp(SolidNode));
-			BrushCount++;
-			WorldspawnBrushCount++;
-		}
+		BrushCount += Emitted.SolidCount;
+		WorldspawnBrushCount += Emitted.SolidCount;
 	}
 
 	if (WorldspawnBrushCount > 0)
@@ -298,29 +610,30 @@ FString FVMFExporter::ExportScene(UWorld* World, const FString& MapName, TSet<FS
 
 	// Add hint/skip brushes to worldspawn (visibility optimization)
 	TArray<FVMFKeyValues> HintBrushes = FVisOptimizer::ExportHintBrushes(
-		World, SolidIdCounter, SideIdCounter);
-	for (FVMFKeyValues& HintBrush : HintBrushes)
+		World, Ids[EVMFIdCounter::Solid], Ids[EVMFIdCounter::Side]);
+	for (const FVMFKeyValues& HintBrush : HintBrushes)
 	{
-		WorldNode.Children.Add(MoveTemp(HintBrush));
+		WorldSolidsText += HintBrush.Serialize(1);
 	}
 
 	// Add skybox shell brushes to worldspawn
-	for (FVMFKeyValues& SkyBrush : SkyData.SkyboxBrushes)
+	for (const FVMFKeyValues& SkyBrush : SkyData.SkyboxBrushes)
 	{
-		WorldNode.Children.Add(MoveTemp(SkyBrush));
+		WorldSolidsText += SkyBrush.Serialize(1);
 	}
 
-	Result += WorldNode.Serialize();
+	// Splice the solids into the world block before its closing brace
+	FString WorldText = WorldNode.Serialize();
+	WorldText.LeftChopInline(2);
+	Result += WorldText;
+	Result += WorldSolidsText;
+	Result += TEXT("}\n");
 
 	// Entity IDs continue after solid IDs
-	EntityIdCounter = SolidIdCounter;
+	Ids[EVMFIdCounter::Entity] = Ids[EVMFIdCounter::Solid] + BrushEntityCount;
 
 	// Write brush entities (func_detail, func_wall, func_door, etc.)
-	for (FVMFKeyValues& BrushEntity : BrushEntities)
-	{
-		Result += BrushEntity.Serialize();
-		EntityIdCounter++;
-	}
+	Result += BrushEntitiesText;
 
 	// Write point entities (spawns, lights, etc.) - skip brush entities handled separately
 	for (const FSourceEntity& Entity : EntityResult.Entities)
@@ -329,7 +642,17 @@ FString FVMFExporter::ExportScene(UWorld* World, const FString& MapName, TSet<FS
 		{
 			continue; // Handled by ExportBrushEntities below
 		}
-		Result += FEntityExporter::EntityToVMF(Entity, EntityIdCounter++).Serialize();
+
+		FVMFFingerprint Fp(TEXT("entity"));
+		FingerprintEntity(Fp, Entity);
+
+		EmitCachedBlocks(Fp.Get(), 0, EVMFIdCounter::Entity, Ids, Result,
+			[&Entity](FVMFIdCounters& BlockIds, FVMFExportCache::FEntry& Entry)
+			{
+				TArray<FVMFKeyValues> Blocks;
+				Blocks.Add(FEntityExporter::EntityToVMF(Entity, BlockIds[EVMFIdCounter::Entity]++));
+				return Blocks;
+			});
 	}
 
 	// Write sky_camera entity if present
@@ -340,20 +663,23 @@ FString FVMFExporter::ExportScene(UWorld* World, const FString& MapName, TSet<FS
 
 	// Export static mesh actors as prop entities
 	TArray<FVMFKeyValues> PropEntities = FPropExporter::ExportProps(
-		World, EntityIdCounter);
+		World, Ids[EVMFIdCounter::Entity]);
 	for (const FVMFKeyValues& PropEntity : PropEntities)
 	{
 		Result += PropEntity.Serialize();
 	}
 
 	// Export brush entities (triggers, water volumes) with solid geometry
-	ExportBrushEntities(EntityResult.Entities, EntityIdCounter, SolidIdCounter, SideIdCounter, MatMapper, Result);
+	ExportBrushEntities(EntityResult.Entities, Ids, MatMapper, MaterialMemo, Result);
 
 	Result += BuildCameras().Serialize();
 	Result += BuildCordon().Serialize();
 
 	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Exported %d brushes (%d from meshes, %d skipped), %d brush entities, %d entities, %d props to VMF."),
-		BrushCount, MeshBrushCount, SkippedCount, BrushEntities.Num(), EntityResult.Entities.Num(), PropEntities.Num());
+		BrushCount, MeshBrushCount, SkippedCount, BrushEntityCount, EntityResult.Entities.Num(), PropEntities.Num());
+
+	FVMFExportCache::EndExport();
+	FVMFPlaneTable::EndExport();
 
 	// Return the set of all Source material paths used in this export
 	if (OutUsedMaterials)
@@ -608,10 +934,9 @@ FVMFKeyValues FVMFExporter::BuildCordon()
 
 void FVMFExporter::ExportBrushEntities(
 	const TArray<FSourceEntity>& Entities,
-	int32& EntityIdCounter,
-	int32& SolidIdCounter,
-	int32& SideIdCounter,
+	FVMFIdCounters& Ids,
 	const FMaterialMapper& MatMapper,
+	FVMFMaterialMemo& MaterialMemo,
 	FString& Result)
 {
 	for (const FSourceEntity& Entity : Entities)
@@ -633,7 +958,7 @@ void FVMFExporter::ExportBrushEntities(
 		ASourceBrushEntity* SourceBrush = Cast<ASourceBrushEntity>(Actor);
 		if (SourceBrush && SourceBrush->StoredBrushData.Num() > 0)
 		{
-			Result += FEntityExporter::BrushEntityToVMF(Entity, EntityIdCounter++, SourceBrush).Serialize();
+			Result += FEntityExporter::BrushEntityToVMF(Entity, Ids[EVMFIdCounter::Entity]++, SourceBrush).Serialize();
 			continue;
 		}
 
@@ -641,7 +966,7 @@ void FVMFExporter::ExportBrushEntities(
 		if (!BrushActor)
 		{
 			// Non-brush actor tagged as brush entity — fallback to point entity
-			Result += FEntityExporter::EntityToVMF(Entity, EntityIdCounter++).Serialize();
+			Result += FEntityExporter::EntityToVMF(Entity, Ids[EVMFIdCounter::Entity]++).Serialize();
 			continue;
 		}
 
@@ -664,54 +989,68 @@ void FVMFExporter::ExportBrushEntities(
 			DefaultMaterial = TEXT("DEV/DEV_MEASUREWALL01A");
 		}
 
-		// Convert UE brush geometry to VMF solids
-		FBrushConversionResult ConvResult = FBrushConverter::ConvertBrush(
-			BrushActor, SolidIdCounter, SideIdCounter, &MatMapper,
-			DefaultMaterial);
+		FVMFFingerprint Fp(TEXT("brushentity"));
+		FingerprintEntity(Fp, Entity);
+		FingerprintBrush(Fp, BrushActor, MaterialMemo);
+		Fp.Add(DefaultMaterial);
 
-		if (ConvResult.Solids.Num() == 0)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("SourceBridge: Brush entity '%s' (%s) has no convertible geometry, exporting as point entity."),
-				*Entity.TargetName, *Entity.ClassName);
-			Result += FEntityExporter::EntityToVMF(Entity, EntityIdCounter++).Serialize();
-			continue;
-		}
+		EmitCachedBlocks(Fp.Get(), 0, EVMFIdCounter::Entity, Ids, Result,
+			[&](FVMFIdCounters& BlockIds, FVMFExportCache::FEntry& Entry)
+			{
+				TArray<FVMFKeyValues> Blocks;
 
-		// Build the brush entity with embedded solids
-		FVMFKeyValues BrushEntity(TEXT("entity"));
-		BrushEntity.AddProperty(TEXT("id"), EntityIdCounter++);
-		BrushEntity.AddProperty(TEXT("classname"), Entity.ClassName);
+				// Convert UE brush geometry to VMF solids
+				FBrushConversionResult ConvResult = FBrushConverter::ConvertBrush(
+					BrushActor, BlockIds[EVMFIdCounter::Solid], BlockIds[EVMFIdCounter::Side], &MatMapper,
+					DefaultMaterial);
 
-		if (!Entity.TargetName.IsEmpty())
-		{
-			BrushEntity.AddProperty(TEXT("targetname"), Entity.TargetName);
-		}
+				if (ConvResult.Solids.Num() == 0)
+				{
+					Entry.Warnings.Add(FString::Printf(TEXT("Brush entity '%s' (%s) has no convertible geometry, exporting as point entity."),
+						*Entity.TargetName, *Entity.ClassName));
+					Blocks.Add(FEntityExporter::EntityToVMF(Entity, BlockIds[EVMFIdCounter::Entity]++));
+					return Blocks;
+				}
 
-		// Key-values (skip internal markers like _water_material)
-		for (const auto& KV : Entity.KeyValues)
-		{
-			if (!KV.Key.StartsWith(TEXT("_")))
-			{
-				BrushEntity.AddProperty(KV.Key, KV.Value);
-			}
-		}
+				// Build the brush entity with embedded solids
+				FVMFKeyValues BrushEntity(TEXT("entity"));
+				BrushEntity.AddProperty(TEXT("id"), BlockIds[EVMFIdCounter::Entity]++);
+				BrushEntity.AddProperty(TEXT("classname"), Entity.ClassName);
 
-		// I/O connections
-		if (Entity.Connections.Num() > 0)
-		{
-			FVMFKeyValues& ConnBlock = BrushEntity.AddChild(TEXT("connections"));
-			for (const FEntityIOConnection& Conn : Entity.Connections)
-			{
-				ConnBlock.AddProperty(Conn.OutputName, Conn.FormatValue());
-			}
-		}
+				if (!Entity.TargetName.IsEmpty())
+				{
+					BrushEntity.AddProperty(TEXT("targetname"), Entity.TargetName);
+				}
 
-		// Embed solid geometry
-		for (FVMFKeyValues& Solid : ConvResult.Solids)
-		{
-			BrushEntity.Children.Add(MoveTemp(Solid));
-		}
+				// Key-values (skip internal markers like _water_material)
+				for (const auto& KV : Entity.KeyValues)
+				{
+					if (!KV.Key.StartsWith(TEXT("_")))
+					{
+						BrushEntity.AddProperty(KV.Key, KV.Value);
+					}
+				}
+
+				// I/O connections
+				if (Entity.Connections.Num() > 0)
+				{
+					FVMFKeyValues& ConnBlock = BrushEntity.AddChild(TEXT("connections"));
+					for (const FEntityIOConnection& Conn : Entity.Connections)
+					{
+						ConnBlock.AddProperty(Conn.OutputName, Conn.FormatValue());
+					}
+				}
+
+				// Embed solid geometry
+				Entry.SolidCount = ConvResult.Solids.Num();
+				Entry.Planes = MoveTemp(ConvResult.Planes);
+				for (FVMFKeyValues& Solid : ConvResult.Solids)
+				{
+					BrushEntity.Children.Add(MoveTemp(Solid));
+				}
 
-		Result += BrushEntity.Serialize();
+				Blocks.Add(MoveTemp(BrushEntity));
+				return Blocks;
+			});
 	}
 }
@@ -0,0 +1,328 @@
+#include "VMF/VMFPlaneTable.h"
+#include "UI/SourceBridgeSettings.h"
+
+FVMFPlaneSet FVMFPlaneTable::RawPlanes;
+FVMFPlaneSet FVMFPlaneTable::WrittenPlanes;
+FVMFPlaneStats FVMFPlaneTable::Stats;
+bool FVMFPlaneTable::bEnabled = true;
+
+// vbsp's plane hash bucket width
+static const double PLANE_HASH_SIZE = 8.0;
+
+// How far (in plane units along each axis) a sloped plane's corner is searched for an
+// integer point that lies on the plane
+static const int32 MAX_POINT_SEARCH = 12;
+
+// ---- FVMFPlaneSet ----
+
+void FVMFPlaneSet::Snap(FVector3d& Normal, double& Dist) const
+{
+	for (int32 i = 0; i < 3; ++i)
+	{
+		if (FMath::Abs(FMath::Abs(Normal[i]) - 1.0) < NormalEpsilon)
+		{
+			const double Sign = Normal[i] > 0.0 ? 1.0 : -1.0;
+			Normal = FVector3d::ZeroVector;
+			Normal[i] = Sign;
+			break;
+		}
+	}
+
+	const double Rounded = FMath::RoundToDouble(Dist);
+	if (FMath::Abs(Dist - Rounded) < DistEpsilon)
+	{
+		Dist = Rounded;
+	}
+}
+
+int32 FVMFPlaneSet::Find(const FVector3d& Normal, double Dist) const
+{
+	const int32 Bucket = (int32)(FMath::Abs(Dist) / PLANE_HASH_SIZE);
+	for (int32 Offset = -1; Offset <= 1; ++Offset)
+	{
+		const TArray<int32>* Candidates = Buckets.Find(Bucket + Offset);
+		if (!Candidates)
+		{
+			continue;
+		}
+
+		for (int32 Index : *Candidates)
+		{
+			const FVector3d& Other = Normals[Index];
+			if (FMath::Abs(Other.X - Normal.X) < NormalEpsilon
+				&& FMath::Abs(Other.Y - Normal.Y) < NormalEpsilon
+				&& FMath::Abs(Other.Z - Normal.Z) < NormalEpsilon
+				&& FMath::Abs(Dists[Index] - Dist) < DistEpsilon)
+			{
+				return Index;
+			}
+		}
+	}
+	return INDEX_NONE;
+}
+
+int32 FVMFPlaneSet::FindOrAdd(const FVector3d& Normal, double Dist)
+{
+	const int32 Existing = Find(Normal, Dist);
+	if (Existing != INDEX_NONE)
+	{
+		return Existing;
+	}
+
+	const int32 Bucket = (int32)(FMath::Abs(Dist) / PLANE_HASH_SIZE);
+	const int32 Index = Normals.Add(Normal);
+	Dists.Add(Dist);
+	Normals.Add(-Normal);
+	Dists.Add(-Dist);
+
+	TArray<int32>& Entries = Buckets.FindOrAdd(Bucket);
+	Entries.Add(Index);
+	Entries.Add(Index + 1);
+	return Index;
+}
+
+void FVMFPlaneSet::Reset()
+{
+	Normals.Reset();
+	Dists.Reset();
+	Buckets.Reset();
+}
+
+// ---- FVMFPlaneTable ----
+
+namespace
+{
+	/** Newell's normal of a polygon (follows the winding; zero if degenerate). */
+	FVector3d PolygonNormal(const TArray<FVector>& Vertices)
+	{
+		FVector3d Normal = FVector3d::ZeroVector;
+		for (int32 i = 0; i < Vertices.Num(); ++i)
+		{
+			const FVector3d A = Vertices[i];
+			const FVector3d B = Vertices[(i + 1) % Vertices.Num()];
+			Normal.X += (A.Y - B.Y) * (A.Z + B.Z);
+			Normal.Y += (A.Z - B.Z) * (A.X + B.X);
+			Normal.Z += (A.X - B.X) * (A.Y + B.Y);
+		}
+		return Normal.GetSafeNormal();
+	}
+
+	double AverageDist(const FVector3d& Normal, const TArray<FVector>& Vertices)
+	{
+		double Dist = 0.0;
+		for (const FVector& Vertex : Vertices)
+		{
+			Dist += FVector3d::DotProduct(Normal, FVector3d(Vertex));
+		}
+		return Dist / Vertices.Num();
+	}
+
+	FVector3d RoundPoint(const FVector3d& Point)
+	{
+		return FVector3d(FMath::RoundToDouble(Point.X), FMath::RoundToDouble(Point.Y), FMath::RoundToDouble(Point.Z));
+	}
+
+	/** The plane vbsp parses from three side points (PlaneFromPoints). */
+	void PlaneFromPoints(const FVector3d Points[3], FVector3d& OutNormal, double& OutDist)
+	{
+		OutNormal = FVector3d::CrossProduct(Points[0] - Points[1], Points[2] - Points[1]).GetSafeNormal();
+		OutDist = FVector3d::DotProduct(Points[0], OutNormal);
+	}
+
+	/** (P2-P1)x(P3-P1) of the points matches Normal within vbsp's per-component normal epsilon. */
+	bool PointsMatchNormal(const FVector3d Points[3], const FVector3d& Normal)
+	{
+		const FVector3d Cross = FVector3d::CrossProduct(Points[1] - Points[0], Points[2] - Points[0]).GetSafeNormal();
+		return FMath::Abs(Cross.X - Normal.X) < FVMFPlaneSet::VBSPNormalEpsilon
+			&& FMath::Abs(Cross.Y - Normal.Y) < FVMFPlaneSet::VBSPNormalEpsilon
+			&& FMath::Abs(Cross.Z - Normal.Z) < FVMFPlaneSet::VBSPNormalEpsilon;
+	}
+
+	/**
+	 * The integer point nearest Corner (searched along the plane axes U and V) that lies
+	 * within vbsp's DIST_EPSILON of the plane. False if there is none close by.
+	 */
+	bool FindPointOnPlane(const FVector3d& Normal, double Dist, const FVector3d& Corner,
+		const FVector3d& U, const FVector3d& V, FVector3d& OutPoint)
+	{
+		int32 BestRadius = MAX_int32;
+		for (int32 i = -MAX_POINT_SEARCH; i <= MAX_POINT_SEARCH; ++i)
+		{
+			for (int32 j = -MAX_POINT_SEARCH; j <= MAX_POINT_SEARCH; ++j)
+			{
+				const int32 Radius = i * i + j * j;
+				if (Radius >= BestRadius)
+				{
+					continue;
+				}
+
+				const FVector3d Point = RoundPoint(Corner + U * i + V * j);
+				if (FMath::Abs(FVector3d::DotProduct(Normal, Point) - Dist) <= FVMFPlaneSet::VBSPDistEpsilon)
+				{
+					BestRadius = Radius;
+					OutPoint = Point;
+				}
+			}
+		}
+		return BestRadius != MAX_int32;
+	}
+
+	/**
+	 * Three integer points on the plane (Normal, Dist), with (P2-P1)x(P3-P1) along Normal.
+	 * They depend on the plane alone, so every face on it gets the same points whatever
+	 * else is in the export. Axial planes get a square corner on the axis; sloped planes a
+	 * triangle around the plane's point nearest the origin, each corner moved to an integer
+	 * point within DIST_EPSILON of the plane, grown until the points give vbsp the same
+	 * normal. Fails (keep the raw points) if no such points are found.
+	 */
+	bool MakePlanePoints(const FVector3d& Normal, double Dist, FVector3d OutPoints[3])
+	{
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			if (FMath::Abs(Normal[Axis]) != 1.0)
+			{
+				continue;
+			}
+
+			const int32 U = (Axis + 1) % 3;
+			const int32 V = (Axis + 2) % 3;
+			FVector3d Corner = FVector3d::ZeroVector;
+			Corner[Axis] = Dist * Normal[Axis];
+
+			OutPoints[0] = Corner;
+			OutPoints[1] = Corner;
+			OutPoints[2] = Corner;
+			OutPoints[1][U] += PointSpan;
+			OutPoints[2][V] += PointSpan;
+			if (Normal[Axis] < 0.0)
+			{
+				Swap(OutPoints[1], OutPoints[2]);
+			}
+			return true;
+		}
+
+		// Plane axes fixed by the normal; U x V = Normal
+		int32 MinAxis = 0;
+		for (int32 Axis = 1; Axis < 3; ++Axis)
+		{
+			if (FMath::Abs(Normal[Axis]) < FMath::Abs(Normal[MinAxis]))
+			{
+				MinAxis = Axis;
+			}
+		}
+		FVector3d Fixed = FVector3d::ZeroVector;
+		Fixed[MinAxis] = 1.0;
+		const FVector3d U = FVector3d::CrossProduct(Normal, Fixed).GetSafeNormal();
+		const FVector3d V = FVector3d::CrossProduct(Normal, U);
+		const FVector3d Origin = Normal * Dist;
+
+		// Off-plane error of the corners tilts the normal less the wider they are apart
+		for (double Span : { PointSpan * 4.0, PointSpan * 16.0, PointSpan * 32.0 })
+		{
+			if (FindPointOnPlane(Normal, Dist, Origin, U, V, OutPoints[0])
+				&& FindPointOnPlane(Normal, Dist, Origin + U * Span, U, V, OutPoints[1])
+				&& FindPointOnPlane(Normal, Dist, Origin + V * Span, U, V, OutPoints[2])
+				&& PointsMatchNormal(OutPoints, Normal))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	FString FormatPlanePoints(const FVector3d& P1, const FVector3d& P2, const FVector3d& P3)
+	{
+		return FString::Printf(TEXT("(%g %g %g) (%g %g %g) (%g %g %g)"),
+			P1.X, P1.Y, P1.Z, P2.X, P2.Y, P2.Z, P3.X, P3.Y, P3.Z);
+	}
+}
+
+void FVMFPlaneTable::BeginExport()
+{
+	USourceBridgeSettings* Settings = USourceBridgeSettings::Get();
+	bEnabled = !Settings || Settings->bCanonicalizePlanes;
+
+	RawPlanes.Reset();
+	WrittenPlanes.Reset();
+	Stats = FVMFPlaneStats();
+}
+
+void FVMFPlaneTable::EndExport()
+{
+	if (!bEnabled || Stats.Sides == 0)
+	{
+		return;
+	}
+
+	Stats.RawPlanes = RawPlanes.Num();
+	Stats.CanonicalPlanes = WrittenPlanes.Num();
+
+	const double Saved = Stats.RawPlanes > 0 ? 100.0 * (Stats.RawPlanes - Stats.CanonicalPlanes) / Stats.RawPlanes : 0.0;
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: %d brush sides on %d planes (%d before canonicalization, %.0f%% fewer)."),
+		Stats.Sides, Stats.CanonicalPlanes, Stats.RawPlanes, Saved);
+}
+
+FString FVMFPlaneTable::GetPlaneString(const TArray<FVector>& Vertices, const FVector (&RawPoints)[3],
+	TArray<FVMFPlaneUse>& OutUses)
+{
+	const FVector3d Raw[3] = { RawPoints[0], RawPoints[1], RawPoints[2] };
+	const FString RawString = FormatPlanePoints(Raw[0], Raw[1], Raw[2]);
+
+	FVMFPlaneUse& Use = OutUses.AddDefaulted_GetRef();
+	PlaneFromPoints(Raw, Use.RawNormal, Use.RawDist);
+	RawPlanes.Snap(Use.RawNormal, Use.RawDist);
+	Use.Normal = Use.RawNormal;
+	Use.Dist = Use.RawDist;
+
+	// The face's own plane, oriented like the raw points
+	const FVector3d Inward = FVector3d::CrossProduct(Raw[1] - Raw[0], Raw[2] - Raw[0]);
+	FVector3d Normal = PolygonNormal(Vertices);
+	if (Vertices.Num() < 3 || Normal.IsZero() || Inward.IsNearlyZero())
+	{
+		return RawString;
+	}
+	if (FVector3d::DotProduct(Normal, Inward) < 0.0)
+	{
+		Normal = -Normal;
+	}
+
+	// Snapped like vbsp would: the normal first, then the distance along it
+	double Dist = AverageDist(Normal, Vertices);
+	WrittenPlanes.Snap(Normal, Dist);
+	Dist = AverageDist(Normal, Vertices);
+	WrittenPlanes.Snap(Normal, Dist);
+	if (Dist != FMath::RoundToDouble(Dist))
+	{
+		return RawString;
+	}
+
+	// Every vertex must already lie on the canonical plane
+	for (const FVector& Vertex : Vertices)
+	{
+		if (FMath::Abs(FVector3d::DotProduct(Normal, FVector3d(Vertex)) - Dist) > DistTolerance)
+		{
+			return RawString;
+		}
+	}
+
+	FVector3d Points[3];
+	if (!MakePlanePoints(Normal, Dist, Points))
+	{
+		return RawString;
+	}
+
+	Use.bCanonical = true;
+	PlaneFromPoints(Points, Use.Normal, Use.Dist);
+	WrittenPlanes.Snap(Use.Normal, Use.Dist);
+	return FormatPlanePoints(Points[0], Points[1], Points[2]);
+}
+
+void FVMFPlaneTable::Record(const TArray<FVMFPlaneUse>& Uses)
+{
+	for (const FVMFPlaneUse& Use : Uses)
+	{
+		Stats.Sides++;
+		RawPlanes.FindOrAdd(Use.RawNormal, Use.RawDist);
+		WrittenPlanes.FindOrAdd(Use.Normal, Use.Dist);
+	}
+}
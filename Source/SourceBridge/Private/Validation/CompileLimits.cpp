@@ -0,0 +1,697 @@
+#include "Validation/CompileLimits.h"
+#include "VMF/VMFKeyValues.h"
+#include "VMF/VMFPlaneTable.h"
+#include "Import/VMFImporter.h"
+#include "Async/ParallelFor.h"
+
+// vbsp's plane comparison and snapping tolerances (map.cpp)
+static const double NORMAL_EPSILON = FVMFPlaneSet::VBSPNormalEpsilon;
+static const double DIST_EPSILON = FVMFPlaneSet::VBSPDistEpsilon;
+
+// Half-size of the base winding each side's polygon is clipped from
+static const double BASE_WINDING_SIZE = 65536.0;
+
+// Space vbsp leaves around the world for the head node's portal planes (portals.cpp)
+static const double SIDESPACE = 8.0;
+
+namespace
+{
+	struct FEstimatePlane
+	{
+		FVector3d Normal = FVector3d::ZeroVector;
+		double Dist = 0.0;
+
+		bool Equals(const FVector3d& OtherNormal, double OtherDist) const
+		{
+			return FMath::Abs(Normal.X - OtherNormal.X) < NORMAL_EPSILON
+				&& FMath::Abs(Normal.Y - OtherNormal.Y) < NORMAL_EPSILON
+				&& FMath::Abs(Normal.Z - OtherNormal.Z) < NORMAL_EPSILON
+				&& FMath::Abs(Dist - OtherDist) < DIST_EPSILON;
+		}
+	};
+
+	/** texinfo_t without flags: texdata plus the texture and lightmap vectors, as floats */
+	struct FTexInfoKey
+	{
+		int32 TexData = 0;
+		float Vecs[4][4] = {};
+
+		bool operator==(const FTexInfoKey& Other) const
+		{
+			if (TexData != Other.TexData) return false;
+			for (int32 i = 0; i < 4; ++i)
+			{
+				for (int32 j = 0; j < 4; ++j)
+				{
+					if (Vecs[i][j] != Other.Vecs[i][j]) return false;
+				}
+			}
+			return true;
+		}
+
+		friend uint32 GetTypeHash(const FTexInfoKey& Key)
+		{
+			uint32 Hash = ::GetTypeHash(Key.TexData);
+			for (int32 i = 0; i < 4; ++i)
+			{
+				for (int32 j = 0; j < 4; ++j)
+				{
+					// -0 and 0 compare equal, so they must hash alike
+					const float Value = Key.Vecs[i][j] == 0.0f ? 0.0f : Key.Vecs[i][j];
+					Hash = HashCombine(Hash, ::GetTypeHash(Value));
+				}
+			}
+			return Hash;
+		}
+	};
+
+	struct FEstimateSide
+	{
+		FString Material;
+		FString UAxis;
+		FString VAxis;
+		int32 LightmapScale = 16;
+	};
+
+	/** A solid queued for the parallel pass */
+	struct FEstimateSolid
+	{
+		const FVMFKeyValues* Block = nullptr;
+		FVector3d Origin = FVector3d::ZeroVector;
+		bool bWorld = false;
+	};
+
+	/** What vbsp's ParseBrush produces for one solid */
+	struct FSolidResult
+	{
+		/** Origin brushes only set their entity's origin */
+		bool bKeep = false;
+
+		/** Planes in the order vbsp looks them up: sides, then bevels, then origin-offset copies */
+		TArray<FEstimatePlane> Planes;
+		int32 OriginalSides = 0;
+		int32 BevelSides = 0;
+
+		/** Material and texture vectors per original side (origin-offset ones appended) */
+		TArray<FEstimateSide> Sides;
+		TArray<FVector3d> TexOrigins;
+
+		FBox3d Bounds = FBox3d(ForceInit);
+	};
+
+	const FString* FindProperty(const FVMFKeyValues& Block, const TCHAR* Key)
+	{
+		for (const TPair<FString, FString>& Prop : Block.Properties)
+		{
+			if (Prop.Key.Equals(Key, ESearchCase::IgnoreCase))
+			{
+				return &Prop.Value;
+			}
+		}
+		return nullptr;
+	}
+
+	/** "(x y z) (x y z) (x y z)" */
+	bool ParsePlanePoints(const FString& Text, FVector3d OutPoints[3])
+	{
+		FString Clean = Text.Replace(TEXT("("), TEXT(" ")).Replace(TEXT(")"), TEXT(" "));
+		TArray<FString> Parts;
+		Clean.ParseIntoArrayWS(Parts);
+		if (Parts.Num() != 9)
+		{
+			return false;
+		}
+		for (int32 i = 0; i < 3; ++i)
+		{
+			OutPoints[i] = FVector3d(
+				FCString::Atod(*Parts[i * 3]),
+				FCString::Atod(*Parts[i * 3 + 1]),
+				FCString::Atod(*Parts[i * 3 + 2]));
+		}
+		return true;
+	}
+
+	/** vbsp's SnapVector: a normal within epsilon of an axis becomes that axis */
+	void SnapVector(FVector3d& Normal)
+	{
+		for (int32 i = 0; i < 3; ++i)
+		{
+			if (FMath::Abs(Normal[i] - 1.0) < NORMAL_EPSILON)
+			{
+				Normal = FVector3d::ZeroVector;
+				Normal[i] = 1.0;
+				break;
+			}
+			if (FMath::Abs(Normal[i] + 1.0) < NORMAL_EPSILON)
+			{
+				Normal = FVector3d::ZeroVector;
+				Normal[i] = -1.0;
+				break;
+			}
+		}
+	}
+
+	/** vbsp's SnapPlane: axial normal, and integer distance when within DIST_EPSILON */
+	FEstimatePlane SnapPlane(FVector3d Normal, double Dist)
+	{
+		SnapVector(Normal);
+		const double Rounded = FMath::RoundToDouble(Dist);
+		if (FMath::Abs(Dist - Rounded) < DIST_EPSILON)
+		{
+			Dist = Rounded;
+		}
+		FEstimatePlane Plane;
+		Plane.Normal = Normal;
+		Plane.Dist = Dist;
+		return Plane;
+	}
+
+	/** vbsp's BaseWindingForPlane: a huge quad on the plane */
+	TArray<FVector3d> BaseWinding(const FEstimatePlane& Plane)
+	{
+		// Up vector along the axis the normal is least aligned with
+		int32 Major = 0;
+		for (int32 i = 1; i < 3; ++i)
+		{
+			if (FMath::Abs(Plane.Normal[i]) > FMath::Abs(Plane.Normal[Major]))
+			{
+				Major = i;
+			}
+		}
+		FVector3d Up = Major == 2 ? FVector3d(1, 0, 0) : FVector3d(0, 0, 1);
+		Up = (Up - Plane.Normal * FVector3d::DotProduct(Up, Plane.Normal)).GetSafeNormal();
+		const FVector3d Right = FVector3d::CrossProduct(Up, Plane.Normal) * BASE_WINDING_SIZE;
+		Up *= BASE_WINDING_SIZE;
+
+		const FVector3d Center = Plane.Normal * Plane.Dist;
+		return { Center - Right + Up, Center + Right + Up, Center + Right - Up, Center - Right - Up };
+	}
+
+	/** Keep the part of Winding behind Plane (vbsp's ChopWindingInPlace with epsilon 0) */
+	void ChopWinding(TArray<FVector3d>& Winding, const FEstimatePlane& Plane)
+	{
+		TArray<double, TInlineAllocator<16>> Dists;
+		bool bAnyFront = false;
+		bool bAnyBack = false;
+		for (const FVector3d& Point : Winding)
+		{
+			const double D = FVector3d::DotProduct(Point, Plane.Normal) - Plane.Dist;
+			Dists.Add(D);
+			bAnyFront |= D > 0.0;
+			bAnyBack |= D < 0.0;
+		}
+		if (!bAnyFront)
+		{
+			return;
+		}
+		if (!bAnyBack)
+		{
+			Winding.Reset();
+			return;
+		}
+
+		TArray<FVector3d> Clipped;
+		for (int32 i = 0; i < Winding.Num(); ++i)
+		{
+			const int32 Next = (i + 1) % Winding.Num();
+			if (Dists[i] <= 0.0)
+			{
+				Clipped.Add(Winding[i]);
+			}
+			if ((Dists[i] < 0.0 && Dists[Next] > 0.0) || (Dists[i] > 0.0 && Dists[Next] < 0.0))
+			{
+				const double T = Dists[i] / (Dists[i] - Dists[Next]);
+				Clipped.Add(Winding[i] + (Winding[Next] - Winding[i]) * T);
+			}
+		}
+		Winding = MoveTemp(Clipped);
+	}
+
+	bool HasPlane(const TArray<FEstimatePlane>& Planes, const FVector3d& Normal, double Dist)
+	{
+		for (const FEstimatePlane& Plane : Planes)
+		{
+			if (Plane.Equals(Normal, Dist))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/** ParseBrush: side planes, windings, then AddBrushBevels */
+	void ProcessSolid(const FEstimateSolid& Solid, FSolidResult& Out)
+	{
+		bool bOriginBrush = false;
+		for (const FVMFKeyValues& Side : Solid.Block->Children)
+		{
+			if (!Side.ClassName.Equals(TEXT("side"), ESearchCase::IgnoreCase))
+			{
+				continue;
+			}
+
+			const FString* PlaneText = FindProperty(Side, TEXT("plane"));
+			FVector3d Points[3];
+			if (!PlaneText || !ParsePlanePoints(*PlaneText, Points))
+			{
+				continue;
+			}
+
+			// PlaneFromPoints: normal = (p0 - p1) x (p2 - p1), dist from p0
+			FVector3d Normal = FVector3d::CrossProduct(Points[0] - Points[1], Points[2] - Points[1]);
+			if (!Normal.Normalize())
+			{
+				continue;
+			}
+			const FEstimatePlane Plane = SnapPlane(Normal, FVector3d::DotProduct(Points[0], Normal));
+
+			// Duplicate and mirrored planes are dropped with a warning
+			if (HasPlane(Out.Planes, Plane.Normal, Plane.Dist) || HasPlane(Out.Planes, -Plane.Normal, -Plane.Dist))
+			{
+				continue;
+			}
+			Out.Planes.Add(Plane);
+
+			FEstimateSide& SideData = Out.Sides.AddDefaulted_GetRef();
+			if (const FString* Material = FindProperty(Side, TEXT("material")))
+			{
+				SideData.Material = Material->ToLower().Replace(TEXT("\\"), TEXT("/"));
+				bOriginBrush |= SideData.Material == TEXT("tools/toolsorigin");
+			}
+			if (const FString* UAxis = FindProperty(Side, TEXT("uaxis"))) SideData.UAxis = *UAxis;
+			if (const FString* VAxis = FindProperty(Side, TEXT("vaxis"))) SideData.VAxis = *VAxis;
+			if (const FString* Scale = FindProperty(Side, TEXT("lightmapscale"))) SideData.LightmapScale = FCString::Atoi(**Scale);
+		}
+		Out.OriginalSides = Out.Planes.Num();
+		Out.TexOrigins.Init(FVector3d::ZeroVector, Out.Sides.Num());
+
+		// MakeBrushWindings
+		TArray<TArray<FVector3d>> Windings;
+		Windings.SetNum(Out.OriginalSides);
+		for (int32 i = 0; i < Out.OriginalSides; ++i)
+		{
+			Windings[i] = BaseWinding(Out.Planes[i]);
+			for (int32 j = 0; j < Out.OriginalSides && Windings[i].Num() > 0; ++j)
+			{
+				if (i != j)
+				{
+					ChopWinding(Windings[i], Out.Planes[j]);
+				}
+			}
+			for (const FVector3d& Point : Windings[i])
+			{
+				Out.Bounds += Point;
+			}
+		}
+
+		if (bOriginBrush || !Out.Bounds.IsValid)
+		{
+			// Origin brushes are removed once their planes exist
+			Out.bKeep = false;
+			return;
+		}
+		Out.bKeep = true;
+
+		// Axial bevels: every brush gets a side facing each axis direction
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			for (int32 Dir = -1; Dir <= 1; Dir += 2)
+			{
+				bool bPresent = false;
+				for (const FEstimatePlane& Plane : Out.Planes)
+				{
+					if (Plane.Normal[Axis] == Dir)
+					{
+						bPresent = true;
+						break;
+					}
+				}
+				if (bPresent)
+				{
+					continue;
+				}
+
+				FVector3d Normal = FVector3d::ZeroVector;
+				Normal[Axis] = Dir;
+				Out.Planes.Add(SnapPlane(Normal, Dir == 1 ? Out.Bounds.Max[Axis] : -Out.Bounds.Min[Axis]));
+				Out.BevelSides++;
+			}
+		}
+
+		// Edge bevels along the non-axial edges of non-axial sides
+		if (Out.Planes.Num() > 6)
+		{
+			for (int32 SideIndex = 0; SideIndex < Out.OriginalSides; ++SideIndex)
+			{
+				const FVector3d& SideNormal = Out.Planes[SideIndex].Normal;
+				if (FMath::Abs(SideNormal.X) == 1.0 || FMath::Abs(SideNormal.Y) == 1.0 || FMath::Abs(SideNormal.Z) == 1.0)
+				{
+					continue;
+				}
+
+				const TArray<FVector3d>& Winding = Windings[SideIndex];
+				for (int32 j = 0; j < Winding.Num(); ++j)
+				{
+					FVector3d Edge = Winding[j] - Winding[(j + 1) % Winding.Num()];
+					const double Length = Edge.Length();
+					if (Length < 0.5)
+					{
+						continue;
+					}
+					Edge /= Length;
+					SnapVector(Edge);
+					if (FMath::Abs(Edge.X) == 1.0 || FMath::Abs(Edge.Y) == 1.0 || FMath::Abs(Edge.Z) == 1.0)
+					{
+						continue;
+					}
+
+					for (int32 Axis = 0; Axis < 3; ++Axis)
+					{
+						for (int32 Dir = -1; Dir <= 1; Dir += 2)
+						{
+							FVector3d AxisVec = FVector3d::ZeroVector;
+							AxisVec[Axis] = Dir;
+							FVector3d Normal = FVector3d::CrossProduct(Edge, AxisVec);
+							const double NormalLength = Normal.Length();
+							if (NormalLength < 0.5)
+							{
+								continue;
+							}
+							Normal /= NormalLength;
+							const double Dist = FVector3d::DotProduct(Winding[j], Normal);
+
+							// A proper bevel has every brush point behind it and isn't a side already
+							if (HasPlane(Out.Planes, Normal, Dist))
+							{
+								continue;
+							}
+							bool bOuter = true;
+							for (int32 k = 0; k < Windings.Num() && bOuter; ++k)
+							{
+								for (const FVector3d& Point : Windings[k])
+								{
+									if (FVector3d::DotProduct(Point, Normal) - Dist > 0.1)
+									{
+										bOuter = false;
+										break;
+									}
+								}
+							}
+							if (!bOuter)
+							{
+								continue;
+							}
+
+							Out.Planes.Add(SnapPlane(Normal, Dist));
+							Out.BevelSides++;
+						}
+					}
+				}
+			}
+		}
+
+		// Entities with an origin get every side's plane and texinfo again, offset by it
+		if (!Solid.Origin.IsZero())
+		{
+			const int32 NumSidePlanes = Out.Planes.Num();
+			for (int32 i = 0; i < NumSidePlanes; ++i)
+			{
+				const FEstimatePlane Plane = Out.Planes[i];
+				Out.Planes.Add(SnapPlane(Plane.Normal, Plane.Dist - FVector3d::DotProduct(Plane.Normal, Solid.Origin)));
+			}
+			const int32 NumSides = Out.Sides.Num();
+			for (int32 i = 0; i < NumSides; ++i)
+			{
+				const FEstimateSide Side = Out.Sides[i];
+				Out.Sides.Add(Side);
+				Out.TexOrigins.Add(Solid.Origin);
+			}
+		}
+	}
+
+	/** Entities vbsp folds into other lumps or drops from the entity lump */
+	bool IsRemovedEntity(const FVMFKeyValues& Entity, const FString& ClassName)
+	{
+		static const TCHAR* Removed[] = {
+			TEXT("func_detail"), TEXT("prop_static"), TEXT("prop_detail"), TEXT("info_overlay"),
+			TEXT("info_overlay_transition"), TEXT("env_cubemap"), TEXT("func_viscluster"),
+			TEXT("info_no_dynamic_shadow"), TEXT("func_instance"),
+		};
+		for (const TCHAR* Name : Removed)
+		{
+			if (ClassName.Equals(Name, ESearchCase::IgnoreCase))
+			{
+				return true;
+			}
+		}
+
+		// Lights nothing can switch only matter to vrad
+		if (ClassName.StartsWith(TEXT("light"), ESearchCase::IgnoreCase)
+			&& !ClassName.Equals(TEXT("light_environment"), ESearchCase::IgnoreCase))
+		{
+			const FString* TargetName = FindProperty(Entity, TEXT("targetname"));
+			return !TargetName || TargetName->IsEmpty();
+		}
+		return false;
+	}
+}
+
+// ---- FCompileLimitEstimate ----
+
+TArray<FBSPBudgetEntry> FCompileLimitEstimate::GetEntries() const
+{
+	TArray<FBSPBudgetEntry> Entries;
+	auto Add = [&Entries](const TCHAR* Name, int64 Used, int64 Limit, bool bByteLimit)
+	{
+		FBSPBudgetEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.Name = Name;
+		Entry.Limit = Limit;
+		Entry.bByteLimit = bByteLimit;
+		(bByteLimit ? Entry.Bytes : Entry.Count) = Used;
+	};
+
+	Add(TEXT("brushes"), Brushes, BSPLimits::Brushes, false);
+	Add(TEXT("brushsides"), BrushSides, BSPLimits::BrushSides, false);
+	Add(TEXT("planes"), Planes, BSPLimits::Planes, false);
+	Add(TEXT("texinfo"), TexInfo, BSPLimits::TexInfo, false);
+	Add(TEXT("texdata"), TexData, BSPLimits::TexData, false);
+	Add(TEXT("texdata_string_table"), TexData, BSPLimits::TexDataStringTable, false);
+	Add(TEXT("texdata_string_data"), TexDataStringBytes, BSPLimits::TexDataStringBytes, true);
+	Add(TEXT("entities"), Entities, BSPLimits::Entities, false);
+	Add(TEXT("overlays"), Overlays, BSPLimits::Overlays, false);
+	Add(TEXT("static_props"), StaticProps, BSPLimits::StaticProps, false);
+	return Entries;
+}
+
+// ---- FCompileLimitEstimator ----
+
+FCompileLimitEstimate FCompileLimitEstimator::EstimateVMF(const TArray<FVMFKeyValues>& Blocks)
+{
+	FCompileLimitEstimate Estimate;
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Gather solids in file order (the order vbsp creates planes in) and count entities
+	TArray<FEstimateSolid> Solids;
+	TArray<FString> OverlayMaterials;
+	for (const FVMFKeyValues& Block : Blocks)
+	{
+		const bool bWorld = Block.ClassName.Equals(TEXT("world"), ESearchCase::IgnoreCase);
+		if (!bWorld && !Block.ClassName.Equals(TEXT("entity"), ESearchCase::IgnoreCase))
+		{
+			continue;
+		}
+
+		const FString* ClassNameValue = FindProperty(Block, TEXT("classname"));
+		const FString ClassName = ClassNameValue ? *ClassNameValue : FString();
+
+		if (bWorld || !IsRemovedEntity(Block, ClassName))
+		{
+			Estimate.Entities++;
+		}
+		if (ClassName.Equals(TEXT("prop_static"), ESearchCase::IgnoreCase))
+		{
+			Estimate.StaticProps++;
+		}
+		else if (ClassName.Equals(TEXT("info_overlay"), ESearchCase::IgnoreCase))
+		{
+			Estimate.Overlays++;
+			if (const FString* Material = FindProperty(Block, TEXT("material")))
+			{
+				OverlayMaterials.Add(Material->ToLower().Replace(TEXT("\\"), TEXT("/")));
+			}
+		}
+
+		// Brush entity origins offset their planes and texinfo (func_detail keeps world space)
+		FVector3d Origin = FVector3d::ZeroVector;
+		if (!bWorld)
+		{
+			if (const FString* OriginText = FindProperty(Block, TEXT("origin")))
+			{
+				TArray<FString> Parts;
+				OriginText->ParseIntoArrayWS(Parts);
+				if (Parts.Num() == 3)
+				{
+					Origin = FVector3d(FCString::Atod(*Parts[0]), FCString::Atod(*Parts[1]), FCString::Atod(*Parts[2]));
+				}
+			}
+		}
+
+		const bool bWorldBrushes = bWorld || ClassName.Equals(TEXT("func_detail"), ESearchCase::IgnoreCase);
+		for (const FVMFKeyValues& Child : Block.Children)
+		{
+			if (Child.ClassName.Equals(TEXT("solid"), ESearchCase::IgnoreCase))
+			{
+				FEstimateSolid& Solid = Solids.AddDefaulted_GetRef();
+				Solid.Block = &Child;
+				Solid.Origin = Origin;
+				Solid.bWorld = bWorldBrushes;
+			}
+		}
+	}
+
+	if (Solids.Num() == 0 && Estimate.Entities == 0)
+	{
+		return Estimate;
+	}
+	Estimate.bChecked = true;
+
+	// Windings and bevels per brush are independent
+	TArray<FSolidResult> Results;
+	Results.SetNum(Solids.Num());
+	ParallelFor(Solids.Num(), [&](int32 Index)
+	{
+		ProcessSolid(Solids[Index], Results[Index]);
+	});
+
+	// Serial dedup in file order, like vbsp
+	FVMFPlaneSet Planes;
+	TMap<FString, int32> TexDataIndices;
+	TSet<FTexInfoKey> TexInfos;
+	FBox3d WorldBounds(ForceInit);
+
+	auto FindOrAddTexData = [&TexDataIndices, &Estimate](const FString& Material)
+	{
+		if (const int32* Existing = TexDataIndices.Find(Material))
+		{
+			return *Existing;
+		}
+		Estimate.TexDataStringBytes += Material.Len() + 1;
+		return TexDataIndices.Add(Material, TexDataIndices.Num());
+	};
+
+	for (int32 i = 0; i < Solids.Num(); ++i)
+	{
+		const FSolidResult& Result = Results[i];
+		for (const FEstimatePlane& Plane : Result.Planes)
+		{
+			Planes.FindOrAdd(Plane.Normal, Plane.Dist);
+		}
+
+		if (!Result.bKeep)
+		{
+			continue;
+		}
+		Estimate.Brushes++;
+		Estimate.BrushSides += Result.OriginalSides + Result.BevelSides;
+		Estimate.BevelSides += Result.BevelSides;
+		if (Solids[i].bWorld)
+		{
+			WorldBounds += Result.Bounds;
+		}
+
+		// TexinfoForBrushTexture
+		for (int32 SideIndex = 0; SideIndex < Result.Sides.Num(); ++SideIndex)
+		{
+			const FEstimateSide& Side = Result.Sides[SideIndex];
+			if (Side.Material.IsEmpty())
+			{
+				continue;
+			}
+
+			FVector UAxis, VAxis;
+			float UShift = 0.0f, UScale = 0.25f, VShift = 0.0f, VScale = 0.25f;
+			FVMFImporter::ParseUVAxis(Side.UAxis, UAxis, UShift, UScale);
+			FVMFImporter::ParseUVAxis(Side.VAxis, VAxis, VShift, VScale);
+			const float LightmapScale = (float)FMath::Max(Side.LightmapScale, 1);
+			const FVector3f Origin = FVector3f(Result.TexOrigins[SideIndex]);
+
+			FTexInfoKey Key;
+			Key.TexData = FindOrAddTexData(Side.Material);
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				Key.Vecs[0][Axis] = (float)UAxis[Axis] / UScale;
+				Key.Vecs[1][Axis] = (float)VAxis[Axis] / VScale;
+				Key.Vecs[2][Axis] = (float)UAxis[Axis] / LightmapScale;
+				Key.Vecs[3][Axis] = (float)VAxis[Axis] / LightmapScale;
+			}
+			for (int32 Row = 0; Row < 4; ++Row)
+			{
+				const float Shift = Row == 0 ? UShift : (Row == 1 ? VShift : 0.0f);
+				Key.Vecs[Row][3] = Shift + Origin.X * Key.Vecs[Row][0] + Origin.Y * Key.Vecs[Row][1] + Origin.Z * Key.Vecs[Row][2];
+			}
+			TexInfos.Add(Key);
+		}
+	}
+
+	// Overlays get a texinfo with no vectors per material
+	for (const FString& Material : OverlayMaterials)
+	{
+		FTexInfoKey Key;
+		Key.TexData = FindOrAddTexData(Material);
+		TexInfos.Add(Key);
+	}
+
+	// MakeHeadnodePortals: six axial planes just outside the world
+	if (WorldBounds.IsValid)
+	{
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			FVector3d Normal = FVector3d::ZeroVector;
+			Normal[Axis] = 1.0;
+			const FEstimatePlane Max = SnapPlane(Normal, WorldBounds.Max[Axis] + SIDESPACE);
+			const FEstimatePlane Min = SnapPlane(-Normal, -(WorldBounds.Min[Axis] - SIDESPACE));
+			Planes.FindOrAdd(Max.Normal, Max.Dist);
+			Planes.FindOrAdd(Min.Normal, Min.Dist);
+		}
+	}
+
+	Estimate.Planes = Planes.Num();
+	Estimate.TexInfo = TexInfos.Num();
+	Estimate.TexData = TexDataIndices.Num();
+	Estimate.Seconds = FPlatformTime::Seconds() - StartTime;
+
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Limit estimate: %d brushes, %d sides (%d bevels), %d planes, %d texinfo, %d texdata (%.3fs)"),
+		Estimate.Brushes, Estimate.BrushSides, Estimate.BevelSides, Estimate.Planes, Estimate.TexInfo,
+		Estimate.TexData, Estimate.Seconds);
+	return Estimate;
+}
+
+TArray<FString> FCompileLimitEstimator::GetWarnings(const FCompileLimitEstimate& Estimate)
+{
+	TArray<FBSPBudgetEntry> Entries = Estimate.GetEntries();
+	Entries.Sort([](const FBSPBudgetEntry& A, const FBSPBudgetEntry& B) { return A.GetUsage() > B.GetUsage(); });
+
+	TArray<FString> Warnings;
+	for (const FBSPBudgetEntry& Entry : Entries)
+	{
+		if (Entry.Limit > 0 && Entry.GetUsage() >= WarningThreshold)
+		{
+			Warnings.Add(FString::Printf(TEXT("[Limits] %s predicted at %lld / %lld (%.1f%%)%s"),
+				*Entry.Name, Entry.GetUsed(), Entry.Limit, Entry.GetUsage() * 100.0f,
+				Entry.GetUsed() > Entry.Limit ? TEXT(": vbsp will fail") : TEXT("")));
+		}
+	}
+	return Warnings;
+}
+
+bool FCompileLimitEstimator::ExceedsLimits(const FCompileLimitEstimate& Estimate)
+{
+	for (const FBSPBudgetEntry& Entry : Estimate.GetEntries())
+	{
+		if (Entry.Limit > 0 && Entry.GetUsed() > Entry.Limit)
+		{
+			return true;
+		}
+	}
+	return false;
+}
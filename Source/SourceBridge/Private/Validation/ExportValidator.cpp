@@ -1,4 +1,9 @@
 #include "Validation/ExportValidator.h"
+#include "Validation/LeakDetector.h"
+#include "Validation/CompileLimits.h"
+#include "VMF/VMFKeyValues.h"
+#include "VMF/VMFExporter.h"
+#include "Import/VMFReader.h"
 #include "SourceBridgeModule.h"
 #include "Entities/EntityExporter.h"
 #include "Entities/FGDParser.h"
@@ -42,7 +47,7 @@ void FValidationResult::LogAll() const
 		ErrorCount, WarningCount, InfoCount);
 }
 
-FValidationResult FExportValidator::ValidateWorld(UWorld* World)
+FValidationResult FExportValidator::ValidateWorld(UWorld* World, bool bCheckExport)
 {
 	FValidationResult Result;
 
@@ -60,9 +65,97 @@ FValidationResult FExportValidator::ValidateWorld(UWorld* World)
 	ValidateEntityClassnames(World, Result);
 	ValidateStaticMeshes(World, Result);
 
+	if (bCheckExport)
+	{
+		const TArray<FVMFKeyValues> Blocks = FVMFReader::ParseString(FVMFExporter::ExportScene(World));
+		ValidateCompileLimits(Blocks, Result);
+		ValidateLeaks(World, Blocks, Result);
+	}
+
 	return Result;
 }
 
+void FExportValidator::ValidateLeaks(UWorld* World, const TArray<FVMFKeyValues>& Blocks, FValidationResult& Result)
+{
+	FLeakCheckResult Leak = FLeakDetector::CheckVMF(Blocks);
+	AddLeakMessages(Leak, Result);
+	FLeakDetector::DrawLeakPath(World, Leak);
+}
+
+void FExportValidator::ValidateCompileLimits(const TArray<FVMFKeyValues>& Blocks, FValidationResult& Result)
+{
+	AddLimitMessages(FCompileLimitEstimator::EstimateVMF(Blocks), Result);
+}
+
+void FExportValidator::AddLimitMessages(const FCompileLimitEstimate& Estimate, FValidationResult& Result)
+{
+	if (!Estimate.bChecked)
+	{
+		return;
+	}
+
+	for (const FBSPBudgetEntry& Entry : Estimate.GetEntries())
+	{
+		const int64 Used = Entry.GetUsed();
+		const float Percent = Entry.GetUsage() * 100.0f;
+
+		Result.AddMessage(EValidationSeverity::Info, TEXT("Limits"),
+			FString::Printf(TEXT("Predicted %s: %lld / %lld (%.1f%%)"), *Entry.Name, Used, Entry.Limit, Percent));
+
+		if (Used > Entry.Limit)
+		{
+			Result.AddMessage(EValidationSeverity::Warning, TEXT("Limits"),
+				FString::Printf(TEXT("Predicted %s %lld exceeds Source limit of %lld; vbsp may fail."),
+					*Entry.Name, Used, Entry.Limit));
+		}
+		else if (Entry.GetUsage() >= FCompileLimitEstimator::WarningThreshold)
+		{
+			Result.AddMessage(EValidationSeverity::Warning, TEXT("Limits"),
+				FString::Printf(TEXT("Predicted %s %lld is %.0f%% of Source limit."), *Entry.Name, Used, Percent));
+		}
+	}
+
+	if (Estimate.BevelSides > 0)
+	{
+		Result.AddMessage(EValidationSeverity::Info, TEXT("Limits"),
+			FString::Printf(TEXT("%d of the predicted brush sides are bevels vbsp adds for collision."), Estimate.BevelSides));
+	}
+}
+
+void FExportValidator::AddLeakMessages(const FLeakCheckResult& Leak, FValidationResult& Result)
+{
+	if (!Leak.bChecked)
+	{
+		return;
+	}
+
+	if (Leak.bLeaked)
+	{
+		const FVector& Origin = Leak.LeakEntityOrigin;
+		Result.AddMessage(EValidationSeverity::Error, TEXT("Leak"),
+			FString::Printf(TEXT("Map leaks: %s at (%.0f %.0f %.0f) can reach the void. vvis will fail; seal the map (leak path drawn in red)."),
+				*Leak.LeakEntityClass, Origin.X, Origin.Y, Origin.Z));
+	}
+	else
+	{
+		Result.AddMessage(EValidationSeverity::Info, TEXT("Leak"),
+			FString::Printf(TEXT("No leaks found (%d sealing brushes, %d entities, %d-unit voxels, %.2fs)."),
+				Leak.SealingBrushCount, Leak.SeedEntityCount, Leak.VoxelSize, Leak.Seconds));
+	}
+
+	if (Leak.HasLowCoverage())
+	{
+		Result.AddMessage(EValidationSeverity::Warning, TEXT("Leak"),
+			FString::Printf(TEXT("Only %d of %d point entities could be flooded from (the rest are inside %d-unit solid voxels); the leak check tested little of the map."),
+				Leak.SeedEntityCount - Leak.EntitiesInSolid, Leak.SeedEntityCount, Leak.VoxelSize));
+	}
+	else if (Leak.EntitiesInSolid > 0)
+	{
+		Result.AddMessage(EValidationSeverity::Warning, TEXT("Leak"),
+			FString::Printf(TEXT("%d point entities have their origin inside a world brush."), Leak.EntitiesInSolid));
+	}
+}
+
 void FExportValidator::ValidateBrushLimits(UWorld* World, FValidationResult& Result)
 {
 	int32 BrushCount = 0;
@@ -480,8 +573,8 @@ void FExportValidator::ValidateEntityClassnames(UWorld* World, FValidationResult
 			for (const FEntityIOConnection& Conn : Entity.Connections)
 			{
 				// Check output exists on this entity
-				FFGDEntityClass Resolved = FGD.GetResolved(Entity.ClassName);
-				if (!Resolved.FindOutput(Conn.OutputName))
+				TSharedPtr<const FFGDEntityClass> Resolved = FGD.FindResolved(Entity.ClassName);
+				if (Resolved.IsValid() && !Resolved->FindOutput(Conn.OutputName))
 				{
 					Result.AddMessage(EValidationSeverity::Warning, TEXT("FGD"),
 						FString::Printf(TEXT("Entity '%s' (%s): output '%s' not found in FGD."),
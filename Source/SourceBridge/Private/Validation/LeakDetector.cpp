@@ -0,0 +1,608 @@
+#include "Validation/LeakDetector.h"
+#include "VMF/VMFKeyValues.h"
+#include "Import/VMFReader.h"
+#include "Utilities/SourceCoord.h"
+#include "Utilities/ToolTextureClassifier.h"
+#include "Async/ParallelFor.h"
+#include "Algo/Reverse.h"
+#include "DrawDebugHelpers.h"
+#include "Engine/World.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+// Finest voxel size tried (Source units); doubled until the grid fits the cell budget
+static const int32 MIN_VOXEL_SIZE = 8;
+static const int64 MAX_VOXEL_CELLS = 8 * 1024 * 1024;
+
+// Budget for the one finer retry when coarse voxels bury most entity origins in solid
+static const int64 MAX_RETRY_VOXEL_CELLS = 32 * 1024 * 1024;
+
+// Empty cells around the map bounds; the outermost layer is the void
+static const int32 GRID_PADDING = 2;
+
+namespace
+{
+	struct FLeakBrush
+	{
+		TArray<FPlane> Planes;
+		FBox Bounds = FBox(ForceInit);
+	};
+
+	struct FLeakSeed
+	{
+		FString ClassName;
+		FVector Origin;
+
+		/** Where the flood starts (nudged up like vbsp does) */
+		FVector FloodOrigin;
+	};
+
+	const FString* FindProperty(const FVMFKeyValues& Block, const TCHAR* Key)
+	{
+		for (const TPair<FString, FString>& Prop : Block.Properties)
+		{
+			if (Prop.Key.Equals(Key, ESearchCase::IgnoreCase))
+			{
+				return &Prop.Value;
+			}
+		}
+		return nullptr;
+	}
+
+	bool ParseVector(const FString& Text, FVector& Out)
+	{
+		TArray<FString> Parts;
+		Text.ParseIntoArrayWS(Parts);
+		if (Parts.Num() < 3)
+		{
+			return false;
+		}
+		Out = FVector(FCString::Atod(*Parts[0]), FCString::Atod(*Parts[1]), FCString::Atod(*Parts[2]));
+		return true;
+	}
+
+	/** "(x y z) (x y z) (x y z)" */
+	bool ParsePlanePoints(const FString& Text, FVector OutPoints[3])
+	{
+		FString Clean = Text.Replace(TEXT("("), TEXT(" ")).Replace(TEXT(")"), TEXT(" "));
+		TArray<FString> Parts;
+		Clean.ParseIntoArrayWS(Parts);
+		if (Parts.Num() != 9)
+		{
+			return false;
+		}
+		for (int32 i = 0; i < 3; ++i)
+		{
+			OutPoints[i] = FVector(
+				FCString::Atod(*Parts[i * 3]),
+				FCString::Atod(*Parts[i * 3 + 1]),
+				FCString::Atod(*Parts[i * 3 + 2]));
+		}
+		return true;
+	}
+
+	bool IsSealingMaterial(const FString& Material)
+	{
+		// Water brushes are see-through contents for vbsp and never seal
+		if (Material.Contains(TEXT("water")))
+		{
+			return false;
+		}
+
+		switch (FToolTextureClassifier::Classify(Material))
+		{
+		case EToolTextureType::Normal:
+		case EToolTextureType::NoDraw:
+		case EToolTextureType::Invisible:
+		case EToolTextureType::Sky:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	/** Corners of the convex brush: plane triple intersections inside every plane. */
+	FBox ComputeBrushBounds(const TArray<FPlane>& Planes)
+	{
+		FBox Bounds(ForceInit);
+		for (int32 i = 0; i < Planes.Num(); ++i)
+		{
+			for (int32 j = i + 1; j < Planes.Num(); ++j)
+			{
+				for (int32 k = j + 1; k < Planes.Num(); ++k)
+				{
+					FVector Point;
+					if (!FMath::IntersectPlanes3(Point, Planes[i], Planes[j], Planes[k]))
+					{
+						continue;
+					}
+
+					bool bInside = true;
+					for (const FPlane& Plane : Planes)
+					{
+						if (Plane.PlaneDot(Point) > 0.1)
+						{
+							bInside = false;
+							break;
+						}
+					}
+					if (bInside)
+					{
+						Bounds += Point;
+					}
+				}
+			}
+		}
+		return Bounds;
+	}
+
+	/** Build a sealing brush from a world "solid" block. Returns false if it doesn't seal. */
+	bool BuildBrush(const FVMFKeyValues& Solid, FLeakBrush& Out)
+	{
+		bool bSeals = false;
+		for (const FVMFKeyValues& Side : Solid.Children)
+		{
+			if (!Side.ClassName.Equals(TEXT("side"), ESearchCase::IgnoreCase))
+			{
+				continue;
+			}
+
+			// Displacement brushes are non-solid to vbsp
+			for (const FVMFKeyValues& SideChild : Side.Children)
+			{
+				if (SideChild.ClassName.Equals(TEXT("dispinfo"), ESearchCase::IgnoreCase))
+				{
+					return false;
+				}
+			}
+
+			const FString* PlaneText = FindProperty(Side, TEXT("plane"));
+			FVector Points[3];
+			if (!PlaneText || !ParsePlanePoints(*PlaneText, Points))
+			{
+				continue;
+			}
+
+			// vbsp's PlaneFromPoints: normal = (p0 - p1) x (p2 - p1), pointing out of the brush
+			FVector Normal = FVector::CrossProduct(Points[0] - Points[1], Points[2] - Points[1]);
+			if (!Normal.Normalize())
+			{
+				continue;
+			}
+			Out.Planes.Add(FPlane(Normal, FVector::DotProduct(Normal, Points[1])));
+
+			const FString* Material = FindProperty(Side, TEXT("material"));
+			if (Material && IsSealingMaterial(*Material))
+			{
+				bSeals = true;
+			}
+		}
+
+		if (!bSeals || Out.Planes.Num() < 4)
+		{
+			return false;
+		}
+
+		Out.Bounds = ComputeBrushBounds(Out.Planes);
+		if (!Out.Bounds.IsValid)
+		{
+			// Opposite winding: flip every plane and retry
+			for (FPlane& Plane : Out.Planes)
+			{
+				Plane = Plane.Flip();
+			}
+			Out.Bounds = ComputeBrushBounds(Out.Planes);
+		}
+		return Out.Bounds.IsValid != 0;
+	}
+
+	/**
+	 * Smallest voxel size from MinSize up (doubling) whose grid around Bounds fits MaxCells.
+	 * The grid is aligned to the voxel size so on-grid walls fall on cell boundaries.
+	 */
+	void FitGrid(const FBox& Bounds, int32 MinSize, int64 MaxCells, int32& OutVoxelSize, FIntVector& OutGridMin, FIntVector& OutGridSize)
+	{
+		OutVoxelSize = MinSize;
+		for (;;)
+		{
+			OutGridMin = FIntVector(
+				FMath::FloorToInt(Bounds.Min.X / OutVoxelSize) - GRID_PADDING,
+				FMath::FloorToInt(Bounds.Min.Y / OutVoxelSize) - GRID_PADDING,
+				FMath::FloorToInt(Bounds.Min.Z / OutVoxelSize) - GRID_PADDING);
+			FIntVector GridMax(
+				FMath::CeilToInt(Bounds.Max.X / OutVoxelSize) + GRID_PADDING,
+				FMath::CeilToInt(Bounds.Max.Y / OutVoxelSize) + GRID_PADDING,
+				FMath::CeilToInt(Bounds.Max.Z / OutVoxelSize) + GRID_PADDING);
+			OutGridSize = GridMax - OutGridMin;
+
+			if ((int64)OutGridSize.X * OutGridSize.Y * OutGridSize.Z <= MaxCells)
+			{
+				return;
+			}
+			OutVoxelSize *= 2;
+		}
+	}
+
+	/** Mark every voxel a brush overlaps; one Z slice per task, so tasks never write the same cell. */
+	TArray<uint8> VoxelizeBrushes(const TArray<FLeakBrush>& Brushes, int32 VoxelSize, const FIntVector& GridMin, const FIntVector& GridSize)
+	{
+		const int64 SliceCells = (int64)GridSize.X * GridSize.Y;
+		auto ToCell = [&](const FVector& P) -> FIntVector
+		{
+			return FIntVector(
+				FMath::FloorToInt(P.X / VoxelSize) - GridMin.X,
+				FMath::FloorToInt(P.Y / VoxelSize) - GridMin.Y,
+				FMath::FloorToInt(P.Z / VoxelSize) - GridMin.Z);
+		};
+
+		TArray<uint8> Solid;
+		Solid.SetNumZeroed((int32)(SliceCells * GridSize.Z));
+
+		const double HalfVoxel = VoxelSize * 0.5;
+		ParallelFor(GridSize.Z, [&](int32 Z)
+		{
+			const double SliceMinZ = (GridMin.Z + Z) * (double)VoxelSize;
+			const double SliceMaxZ = SliceMinZ + VoxelSize;
+
+			for (const FLeakBrush& Brush : Brushes)
+			{
+				if (Brush.Bounds.Max.Z <= SliceMinZ || Brush.Bounds.Min.Z >= SliceMaxZ)
+				{
+					continue;
+				}
+
+				FIntVector MinCell = ToCell(Brush.Bounds.Min);
+				FIntVector MaxCell = ToCell(Brush.Bounds.Max);
+				for (int32 Y = FMath::Max(MinCell.Y, 0); Y <= FMath::Min(MaxCell.Y, GridSize.Y - 1); ++Y)
+				{
+					for (int32 X = FMath::Max(MinCell.X, 0); X <= FMath::Min(MaxCell.X, GridSize.X - 1); ++X)
+					{
+						int64 Index = X + (int64)Y * GridSize.X + Z * SliceCells;
+						if (Solid[Index])
+						{
+							continue;
+						}
+
+						// Overlap unless some brush plane separates the voxel (touching doesn't count)
+						FVector Center(
+							(GridMin.X + X + 0.5) * VoxelSize,
+							(GridMin.Y + Y + 0.5) * VoxelSize,
+							(GridMin.Z + Z + 0.5) * VoxelSize);
+						bool bOverlaps = true;
+						for (const FPlane& Plane : Brush.Planes)
+						{
+							double Extent = HalfVoxel * (FMath::Abs(Plane.X) + FMath::Abs(Plane.Y) + FMath::Abs(Plane.Z));
+							if (Plane.PlaneDot(Center) - Extent >= -0.01)
+							{
+								bOverlaps = false;
+								break;
+							}
+						}
+						if (bOverlaps)
+						{
+							Solid[Index] = 1;
+						}
+					}
+				}
+			}
+		});
+		return Solid;
+	}
+
+	const FIntVector NeighbourOffsets[6] = {
+		FIntVector(1, 0, 0), FIntVector(-1, 0, 0),
+		FIntVector(0, 1, 0), FIntVector(0, -1, 0),
+		FIntVector(0, 0, 1), FIntVector(0, 0, -1)
+	};
+
+	// Flood state per cell: unvisited, reached through NeighbourOffsets[State - 1], or a seed
+	const uint8 CELL_UNVISITED = 0;
+	const uint8 CELL_SEED = 7;
+}
+
+FLeakCheckResult FLeakDetector::CheckVMF(const TArray<FVMFKeyValues>& Blocks)
+{
+	double StartTime = FPlatformTime::Seconds();
+	FLeakCheckResult Result;
+
+	// ---- Collect sealing world brushes and point entity origins ----
+	TArray<FLeakBrush> Brushes;
+	TArray<FLeakSeed> Seeds;
+
+	for (const FVMFKeyValues& Block : Blocks)
+	{
+		if (Block.ClassName.Equals(TEXT("world"), ESearchCase::IgnoreCase))
+		{
+			for (const FVMFKeyValues& Child : Block.Children)
+			{
+				if (!Child.ClassName.Equals(TEXT("solid"), ESearchCase::IgnoreCase))
+				{
+					continue;
+				}
+				FLeakBrush Brush;
+				if (BuildBrush(Child, Brush))
+				{
+					Brushes.Add(MoveTemp(Brush));
+				}
+			}
+		}
+		else if (Block.ClassName.Equals(TEXT("entity"), ESearchCase::IgnoreCase))
+		{
+			bool bHasSolids = Block.Children.ContainsByPredicate([](const FVMFKeyValues& Child)
+			{
+				return Child.ClassName.Equals(TEXT("solid"), ESearchCase::IgnoreCase);
+			});
+
+			const FString* OriginText = FindProperty(Block, TEXT("origin"));
+			FVector Origin;
+			if (bHasSolids || !OriginText || !ParseVector(*OriginText, Origin))
+			{
+				continue;
+			}
+
+			// Like vbsp's FloodEntities: entities at the world origin don't flood, and the
+			// rest are nudged up a unit so ones standing on a floor aren't in it
+			if (Origin.IsZero())
+			{
+				continue;
+			}
+
+			const FString* ClassName = FindProperty(Block, TEXT("classname"));
+			Seeds.Add({ ClassName ? *ClassName : FString(TEXT("unknown")), Origin, Origin + FVector(0.0, 0.0, 1.0) });
+		}
+	}
+
+	Result.SealingBrushCount = Brushes.Num();
+	Result.SeedEntityCount = Seeds.Num();
+	if (Brushes.Num() == 0 || Seeds.Num() == 0)
+	{
+		Result.Seconds = FPlatformTime::Seconds() - StartTime;
+		return Result;
+	}
+	Result.bChecked = true;
+
+	// ---- Grid setup ----
+	FBox WorldBounds(ForceInit);
+	for (const FLeakBrush& Brush : Brushes)
+	{
+		WorldBounds += Brush.Bounds;
+	}
+
+	int32 VoxelSize;
+	FIntVector GridMin, GridSize;
+	FitGrid(WorldBounds, MIN_VOXEL_SIZE, MAX_VOXEL_CELLS, VoxelSize, GridMin, GridSize);
+
+	int64 SliceCells = (int64)GridSize.X * GridSize.Y;
+	auto CellIndex = [&](int32 X, int32 Y, int32 Z) -> int64
+	{
+		return X + (int64)Y * GridSize.X + Z * SliceCells;
+	};
+	auto CellCenter = [&](int32 X, int32 Y, int32 Z) -> FVector
+	{
+		return FVector(
+			(GridMin.X + X + 0.5) * VoxelSize,
+			(GridMin.Y + Y + 0.5) * VoxelSize,
+			(GridMin.Z + Z + 0.5) * VoxelSize);
+	};
+	auto ToCell = [&](const FVector& P) -> FIntVector
+	{
+		return FIntVector(
+			FMath::FloorToInt(P.X / VoxelSize) - GridMin.X,
+			FMath::FloorToInt(P.Y / VoxelSize) - GridMin.Y,
+			FMath::FloorToInt(P.Z / VoxelSize) - GridMin.Z);
+	};
+	auto CountSeedsInSolid = [&](const TArray<uint8>& SolidCells) -> int32
+	{
+		int32 Count = 0;
+		for (const FLeakSeed& Seed : Seeds)
+		{
+			FIntVector Cell = ToCell(Seed.FloodOrigin);
+			if (Cell.X > 0 && Cell.Y > 0 && Cell.Z > 0
+				&& Cell.X < GridSize.X - 1 && Cell.Y < GridSize.Y - 1 && Cell.Z < GridSize.Z - 1
+				&& SolidCells[CellIndex(Cell.X, Cell.Y, Cell.Z)])
+			{
+				Count++;
+			}
+		}
+		return Count;
+	};
+
+	// ---- Voxelize ----
+	TArray<uint8> Solid = VoxelizeBrushes(Brushes, VoxelSize, GridMin, GridSize);
+
+	// Coarse voxels swallow entities standing near walls, leaving little to flood from;
+	// retry once on the finest grid a larger budget allows
+	if (VoxelSize > MIN_VOXEL_SIZE && CountSeedsInSolid(Solid) * 2 > Seeds.Num())
+	{
+		int32 FinerVoxelSize;
+		FIntVector FinerGridMin, FinerGridSize;
+		FitGrid(WorldBounds, MIN_VOXEL_SIZE, MAX_RETRY_VOXEL_CELLS, FinerVoxelSize, FinerGridMin, FinerGridSize);
+		if (FinerVoxelSize < VoxelSize)
+		{
+			UE_LOG(LogTemp, Log, TEXT("SourceBridge: Leak check: most entities are inside %d-unit solid voxels, retrying with %d-unit voxels"),
+				VoxelSize, FinerVoxelSize);
+			VoxelSize = FinerVoxelSize;
+			GridMin = FinerGridMin;
+			GridSize = FinerGridSize;
+			SliceCells = (int64)GridSize.X * GridSize.Y;
+			Solid = VoxelizeBrushes(Brushes, VoxelSize, GridMin, GridSize);
+		}
+	}
+
+	Result.VoxelSize = VoxelSize;
+	Result.GridSize = GridSize;
+
+	// ---- Flood fill from every entity origin ----
+	TArray<uint8> State;
+	State.SetNumZeroed(Solid.Num());
+	TArray<int64> Queue;
+	TMap<int64, int32> SeedCells;
+
+	auto TraceLeak = [&](int64 Index, int32 SeedIndex)
+	{
+		const FLeakSeed& Seed = Seeds[SeedIndex];
+		Result.bLeaked = true;
+		Result.LeakEntityClass = Seed.ClassName;
+		Result.LeakEntityOrigin = Seed.Origin;
+
+		// Walk back to the seed, then reverse so the path runs entity -> void
+		TArray<FVector> Cells;
+		while (Index >= 0)
+		{
+			int32 Z = (int32)(Index / SliceCells);
+			int32 Y = (int32)((Index % SliceCells) / GridSize.X);
+			int32 X = (int32)(Index % GridSize.X);
+			Cells.Add(CellCenter(X, Y, Z));
+
+			uint8 Came = State[Index];
+			if (Came == CELL_SEED)
+			{
+				break;
+			}
+			const FIntVector& Step = NeighbourOffsets[Came - 1];
+			Index = CellIndex(X - Step.X, Y - Step.Y, Z - Step.Z);
+		}
+		Algo::Reverse(Cells);
+
+		// Keep only the corners of the path
+		Result.LeakPath.Add(Seed.FloodOrigin);
+		for (int32 i = 1; i < Cells.Num() - 1; ++i)
+		{
+			FVector In = (Cells[i] - Cells[i - 1]).GetSafeNormal();
+			FVector Out = (Cells[i + 1] - Cells[i]).GetSafeNormal();
+			if (!In.Equals(Out))
+			{
+				Result.LeakPath.Add(Cells[i]);
+			}
+		}
+		if (Cells.Num() > 0)
+		{
+			Result.LeakPath.Add(Cells.Last());
+		}
+	};
+
+	for (int32 SeedIndex = 0; SeedIndex < Seeds.Num(); ++SeedIndex)
+	{
+		FIntVector Cell = ToCell(Seeds[SeedIndex].FloodOrigin);
+		if (Cell.X <= 0 || Cell.Y <= 0 || Cell.Z <= 0
+			|| Cell.X >= GridSize.X - 1 || Cell.Y >= GridSize.Y - 1 || Cell.Z >= GridSize.Z - 1)
+		{
+			// Outside every brush: leaks on its own
+			Result.bLeaked = true;
+			Result.LeakEntityClass = Seeds[SeedIndex].ClassName;
+			Result.LeakEntityOrigin = Seeds[SeedIndex].Origin;
+			Result.LeakPath = { Seeds[SeedIndex].FloodOrigin };
+			Result.Seconds = FPlatformTime::Seconds() - StartTime;
+			return Result;
+		}
+
+		int64 Index = CellIndex(Cell.X, Cell.Y, Cell.Z);
+		if (Solid[Index])
+		{
+			Result.EntitiesInSolid++;
+			continue;
+		}
+		if (State[Index] == CELL_UNVISITED)
+		{
+			State[Index] = CELL_SEED;
+			SeedCells.Add(Index, SeedIndex);
+			Queue.Add(Index);
+		}
+	}
+
+	// Which seed each queued cell came from, for naming the leaking entity
+	TArray<int32> QueueSeed;
+	QueueSeed.Reserve(Queue.Num());
+	for (int64 Index : Queue)
+	{
+		QueueSeed.Add(SeedCells[Index]);
+	}
+
+	for (int32 Head = 0; Head < Queue.Num(); ++Head)
+	{
+		int64 Index = Queue[Head];
+		int32 Z = (int32)(Index / SliceCells);
+		int32 Y = (int32)((Index % SliceCells) / GridSize.X);
+		int32 X = (int32)(Index % GridSize.X);
+
+		// The outer layer is outside every brush: the void
+		if (X == 0 || Y == 0 || Z == 0 || X == GridSize.X - 1 || Y == GridSize.Y - 1 || Z == GridSize.Z - 1)
+		{
+			TraceLeak(Index, QueueSeed[Head]);
+			break;
+		}
+
+		for (int32 Dir = 0; Dir < 6; ++Dir)
+		{
+			const FIntVector& Step = NeighbourOffsets[Dir];
+			int64 Next = CellIndex(X + Step.X, Y + Step.Y, Z + Step.Z);
+			if (Solid[Next] || State[Next] != CELL_UNVISITED)
+			{
+				continue;
+			}
+			State[Next] = (uint8)(Dir + 1);
+			Queue.Add(Next);
+			QueueSeed.Add(QueueSeed[Head]);
+		}
+	}
+
+	Result.Seconds = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogTemp, Log, TEXT("SourceBridge: Leak check %s in %.2fs (%d brushes, %d entities, %dx%dx%d voxels of %d units)"),
+		Result.bLeaked ? TEXT("found a leak") : TEXT("passed"), Result.Seconds,
+		Result.SealingBrushCount, Result.SeedEntityCount,
+		GridSize.X, GridSize.Y, GridSize.Z, VoxelSize);
+	if (Result.HasLowCoverage())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SourceBridge: Leak check flooded from only %d of %d entities; the rest are inside %d-unit solid voxels"),
+			Result.SeedEntityCount - Result.EntitiesInSolid, Result.SeedEntityCount, VoxelSize);
+	}
+
+	return Result;
+}
+
+FLeakCheckResult FLeakDetector::CheckVMFFile(const FString& VMFPath)
+{
+	return CheckVMF(FVMFReader::ParseFile(VMFPath));
+}
+
+void FLeakDetector::DrawLeakPath(UWorld* World, const FLeakCheckResult& Result)
+{
+	if (!World)
+	{
+		return;
+	}
+
+	FlushPersistentDebugLines(World);
+	if (!Result.bLeaked || Result.LeakPath.Num() == 0)
+	{
+		return;
+	}
+
+	FVector Start = FSourceCoord::SourceToUE(Result.LeakPath[0]);
+	DrawDebugSphere(World, Start, 24.0f, 12, FColor::Red, true, -1.0f, 0, 2.0f);
+
+	for (int32 i = 1; i < Result.LeakPath.Num(); ++i)
+	{
+		DrawDebugLine(World,
+			FSourceCoord::SourceToUE(Result.LeakPath[i - 1]),
+			FSourceCoord::SourceToUE(Result.LeakPath[i]),
+			FColor::Red, true, -1.0f, 0, 4.0f);
+	}
+}
+
+bool FLeakDetector::WritePointfile(const FString& VMFPath, const FLeakCheckResult& Result)
+{
+	if (!Result.bLeaked || Result.LeakPath.Num() == 0)
+	{
+		return false;
+	}
+
+	FString Content;
+	for (const FVector& Point : Result.LeakPath)
+	{
+		Content += FString::Printf(TEXT("%g %g %g\n"), Point.X, Point.Y, Point.Z);
+	}
+
+	FString PointfilePath = FPaths::ChangeExtension(VMFPath, TEXT("lin"));
+	return FFileHelper::SaveStringToFile(Content, *PointfilePath);
+}
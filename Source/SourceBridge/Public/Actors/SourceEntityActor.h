@@ -7,6 +7,8 @@
 #include "ProceduralMeshComponent.h"
 #include "SourceEntityActor.generated.h"
 
+class UHierarchicalInstancedStaticMeshComponent;
+
 /**
  * Stores per-side (face) data from an imported VMF solid for lossless re-export.
  */
@@ -254,6 +256,57 @@ public:
 	void SetStaticMesh(UStaticMesh* Mesh);
 };
 
+/**
+ * Static props imported from a compiled BSP's sprp lump, instanced.
+ * Holds every placement of one model that shares skin, collision, shadow and fade
+ * settings, rendered by a single hierarchical instanced mesh component.
+ * Exports as one prop_static per instance.
+ */
+UCLASS(ClassGroup = "SourceBridge", meta = (DisplayName = "Source Static Prop Group"))
+class SOURCEBRIDGE_API ASourceStaticPropGroup : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ASourceStaticPropGroup();
+
+	/** Source model path shared by all instances. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Source Prop")
+	FString ModelPath;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Source Prop")
+	int32 Skin = 0;
+
+	/** Collision type (0 = not solid, 2 = BSP, 6 = VPhysics). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Source Prop")
+	int32 Solid = 6;
+
+	/** Fade distances in Source units (FadeMaxDist 0 = no fade). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Source Prop")
+	float FadeMinDist = -1.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Source Prop")
+	float FadeMaxDist = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Source Prop")
+	bool bDisableShadows = false;
+
+	/** Per-instance static prop flags from the BSP (STATIC_PROP_*), parallel to the component's instances. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Source Prop|Instances")
+	TArray<int32> InstanceFlags;
+
+	/** Per-instance color and alpha tint (rendercolor/renderamt). */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Source Prop|Instances")
+	TArray<FColor> InstanceColors;
+
+	/** Per-instance model scale (modelscale). */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Source Prop|Instances")
+	TArray<float> InstanceScales;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Source Prop")
+	TObjectPtr<UHierarchicalInstancedStaticMeshComponent> InstancesComponent;
+};
+
 /**
  * Generic brush entity actor for Source engine brush entities.
  * Owns one or more ProceduralMeshComponent children (one per solid in the entity).
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FJsonObject;
+
+/** Hard limits of the Source 2013 engine and compile tools (MAX_MAP_* in bspfile.h). */
+namespace BSPLimits
+{
+	constexpr int64 Models = 1024;
+	constexpr int64 Brushes = 8192;
+	constexpr int64 BrushSides = 65536;
+	constexpr int64 Planes = 65536;
+	constexpr int64 Vertexes = 65536;
+	constexpr int64 Nodes = 65536;
+	constexpr int64 TexInfo = 12288;
+	constexpr int64 TexData = 2048;
+	constexpr int64 Faces = 65536;
+	constexpr int64 Leafs = 65536;
+	constexpr int64 LeafFaces = 65536;
+	constexpr int64 LeafBrushes = 65536;
+	constexpr int64 Edges = 256000;
+	constexpr int64 SurfEdges = 512000;
+	constexpr int64 Entities = 8192;
+	constexpr int64 WorldLights = 8192;
+	constexpr int64 DispInfo = 2048;
+	constexpr int64 Areas = 256;
+	constexpr int64 AreaPortals = 1024;
+	constexpr int64 Overlays = 512;
+	constexpr int64 Cubemaps = 1024;
+	constexpr int64 TexDataStringTable = 65536;
+
+	/** Byte limits */
+	constexpr int64 EntStringBytes = 384 * 1024;
+	constexpr int64 TexDataStringBytes = 256000;
+	constexpr int64 LightingBytes = 0x1000000;
+	constexpr int64 VisibilityBytes = 0x1000000;
+
+	/** Static props are indexed with 16 bits in the sprp leaf list */
+	constexpr int64 StaticProps = 65535;
+
+	/** Lump offsets in the header are signed 32-bit */
+	constexpr int64 FileBytes = MAX_int32;
+}
+
+/** Usage of one budgeted BSP resource. */
+struct SOURCEBRIDGE_API FBSPBudgetEntry
+{
+	/** "planes", "brushsides", "lighting"... (stable: used as the JSON key for deltas) */
+	FString Name;
+
+	/** Elements in the lump (0 for byte-only entries like the pakfile) */
+	int64 Count = 0;
+
+	/** Lump size in bytes, uncompressed */
+	int64 Bytes = 0;
+
+	/** Engine maximum of Count, or of Bytes with bByteLimit (0 = no hard limit) */
+	int64 Limit = 0;
+	bool bByteLimit = false;
+
+	/** Usage in the previous compile's report of the same map */
+	bool bHasPrevious = false;
+	int64 PreviousUsed = 0;
+
+	/** The value Limit applies to. */
+	int64 GetUsed() const { return bByteLimit ? Bytes : Count; }
+
+	/** Fraction of the limit in use (0 without one). */
+	float GetUsage() const { return Limit > 0 ? (float)((double)GetUsed() / Limit) : 0.0f; }
+
+	int64 GetDelta() const { return bHasPrevious ? GetUsed() - PreviousUsed : 0; }
+};
+
+/** Budget of a compiled map: every budgeted lump against its engine limit. */
+struct SOURCEBRIDGE_API FBSPBudgetReport
+{
+	FString BSPPath;
+	int32 Version = 0;
+	int64 FileBytes = 0;
+
+	TArray<FBSPBudgetEntry> Entries;
+
+	/** Date of the report the deltas are against (empty = first compile) */
+	FString PreviousDate;
+
+	bool IsValid() const { return Entries.Num() > 0; }
+
+	const FBSPBudgetEntry* Find(const FString& Name) const;
+
+	/** Entries using at least Threshold of their limit, fullest first. */
+	TArray<const FBSPBudgetEntry*> GetEntriesOver(float Threshold) const;
+
+	TSharedRef<FJsonObject> ToJson() const;
+};
+
+/**
+ * Post-compile budget report, read natively from the compiled BSP's header.
+ *
+ * Counts the elements and bytes of every lump with an engine limit (planes, brushes,
+ * brushsides, texinfo, the texdata string table, lightmaps, entities, static props...)
+ * and the pakfile size, and compares them with the report of the previous compile
+ * (<map>.budget.json next to the BSP), which the new report then replaces.
+ */
+class SOURCEBRIDGE_API FBSPBudget
+{
+public:
+	/** Usage above which the export summary warns about an entry. */
+	static constexpr float WarningThreshold = 0.9f;
+
+	static FString GetReportPath(const FString& BSPPath);
+
+	/** Read a BSP's budget. Returns false if it can't be opened. */
+	static bool Analyze(const FString& BSPPath, FBSPBudgetReport& OutReport);
+
+	/** Analyze, fill in deltas from the last report and write the new one. */
+	static bool Run(const FString& BSPPath, FBSPBudgetReport& OutReport);
+
+	/** Log a table of every entry, with deltas. */
+	static void LogReport(const FBSPBudgetReport& Report);
+
+	/** "[Budget] ..." warnings for entries over WarningThreshold. */
+	static TArray<FString> GetWarnings(const FBSPBudgetReport& Report);
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Options for FBSPPakWriter::Pack.
+ */
+struct SOURCEBRIDGE_API FBSPPakOptions
+{
+	/** LZMA-compress new entries (kept stored when that doesn't make them smaller) */
+	bool bCompress = false;
+
+	/** Keep files already in the pakfile that aren't in the new list (vbsp's cubemaps, earlier packs) */
+	bool bKeepExisting = true;
+};
+
+/**
+ * What FBSPPakWriter::Pack did.
+ */
+struct SOURCEBRIDGE_API FBSPPakResult
+{
+	bool bSuccess = false;
+	FString ErrorMessage;
+
+	/** Files read from disk and written (stored or compressed) */
+	int32 FilesWritten = 0;
+
+	/** Files identical to the entry already packed under the same path, copied over as is */
+	int32 FilesUnchanged = 0;
+
+	/** Files with the same content as an earlier file of this pack, whose compressed payload was written again instead of recompressing */
+	int32 FilesDeduplicated = 0;
+
+	/** Entries of the old pakfile kept because the list didn't replace them */
+	int32 FilesKept = 0;
+
+	/** Listed files that couldn't be read */
+	TArray<FString> MissingFiles;
+
+	/** Size of the new pakfile lump */
+	int64 PakBytes = 0;
+
+	/** True when the old pakfile was the last lump and got replaced without moving anything else */
+	bool bInPlace = false;
+
+	/** Map CRC of the packed BSP (see FBSPReader::ComputeMapChecksum) */
+	uint32 MapChecksum = 0;
+};
+
+/**
+ * Rebuilds the pakfile lump (40) of a compiled BSP natively, replacing bspzip.
+ *
+ * The new ZIP archive is assembled in a temporary file next to the BSP, one file at a
+ * time in fixed-size chunks, so nothing is ever loaded whole except a single file being
+ * LZMA-compressed. Then:
+ *   - if the old pakfile is the last lump (as vbsp and bspzip leave it), the BSP is
+ *     truncated at the lump and the new archive written there;
+ *   - otherwise the archive is appended at the end of the file and the old lump left
+ *     unreferenced, so later packs happen in place.
+ * Only the pakfile's lump directory entry changes in the header. The map revision is kept,
+ * and the map CRC follows from the new lump bytes (the header doesn't store one).
+ *
+ * Repacking is incremental: a file whose CRC and size match the entry already packed
+ * under its path is copied over byte for byte instead of being recompressed, and files
+ * with identical content (by SHA-1) are compressed once. Each entry still carries its own
+ * copy of the payload, since Source locates entry data by the name it was looked up with.
+ * Packs past 65535 entries fail, as the engine reads no ZIP64.
+ */
+class SOURCEBRIDGE_API FBSPPakWriter
+{
+public:
+	/**
+	 * Pack Files (internal path, e.g. "models/foo/bar.mdl" -> absolute disk path) into BSPPath.
+	 * Internal paths are lowercased with forward slashes, as the engine looks them up.
+	 */
+	static FBSPPakResult Pack(
+		const FString& BSPPath,
+		const TMap<FString, FString>& Files,
+		const FBSPPakOptions& Options = FBSPPakOptions());
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** A compile stage whose outputs can be cached. */
+enum class ECompileStage : uint8
+{
+	VBSP,
+	VVIS,
+	VRAD
+};
+
+/**
+ * Cache of intermediate compile outputs, stored under Saved/SourceBridge/CompileCache/<map>/.
+ *
+ * Each stage is keyed by a hash of exactly what it reads:
+ * - VBSP: VMF bytes, tool version, game directory, arguments
+ * - VVIS: post-VBSP BSP without its entity lump, the .prt file, tool version, arguments
+ * - VRAD: post-VVIS BSP without its entity lump, worldspawn and light-related entities,
+ *         lights.rad (game and per-map), tool version, arguments
+ *
+ * Entities that a stage ignores are left out of its key, so editing a light reruns VBSP
+ * and VRAD but restores VVIS from cache. A restored BSP may carry an older entity lump;
+ * FCompilePipeline patches it with vbsp -onlyents (see EntityLumpMatches).
+ */
+class SOURCEBRIDGE_API FCompileArtifactCache
+{
+public:
+	static uint64 KeyForVBSP(const FString& VMFPath, const FString& ToolPath, const FString& GameDir, const FString& Arguments);
+	static uint64 KeyForVVIS(const FString& BSPPath, const FString& ToolPath, const FString& Arguments);
+	static uint64 KeyForVRAD(const FString& BSPPath, const FString& ToolPath, const FString& GameDir, const FString& Arguments);
+
+	/**
+	 * Copy a stage's cached outputs over the files next to BSPPath.
+	 * Returns false on a miss (or if the key is 0).
+	 */
+	static bool Restore(ECompileStage Stage, uint64 Key, const FString& BSPPath);
+
+	/** Store a stage's outputs (the BSP, plus the .prt after VBSP). Keeps the newest few per stage. */
+	static void Store(ECompileStage Stage, uint64 Key, const FString& BSPPath);
+
+	/** Whether a BSP's entity lump is byte-identical to EntityLump. */
+	static bool EntityLumpMatches(const FString& BSPPath, const TArray<uint8>& EntityLump);
+
+	/** Read the raw entity lump of a BSP. Returns false if the file isn't a readable BSP. */
+	static bool ReadEntityLump(const FString& BSPPath, TArray<uint8>& OutLump);
+
+	/** Delete every cached artifact (all maps). */
+	static void Clear();
+
+private:
+	static FString GetCacheDir(const FString& BSPPath);
+	static FString GetArtifactPath(ECompileStage Stage, uint64 Key, const FString& BSPPath, const TCHAR* Extension);
+};
@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 
 class UWorld;
+struct FCompileStageStats;
 
 /**
  * Estimated compile times for each stage.
@@ -21,16 +22,25 @@ struct FCompileTimeEstimate
 	/** Total estimated seconds. */
 	float TotalSeconds = 0.0f;
 
+	/** 90% interval for TotalSeconds. */
+	float LowSeconds = 0.0f;
+	float HighSeconds = 0.0f;
+
 	/** Confidence level: "low", "medium", "high". */
 	FString Confidence;
 
+	/** Past compiles on this machine the estimate was fitted to (0 = heuristics only). */
+	int32 CalibrationSamples = 0;
+
 	/** Scene complexity metrics used for estimation. */
 	int32 BrushCount = 0;
 	int32 BrushSideCount = 0;
 	int32 EntityCount = 0;
 	int32 LightCount = 0;
+	int32 PropCount = 0;
 	bool bHasDisplacements = false;
 	bool bFastCompile = true;
+	bool bFinalCompile = false;
 
 	/** Get a human-readable summary. */
 	FString GetSummary() const;
@@ -45,6 +55,12 @@ struct FCompileTimeEstimate
  * - vrad: Proportional to surface area * light count
  *
  * Fast compile (-fast flag) is ~10x faster for vvis and ~5x for vrad.
+ *
+ * Every recorded compile is stored in a per-machine history
+ * (Saved/SourceBridge/CompileHistory/<machine>.json). Once a stage has enough samples
+ * for a compile mode, log(actual) is fitted against log(heuristic) by least squares,
+ * which calibrates both the machine's speed and how the stage scales, and the
+ * prediction interval of that fit gives LowSeconds/HighSeconds.
  */
 class SOURCEBRIDGE_API FCompileEstimator
 {
@@ -60,4 +76,24 @@ public:
 		UWorld* World,
 		bool bFastCompile = true,
 		bool bFinalCompile = false);
+
+	/**
+	 * Add a finished compile to this machine's history.
+	 * @param Estimate The estimate made for the compiled scene (its metrics are stored)
+	 * @param Stages Measured tool timings; stages restored from cache are simply absent
+	 * @param ThreadCount -threads given to vvis/vrad (0 = all cores)
+	 */
+	static void RecordCompile(
+		const FCompileTimeEstimate& Estimate,
+		const TArray<FCompileStageStats>& Stages,
+		int32 ThreadCount);
+
+private:
+	/** Fill the per-stage heuristic estimates from the scene metrics. */
+	static void ApplyHeuristics(FCompileTimeEstimate& Est);
+
+	/** Replace heuristic stage times with fitted ones and set the interval. */
+	static void ApplyCalibration(FCompileTimeEstimate& Est);
+
+	static FString GetHistoryPath();
 };
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Compile/CompilePipeline.h"
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnCompileJobFinished, const FCompileResult& /*Result*/);
+
+/**
+ * A map compile running on a worker thread.
+ *
+ * The calling thread returns immediately. Tool output is collected line by line for the
+ * compile output window, and Cancel() kills the running tool's process tree.
+ *
+ * Usage:
+ *   TSharedRef<FCompileJob> Job = FCompileJob::StartMapCompile(Settings);
+ *   Job->OnFinished.AddLambda([](const FCompileResult& Result) { ... });
+ */
+class SOURCEBRIDGE_API FCompileJob : public TSharedFromThis<FCompileJob>
+{
+public:
+	/**
+	 * Start FCompilePipeline::CompileMap on a worker thread.
+	 * Hooks already set in Settings are still called, on the worker thread.
+	 */
+	static TSharedRef<FCompileJob> StartMapCompile(const FCompileSettings& Settings);
+
+	/** The most recently started job, if any. */
+	static TSharedPtr<FCompileJob> GetLatest();
+
+	/** Request cancellation. The running tool is killed at its next poll. */
+	void Cancel();
+
+	bool IsCancelRequested() const { return bCancelRequested; }
+	bool IsDone() const { return bDone; }
+
+	/** Name of the tool currently running (empty before the first tool and once done). */
+	FString GetCurrentTool() const;
+
+	/** Estimated progress of the whole compile, 0-1, from parsed tool output. */
+	float GetProgress() const;
+
+	/** Current progress phase of the running tool, e.g. "PortalFlow" (may be empty). */
+	FString GetCurrentPhase() const;
+
+	/** Seconds since the job started (frozen once done). */
+	double GetElapsedSeconds() const;
+
+	/**
+	 * Append output lines from index InOutNextLine onwards to OutLines and advance the index.
+	 * Safe to call from any thread while the job runs.
+	 */
+	void GetOutputSince(int32& InOutNextLine, TArray<FString>& OutLines) const;
+
+	/** The compile result. Only meaningful once IsDone() is true. */
+	FCompileResult GetResult() const;
+
+	/** Broadcast on the game thread when the compile finishes (including cancel/failure). */
+	FOnCompileJobFinished OnFinished;
+
+private:
+	FCompileJob() = default;
+
+	void AddLine(const FString& Line);
+	void Finish(FCompileResult&& InResult);
+
+	mutable FCriticalSection Lock;
+	TArray<FString> Lines;
+	FString CurrentTool;
+	FString CurrentPhase;
+	float Progress = 0.0f;
+	FCompileResult Result;
+
+	double StartTime = 0.0;
+	double EndTime = 0.0;
+	TAtomic<bool> bCancelRequested { false };
+	TAtomic<bool> bDone { false };
+
+	static TSharedPtr<FCompileJob> LatestJob;
+};
@@ -1,6 +1,29 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Compile/CompileTelemetry.h"
+
+/**
+ * Streaming and cancellation hooks for a compile. All of them are called on the thread
+ * running the compile (a worker thread when started through FCompileJob).
+ */
+struct SOURCEBRIDGE_API FCompileHooks
+{
+	/** Called when a tool is launched. */
+	TFunction<void(const FString& ToolName)> OnToolStarted;
+
+	/** Called for every complete line a tool writes to stdout or stderr. */
+	TFunction<void(const FString& ToolName, const FString& Line, bool bIsStdErr)> OnOutputLine;
+
+	/** Called with the unterminated tail of stdout as it grows (progress counters like "0...1...2"). */
+	TFunction<void(const FString& ToolName, const FString& PartialLine)> OnPartialLine;
+
+	/** Called for typed progress/leak/stats events parsed from map compile output. */
+	TFunction<void(const FCompileEvent& Event)> OnEvent;
+
+	/** Polled while a tool runs; returning true kills the tool's process tree. */
+	TFunction<bool()> ShouldCancel;
+};
 
 /**
  * Settings for a Source engine map compile.
@@ -24,6 +47,21 @@ struct SOURCEBRIDGE_API FCompileSettings
 
 	/** Copy resulting BSP to game's maps/ folder */
 	bool bCopyToGame = true;
+
+	/**
+	 * When only point entities changed since the last successful compile, patch the
+	 * existing BSP with vbsp -onlyents and skip vvis/vrad.
+	 */
+	bool bAllowEntityOnlyCompile = true;
+
+	/** Restore vbsp/vvis/vrad outputs from FCompileArtifactCache when a stage's inputs are unchanged */
+	bool bUseArtifactCache = true;
+
+	/** -threads passed to vvis and vrad (0 = the tools use every core). See FCompileScheduler. */
+	int32 ThreadCount = 0;
+
+	/** Output streaming and cancellation */
+	FCompileHooks Hooks;
 };
 
 /**
@@ -42,6 +80,29 @@ struct SOURCEBRIDGE_API FModelCompileSettings
 
 	/** Copy resulting MDL files to game's models/ folder */
 	bool bCopyToGame = true;
+
+	/** Restore unchanged models from FModelCompileCache instead of running studiomdl */
+	bool bUseCache = false;
+
+	/** Output streaming and cancellation */
+	FCompileHooks Hooks;
+};
+
+/**
+ * Wall time and memory use of one compile tool run.
+ */
+struct SOURCEBRIDGE_API FCompileStageStats
+{
+	FString ToolName;
+	double WallSeconds = 0.0;
+
+	/** Highest sampled memory use of the tool process in bytes (0 if unavailable) */
+	uint64 PeakMemoryBytes = 0;
+
+	int32 ReturnCode = -1;
+
+	/** A vbsp -onlyents patch of an existing BSP rather than a full run of the stage */
+	bool bEntitiesOnly = false;
 };
 
 /**
@@ -53,6 +114,51 @@ struct SOURCEBRIDGE_API FCompileResult
 	FString Output;
 	FString ErrorMessage;
 	double ElapsedSeconds = 0.0;
+
+	/** True when vbsp -onlyents patched the existing BSP and vvis/vrad were skipped. */
+	bool bEntitiesOnly = false;
+
+	/** True when the compile was cancelled through FCompileHooks::ShouldCancel. */
+	bool bCancelled = false;
+
+	/** True when cached outputs were restored and no tool ran. */
+	bool bFromCache = false;
+
+	/** One entry per tool that was launched, in order. */
+	TArray<FCompileStageStats> Stages;
+
+	/** Leak, vis and lighting data parsed from map compile output. */
+	FCompileTelemetry Telemetry;
+
+	/** JSON report written by CompileMap (empty if none was written). */
+	FString ReportPath;
+};
+
+/**
+ * What the last successful map compile was built from, saved next to the VMF as
+ * <mapname>.compilestate.
+ *
+ * The VMF's top-level blocks are split into two hashes. GeometryHash covers everything
+ * vbsp/vvis/vrad bake into the BSP: world solids and keyvalues, brush entities, lights,
+ * and point entities compiled into lumps (static props, overlays, cubemaps, ...).
+ * EntityHash covers the remaining point entities, which only live in the entity lump.
+ * Block IDs and editor-only data are ignored.
+ */
+struct SOURCEBRIDGE_API FMapCompileState
+{
+	uint64 GeometryHash = 0;
+	uint64 EntityHash = 0;
+	bool bFastCompile = false;
+	bool bFinalCompile = false;
+
+	/** Hash a VMF for the given compile settings. Returns false if the VMF can't be parsed. */
+	static bool Compute(const FString& VMFPath, const FCompileSettings& Settings, FMapCompileState& OutState);
+
+	static bool Load(const FString& StatePath, FMapCompileState& OutState);
+	bool Save(const FString& StatePath) const;
+
+	/** Path of the state file for a VMF (same directory, .compilestate extension). */
+	static FString GetStatePath(const FString& VMFPath);
 };
 
 /**
@@ -60,13 +166,19 @@ struct SOURCEBRIDGE_API FCompileResult
  * Runs vbsp -> vvis -> vrad via CLI to produce a playable .bsp from a .vmf.
  *
  * All tools follow the pattern: tool.exe -game "gamedir" input_file
+ *
+ * These calls block until the tools exit, streaming their output through the settings'
+ * FCompileHooks. Use FCompileJob to run a map compile on a worker thread.
  */
 class SOURCEBRIDGE_API FCompilePipeline
 {
 public:
 	/**
 	 * Run the full compile pipeline: vbsp -> vvis -> vrad.
+	 * If only point entities changed since the last compile (see FMapCompileState), runs
+	 * vbsp -onlyents against the existing BSP instead.
 	 * Optionally copies BSP to game's maps/ folder.
+	 * Tool output is parsed into FCompileEvents and a <map>.compile.json report.
 	 */
 	static FCompileResult CompileMap(const FCompileSettings& Settings);
 
@@ -77,17 +189,25 @@ public:
 	static FCompileResult CompileModel(const FModelCompileSettings& Settings);
 
 	/**
-	 * Pack custom content (models, materials) into a compiled BSP using bspzip.
+	 * Pack custom content (models, materials) into a compiled BSP's pakfile lump.
+	 * Written natively by FBSPPakWriter; files already packed unchanged are kept as is.
 	 *
 	 * @param BSPPath Path to the compiled .bsp file
-	 * @param ToolsDir Path to Source SDK bin directory containing bspzip.exe
 	 * @param FileList Map of internal paths (e.g., "models/foo/bar.mdl") to absolute disk paths
+	 * @param bCompress LZMA-compress the packed files (CS:GO and the Source 2013 multiplayer games; not L4D2)
 	 * @return Compile result
 	 */
 	static FCompileResult PackCustomContent(
 		const FString& BSPPath,
-		const FString& ToolsDir,
-		const TMap<FString, FString>& FileList);
+		const TMap<FString, FString>& FileList,
+		bool bCompress = false);
+
+	/**
+	 * Path of a compile tool ("vbsp", "studiomdl", ...) in ToolsDir for this platform:
+	 * <name>.exe on Windows; elsewhere the first of <name>, <name>_linux, <name>.sh and
+	 * <name>.exe that exists (<name> if none does).
+	 */
+	static FString GetToolPath(const FString& ToolsDir, const FString& ToolName);
 
 	/**
 	 * Try to auto-detect Source SDK tools in common Steam install paths.
@@ -102,11 +222,18 @@ public:
 	static FString FindGameDirectory(const FString& GameName = TEXT("cstrike"));
 
 private:
-	/** Run a single compile tool and capture output. */
+	/** The vbsp/vvis/vrad stages of CompileMap, without telemetry. */
+	static FCompileResult CompileMapStages(const FCompileSettings& Settings);
+
+	/**
+	 * Run a single compile tool, streaming its output line by line to the log and Hooks.
+	 * Records wall time and sampled peak memory in the result's single stage entry.
+	 */
 	static FCompileResult RunTool(
 		const FString& ToolPath,
 		const FString& Arguments,
-		const FString& ToolName);
+		const FString& ToolName,
+		const FCompileHooks& Hooks);
 
 	/** Common Steam library paths to search. */
 	static TArray<FString> GetSteamLibraryPaths();
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Compile/CompilePipeline.h"
+#include "Compile/CompileJob.h"
+
+/**
+ * One map waiting in a batch compile.
+ */
+struct SOURCEBRIDGE_API FCompileQueueItem
+{
+	FCompileSettings Settings;
+
+	/** Higher priorities start first; equal priorities keep queue order. */
+	int32 Priority = 0;
+};
+
+/**
+ * Outcome of a batch compile. Results are in queue order, not completion order.
+ */
+struct SOURCEBRIDGE_API FCompileBatchResult
+{
+	TArray<FCompileResult> Results;
+	int32 SucceededCount = 0;
+	int32 FailedCount = 0;
+	double ElapsedSeconds = 0.0;
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnCompileBatchMapFinished, int32 /*QueueIndex*/, const FCompileResult& /*Result*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnCompileBatchFinished, const FCompileBatchResult& /*Batch*/);
+
+/**
+ * A batch compile in progress, started by FCompileScheduler::StartBatch.
+ *
+ * Each map runs as an FCompileJob, so its output streams to the compile output window
+ * and Cancel() kills the running tools. Queued maps start from the game thread as
+ * running ones finish; everything here is game-thread only.
+ */
+class SOURCEBRIDGE_API FCompileBatch : public TSharedFromThis<FCompileBatch>
+{
+public:
+	/** The most recently started batch, if any. */
+	static TSharedPtr<FCompileBatch> GetLatest();
+
+	/** Cancel the running compiles and don't start the queued ones (reported as cancelled). */
+	void Cancel();
+
+	bool IsCancelRequested() const { return bCancelRequested; }
+	bool IsDone() const { return bDone; }
+
+	/** Results in queue order; complete once IsDone() is true. */
+	const FCompileBatchResult& GetResult() const { return Result; }
+
+	/** Broadcast on the game thread as each map finishes. */
+	FOnCompileBatchMapFinished OnMapFinished;
+
+	/** Broadcast on the game thread once every map has finished or been cancelled. */
+	FOnCompileBatchFinished OnFinished;
+
+private:
+	friend class FCompileScheduler;
+
+	FCompileBatch() = default;
+
+	/** Start queued maps while slots are free; finish the batch once nothing is left. */
+	void StartNext();
+	void OnJobFinished(int32 QueueIndex, int32 Threads, const FCompileResult& MapResult);
+	void Finish();
+
+	TArray<FCompileQueueItem> Queue;
+
+	/** Start order: priority descending, queue order within a priority */
+	TArray<int32> Order;
+	int32 NextOrder = 0;
+
+	int32 Budget = 1;
+	int32 Concurrency = 1;
+	int32 ThreadsInUse = 0;
+
+	/** Queue index -> its running job */
+	TMap<int32, TSharedRef<FCompileJob>> RunningJobs;
+
+	FCompileBatchResult Result;
+	double StartTime = 0.0;
+	bool bCancelRequested = false;
+	bool bDone = false;
+
+	static TSharedPtr<FCompileBatch> LatestBatch;
+};
+
+/**
+ * Splits a CPU thread budget between map compiles.
+ *
+ * vvis and vrad get "-threads N" from the budget. A batch runs several maps at once:
+ * each compile takes an even share of the threads still free when it starts, so the
+ * last maps in the queue pick up the cores earlier ones released.
+ *
+ * Usage:
+ *   TSharedRef<FCompileBatch> Batch = FCompileScheduler::StartBatch(Queue, 0, 0);
+ *   Batch->OnFinished.AddLambda([](const FCompileBatchResult& Result) { ... });
+ */
+class SOURCEBRIDGE_API FCompileScheduler
+{
+public:
+	/**
+	 * Resolve a user thread budget. 0 or less means every logical core but one
+	 * (left for the editor); larger values are clamped to the core count.
+	 */
+	static int32 GetThreadBudget(int32 RequestedBudget);
+
+	/**
+	 * How many maps to compile at once. RequestedConcurrency of 0 or less picks one
+	 * compile per 4 budgeted threads. Never more than QueueLength or the budget.
+	 */
+	static int32 GetConcurrency(int32 ThreadBudget, int32 RequestedConcurrency, int32 QueueLength);
+
+	/**
+	 * Start compiling every queued map and return immediately. Call on the game thread.
+	 * Each item's ThreadCount is overwritten with its share of the budget.
+	 * An empty queue is done (and OnFinished already broadcast) when this returns.
+	 */
+	static TSharedRef<FCompileBatch> StartBatch(
+		const TArray<FCompileQueueItem>& Queue,
+		int32 ThreadBudget,
+		int32 MaxConcurrent);
+
+	/**
+	 * Run studiomdl for every model, MaxConcurrent processes at a time (0 or less = one
+	 * per budgeted thread; studiomdl is single-threaded). Blocks until all finish.
+	 * Results are in input order. OnModelFinished runs on the compile's worker thread.
+	 */
+	static TArray<FCompileResult> RunModelBatch(
+		const TArray<FModelCompileSettings>& Models,
+		int32 MaxConcurrent,
+		TFunction<void(int32 /*ModelIndex*/, const FCompileResult&)> OnModelFinished = nullptr);
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FCompileResult;
+
+/** Kind of event recognised in compile tool output. */
+enum class ECompileEventType : uint8
+{
+	/** A "Phase: 0...1...2" progress counter advanced. */
+	PhaseProgress,
+	/** vbsp reported a leak (Path is the pointfile once written). */
+	Leak,
+	/** vvis portal/cluster counts. */
+	VisStats,
+	/** vrad finished a light bounce (Value is the bounce number). */
+	RadBounce,
+	/** vrad light and lightmap totals. */
+	RadStats
+};
+
+/**
+ * A typed event parsed from vbsp/vvis/vrad output.
+ */
+struct SOURCEBRIDGE_API FCompileEvent
+{
+	ECompileEventType Type = ECompileEventType::PhaseProgress;
+	FString ToolName;
+
+	/** Current phase label, e.g. "PortalFlow" (PhaseProgress only). */
+	FString Phase;
+
+	/** Progress of the current phase, 0-1. */
+	float PhaseProgress = 0.0f;
+
+	/** Estimated progress of the whole vbsp/vvis/vrad run, 0-1. */
+	float OverallProgress = 0.0f;
+
+	/** Leaked entity description, or the raw line for stats events. */
+	FString Text;
+
+	/** Pointfile path (Leak only). */
+	FString Path;
+
+	/** Event-specific number: bounce index, portal count, ... */
+	int64 Value = 0;
+};
+
+/** Wall time of one progress phase, e.g. vvis PortalFlow. */
+struct SOURCEBRIDGE_API FCompilePhaseTiming
+{
+	FString ToolName;
+	FString Phase;
+	double Seconds = 0.0;
+};
+
+/**
+ * Everything the telemetry parser extracted from one map compile.
+ */
+struct SOURCEBRIDGE_API FCompileTelemetry
+{
+	TArray<FCompilePhaseTiming> Phases;
+
+	// vbsp
+	bool bLeaked = false;
+	FString LeakEntity;
+	FString PointfilePath;
+
+	// vvis
+	int32 PortalClusters = 0;
+	int32 Portals = 0;
+	int32 AverageClustersVisible = 0;
+
+	// vrad
+	int32 DirectLights = 0;
+	int32 Bounces = 0;
+	/** Sum of the RGB energy added by the last bounce (drops as vrad converges). */
+	int64 LastBounceEnergy = 0;
+	int64 LightmapBytes = 0;
+
+	/** Lightmap luxels (4 bytes each, LDR + HDR). */
+	int64 GetLightmapTexels() const { return LightmapBytes / 4; }
+};
+
+/**
+ * Turns the live output stream of vbsp/vvis/vrad into FCompileEvents.
+ *
+ * The tools print progress counters without a newline ("BuildFacelights: 0...1...2"),
+ * so unterminated output is fed through ParsePartial as it arrives. Overall progress
+ * weights each tool and its main phases by their typical share of compile time.
+ *
+ * Not thread-safe; feed it from the thread running the compile.
+ */
+class SOURCEBRIDGE_API FCompileTelemetryParser
+{
+public:
+	/** Called for every event, on the feeding thread. */
+	TFunction<void(const FCompileEvent&)> OnEvent;
+
+	void BeginTool(const FString& ToolName);
+
+	/** Parse a complete output line. */
+	void ParseLine(const FString& Line);
+
+	/** Parse the unterminated tail of the current line (progress counters). */
+	void ParsePartial(const FString& Text);
+
+	/** Close the open phase and report a leak no pointfile line followed. */
+	void Finish();
+
+	const FCompileTelemetry& GetTelemetry() const { return Telemetry; }
+	float GetOverallProgress() const { return OverallProgress; }
+
+private:
+	void UpdatePhaseProgress(const FString& Text, bool bLineComplete);
+	void EndPhase();
+	void Emit(ECompileEventType Type, const FString& Text = FString(), int64 Value = 0);
+
+	FCompileTelemetry Telemetry;
+
+	FString CurrentTool;
+	FString CurrentPhase;
+	float CurrentPhaseProgress = 0.0f;
+	double PhaseStartTime = 0.0;
+	float OverallProgress = 0.0f;
+	bool bLeakReported = false;
+};
+
+/**
+ * JSON compile report written next to the map (<map>.compile.json).
+ */
+class SOURCEBRIDGE_API FCompileReport
+{
+public:
+	static FString GetReportPath(const FString& VMFPath);
+
+	/** Write stages, phase timings and telemetry for a compile. */
+	static bool Write(const FString& VMFPath, const FCompileResult& Result);
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Size and use of the model compile cache.
+ */
+struct SOURCEBRIDGE_API FModelCacheStats
+{
+	int32 EntryCount = 0;
+	int64 TotalBytes = 0;
+
+	/** Lookups since the editor started */
+	int32 Hits = 0;
+	int32 Misses = 0;
+
+	float GetHitRate() const
+	{
+		int32 Lookups = Hits + Misses;
+		return Lookups > 0 ? (float)Hits / Lookups : 0.0f;
+	}
+};
+
+/**
+ * Content-addressed store of studiomdl outputs, under Saved/SourceBridge/ModelCache/<key>/.
+ *
+ * The key hashes the QC, every SMD it references, the studiomdl executable (path, size,
+ * timestamp) and the game directory. A hit copies the cached .mdl/.vvd/.vtx/.phy set
+ * into the game's models folder, so an unchanged mesh never reaches studiomdl.
+ *
+ * Entries are trimmed least recently used first once the cache passes its disk budget.
+ * Safe to call from several compile workers at once.
+ */
+class SOURCEBRIDGE_API FModelCompileCache
+{
+public:
+	/** Key for compiling QCPath. Returns 0 if the QC can't be read. */
+	static uint64 ComputeKey(const FString& QCPath, const FString& StudioMDLPath, const FString& GameDir);
+
+	/** The $modelname of a QC file, without ".mdl" (e.g. "props/crate"). Empty if none. */
+	static FString ReadModelName(const FString& QCPath);
+
+	/** Copy a cached output set into GameDir/models. Returns false on a miss. */
+	static bool Restore(uint64 Key, const FString& GameDir, const FString& ModelName);
+
+	/**
+	 * Store the outputs studiomdl wrote for ModelName. Only files written at or after
+	 * CompileStartTime are taken, so stale outputs from older compiles are left out.
+	 */
+	static void Store(uint64 Key, const FString& GameDir, const FString& ModelName, const FDateTime& CompileStartTime);
+
+	/** Delete least recently used entries until the cache fits in BudgetBytes. */
+	static void Trim(int64 BudgetBytes);
+
+	static FModelCacheStats GetStats();
+
+	/** Delete every cached model. */
+	static void Clear();
+
+private:
+	static FString GetCacheRoot();
+
+	/** Compiled files for ModelName in GameDir/models (all of them if MinTime is MinValue). */
+	static TArray<FString> FindOutputs(const FString& GameDir, const FString& ModelName, const FDateTime& MinTime);
+};
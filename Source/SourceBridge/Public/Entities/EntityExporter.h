@@ -110,6 +110,9 @@ private:
 	/** Try to export an overlay/decal (actor tagged with "overlay:material"). */
 	static bool TryExportOverlay(AActor* Actor, FEntityExportResult& Result);
 
+	/** Try to export an instanced static prop group as one prop_static per instance. */
+	static bool TryExportStaticPropGroup(AActor* Actor, FEntityExportResult& Result);
+
 	/** Try to export a brush entity (ASourceBrushEntity). */
 	static bool TryExportBrushEntity(AActor* Actor, FEntityExportResult& Result);
 
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Entities/FGDParser.h"
+
+/**
+ * Binary snapshot of a parsed FGD database, stored under Saved/SourceBridge/FGDCache/.
+ *
+ * The cache records the path, size and CRC32 of the root FGD and every file it
+ * @include'd. It is only used when all of them still match, so editing any included
+ * FGD (or adding a missing one) forces a reparse.
+ *
+ * Only the raw classes and warnings are stored; the resolved-class table is rebuilt
+ * after loading.
+ */
+class SOURCEBRIDGE_API FFGDBinaryCache
+{
+public:
+	/** Path of the cache file for an FGD (keyed by its absolute path). */
+	static FString GetCachePath(const FString& AbsFGDPath);
+
+	/** Compute the size and CRC32 of a file on disk. Size is -1 if it cannot be read. */
+	static FFGDSourceFile HashFile(const FString& AbsPath);
+
+	/**
+	 * Write a cache for a freshly parsed database.
+	 * @param SourceFiles Every file read while parsing, root first
+	 */
+	static bool Write(const FString& AbsFGDPath, const FFGDDatabase& Database,
+		const TArray<FFGDSourceFile>& SourceFiles);
+
+	/**
+	 * Load the database from the cache if every recorded source file is unchanged.
+	 * Returns false (leaving OutDatabase untouched) on a missing, stale or corrupt cache.
+	 */
+	static bool TryRead(const FString& AbsFGDPath, FFGDDatabase& OutDatabase);
+};
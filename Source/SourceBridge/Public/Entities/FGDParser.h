@@ -149,6 +149,20 @@ struct SOURCEBRIDGE_API FFGDEntityClass
 
 	/** Find an output by name. Returns nullptr if not found. */
 	const FFGDIODef* FindOutput(const FString& Name) const;
+
+	/**
+	 * Build name -> index maps so the Find* functions hash instead of scanning.
+	 * The Properties/Inputs/Outputs arrays must not change afterwards; classes in the
+	 * resolved table are immutable, so they are always indexed.
+	 */
+	void BuildLookup();
+
+private:
+	/** Case-insensitive name -> array index (first occurrence wins, like the linear scan). */
+	TMap<FString, int32> PropertyLookup;
+	TMap<FString, int32> InputLookup;
+	TMap<FString, int32> OutputLookup;
+	bool bHasLookup = false;
 };
 
 /**
@@ -177,11 +191,27 @@ struct SOURCEBRIDGE_API FFGDDatabase
 	/**
 	 * Get a fully resolved entity class with all base class properties merged.
 	 * Properties from derived classes override base class properties.
+	 * Returns a copy; prefer FindResolved() on hot paths.
 	 */
 	FFGDEntityClass GetResolved(const FString& ClassName) const;
 
+	/**
+	 * Get the shared, immutable resolved class from the flattened table.
+	 * Returns nullptr if the class is not in the FGD.
+	 */
+	TSharedPtr<const FFGDEntityClass> FindResolved(const FString& ClassName) const;
+
+	/**
+	 * Resolve every class once into the flattened table used by FindResolved().
+	 * Called by FFGDParser after parsing; call again if Classes is modified by hand.
+	 */
+	void BuildResolvedTable();
+
 private:
-	FFGDEntityClass GetResolvedInternal(const FString& ClassName, TSet<FString>& Visited) const;
+	/** Flattened classes with inheritance merged. Key = classname (case-insensitive). */
+	TMap<FString, TSharedPtr<const FFGDEntityClass>> ResolvedClasses;
+
+	TSharedPtr<const FFGDEntityClass> ResolveMemoized(const FString& ClassName, TSet<FString>& InProgress);
 
 public:
 	/** Validate an entity's keyvalues against the FGD schema. Returns warnings. */
@@ -197,6 +227,22 @@ public:
 		const FString& InputName) const;
 };
 
+/**
+ * One file that went into a parsed FGD database (root file or @include).
+ * Used as the key of the binary FGD cache.
+ */
+struct FFGDSourceFile
+{
+	/** Absolute path */
+	FString Path;
+
+	/** Size in bytes, or -1 if the file could not be read */
+	int64 Size = -1;
+
+	/** CRC32 of the file bytes */
+	uint32 Crc = 0;
+};
+
 /**
  * Parses Valve FGD (Forge Game Data) files.
  *
@@ -208,6 +254,9 @@ public:
  *
  * Supports @include directives for nested FGD files.
  *
+ * ParseFile() keeps a binary cache of each parsed database (see FFGDBinaryCache), so
+ * unchanged FGDs load without reparsing.
+ *
  * Usage:
  *   FFGDDatabase DB = FFGDParser::ParseFile("path/to/cstrike.fgd");
  *   const FFGDEntityClass* Trigger = DB.FindClass("trigger_multiple");
@@ -218,6 +267,7 @@ public:
 	/**
 	 * Parse an FGD file and all @include'd files.
 	 * Returns a database of all parsed entity classes.
+	 * Loads from the binary cache when none of the files have changed.
 	 */
 	static FFGDDatabase ParseFile(const FString& FilePath);
 
@@ -233,8 +283,12 @@ private:
 		FFGDDatabase& Database;
 		FString BaseDirectory;
 		TSet<FString> IncludedFiles; // prevent circular includes
+		TArray<FFGDSourceFile> SourceFiles; // every file read, for the binary cache key
 	};
 
+	/** Load an FGD file as text and record its size and CRC in SourceFiles. */
+	static bool LoadSourceFile(const FString& AbsPath, FString& OutContent, TArray<FFGDSourceFile>& SourceFiles);
+
 	static void ParseContent(const FString& Content, FParseContext& Context);
 	static void ParseEntityClass(const FString& Content, int32& Pos, FParseContext& Context);
 	static void ParseProperty(const FString& Content, int32& Pos, FFGDEntityClass& EntityClass, FParseContext& Context);
@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "VMF/VMFKeyValues.h"
+#include "VMF/VMFPlaneTable.h"
 
 class UWorld;
 class AStaticMeshActor;
@@ -67,6 +68,9 @@ struct FMeshToBrushResult
 
 	/** Warnings generated during conversion. */
 	TArray<FString> Warnings;
+
+	/** Side planes written through FVMFPlaneTable (empty when it's disabled). */
+	TArray<FVMFPlaneUse> Planes;
 };
 
 class SOURCEBRIDGE_API FPropExporter
@@ -75,7 +79,7 @@ public:
 	/**
 	 * Export all static mesh actors from a world as prop entities.
 	 * Actors tagged source:worldspawn or source:func_detail are skipped here
-	 * (handled by CollectMeshBrushes instead).
+	 * (FVMFExporter converts them to brushes instead).
 	 */
 	static TArray<FVMFKeyValues> ExportProps(
 		UWorld* World,
@@ -90,15 +94,6 @@ public:
 		int32 EntityId,
 		const FPropExportSettings& Settings);
 
-	/**
-	 * Collect all static mesh actors that should be exported as brush geometry.
-	 * Handles source:worldspawn, source:func_detail tags and auto-detection.
-	 */
-	static TArray<FMeshToBrushResult> CollectMeshBrushes(
-		UWorld* World,
-		int32& SolidIdCounter,
-		int32& SideIdCounter);
-
 	/**
 	 * Try to convert a static mesh actor to VMF brush solids.
 	 * Returns success if the mesh is convex with reasonable face count.
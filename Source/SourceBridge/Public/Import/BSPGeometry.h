@@ -0,0 +1,108 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/Float16Color.h"
+
+class FBSPReader;
+
+/** Triangles of one material within one chunk of a BSP model, in Source coordinates. */
+struct FBSPMeshSection
+{
+	/** Source material path as vbsp referenced it, with cubemap/WVT patch names undone */
+	FString Material;
+
+	/** Texture size vbsp used for this material (texdata), for normalizing UVs */
+	int32 TextureWidth = 512;
+	int32 TextureHeight = 512;
+
+	/** True when every face is a tools material (nodraw-like surfaces that still render, e.g. skybox) */
+	bool bToolsMaterial = false;
+
+	TArray<FVector3f> Positions;
+	TArray<FVector3f> Normals;
+
+	/** Texture U axis, for tangents */
+	TArray<FVector3f> TangentsU;
+
+	/** Texture coordinates in texels (divide by the texture size) */
+	TArray<FVector2f> TexelUVs;
+
+	/** Counter-clockwise around the normal in Source's right-handed space */
+	TArray<int32> Indices;
+
+	/** Normalized UVs into the chunk's lightmap atlas (empty when lightmaps weren't built) */
+	TArray<FVector2f> LightmapUVs;
+};
+
+/** vrad's baked lighting for one chunk: every lightmapped face's luxels packed into one texture. */
+struct FBSPLightmapAtlas
+{
+	int32 Width = 0;
+	int32 Height = 0;
+
+	/** Linear light, row-major. Unlit faces map to a fullbright block at the origin. */
+	TArray<FFloat16Color> Pixels;
+
+	/** True when read from the HDR lighting lump */
+	bool bHDR = false;
+
+	bool IsValid() const { return Width > 0 && Height > 0; }
+};
+
+/** Sections of a BSP model whose faces fall into one spatial cell. */
+struct FBSPMeshChunk
+{
+	FIntVector Cell = FIntVector::ZeroValue;
+	FBox3f Bounds = FBox3f(ForceInit);
+	TArray<FBSPMeshSection> Sections;
+
+	FBSPLightmapAtlas Lightmap;
+};
+
+/** Render geometry of one dmodel_t: model 0 is the world, the rest belong to brush entities ("model" "*N"). */
+struct FBSPModelMesh
+{
+	int32 ModelIndex = 0;
+
+	/** Model bounds as stored by vbsp */
+	FBox3f Bounds = FBox3f(ForceInit);
+
+	TArray<FBSPMeshChunk> Chunks;
+
+	int32 FaceCount = 0;
+	int32 DisplacementCount = 0;
+	int32 TriangleCount = 0;
+	int32 LightmappedFaceCount = 0;
+};
+
+/**
+ * Builds render meshes straight from a compiled BSP's faces, skipping the VMF
+ * round-trip and CSG reconstruction.
+ *
+ * Reads the models, faces, edges, surfedges, vertexes, texinfo and texdata lumps.
+ * Faces vbsp split for T-junctions are triangulated from their primitives, displacement
+ * faces from their dispinfo/dispverts grids; nodraw, hint and skip faces are dropped, as
+ * the engine never draws them. Faces are grouped per spatial chunk (by face center) and
+ * per material within each chunk.
+ *
+ * Optionally the baked lighting is read too: each face's luxel block (LightmapSize + 1
+ * samples per axis at LightOffset, all of its light styles summed, the unbumped set of
+ * bumpmapped faces) is decoded from the HDR lighting lump, or the LDR one when the map has
+ * no HDR lighting, and packed into a per-chunk atlas that LightmapUVs index.
+ */
+class SOURCEBRIDGE_API FBSPGeometry
+{
+public:
+	/**
+	 * Build every model of an opened BSP.
+	 * @param ChunkSize Edge length of the chunk grid in Source units (0 = one chunk per model)
+	 * @param bLightmaps Also build lightmap atlases and LightmapUVs
+	 */
+	static TArray<FBSPModelMesh> Build(const FBSPReader& Reader, float ChunkSize = 2048.0f, bool bLightmaps = false);
+
+	/**
+	 * Undo vbsp's material patching: "maps/<map>/brick/wall01_128_-64_32" (cubemap) and
+	 * "..._wvt_patch" (blend textures) go back to "brick/wall01".
+	 */
+	static FString UnpatchMaterialName(const FString& Material);
+};
@@ -4,17 +4,25 @@
 #include "Import/VMFImporter.h"
 
 /**
- * Imports Source BSP files by decompiling them with BSPSource, then
- * importing the resulting VMF via FVMFImporter.
+ * Imports Source BSP files into the editor world via FVMFImporter.
+ *
+ * Embedded assets and entities are read natively with FBSPReader. Brush geometry is
+ * decompiled with BSPSource into editable solids when it is installed; otherwise (or with
+ * bUseCompiledBSPGeometry) the compiled faces are imported directly as meshes, see FBSPGeometry.
+ * Static props are read from the sprp game lump and imported instanced (FBSPStaticProps).
+ * Compiled geometry carries the map's baked lightmaps (bImportLightmaps), saved as atlas
+ * textures under /Game/SourceBridge/Lightmaps/<mapname>/.
+ * Imported actors are tagged with the vis clusters they touch and an ASourceVisibility actor
+ * culls them by the map's PVS (bImportVisibility, see FBSPVisibility).
  *
  * Output goes to Saved/SourceBridge/Import/<mapname>/ including:
- * - Decompiled VMF file
- * - Extracted materials (.vmt) and textures (.vtf) from BSP pakfile
+ * - Every file from the BSP pakfile (materials, models, sounds...), at its game path
+ * - Decompiled VMF file and its binary parse cache (.vmfc, see FVMFBinaryCache), with BSPSource
  */
 class SOURCEBRIDGE_API FBSPImporter
 {
 public:
-	/** Import a BSP file into the given world. Decompiles via BSPSource first. */
+	/** Import a BSP file into the given world. */
 	static FVMFImportResult ImportFile(const FString& BSPPath, UWorld* World,
 		const FVMFImportSettings& Settings = FVMFImportSettings());
 
@@ -22,9 +30,9 @@ public:
 	static FString FindBSPSourceJavaPath();
 
 	/**
-	 * Decompile a BSP to VMF using BSPSource with asset extraction.
+	 * Decompile a BSP to VMF using BSPSource (geometry only; assets come from FBSPReader).
 	 * @param BSPPath Path to the input BSP file
-	 * @param OutputDir Directory for decompiled VMF and extracted assets
+	 * @param OutputDir Directory for the decompiled VMF
 	 * @param OutError Error message if decompilation fails
 	 * @return Path to the decompiled VMF file, or empty on failure
 	 */
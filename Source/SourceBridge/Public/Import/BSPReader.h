@@ -0,0 +1,263 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VMF/VMFKeyValues.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/** BSP lump indices (Source 2007+ numbering). */
+enum class EBSPLump : int32
+{
+	Entities = 0,
+	Planes = 1,
+	TexData = 2,
+	Vertexes = 3,
+	Visibility = 4,
+	Nodes = 5,
+	TexInfo = 6,
+	Faces = 7,
+	Lighting = 8,
+	Occlusion = 9,
+	Leafs = 10,
+	FaceIds = 11,
+	Edges = 12,
+	SurfEdges = 13,
+	Models = 14,
+	WorldLights = 15,
+	LeafFaces = 16,
+	LeafBrushes = 17,
+	Brushes = 18,
+	BrushSides = 19,
+	Areas = 20,
+	AreaPortals = 21,
+	DispInfo = 26,
+	OriginalFaces = 27,
+	DispVerts = 33,
+	DispLightmapSamplePositions = 34,
+	GameLump = 35,
+	LeafWaterData = 36,
+	Primitives = 37,
+	PrimVerts = 38,
+	PrimIndices = 39,
+	PakFile = 40,
+	ClipPortalVerts = 41,
+	Cubemaps = 42,
+	TexDataStringData = 43,
+	TexDataStringTable = 44,
+	Overlays = 45,
+	LeafMinDistToWater = 46,
+	FaceMacroTextureInfo = 47,
+	DispTris = 48,
+	LightingHDR = 53,
+	WorldLightsHDR = 54,
+	LeafAmbientLightingHDR = 55,
+	LeafAmbientLighting = 56,
+	FacesHDR = 58,
+
+	Count = 64
+};
+
+/** One entry of the BSP header's lump directory. */
+struct FBSPLumpInfo
+{
+	int32 Offset = 0;
+	int32 Length = 0;
+	int32 Version = 0;
+
+	/** Uncompressed size when the lump is LZMA compressed, else 0 */
+	int32 FourCC = 0;
+};
+
+/** A file inside the pakfile lump's ZIP archive. */
+struct FBSPPakEntry
+{
+	/** Path inside the archive, lowercase with forward slashes (e.g. "materials/foo/bar.vmt") */
+	FString Path;
+
+	uint32 CRC = 0;
+
+	/** Modification time in MS-DOS format, as stored */
+	uint32 DosTime = 0;
+
+	/** ZIP compression method: 0 stored, 8 deflate, 14 LZMA */
+	uint16 Method = 0;
+
+	int64 CompressedSize = 0;
+	int64 UncompressedSize = 0;
+
+	/** Offset of the local file header, relative to the pakfile lump */
+	int64 LocalHeaderOffset = 0;
+};
+
+/** One entry of the game lump directory (dgamelump_t). */
+struct FBSPGameLumpInfo
+{
+	/** FourCC as an int, e.g. 'sprp' for static props */
+	int32 Id = 0;
+
+	/** Bit 0 set when the sub-lump is LZMA compressed */
+	uint16 Flags = 0;
+	uint16 Version = 0;
+
+	/** Offset from the start of the file */
+	int32 Offset = 0;
+	int32 Length = 0;
+};
+
+/** dtexdata_t with its material name resolved through the string table. */
+struct FBSPTexData
+{
+	FVector3f Reflectivity = FVector3f::ZeroVector;
+	FString MaterialName;
+	int32 Width = 0;
+	int32 Height = 0;
+};
+
+/**
+ * Reads compiled Source BSP files (versions 19-21) without decompiling them.
+ *
+ * The file is memory-mapped (with a whole-file read as fallback), the header and lump
+ * directory are validated, and lumps are served as views into the mapping. Lumps stored
+ * LZMA-compressed are decompressed on request. L4D2's v21 lump directory layout is
+ * detected automatically.
+ *
+ * Usage:
+ *   FBSPReader Reader;
+ *   if (Reader.Open(BSPPath))
+ *   {
+ *       TArray<FVMFKeyValues> Entities = Reader.ReadEntities();
+ *       Reader.ExtractPakFile(OutputDir);
+ *   }
+ */
+class SOURCEBRIDGE_API FBSPReader
+{
+public:
+	FBSPReader();
+	~FBSPReader();
+
+	FBSPReader(const FBSPReader&) = delete;
+	FBSPReader& operator=(const FBSPReader&) = delete;
+
+	/** Map and validate a BSP file. Returns false (see GetError) if it isn't a readable BSP. */
+	bool Open(const FString& BSPPath);
+
+	void Close();
+
+	bool IsOpen() const { return Data != nullptr; }
+	const FString& GetError() const { return Error; }
+	int32 GetVersion() const { return Version; }
+	int32 GetMapRevision() const { return MapRevision; }
+
+	const FBSPLumpInfo& GetLumpInfo(EBSPLump Lump) const { return Lumps[(int32)Lump]; }
+
+	/** True for L4D2-style v21 files, whose lump entries start with the version instead of the offset. */
+	bool HasVersionFirstLumps() const { return bVersionFirstLumps; }
+
+	/** Size of the mapped file in bytes. */
+	int64 GetFileSize() const { return DataSize; }
+
+	/** The lump's bytes as stored in the file (still compressed if FourCC != 0). */
+	TArrayView<const uint8> GetRawLump(EBSPLump Lump) const;
+
+	/**
+	 * The map CRC the engine compares between server and client: CRC32 over every lump
+	 * except the entities, as stored, in lump order. Nothing in the file records it.
+	 */
+	uint32 ComputeMapChecksum() const;
+
+	/** Copy a lump out, decompressing it if needed. Returns false if it is corrupt. */
+	bool ReadLump(EBSPLump Lump, TArray<uint8>& OutData) const;
+
+	/** Read a lump as an array of fixed-size structs. Trailing partial elements are dropped. */
+	template <typename T>
+	bool ReadLumpArray(EBSPLump Lump, TArray<T>& OutItems) const
+	{
+		TArray<uint8> Bytes;
+		if (!ReadLump(Lump, Bytes))
+		{
+			return false;
+		}
+		OutItems.SetNumUninitialized(Bytes.Num() / sizeof(T));
+		FMemory::Memcpy(OutItems.GetData(), Bytes.GetData(), OutItems.Num() * sizeof(T));
+		return true;
+	}
+
+	// ---- Game lump ----
+
+	/** Entries of the game lump directory (parsed on first use). */
+	const TArray<FBSPGameLumpInfo>& GetGameLumps() const;
+
+	/**
+	 * Copy a game lump sub-lump out by id ('sprp', 'dprp'...), decompressing it if needed.
+	 * Returns false if the map has none or it is corrupt.
+	 */
+	bool ReadGameLump(int32 Id, TArray<uint8>& OutData, int32& OutVersion) const;
+
+	// ---- Entities ----
+
+	/** The entity lump as text. */
+	FString ReadEntityString() const;
+
+	/**
+	 * Parse the entity lump into VMF-style blocks: worldspawn becomes a "world" block and
+	 * every other entity an "entity" block. Outputs (values with ESC or four commas under
+	 * an On.../Out... key) are moved into a "connections" child, as in a VMF.
+	 * Brush entities keep their "model" "*N" key; they have no solids.
+	 */
+	TArray<FVMFKeyValues> ReadEntities() const;
+
+	// ---- Pakfile ----
+
+	/** Files in the pakfile lump (parsed from its ZIP central directory on first use). */
+	const TArray<FBSPPakEntry>& GetPakEntries() const;
+
+	/** An entry's data as stored in the archive (still compressed). Empty if the entry is corrupt. */
+	TArrayView<const uint8> GetPakEntryData(const FBSPPakEntry& Entry) const;
+
+	/** Decompress one pakfile entry (stored, deflate or LZMA). */
+	bool ReadPakFile(const FBSPPakEntry& Entry, TArray<uint8>& OutData) const;
+
+	/** Find a pakfile entry by path (case-insensitive, either slash). Null if absent. */
+	const FBSPPakEntry* FindPakEntry(const FString& Path) const;
+
+	/**
+	 * Write every pakfile entry under OutputDir, keeping its relative path.
+	 * Returns the number of files written.
+	 */
+	int32 ExtractPakFile(const FString& OutputDir) const;
+
+	// ---- Texture data ----
+
+	/** Material names of the texdata string table, indexed like dtexdata_t::nameStringTableID. */
+	TArray<FString> ReadTexDataStrings() const;
+
+	/** Every dtexdata_t with its material name. */
+	TArray<FBSPTexData> ReadTexData() const;
+
+private:
+	bool ParsePakDirectory() const;
+	void ParseGameLumpDirectory() const;
+
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/** Whole-file copy used when the file can't be mapped */
+	TArray<uint8> FileData;
+
+	const uint8* Data = nullptr;
+	int64 DataSize = 0;
+
+	int32 Version = 0;
+	int32 MapRevision = 0;
+	bool bVersionFirstLumps = false;
+	FBSPLumpInfo Lumps[(int32)EBSPLump::Count];
+	FString Error;
+
+	mutable bool bGameLumpsParsed = false;
+	mutable TArray<FBSPGameLumpInfo> GameLumps;
+
+	mutable bool bPakParsed = false;
+	mutable TArray<FBSPPakEntry> PakEntries;
+	mutable TMap<FString, int32> PakIndex;
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FBSPReader;
+
+/** StaticPropLump_t flags (the 8-bit Flags field). */
+namespace EBSPStaticPropFlags
+{
+	enum : uint8
+	{
+		Fades = 0x01,
+		UseLightingOrigin = 0x02,
+		NoDraw = 0x04,
+		IgnoreNormals = 0x08,
+		NoShadow = 0x10,
+		ScreenSpaceFade = 0x20,
+		NoPerVertexLighting = 0x40,
+		NoSelfShadowing = 0x80,
+	};
+}
+
+/** One placement from the sprp game lump, in Source coordinates. */
+struct FBSPStaticProp
+{
+	FVector3f Origin = FVector3f::ZeroVector;
+
+	/** Pitch, yaw, roll in degrees, as stored */
+	FVector3f Angles = FVector3f::ZeroVector;
+
+	/** Index into FBSPStaticPropLump::Models */
+	int32 ModelIndex = 0;
+
+	int32 Skin = 0;
+
+	/** 0 not solid, 2 bounding box, 6 VPhysics */
+	uint8 Solid = 6;
+
+	/** EBSPStaticPropFlags */
+	uint8 Flags = 0;
+
+	/** Extended flags (v10+ layouts that have them) */
+	uint32 FlagsEx = 0;
+
+	/** Source units; FadeMaxDist 0 = never fades */
+	float FadeMinDist = 0.0f;
+	float FadeMaxDist = 0.0f;
+
+	/** v5+ */
+	float ForcedFadeScale = 1.0f;
+
+	/** Color and alpha tint (v7+ except the SDK 2013 layout, "rendercolor"/"renderamt" of the prop_static) */
+	FColor DiffuseModulation = FColor::White;
+
+	/** v11+ ("modelscale") */
+	float UniformScale = 1.0f;
+};
+
+/** Contents of the sprp game lump. */
+struct FBSPStaticPropLump
+{
+	int32 Version = 0;
+
+	/** Model dictionary ("models/props/barrel.mdl") */
+	TArray<FString> Models;
+
+	TArray<FBSPStaticProp> Props;
+};
+
+/**
+ * Reads static props straight from a compiled BSP's sprp game lump.
+ *
+ * vbsp removes prop_static entities from the entity lump and stores them here: a model
+ * dictionary, the leaf list (ignored here) and one fixed-size record per prop. Versions 4
+ * to 11 are read. Games disagree on the record layout for some versions, so the record
+ * size is derived from the lump length and fields are only read when the record has room
+ * for them.
+ */
+class SOURCEBRIDGE_API FBSPStaticProps
+{
+public:
+	/** Read the static props of an opened BSP. Returns false if it has no readable sprp lump. */
+	static bool Read(const FBSPReader& Reader, FBSPStaticPropLump& OutLump);
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FBSPReader;
+
+/**
+ * Point-in-leaf and potentially visible set (PVS) queries over a compiled BSP's world tree.
+ *
+ * Keeps the world model's nodes and planes, each leaf's cluster and the visibility lump
+ * as compressed by vvis (run-length encoded zero bytes). PVS rows are decompressed on
+ * request. All positions are in Source coordinates.
+ *
+ * Usage:
+ *   FBSPVisibility Vis;
+ *   if (Vis.Load(Reader))
+ *   {
+ *       int32 Cluster = Vis.FindCluster(EyePosition);
+ *       bool bVisible = Vis.IsClusterVisible(Cluster, OtherCluster);
+ *   }
+ */
+class SOURCEBRIDGE_API FBSPVisibility
+{
+public:
+	/** Read the planes, nodes, leafs, models and visibility lumps. False if the map has no vis data. */
+	bool Load(const FBSPReader& Reader);
+
+	bool IsValid() const { return NodeChildren.Num() > 0 && LeafClusters.Num() > 0 && NumClusters > 0; }
+
+	int32 GetNumClusters() const { return NumClusters; }
+	int32 GetNumLeafs() const { return LeafClusters.Num(); }
+
+	/** The leaf containing Point. */
+	int32 FindLeaf(const FVector3f& Point) const;
+
+	/** The cluster containing Point, or -1 in solid space and outside the map. */
+	int32 FindCluster(const FVector3f& Point) const;
+
+	/**
+	 * Decompress a cluster's PVS row: one bit per cluster.
+	 * Returns false (and every cluster visible) when the row is missing, as the engine does.
+	 */
+	bool GetVisibleClusters(int32 Cluster, TBitArray<>& OutVisible) const;
+
+	/** Whether To is in From's PVS. Clusters of -1 (outside the map) see and are seen by everything. */
+	bool IsClusterVisible(int32 From, int32 To) const;
+
+	/** Clusters of every non-solid leaf touching Box, sorted and unique. */
+	void GetClustersInBox(const FBox3f& Box, TArray<int32>& OutClusters) const;
+
+	friend FArchive& operator<<(FArchive& Ar, FBSPVisibility& Vis);
+
+private:
+	/** Plane normal (XYZ) and distance (W), indexed like the planes lump */
+	TArray<FVector4f> Planes;
+
+	/** Per node: its plane, and two children each (>= 0 node, < 0 leaf -1 - child) */
+	TArray<int32> NodePlanes;
+	TArray<int32> NodeChildren;
+
+	int32 HeadNode = 0;
+
+	/** Cluster per leaf (-1 for solid leaves) */
+	TArray<int32> LeafClusters;
+
+	int32 NumClusters = 0;
+
+	/** Byte offset of each cluster's compressed PVS row in VisData */
+	TArray<int32> PVSOffsets;
+
+	/** The visibility lump as stored */
+	TArray<uint8> VisData;
+};
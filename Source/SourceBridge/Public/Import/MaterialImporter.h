@@ -1,7 +1,9 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Math/Float16Color.h"
 #include "Import/VPKReader.h"
+#include "VMF/VMFKeyValues.h"
 
 class UMaterial;
 class UMaterialInterface;
@@ -20,8 +22,28 @@ enum class ESourceAlphaMode : uint8
 struct FVMTParsedMaterial
 {
 	FString ShaderName;
+
+	/** Top-level parameters, keys lowercased. */
 	TMap<FString, FString> Parameters;
 
+	/** Nested blocks in file order (Proxies, shader fallback blocks, patch insert/replace). */
+	TArray<FVMFKeyValues> Blocks;
+
+	/** True if the VMT was read from a VPK archive rather than loose files. */
+	bool bFromVPK = false;
+
+	/** Find a nested block by name (case-insensitive). */
+	const FVMFKeyValues* FindBlock(const FString& Name) const
+	{
+		return Blocks.FindByPredicate([&Name](const FVMFKeyValues& Block)
+		{
+			return Block.ClassName.Equals(Name, ESearchCase::IgnoreCase);
+		});
+	}
+
+	/** Patch materials wrap another VMT: patch { include "materials/x.vmt" insert { } replace { } } */
+	bool IsPatch() const { return ShaderName.Equals(TEXT("patch"), ESearchCase::IgnoreCase); }
+
 	FString GetBaseTexture() const { return Parameters.FindRef(TEXT("$basetexture")); }
 	FString GetBumpMap() const { return Parameters.FindRef(TEXT("$bumpmap")); }
 	FString GetSurfaceProp() const { return Parameters.FindRef(TEXT("$surfaceprop")); }
@@ -41,12 +63,24 @@ struct FVMTParsedMaterial
 class SOURCEBRIDGE_API FMaterialImporter
 {
 public:
-	/** Parse a VMT file into structured data. */
+	/**
+	 * Parse VMT text into structured data using the shared KeyValues tokenizer (FVMFReader).
+	 * Patch materials are returned as-is; use FindParsedVMT() to resolve their includes.
+	 */
 	static FVMTParsedMaterial ParseVMT(const FString& VMTContent);
 
 	/** Parse a VMT file from disk. */
 	static FVMTParsedMaterial ParseVMTFile(const FString& FilePath);
 
+	/**
+	 * Find and parse the VMT for a Source material path (loose files, then VPKs).
+	 * Patch materials are resolved recursively against their included VMT.
+	 * Results, including misses, are cached by path until ClearCache() or a search path
+	 * change, so the material browser, importer and exporter share one parse per VMT.
+	 * Returns nullptr if no VMT was found.
+	 */
+	static TSharedPtr<const FVMTParsedMaterial> FindParsedVMT(const FString& SourceMaterialPath);
+
 	/**
 	 * Set the directory to search for extracted VMT/VTF files.
 	 * Called by BSPImporter after extracting BSP pakfile contents.
@@ -97,6 +131,23 @@ public:
 	 */
 	static UTexture2D* LoadThumbnailTexture(const FString& SourceMaterialPath);
 
+	// ---- Lightmaps ----
+
+	/**
+	 * Create (or overwrite on re-import) a persistent linear HDR texture from a lightmap atlas.
+	 * @param AssetPath Package path, e.g. "/Game/SourceBridge/Lightmaps/de_dust2/LM_World_0_0_0"
+	 */
+	static UTexture2D* CreateLightmapTexture(const TArray<FFloat16Color>& Pixels, int32 Width, int32 Height,
+		const FString& AssetPath);
+
+	/**
+	 * Lightmapped variant of an imported material: unlit, BaseTexture times Lightmap sampled
+	 * with UV channel 1. A dynamic instance owned by Outer, so it is saved with the level.
+	 * Null if Material has no BaseTexture (placeholders, tool materials).
+	 */
+	static UMaterialInterface* CreateLightmappedMaterial(UMaterialInterface* Material, UTexture2D* Lightmap,
+		UObject* Outer);
+
 private:
 	/** Runtime pointer cache (Source path → loaded persistent UMaterialInterface*) */
 	static TMap<FString, UMaterialInterface*> MaterialCache;
@@ -124,6 +175,9 @@ private:
 	/** Opened VPK archives for game material access */
 	static TArray<TSharedPtr<FVPKReader>> VPKArchives;
 
+	/** Parsed VMT cache (normalized lowercase Source path → parsed material, null = not found) */
+	static TMap<FString, TSharedPtr<const FVMTParsedMaterial>> ParsedVMTCache;
+
 	// ---- Persistent Asset Creation ----
 
 	/** Create a persistent UTexture2D from BGRA pixel data. */
@@ -149,11 +203,17 @@ private:
 	/** Get or create the persistent tool texture base material (Unlit + Translucent). */
 	static UMaterial* GetOrCreateToolBaseMaterial();
 
+	/** Get or create the persistent lightmapped base material (Unlit, emissive = base * lightmap). */
+	static UMaterial* GetOrCreateLightmappedBaseMaterial(ESourceAlphaMode AlphaMode);
+
 	static UMaterial* CachedOpaqueMaterial;
 	static UMaterial* CachedMaskedMaterial;
 	static UMaterial* CachedTranslucentMaterial;
 	static UMaterial* CachedColorMaterial;
 	static UMaterial* CachedToolMaterial;
+	static UMaterial* CachedLightmappedOpaqueMaterial;
+	static UMaterial* CachedLightmappedMaskedMaterial;
+	static UMaterial* CachedLightmappedTranslucentMaterial;
 
 	// ---- VTF Loading ----
 
@@ -168,6 +228,15 @@ private:
 	/** Try to find and read VMT content from VPK archives. */
 	static FString FindVMTInVPK(const FString& SourceMaterialPath);
 
+	/** Find raw VMT text on disk (exact, then case-insensitive) or in VPK archives. */
+	static bool FindVMTContent(const FString& SourceMaterialPath, FString& OutContent, bool& bOutFromVPK);
+
+	/** FindParsedVMT() with include depth tracking for patch materials. */
+	static TSharedPtr<const FVMTParsedMaterial> FindParsedVMTInternal(const FString& SourceMaterialPath, int32 IncludeDepth);
+
+	/** Apply a patch material's insert (add/override) or replace (override existing) block. */
+	static void ApplyVMTPatchBlock(FVMTParsedMaterial& Target, const FVMFKeyValues& PatchBlock, bool bInsert);
+
 	// ---- Helpers ----
 
 	static void EnsureReverseToolMappings();
@@ -64,6 +64,16 @@ public:
 	 */
 	static bool IsStockModel(const FString& SourceModelPath);
 
+	/**
+	 * Check if a file on disk is byte-identical to the game's VPK entry at the same path,
+	 * by comparing its CRC32 with the one stored in the VPK directory. Any content type.
+	 * Must call SetupGameSearchPaths() first.
+	 *
+	 * @param InternalPath Source-relative path (e.g., "materials/brick/brickwall001a.vtf")
+	 * @param DiskPath File to compare
+	 */
+	static bool MatchesStockFile(const FString& InternalPath, const FString& DiskPath);
+
 	/**
 	 * Find the disk paths for a model's companion files (.mdl, .vvd, .vtx, .phy).
 	 * Only returns files found on disk (not from VPK archives).
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VMF/VMFKeyValues.h"
+
+/**
+ * Compact binary form of a parsed VMF tree, written next to the source VMF as <mapname>.vmfc.
+ *
+ * Layout (little-endian):
+ *   Header | string refs | nodes | properties | UTF-8 string data
+ *
+ * Every class name, key and value is stored once in the string table. Nodes are laid out
+ * breadth-first so the children of any node are contiguous, which lets the reader rebuild
+ * the tree from a memory-mapped file in one pass with no text parsing.
+ *
+ * A cache is only valid for the exact VMF bytes it was built from (size + CRC32).
+ */
+class SOURCEBRIDGE_API FVMFBinaryCache
+{
+public:
+	/** Path of the cache file for a VMF (same directory, .vmfc extension). */
+	static FString GetCachePath(const FString& VMFPath);
+
+	/** Compute the cache key for raw VMF file bytes. */
+	static uint32 HashContent(const TArray<uint8>& VMFBytes);
+
+	/**
+	 * Write a cache for the given parsed blocks.
+	 * @param SourceSize Size in bytes of the VMF the blocks were parsed from
+	 * @param SourceCrc HashContent() of the same VMF bytes
+	 */
+	static bool Write(const FString& VMFPath, const TArray<FVMFKeyValues>& Blocks,
+		int64 SourceSize, uint32 SourceCrc);
+
+	/**
+	 * Load blocks from the cache if it exists and matches the given VMF key.
+	 * Returns false (leaving OutBlocks empty) on a missing, stale or corrupt cache.
+	 */
+	static bool TryRead(const FString& VMFPath, int64 SourceSize, uint32 SourceCrc,
+		TArray<FVMFKeyValues>& OutBlocks);
+};
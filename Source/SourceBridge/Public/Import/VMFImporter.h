@@ -6,6 +6,10 @@
 class ASourceEntityActor;
 class ASourceBrushEntity;
 class UProceduralMeshComponent;
+struct FBSPModelMesh;
+struct FBSPMeshChunk;
+struct FBSPStaticPropLump;
+class FBSPVisibility;
 
 /** Per-face data parsed from a VMF side definition. */
 struct FVMFSideData
@@ -45,14 +49,57 @@ struct FVMFImportSettings
 	/** Whether to apply material names to brush faces */
 	bool bImportMaterials = true;
 
+	/**
+	 * BSP import: build brush geometry from the compiled faces instead of a BSPSource
+	 * decompile. Exactly what the game renders and much faster, but not editable as solids.
+	 * Always used when BSPSource isn't installed.
+	 */
+	bool bUseCompiledBSPGeometry = false;
+
+	/** BSP import: apply the compiled lightmaps to compiled geometry (see FBSPGeometry) */
+	bool bImportLightmaps = true;
+
+	/** BSP import: tag imported actors with their vis clusters for PVS culling (see FBSPVisibility) */
+	bool bImportVisibility = true;
+
 	/** Directory containing extracted assets (VMT/VTF files from BSP pakfile) */
 	FString AssetSearchPath;
+
+	/**
+	 * Render geometry of a compiled BSP, indexed by model number (see FBSPGeometry).
+	 * When set, worldspawn is built from model 0 and brush entities with "model" "*N"
+	 * from model N, instead of from solids.
+	 */
+	const TArray<FBSPModelMesh>* CompiledModels = nullptr;
+
+	/** Content folder for the lightmap atlas textures of CompiledModels (empty = no lightmaps) */
+	FString LightmapAssetPath;
+
+	/**
+	 * Static props of a compiled BSP (see FBSPStaticProps). When set, they are imported as
+	 * instanced ASourceStaticPropGroup actors and prop_static entity blocks are skipped.
+	 */
+	const FBSPStaticPropLump* StaticProps = nullptr;
+
+	/**
+	 * Compiled visibility of a BSP (see FBSPVisibility). When set, every imported actor is
+	 * tagged with the clusters its bounds touch and an ASourceVisibility actor is placed.
+	 */
+	const FBSPVisibility* Visibility = nullptr;
 };
 
 struct FVMFImportResult
 {
 	int32 BrushesImported = 0;
 	int32 EntitiesImported = 0;
+
+	/** Static prop instances and the groups (actors) they were batched into */
+	int32 StaticPropsImported = 0;
+	int32 StaticPropGroups = 0;
+
+	/** Actors tagged with the BSP visibility clusters they touch */
+	int32 VisTaggedActors = 0;
+
 	TArray<FString> Warnings;
 
 	/** All spawned entity actors (for post-import parentname resolution). */
@@ -143,6 +190,45 @@ private:
 	static ASourceBrushEntity* ImportBrushEntity(const FVMFKeyValues& EntityBlock, UWorld* World,
 		const FVMFImportSettings& Settings, FVMFImportResult& Result);
 
+	/** Import the world model of a compiled BSP, one ASourceBrushEntity per chunk. */
+	static void ImportCompiledWorld(const FBSPModelMesh& Model, UWorld* World,
+		const FVMFImportSettings& Settings, FVMFImportResult& Result);
+
+	/** Import a brush entity whose geometry comes from a compiled BSP model. */
+	static ASourceBrushEntity* ImportCompiledBrushEntity(const FVMFKeyValues& EntityBlock, const FBSPModelMesh& Model,
+		UWorld* World, const FVMFImportSettings& Settings, FVMFImportResult& Result);
+
+	/**
+	 * Build a ProceduralMeshComponent from one chunk of compiled BSP geometry.
+	 * SourceOffset is added to the chunk's Source-space positions (a brush entity's origin).
+	 * The chunk's lightmap atlas, if any, is saved as LightmapName under Settings.LightmapAssetPath.
+	 */
+	static UProceduralMeshComponent* BuildCompiledMesh(
+		AActor* OwnerActor,
+		const FString& MeshName,
+		const FString& LightmapName,
+		const FBSPMeshChunk& Chunk,
+		const FVMFImportSettings& Settings,
+		const FVector& ActorCenter,
+		const FVector& SourceOffset);
+
+	/** The compiled model an entity's "model" "*N" key refers to, or null. */
+	static const FBSPModelMesh* FindCompiledModel(const FVMFKeyValues& EntityBlock, const FVMFImportSettings& Settings);
+
+	/**
+	 * Import a BSP's static props: every unique model/skin is resolved once, then placements
+	 * sharing model, skin, collision, shadow and fade settings become one ASourceStaticPropGroup.
+	 */
+	static void ImportStaticProps(const FBSPStaticPropLump& StaticProps, UWorld* World,
+		const FVMFImportSettings& Settings, FVMFImportResult& Result);
+
+	/**
+	 * Tag Actors with the visibility clusters their bounds touch (USourceVisClusterComponent)
+	 * and spawn the ASourceVisibility actor that culls them by PVS.
+	 */
+	static void ImportVisibility(const FBSPVisibility& Visibility, const TArray<TWeakObjectPtr<AActor>>& Actors,
+		UWorld* World, const FVMFImportSettings& Settings, FVMFImportResult& Result);
+
 	/** Import a point entity. */
 	static bool ImportPointEntity(const FVMFKeyValues& EntityBlock, UWorld* World,
 		const FVMFImportSettings& Settings, FVMFImportResult& Result);
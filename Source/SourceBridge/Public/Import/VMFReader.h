@@ -6,19 +6,42 @@
 /**
  * Parses VMF (Valve Map Format) text files into FVMFKeyValues tree structure.
  * This is the reverse of FVMFKeyValues::Serialize().
+ *
+ * The tokenizer accepts general Valve KeyValues text, so it is also used for VMT files:
+ * quoted or bare keys and values, quoted block names, and [$PLATFORM] conditionals.
+ * Conditionals are evaluated for the Windows PC build ($WIN32 and $WINDOWS set; $X360,
+ * $PS3, $GAMECONSOLE and everything else unset), and excluded keys are dropped.
  */
 class SOURCEBRIDGE_API FVMFReader
 {
 public:
-	/** Parse a VMF file from disk. Returns the top-level blocks. */
-	static TArray<FVMFKeyValues> ParseFile(const FString& FilePath);
+	/**
+	 * Parse a VMF file from disk. Returns the top-level blocks.
+	 * If a matching binary cache (<mapname>.vmfc, see FVMFBinaryCache) exists next to the
+	 * file, the tree is loaded from it instead of parsing the text.
+	 */
+	static TArray<FVMFKeyValues> ParseFile(const FString& FilePath, bool bUseBinaryCache = true);
 
-	/** Parse VMF text content. Returns the top-level blocks. */
-	static TArray<FVMFKeyValues> ParseString(const FString& Content);
+	/**
+	 * Like ParseFile(), but (re)writes the binary cache when it is missing or stale,
+	 * so later loads of the same unchanged file skip text parsing.
+	 */
+	static TArray<FVMFKeyValues> ParseFileAndUpdateCache(const FString& FilePath);
+
+	/**
+	 * Parse VMF text content. Returns the top-level blocks.
+	 * @param bEscapeSequences Treat \" \\ \n in quoted strings as escapes. VMTs are read
+	 *        without escapes, since texture paths commonly contain backslashes.
+	 */
+	static TArray<FVMFKeyValues> ParseString(const FString& Content, bool bEscapeSequences = true);
 
 private:
 	static void SkipWhitespaceAndComments(const FString& Content, int32& Pos);
-	static FString ReadQuotedString(const FString& Content, int32& Pos);
+	static void SkipInlineWhitespace(const FString& Content, int32& Pos);
+	/** Consume a [$PLATFORM] conditional if one follows; false if it excludes the PC build. */
+	static bool ReadConditional(const FString& Content, int32& Pos);
+	static FString ReadQuotedString(const FString& Content, int32& Pos, bool bEscapeSequences);
 	static FString ReadUnquotedToken(const FString& Content, int32& Pos);
-	static FVMFKeyValues ParseBlock(const FString& Content, int32& Pos, const FString& ClassName);
+	static FString ReadRestOfLine(const FString& Content, int32& Pos);
+	static FVMFKeyValues ParseBlock(const FString& Content, int32& Pos, const FString& ClassName, bool bEscapeSequences);
 };
@@ -20,6 +20,9 @@ public:
 	/** Check if a file path exists in the VPK. Path uses forward slashes, no leading slash. */
 	bool Contains(const FString& FilePath) const;
 
+	/** Get the CRC32 stored in the directory for a file, without reading its data. Returns false if absent. */
+	bool GetCRC(const FString& FilePath, uint32& OutCRC) const;
+
 	/** Extract a file's contents from the VPK archives. Returns true on success. */
 	bool ReadFile(const FString& FilePath, TArray<uint8>& OutData) const;
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "VMF/VMFKeyValues.h"
 
 /**
  * Generates Source VMT (Valve Material Type) files.
@@ -21,6 +22,9 @@ public:
 	/** Material parameters ($basetexture, $surfaceprop, $bumpmap, etc.) */
 	TMap<FString, FString> Parameters;
 
+	/** Nested blocks written after the parameters (Proxies, etc.) */
+	TArray<FVMFKeyValues> Blocks;
+
 	FVMTWriter();
 
 	/** Set the shader (LightmappedGeneric, VertexLitGeneric, UnlitGeneric, etc.) */
@@ -69,9 +73,11 @@ public:
 
 	/**
 	 * Generate a VMT from stored VMT parameters (lossless re-export of imported materials).
-	 * Uses the original shader and all original parameters from the manifest entry.
+	 * Uses the original shader and all original parameters from the manifest entry,
+	 * plus any nested blocks (Proxies) from the original VMT.
 	 */
 	static FString GenerateFromStoredParams(
 		const FString& Shader,
-		const TMap<FString, FString>& Params);
+		const TMap<FString, FString>& Params,
+		const TArray<FVMFKeyValues>& Blocks = TArray<FVMFKeyValues>());
 };
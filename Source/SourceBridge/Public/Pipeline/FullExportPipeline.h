@@ -1,8 +1,14 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Compile/CompilePipeline.h"
+#include "Compile/BSPBudget.h"
+#include "Validation/LeakDetector.h"
+#include "Validation/CompileLimits.h"
+#include "VMF/VMFPlaneTable.h"
 
 class UWorld;
+class FCompileJob;
 
 /**
  * Settings for a full project export (map + materials + models).
@@ -30,6 +36,45 @@ struct SOURCEBRIDGE_API FFullExportSettings
 	/** Copy results to game directory */
 	bool bCopyToGame = true;
 
+	/** Patch the existing BSP with vbsp -onlyents when only point entities changed */
+	bool bAllowEntityOnlyCompile = true;
+
+	/** Reuse cached vbsp/vvis/vrad outputs for stages whose inputs are unchanged */
+	bool bUseCompileCache = true;
+
+	/** Compile tools and game directory (empty = auto-detect from Steam) */
+	FString ToolsDir;
+	FString GameDir;
+
+	/**
+	 * Stop before the map compile and hand it back in FFullExportResult::DeferredCompile,
+	 * so the caller can compile several maps at once (see FCompileScheduler).
+	 * Packing and packaging are then left to the caller too.
+	 */
+	bool bDeferMapCompile = false;
+
+	/** Flood-fill the exported VMF for leaks and skip the compile if it leaks */
+	bool bCheckLeaks = true;
+
+	/** Predict vbsp's planes/texinfo/texdata... from the exported VMF and warn when a limit would be exceeded */
+	bool bCheckLimits = true;
+
+	/** Skip the compile when the limit prediction is over a limit (the prediction is approximate) */
+	bool bSkipCompileOverLimits = false;
+
+	/** -threads for vvis/vrad (0 = tool default) */
+	int32 CompileThreads = 0;
+
+	/** studiomdl processes run at once (0 = one per core but one) */
+	int32 ModelCompileJobs = 0;
+
+	/** Restore unchanged models from the model compile cache, trimmed to ModelCacheBudgetMB */
+	bool bUseModelCache = true;
+	int32 ModelCacheBudgetMB = 2048;
+
+	/** LZMA-compress custom content packed into the BSP */
+	bool bCompressPakfile = false;
+
 	/** Run validation before export */
 	bool bValidate = true;
 
@@ -40,6 +85,25 @@ struct SOURCEBRIDGE_API FFullExportSettings
 	 *  When false (default), uses FGD-aware auto-detect to only pack referenced assets.
 	 *  Force-packed entries (bForcePack) are always included either way. */
 	bool bPackAllManifestAssets = false;
+
+	/** Polled while the map compiles; returning true cancels the compile. */
+	TFunction<bool()> ShouldCancel;
+};
+
+/**
+ * One studiomdl run from the model step. Each unique mesh is compiled once,
+ * however many actors place it.
+ */
+struct SOURCEBRIDGE_API FModelCompileTiming
+{
+	FString ModelName;
+	FString QCPath;
+	int32 Placements = 0;
+	double Seconds = 0.0;
+	bool bSuccess = false;
+
+	/** Restored from the model compile cache; studiomdl did not run */
+	bool bFromCache = false;
 };
 
 /**
@@ -57,11 +121,43 @@ struct SOURCEBRIDGE_API FFullExportResult
 	double CompileSeconds = 0.0;
 	FString ErrorMessage;
 	TArray<FString> Warnings;
+
+	/** Per-model studiomdl runs and the wall time of the whole model step */
+	TArray<FModelCompileTiming> ModelCompiles;
+	double ModelCompileSeconds = 0.0;
+
+	/** Per-tool wall time and peak memory from the map compile */
+	TArray<FCompileStageStats> CompileStages;
+
+	/** Leak, vis and lighting data parsed from the compile, and its JSON report */
+	FCompileTelemetry CompileTelemetry;
+	FString CompileReportPath;
+
+	/** Lump usage of the compiled BSP against engine limits, and its JSON report */
+	FBSPBudgetReport Budget;
+	FString BudgetReportPath;
+
+	/** Brush side planes of the exported VMF, before and after canonicalization */
+	FVMFPlaneStats PlaneStats;
+
+	/** Pre-compile leak check (bChecked is false if it didn't run) */
+	FLeakCheckResult LeakCheck;
+
+	/** Pre-compile prediction of vbsp's limit-bound counts (bChecked is false if it didn't run) */
+	FCompileLimitEstimate LimitEstimate;
+
+	/** Set with bDeferMapCompile: the compile to run, and content to pack into the BSP after it */
+	bool bCompileDeferred = false;
+	FCompileSettings DeferredCompile;
+	TMap<FString, FString> DeferredPackFiles;
 };
 
 /** Callback for pipeline progress updates. StepName is the current step description. */
 DECLARE_DELEGATE_TwoParams(FOnPipelineProgress, const FString& /*StepName*/, float /*Progress 0-1*/);
 
+/** Called on the game thread with the final result of FFullExportPipeline::RunAsync. */
+DECLARE_DELEGATE_OneParam(FOnFullExportFinished, const FFullExportResult& /*Result*/);
+
 /**
  * One-click full export pipeline.
  *
@@ -84,4 +180,18 @@ public:
 		UWorld* World,
 		const FFullExportSettings& Settings,
 		FOnPipelineProgress ProgressCallback);
+
+	/**
+	 * Run without waiting on the map compile, for the editor UI.
+	 * Everything up to the compile runs before this returns (ProgressCallback is only
+	 * called until then). The compile runs as an FCompileJob, and packing, the budget
+	 * report and packaging continue on the game thread when it finishes.
+	 * OnFinished gets the final result, before this returns if no compile was started.
+	 * @return The running compile (cancel it through the job), or null if none was started
+	 */
+	static TSharedPtr<FCompileJob> RunAsync(
+		UWorld* World,
+		const FFullExportSettings& Settings,
+		FOnPipelineProgress ProgressCallback,
+		FOnFullExportFinished OnFinished);
 };
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SourceBridgeExportCommandlet.generated.h"
+
+/**
+ * Headless export and compile of a list of maps, for build machines.
+ *
+ * Each map is loaded and run through FFullExportPipeline in turn, sharing the warmed
+ * game VPK index and the material/model caches. Map compiles are deferred and then run
+ * concurrently through FCompileScheduler. A JSON summary with timings, warnings, output
+ * paths and each compiled map's lump budget (FBSPBudget) is written at the end.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd Project.uproject -run=SourceBridgeExport
+ *     -Maps=/Game/Maps/A+/Game/Maps/B | -MapList=maps.txt
+ *     [-Game=cstrike] [-Output=<dir>] [-Summary=<file.json>]
+ *     [-ToolsDir=<dir>] [-GameDir=<dir>] [-Jobs=N] [-Threads=N]
+ *     [-NoCompile] [-Final] [-NoLeakCheck] [-NoLimitCheck] [-SkipOverLimits]
+ *
+ * -ToolsDir may point at stand-in vbsp/vvis/vrad scripts on machines without the SDK.
+ * Returns 0 when every map exported (and compiled), 1 otherwise.
+ */
+UCLASS()
+class SOURCEBRIDGE_API USourceBridgeExportCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	USourceBridgeExportCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Components/ActorComponent.h"
+#include "Import/BSPVisibility.h"
+#include "SourceVisibility.generated.h"
+
+/**
+ * The BSP visibility clusters an imported actor's bounds touch.
+ * Added by the BSP importer; ASourceVisibility hides the owner when none of them is
+ * in the camera's PVS. An empty list means "always visible".
+ */
+UCLASS(ClassGroup = "SourceBridge", meta = (DisplayName = "Source Vis Clusters"))
+class SOURCEBRIDGE_API USourceVisClusterComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Source Visibility")
+	TArray<int32> Clusters;
+};
+
+/**
+ * PVS culling for an imported BSP, placed once per level by the BSP importer.
+ *
+ * Holds the map's compiled visibility (see FBSPVisibility). Each tick it finds the
+ * cluster the camera is in and, when that changes, hides every actor tagged with
+ * USourceVisClusterComponent whose clusters are all outside the cluster's PVS, the way
+ * the Source engine skips leaves it can't see. Runs in PIE by default and optionally in
+ * the editor viewport. Only actors it hid itself are shown again.
+ */
+UCLASS(meta = (DisplayName = "Source Visibility"))
+class SOURCEBRIDGE_API ASourceVisibility : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ASourceVisibility();
+
+	/** Hide actors outside the PVS while playing. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Source Visibility")
+	bool bCullInGame = true;
+
+	/** Hide actors outside the PVS of the editor viewport camera (temporary, not saved). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Source Visibility")
+	bool bCullInEditor = false;
+
+	/** UE units per Source unit the map was imported with. */
+	UPROPERTY(EditAnywhere, Category = "Source Visibility")
+	float ScaleMultiplier = 1.0f / 0.525f;
+
+	UPROPERTY(VisibleAnywhere, Category = "Source Visibility")
+	int32 NumClusters = 0;
+
+	/** Cluster the camera was last in (-1 = outside the map, nothing culled). */
+	UPROPERTY(VisibleAnywhere, Transient, Category = "Source Visibility")
+	int32 CurrentCluster = -1;
+
+	/** Store the compiled visibility in this actor. */
+	void SetVisibility(const FBSPVisibility& InVisibility);
+
+	const FBSPVisibility& GetVisibility() const { return Visibility; }
+
+	virtual void PostLoad() override;
+	virtual void PostDuplicate(bool bDuplicateForPIE) override;
+	virtual void Tick(float DeltaSeconds) override;
+	virtual bool ShouldTickIfViewportsOnly() const override { return bCullInEditor; }
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void Destroyed() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	/** Hide/show tagged actors for the PVS of Cluster. */
+	void ApplyCluster(int32 Cluster);
+
+	/** Rebuild Visibility from VisData. */
+	void LoadVisData();
+
+	/** Show every actor this actor hid. */
+	void RestoreAll();
+
+	/** Serialized FBSPVisibility */
+	UPROPERTY()
+	TArray<uint8> VisData;
+
+	FBSPVisibility Visibility;
+
+	/** Actors hidden by ApplyCluster, and whether in game (vs. temporarily in the editor) */
+	TArray<TWeakObjectPtr<AActor>> CulledActors;
+	bool bCulledInGame = false;
+
+	/** Force ApplyCluster on the next tick */
+	bool bDirty = true;
+};
@@ -22,6 +22,10 @@ private:
 	TSharedPtr<class FAutoConsoleCommand> ExportTestBoxRoomCommand;
 	TSharedPtr<class FAutoConsoleCommand> ExportSceneCommand;
 	TSharedPtr<class FAutoConsoleCommand> CompileMapCommand;
+	TSharedPtr<class FAutoConsoleCommand> CancelCompileCommand;
+	TSharedPtr<class FAutoConsoleCommand> CompileBatchCommand;
+	TSharedPtr<class FAutoConsoleCommand> ClearCompileCacheCommand;
+	TSharedPtr<class FAutoConsoleCommand> ModelCacheCommand;
 	TSharedPtr<class FAutoConsoleCommand> ExportModelCommand;
 	TSharedPtr<class FAutoConsoleCommand> FullExportCommand;
 	TSharedPtr<class FAutoConsoleCommand> ValidateCommand;
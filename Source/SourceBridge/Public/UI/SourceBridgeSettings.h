@@ -43,6 +43,18 @@ public:
 	UPROPERTY(Config, EditAnywhere, Category = "Export")
 	FString MapName;
 
+	/** Reuse serialized VMF blocks for actors unchanged since the last export */
+	UPROPERTY(Config, EditAnywhere, Category = "Export")
+	bool bIncrementalExport = true;
+
+	/** Write brush faces on the same axial or integer-distance plane with identical integer plane points */
+	UPROPERTY(Config, EditAnywhere, Category = "Export")
+	bool bCanonicalizePlanes = true;
+
+	/** Merge touching world brushes into single convex solids where faces match (fewer brushes for vbsp) */
+	UPROPERTY(Config, EditAnywhere, Category = "Export")
+	bool bMergeBrushes = false;
+
 	/** Path to Source SDK bin directory (auto-detected if empty) */
 	UPROPERTY(Config, EditAnywhere, Category = "Tools")
 	FDirectoryPath ToolsDirectory;
@@ -63,6 +75,50 @@ public:
 	UPROPERTY(Config, EditAnywhere, Category = "Compile")
 	bool bCopyToGame = true;
 
+	/** When only point entities changed since the last compile, patch the BSP with vbsp -onlyents (skips vvis/vrad) */
+	UPROPERTY(Config, EditAnywhere, Category = "Compile")
+	bool bEntityOnlyCompile = true;
+
+	/** Flood-fill the exported map for leaks before compiling; a leaking map is not compiled */
+	UPROPERTY(Config, EditAnywhere, Category = "Compile")
+	bool bCheckLeaksBeforeCompile = true;
+
+	/** Predict vbsp's plane, texinfo and texdata counts before compiling and warn at 90% of a limit */
+	UPROPERTY(Config, EditAnywhere, Category = "Compile")
+	bool bCheckLimitsBeforeCompile = true;
+
+	/** Skip the compile when the prediction is over a limit. The prediction ignores instances, water and displacements, so it can overestimate. */
+	UPROPERTY(Config, EditAnywhere, Category = "Compile", meta = (EditCondition = "bCheckLimitsBeforeCompile"))
+	bool bSkipCompileOverLimits = false;
+
+	/** Cache each compile stage's output by input hash and skip stages whose inputs are unchanged */
+	UPROPERTY(Config, EditAnywhere, Category = "Compile")
+	bool bCacheCompileStages = true;
+
+	/** Threads vvis/vrad may use across all running compiles (0 = every core but one) */
+	UPROPERTY(Config, EditAnywhere, Category = "Compile", meta = (ClampMin = "0", ClampMax = "256"))
+	int32 CompileThreadBudget = 0;
+
+	/** Maps compiled at once by SourceBridge.CompileBatch (0 = one per 4 budgeted threads) */
+	UPROPERTY(Config, EditAnywhere, Category = "Compile", meta = (ClampMin = "0", ClampMax = "64"))
+	int32 MaxConcurrentCompiles = 0;
+
+	/** studiomdl processes run at once during full export (0 = one per core but one) */
+	UPROPERTY(Config, EditAnywhere, Category = "Compile", meta = (ClampMin = "0", ClampMax = "64"))
+	int32 MaxConcurrentModelCompiles = 0;
+
+	/** Restore unchanged models from a local cache instead of rerunning studiomdl */
+	UPROPERTY(Config, EditAnywhere, Category = "Compile")
+	bool bCacheModelCompiles = true;
+
+	/** Disk budget of the model compile cache; least recently used models are trimmed past it */
+	UPROPERTY(Config, EditAnywhere, Category = "Compile", meta = (ClampMin = "64", EditCondition = "bCacheModelCompiles"))
+	int32 ModelCacheBudgetMB = 2048;
+
+	/** LZMA-compress files packed into the BSP. Only CS:GO and the Source 2013 multiplayer games (TF2, CS:S, DoD:S, HL2:DM) can read them; L4D2 and older branches can't. */
+	UPROPERTY(Config, EditAnywhere, Category = "Compile")
+	bool bCompressPakfile = false;
+
 	/** Material export mode */
 	UPROPERTY(Config, EditAnywhere, Category = "Materials")
 	EMaterialExportMode MaterialExportMode = EMaterialExportMode::AutoWithOverrides;
@@ -93,6 +149,18 @@ public:
 	UPROPERTY(Config, EditAnywhere, Category = "Import")
 	bool bImportMaterials = true;
 
+	/** Import BSP geometry from its compiled faces instead of decompiling to brushes (fast, not editable as solids) */
+	UPROPERTY(Config, EditAnywhere, Category = "Import")
+	bool bImportCompiledBSPGeometry = false;
+
+	/** Show the BSP's baked vrad lighting on compiled geometry (lightmap atlases, unlit materials) instead of relighting in UE */
+	UPROPERTY(Config, EditAnywhere, Category = "Import", meta = (EditCondition = "bImportCompiledBSPGeometry"))
+	bool bImportBSPLightmaps = true;
+
+	/** Use the BSP's compiled visibility (PVS) to hide imported geometry the camera can't see, in PIE and optionally the editor */
+	UPROPERTY(Config, EditAnywhere, Category = "Import")
+	bool bImportBSPVisibility = true;
+
 	/** Get the singleton settings instance. */
 	static USourceBridgeSettings* Get();
 };
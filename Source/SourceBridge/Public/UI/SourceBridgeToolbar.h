@@ -4,6 +4,7 @@
 
 class FToolBarBuilder;
 class FExtender;
+struct FFullExportResult;
 
 /**
  * Registers SourceBridge toolbar button and menu in the UE editor.
@@ -37,6 +38,9 @@ private:
 	static void OnImportBSP();
 	static void OnOpenSettings();
 
+	/** Notify and show the details of a finished full export. */
+	static void ShowFullExportResult(const FFullExportResult& Result);
+
 	/** Brush tools */
 	static void OnCreateSourceBrush();
 	static void OnTieToEntity();
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+
+class FCompileJob;
+
+/**
+ * Compile output widget.
+ * Follows the latest FCompileJob, streaming tool output as it arrives.
+ *
+ * Shows:
+ * - Current tool and elapsed time
+ * - Live vbsp/vvis/vrad output (auto-scrolls while at the bottom)
+ * - Per-stage wall time and peak memory once the compile finishes
+ * - Cancel button that kills the running tool
+ */
+class SSourceCompileOutput : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SSourceCompileOutput) {}
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+private:
+	/** Poll the latest job for new output. */
+	EActiveTimerReturnType OnPollJob(double InCurrentTime, float InDeltaTime);
+
+	FReply OnCancelCompile();
+	bool IsCancelEnabled() const;
+	FText GetStatusText() const;
+
+	TSharedRef<ITableRow> OnGenerateRow(
+		TSharedPtr<FString> Item,
+		const TSharedRef<STableViewBase>& OwnerTable);
+
+	TWeakPtr<FCompileJob> WatchedJob;
+	int32 NextLine = 0;
+	FString StageSummary;
+
+	TArray<TSharedPtr<FString>> OutputLines;
+	TSharedPtr<SListView<TSharedPtr<FString>>> OutputListView;
+};
+
+/**
+ * Registers the compile output window as a nomad tab in the editor.
+ */
+class FSourceCompileOutputTab
+{
+public:
+	static void Register();
+	static void Unregister();
+
+	static const FName TabId;
+
+private:
+	static TSharedRef<class SDockTab> SpawnTab(const class FSpawnTabArgs& Args);
+};
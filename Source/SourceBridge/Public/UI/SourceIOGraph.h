@@ -28,8 +28,8 @@ public:
 	/** Cached targetname. */
 	FString CachedTargetName;
 
-	/** Resolved FGD class data (inputs/outputs for pin creation). */
-	FFGDEntityClass ResolvedFGDClass;
+	/** Resolved FGD class data (inputs/outputs for pin creation), shared with the FGD database. */
+	TSharedPtr<const FFGDEntityClass> ResolvedFGDClass;
 
 	/** Whether FGD data was found for this entity. */
 	bool bHasFGDData = false;
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Decoder for raw LZMA streams, as found in Source engine files:
+ * - compressed BSP lumps and game lumps (Valve "LZMA" header, see DecompressValve)
+ * - pakfile ZIP entries stored with method 14 (see DecompressZipEntry)
+ *
+ * Follows the reference decoder of the LZMA SDK (public domain). The uncompressed size
+ * is always known for these formats, so the output buffer doubles as the dictionary.
+ */
+class SOURCEBRIDGE_API FLZMADecoder
+{
+public:
+	/** Size of the "lc/lp/pb + dictionary size" properties block. */
+	static constexpr int32 PropertiesSize = 5;
+
+	/**
+	 * Decode an LZMA stream into a buffer of exactly OutSize bytes.
+	 * Returns false on corrupt input or if the stream ends early.
+	 */
+	static bool Decompress(const uint8* Properties, const uint8* Src, int64 SrcSize, uint8* Dst, int64 OutSize);
+
+	/** Whether Data starts with Valve's lzma_header_t ("LZMA" id). */
+	static bool HasValveHeader(const uint8* Data, int64 Size);
+
+	/** Decompress data with Valve's 17-byte lzma_header_t (id, actualSize, lzmaSize, properties). */
+	static bool DecompressValve(const uint8* Data, int64 Size, TArray<uint8>& Out);
+
+	/** Decompress a ZIP method 14 entry (2-byte version, 2-byte properties size, properties, stream). */
+	static bool DecompressZipEntry(const uint8* Data, int64 Size, int64 UncompressedSize, TArray<uint8>& Out);
+};
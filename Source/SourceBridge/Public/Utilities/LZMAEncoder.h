@@ -0,0 +1,23 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Small LZMA encoder producing streams FLZMADecoder (and the engine's LZMA reader) accept.
+ *
+ * Greedy parsing over a hash-chain match finder, with literal coding conditioned on
+ * the last match like the reference encoder. It trades some ratio against the LZMA SDK
+ * for simplicity; pakfile content is mostly already-compressed VTFs and MDLs anyway.
+ */
+class SOURCEBRIDGE_API FLZMAEncoder
+{
+public:
+	/**
+	 * Compress Size bytes into a raw LZMA stream without an end marker (the decoder must
+	 * know the uncompressed size). OutProperties receives the 5-byte lc/lp/pb + dictionary size.
+	 */
+	static void Compress(const uint8* Src, int64 Size, TArray<uint8>& OutStream, uint8 OutProperties[5]);
+
+	/** Compress into a ZIP method 14 payload (version, properties size, properties, stream). */
+	static void CompressZipEntry(const uint8* Src, int64 Size, TArray<uint8>& OutPayload);
+};
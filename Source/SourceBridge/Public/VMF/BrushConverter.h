@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "VMF/VMFKeyValues.h"
+#include "VMF/VMFPlaneTable.h"
 
 class ABrush;
 class FMaterialMapper;
@@ -11,6 +12,9 @@ struct SOURCEBRIDGE_API FBrushConversionResult
 {
 	TArray<FVMFKeyValues> Solids;
 	TArray<FString> Warnings;
+
+	/** Side planes written through FVMFPlaneTable (empty when it's disabled). */
+	TArray<FVMFPlaneUse> Planes;
 };
 
 /**
@@ -21,7 +25,7 @@ struct SOURCEBRIDGE_API FBrushConversionResult
  * 2. Transforms vertices from local to world space
  * 3. Converts to Source engine coordinates (scale 0.525, negate Y)
  * 4. Reverses winding order (left-handed -> right-handed)
- * 5. Picks 3 plane-defining points per face
+ * 5. Picks 3 plane-defining points per face (the face's canonical plane, see FVMFPlaneTable)
  * 6. Resolves UE materials to Source material paths via FMaterialMapper
  * 7. Computes UV axes from face geometry
  */
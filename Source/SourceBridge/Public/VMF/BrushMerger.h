@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VMF/VMFKeyValues.h"
+
+/** Brush and side counts before and after merging. */
+struct FBrushMergeStats
+{
+	int32 BrushesBefore = 0;
+	int32 BrushesAfter = 0;
+	int32 SidesBefore = 0;
+	int32 SidesAfter = 0;
+	double Seconds = 0.0;
+};
+
+/**
+ * Merges adjacent convex VMF solids into single solids where their union is convex.
+ *
+ * Two solids merge when they touch on opposing planes, every side of each is in front of
+ * no point of the other, and the solid cut by their remaining planes has exactly their
+ * combined volume. Sides on a plane both solids have must match in material, texture axes
+ * and lightmap scale; solids of different contents (clip, player clip, sky, ...) never merge,
+ * and solids with a hint or skip side are never merged.
+ * Neighbours are found through a spatial hash of solid bounds, and merging repeats until
+ * no pair merges, so rows of boxes collapse into one solid.
+ */
+class SOURCEBRIDGE_API FBrushMerger
+{
+public:
+	/** Sides vbsp allows per brush (MAX_BRUSH_SIDES); merges beyond it are skipped. */
+	static constexpr int32 MaxBrushSides = 128;
+
+	/**
+	 * Merge solid blocks in place. A merged solid keeps the ID of its first solid
+	 * and the side blocks (with their IDs) of the sides that remain.
+	 */
+	static FBrushMergeStats MergeSolids(TArray<FVMFKeyValues>& Solids);
+};
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VMF/VMFKeyValues.h"
+#include "VMF/VMFPlaneTable.h"
+
+class FMaterialMapper;
+class UMaterialInterface;
+
+/** Which VMF ID counter a block's "id" value is drawn from. */
+enum class EVMFIdCounter : uint8
+{
+	Solid,
+	Side,
+	Entity,
+	Num
+};
+
+/**
+ * Running VMF ID counters, in the order ExportScene consumes them.
+ */
+struct FVMFIdCounters
+{
+	int32 Counters[(int32)EVMFIdCounter::Num] = { 0, 0, 0 };
+
+	int32& operator[](EVMFIdCounter Kind) { return Counters[(int32)Kind]; }
+	int32 operator[](EVMFIdCounter Kind) const { return Counters[(int32)Kind]; }
+};
+
+/**
+ * Serialized VMF text for one actor's blocks with the IDs cut out.
+ *
+ * Blocks are generated against virtual ID counters starting at VirtualIdBase. Every
+ * "id" at or above that base becomes a slot holding its offset from the start of the
+ * actor's range, so the text can be re-emitted at any position in the export with
+ * IDs renumbered exactly as a full export would number them. IDs below the base
+ * (e.g. preserved SolidIds from imported brushes) stay literal.
+ */
+struct SOURCEBRIDGE_API FVMFBlockTemplate
+{
+	/** Virtual counter start used when generating blocks for a template. */
+	static constexpr int32 VirtualIdBase = 1 << 30;
+
+	struct FSlot
+	{
+		EVMFIdCounter Kind = EVMFIdCounter::Solid;
+		int32 Offset = 0;
+	};
+
+	/** Text runs between slots (Slots.Num() + 1 entries). */
+	TArray<FString> Segments;
+	TArray<FSlot> Slots;
+
+	/** How many IDs of each kind this template consumes. */
+	FVMFIdCounters IdsUsed;
+
+	/**
+	 * Build a template from blocks generated with virtual counters.
+	 * @param Blocks Blocks to serialize (solids, or entity blocks with embedded solids)
+	 * @param IndentLevel Indent level the blocks are serialized at
+	 * @param EntityIdKind Counter that "entity" block IDs were drawn from
+	 * @param VirtualCountersAfter Virtual counter values after generating the blocks
+	 * @return false if the blocks could not be templated (caller should not cache them)
+	 */
+	bool Build(const TArray<FVMFKeyValues>& Blocks, int32 IndentLevel,
+		EVMFIdCounter EntityIdKind, const FVMFIdCounters& VirtualCountersAfter);
+
+	/** Append the text with real IDs and advance the counters by IdsUsed. */
+	void Render(FString& Out, FVMFIdCounters& Counters) const;
+
+	/** Virtual counters to pass to block generators before calling Build(). */
+	static FVMFIdCounters MakeVirtualCounters();
+};
+
+/**
+ * Content fingerprint of everything an actor's exported blocks depend on.
+ * Accumulates raw bytes and hashes them with CityHash64.
+ */
+class SOURCEBRIDGE_API FVMFFingerprint
+{
+public:
+	explicit FVMFFingerprint(const TCHAR* Domain);
+
+	void Add(const FString& Value);
+	void Add(const FName& Value);
+	void Add(int32 Value);
+	void Add(uint32 Value);
+	void Add(double Value);
+	void Add(const FVector& Value);
+	void Add(const FTransform& Value);
+	void Add(const FGuid& Value);
+
+	uint64 Get() const;
+
+private:
+	TArray<uint8> Buffer;
+};
+
+/**
+ * Maps each UE material through an FMaterialMapper once per export.
+ * Fingerprinting brushes needs the resolved Source path of every face, and going through
+ * the mapper also records the path as used even when the cached blocks are reused.
+ */
+struct SOURCEBRIDGE_API FVMFMaterialMemo
+{
+	explicit FVMFMaterialMemo(const FMaterialMapper& InMapper) : Mapper(InMapper) {}
+
+	const FString& Map(UMaterialInterface* Material);
+
+private:
+	const FMaterialMapper& Mapper;
+	TMap<UMaterialInterface*, FString> Paths;
+};
+
+/**
+ * Per-actor cache of serialized VMF blocks for incremental export.
+ *
+ * FVMFExporter::ExportScene fingerprints each brush, mesh brush, stored worldspawn
+ * solid set and entity it exports (transform, brush model, materials, tags, keyvalues).
+ * Unchanged fingerprints reuse the cached template instead of reconverting and
+ * reserializing; changed ones are regenerated. Output is identical to a full export.
+ */
+class SOURCEBRIDGE_API FVMFExportCache
+{
+public:
+	/** Cached result of exporting one actor. */
+	struct FEntry
+	{
+		FVMFBlockTemplate Template;
+
+		/** Warnings produced when the blocks were generated (replayed on every hit). */
+		TArray<FString> Warnings;
+
+		/** Number of solids in the template (for export stats). */
+		int32 SolidCount = 0;
+
+		/** Side planes of the solids (see FVMFPlaneTable), counted on every hit. */
+		TArray<FVMFPlaneUse> Planes;
+
+		uint32 LastUsedExport = 0;
+	};
+
+	/** Start an export pass. Entries not touched before EndExport() are dropped. */
+	static void BeginExport();
+
+	/** Finish an export pass, pruning stale entries and logging hit statistics. */
+	static void EndExport();
+
+	/** Look up a fingerprint. Returns nullptr on a miss (or when incremental export is disabled). */
+	static const FEntry* Find(uint64 Fingerprint);
+
+	/** Store a freshly generated entry (no-op when incremental export is disabled). */
+	static void Add(uint64 Fingerprint, FEntry&& Entry);
+
+	/** Drop every cached block. */
+	static void Clear();
+
+	static int32 Num() { return Entries.Num(); }
+
+private:
+	static TMap<uint64, FEntry> Entries;
+	static uint32 ExportSerial;
+	static int32 Hits;
+	static int32 Misses;
+	static bool bEnabled;
+
+	/** bCanonicalizePlanes the cached blocks were written with */
+	static bool bCanonicalPlanes;
+};
@@ -5,6 +5,8 @@
 
 class UWorld;
 class FMaterialMapper;
+struct FVMFIdCounters;
+struct FVMFMaterialMemo;
 
 /**
  * Builds and exports complete VMF documents.
@@ -22,6 +24,11 @@ public:
 	 * Skips the default builder brush and volume actors.
 	 * Warnings are logged via UE_LOG.
 	 *
+	 * Brushes, mesh brushes, imported worldspawn solids and entities are emitted through
+	 * FVMFExportCache, so actors unchanged since the previous export are not reconverted.
+	 * With bMergeBrushes, world brushes are converted every time and merged into fewer
+	 * convex solids by FBrushMerger.
+	 *
 	 * @param World The world to export.
 	 * @param MapName Optional map name for custom material Source paths (e.g. "custom/<mapname>/<material>").
 	 * @param OutUsedMaterials Optional output: all Source material paths referenced in the exported VMF.
@@ -67,9 +74,8 @@ private:
 	 */
 	static void ExportBrushEntities(
 		const TArray<struct FSourceEntity>& Entities,
-		int32& EntityIdCounter,
-		int32& SolidIdCounter,
-		int32& SideIdCounter,
+		FVMFIdCounters& Ids,
 		const FMaterialMapper& MatMapper,
+		FVMFMaterialMemo& MaterialMemo,
 		FString& Result);
 };
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Planes deduplicated the way vbsp builds its plane lump (FindFloatPlane in map.cpp):
+ * hashed on |dist|, compared component-wise within tolerances, and each new plane
+ * stored together with its flip at the next index (index ^ 1 is the flip).
+ */
+class SOURCEBRIDGE_API FVMFPlaneSet
+{
+public:
+	/** vbsp's NORMAL_EPSILON and DIST_EPSILON */
+	static constexpr double VBSPNormalEpsilon = 0.00001;
+	static constexpr double VBSPDistEpsilon = 0.01;
+
+	explicit FVMFPlaneSet(double InNormalEpsilon = VBSPNormalEpsilon, double InDistEpsilon = VBSPDistEpsilon)
+		: NormalEpsilon(InNormalEpsilon), DistEpsilon(InDistEpsilon) {}
+
+	/** vbsp's SnapPlane with this set's tolerances: axial normals and integer distances. */
+	void Snap(FVector3d& Normal, double& Dist) const;
+
+	/** Index of a (snapped) plane, or INDEX_NONE. */
+	int32 Find(const FVector3d& Normal, double Dist) const;
+
+	/** Index of a (snapped) plane, adding it and its flip if it's new. */
+	int32 FindOrAdd(const FVector3d& Normal, double Dist);
+
+	const FVector3d& GetNormal(int32 Index) const { return Normals[Index]; }
+	double GetDist(int32 Index) const { return Dists[Index]; }
+
+	/** Entries including flips (what the plane lump would hold). */
+	int32 Num() const { return Normals.Num(); }
+
+	void Reset();
+
+private:
+	double NormalEpsilon;
+	double DistEpsilon;
+
+	TArray<FVector3d> Normals;
+	TArray<double> Dists;
+	TMap<int32, TArray<int32>> Buckets;
+};
+
+/** A brush side's plane as it would have been written, and the plane it was written on. */
+struct FVMFPlaneUse
+{
+	FVector3d RawNormal = FVector3d::ZeroVector;
+	double RawDist = 0.0;
+
+	/** The plane vbsp parses from the written points (the raw plane if not canonicalized) */
+	FVector3d Normal = FVector3d::ZeroVector;
+	double Dist = 0.0;
+
+	bool bCanonical = false;
+};
+
+/** Side planes of one export, before and after canonicalization (as plane lump entries). */
+struct FVMFPlaneStats
+{
+	int32 Sides = 0;
+	int32 RawPlanes = 0;
+	int32 CanonicalPlanes = 0;
+};
+
+/**
+ * Canonical plane points for brush sides.
+ *
+ * Converted faces carry float noise from the UE transform, so faces that share a plane
+ * in the editor get slightly different plane points and vbsp keeps every variant. A face
+ * whose plane (from all its vertices) vbsp itself would snap to an integer distance, and
+ * whose vertices all lie within DistTolerance of it, is written with
+ * three integer points derived from that plane alone; every face on the plane (or its
+ * flip) gets the same points, so vbsp parses one plane for all of them. Other faces keep
+ * their raw points.
+ *
+ * The points don't depend on the rest of the export, so cached and regenerated brushes
+ * agree, and an incremental export matches a full one.
+ */
+class SOURCEBRIDGE_API FVMFPlaneTable
+{
+public:
+	/** How far a face's vertices may lie off the canonical plane it's written on. */
+	static constexpr double DistTolerance = 0.1;
+
+	/** Edge of an axial plane's point triangle; sloped planes' triangles are multiples of it. */
+	static constexpr double PointSpan = 512.0;
+
+	/** Start an export pass. */
+	static void BeginExport();
+
+	/** Finish an export pass and log the plane counts. */
+	static void EndExport();
+
+	/** Whether faces are canonicalized in this export (bCanonicalizePlanes). */
+	static bool IsEnabled() { return bEnabled; }
+
+	/**
+	 * Plane string for a face, on its canonical plane.
+	 * @param Vertices Face vertices in Source space, in winding order
+	 * @param RawPoints The points the face would otherwise be written with (their
+	 *        (P2-P1)x(P3-P1) gives the side's orientation)
+	 * @param OutUses Receives the face's plane use, for Record()
+	 */
+	static FString GetPlaneString(const TArray<FVector>& Vertices, const FVector (&RawPoints)[3],
+		TArray<FVMFPlaneUse>& OutUses);
+
+	/** Count the sides of an emitted (generated or cached) block. */
+	static void Record(const TArray<FVMFPlaneUse>& Uses);
+
+	/** Counts of the current (or last) export. */
+	static const FVMFPlaneStats& GetStats() { return Stats; }
+
+private:
+	/** Per-export counting: planes of the raw points, and of the points actually written */
+	static FVMFPlaneSet RawPlanes;
+	static FVMFPlaneSet WrittenPlanes;
+	static FVMFPlaneStats Stats;
+
+	static bool bEnabled;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Compile/BSPBudget.h"
+
+struct FVMFKeyValues;
+
+/**
+ * What vbsp will emit for a VMF, counted before it runs.
+ */
+struct SOURCEBRIDGE_API FCompileLimitEstimate
+{
+	/** False when there was nothing to count. */
+	bool bChecked = false;
+
+	/** Solids vbsp keeps (origin brushes are dropped) */
+	int32 Brushes = 0;
+
+	/** Brush sides including the bevel sides vbsp adds for collision */
+	int32 BrushSides = 0;
+	int32 BevelSides = 0;
+
+	/** Entries in the planes lump: unique snapped planes, each stored with its flip */
+	int32 Planes = 0;
+
+	/** Unique texinfo (material, texture axes, scales, shifts, lightmap scale) */
+	int32 TexInfo = 0;
+
+	/** Unique materials, and the bytes of their names in the texdata string data */
+	int32 TexData = 0;
+	int32 TexDataStringBytes = 0;
+
+	/** Entities left in the entity lump */
+	int32 Entities = 0;
+
+	int32 Overlays = 0;
+	int32 StaticProps = 0;
+
+	double Seconds = 0.0;
+
+	/** Counts against engine limits, named like FBSPBudget's entries. */
+	TArray<FBSPBudgetEntry> GetEntries() const;
+};
+
+/**
+ * Predicts vbsp's limit-bound counts from an exported VMF.
+ *
+ * Brushes are processed the way vbsp's map loader does, on multiple threads: planes
+ * from the three side points, snapped to axial normals and integer distances, brush
+ * windings, then the axial and edge bevel planes. The planes are deduplicated serially
+ * with vbsp's epsilons, in file order, adding each new plane together with its flip.
+ * Texinfo is deduplicated on the exact float texture and lightmap vectors vbsp builds,
+ * texdata on the material name.
+ *
+ * Not modelled: func_instance contents, the cubemap material patches vbsp writes for
+ * env_cubemap sides, and water/displacement extras. These only add, so an over-limit
+ * estimate will fail to compile.
+ */
+class SOURCEBRIDGE_API FCompileLimitEstimator
+{
+public:
+	/** Usage at which an estimate is reported as a warning. */
+	static constexpr float WarningThreshold = 0.9f;
+
+	/** Count parsed VMF blocks (as returned by FVMFReader). */
+	static FCompileLimitEstimate EstimateVMF(const TArray<FVMFKeyValues>& Blocks);
+
+	/** Entries at or above WarningThreshold, as "[Limits] ..." messages (over 100% first). */
+	static TArray<FString> GetWarnings(const FCompileLimitEstimate& Estimate);
+
+	/** Whether any count is over its engine limit (vbsp would likely fail; the estimate is approximate). */
+	static bool ExceedsLimits(const FCompileLimitEstimate& Estimate);
+};
@@ -79,8 +79,16 @@ class SOURCEBRIDGE_API FExportValidator
 public:
 	/**
 	 * Run all validation checks on a world.
+	 * @param bCheckExport Export the world in memory, predict vbsp's counts against the engine
+	 *        limits (see FCompileLimitEstimator) and flood-fill it for leaks (see FLeakDetector)
 	 */
-	static FValidationResult ValidateWorld(UWorld* World);
+	static FValidationResult ValidateWorld(UWorld* World, bool bCheckExport = true);
+
+	/** Report a leak check result as validation messages. */
+	static void AddLeakMessages(const struct FLeakCheckResult& Leak, FValidationResult& Result);
+
+	/** Report predicted compile counts as validation messages (warnings from 90% on; the prediction is approximate, so never an error). */
+	static void AddLimitMessages(const struct FCompileLimitEstimate& Estimate, FValidationResult& Result);
 
 private:
 	/** Check brush counts against Source limits. */
@@ -106,4 +114,10 @@ private:
 
 	/** Warn about static meshes that may not export properly. */
 	static void ValidateStaticMeshes(UWorld* World, FValidationResult& Result);
+
+	/** Flood-fill the exported world solids for leaks and draw the leak path. */
+	static void ValidateLeaks(UWorld* World, const TArray<struct FVMFKeyValues>& Blocks, FValidationResult& Result);
+
+	/** Predict planes, texinfo, texdata and the other vbsp counts of the exported VMF. */
+	static void ValidateCompileLimits(const TArray<struct FVMFKeyValues>& Blocks, FValidationResult& Result);
 };
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+struct FVMFKeyValues;
+
+/**
+ * Result of a native leak check. Positions are in Source units.
+ */
+struct SOURCEBRIDGE_API FLeakCheckResult
+{
+	/** False when there was nothing to check (no sealing world brushes). */
+	bool bChecked = false;
+
+	bool bLeaked = false;
+
+	/** Entity whose origin reaches the void. */
+	FString LeakEntityClass;
+	FVector LeakEntityOrigin = FVector::ZeroVector;
+
+	/** Polyline from the leaking entity to the outside of the map. */
+	TArray<FVector> LeakPath;
+
+	/** Voxel edge length used; gaps narrower than this are not detected. */
+	int32 VoxelSize = 0;
+	FIntVector GridSize = FIntVector::ZeroValue;
+
+	int32 SealingBrushCount = 0;
+	int32 SeedEntityCount = 0;
+
+	/** Point entities whose origin is inside a solid (not used as seeds). */
+	int32 EntitiesInSolid = 0;
+
+	double Seconds = 0.0;
+
+	/** Whether most entities were inside solid voxels, so a pass says little. */
+	bool HasLowCoverage() const
+	{
+		return bChecked && EntitiesInSolid * 2 > SeedEntityCount;
+	}
+};
+
+/**
+ * Finds leaks before vbsp runs.
+ *
+ * World solids that seal (not clip, hint, skip, trigger or water brushes, nor brushes
+ * with displacements) are voxelized on multiple threads. A breadth-first flood fill then
+ * starts from every point entity origin, nudged up a unit and skipping entities at the
+ * world origin like vbsp's FloodEntities. If the fill reaches the padding around the
+ * map, the map leaks, and the shortest path from that entity is reported, like a vbsp
+ * pointfile.
+ *
+ * A voxel counts as solid if any sealing brush overlaps it. Reported leaks are
+ * therefore real, but gaps narrower than VoxelSize may go unnoticed and vbsp stays the
+ * final word. When coarse voxels bury most entity origins in solid, the check is retried
+ * once on a finer grid; HasLowCoverage() tells if that didn't help. Brush entities
+ * (func_detail, ...) never seal. func_instance contents are not expanded.
+ */
+class SOURCEBRIDGE_API FLeakDetector
+{
+public:
+	/** Check parsed VMF blocks (as returned by FVMFReader). */
+	static FLeakCheckResult CheckVMF(const TArray<FVMFKeyValues>& Blocks);
+
+	/** Parse and check a VMF file. */
+	static FLeakCheckResult CheckVMFFile(const FString& VMFPath);
+
+	/** Draw the leak path as persistent debug lines in the editor viewport. */
+	static void DrawLeakPath(UWorld* World, const FLeakCheckResult& Result);
+
+	/** Write the leak path as a Hammer pointfile (<map>.lin next to the VMF). */
+	static bool WritePointfile(const FString& VMFPath, const FLeakCheckResult& Result);
+};
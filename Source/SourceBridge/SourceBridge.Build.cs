@@ -36,7 +36,8 @@ public class SourceBridge : ModuleRules
 			"ProceduralMeshComponent",
 			"ImageWrapper",
 			"GraphEditor",
-			"AssetTools"
+			"AssetTools",
+			"Json"
 		});
 	}
 }